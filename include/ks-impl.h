@@ -42,6 +42,7 @@ void ks_init_T_Enum();
 
 void ks_init_T_str();
 void ks_init_T_bytes();
+void ks_init_T_bytearray();
 void ks_init_T_str_builder();
 
 void ks_init_T_list();
@@ -50,21 +51,31 @@ void ks_init_T_slice();
 void ks_init_T_range();
 void ks_init_T_dict();
 void ks_init_T_set();
+void ks_init_T_deque();
+void ks_init_T_heap();
+void ks_init_T_iters();
 void ks_init_T_namespace();
 
 void ks_init_T_func();
 void ks_init_T_cfunc();
 void ks_init_T_pfunc();
+void ks_init_T_memoize();
 void ks_init_T_Error();
 void ks_init_T_thread();
 void ks_init_T_logger();
 void ks_init_T_module();
 void ks_init_T_ios();
+void ks_init_T_mmap();
+
+// Write out anything buffered in 'ks_stdout' and 'ks_stderr' (ignoring errors), so that C code can write to
+//   'stdout'/'stderr' directly and keep the output in order
+void ks_ios_sync_std();
 
 void ks_init_T_parser();
 void ks_init_T_ast();
 void ks_init_T_code();
 void ks_init_T_kfunc();
+void ks_init_T_gen();
 void ks_init_T_stack_frame();
 
 // extra initializations
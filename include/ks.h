@@ -213,6 +213,54 @@ extern ks_none KS_NONE;
 // 'none' downcasted to an object
 #define KSO_NONE ((ks_obj)KS_NONE)
 
+// ks_buffer - a description of the raw memory an object exposes (the 'buffer protocol'), so that C code
+//   can read (or write) it in place, without converting to `bytes` or iterating element-by-element
+// Use `ks_buffer_get()` to request a buffer from an object, and `ks_buffer_release()` when done with it
+typedef struct {
+
+    // the object which owns the memory (holds a reference while the buffer is held)
+    ks_obj owner;
+
+    // pointer to the first element
+    void* data;
+
+    // total size (in bytes) of all the elements
+    ks_ssize_t len_b;
+
+    // format of a single element, as a `bytearray.pack()` format character ('B', 'i', 'd', ...), or
+    //   'Z' followed by 'f' or 'd' for complex numbers
+    const char* fmt;
+
+    // size (in bytes) of a single element
+    ks_ssize_t itemsize;
+
+    // whether the memory may not be written to
+    bool readonly;
+
+    // number of dimensions, and arrays of [ndim] sizes & strides (in bytes)
+    int ndim;
+    ks_ssize_t* shape;
+    ks_ssize_t* strides;
+
+    // storage used by 1D buffers for `shape` and `strides`
+    ks_ssize_t _shape1, _stride1;
+
+} ks_buffer;
+
+// Flags for requesting a buffer
+enum ks_buffer_flags {
+
+    // read-only access is fine
+    KS_BUFFER_NONE          = 0x00,
+
+    // the memory must be writable
+    KS_BUFFER_WRITABLE      = 0x01,
+
+    // the memory must be a single dense block (in row-major order)
+    KS_BUFFER_CONTIG        = 0x02,
+
+};
+
 enum ks_type_flags {
 
     // no special flags
@@ -324,6 +372,18 @@ struct ks_type_s {
     // |, &, ^ operators
     ks_obj __binor__, __binand__, __binxor__;
 
+
+    /* C-level Protocols */
+
+    // getbuf(self, buf, flags) - fill in 'buf' with the memory of 'self' (the buffer protocol), or NULL if the
+    //   type does not expose its memory. This should not take a reference to 'self' (`ks_buffer_get()` does that)
+    // NOTE: Returns success, or false and throws an error
+    bool (*getbuf)(ks_obj self, ks_buffer* buf, int flags);
+
+    // relbuf(self, buf) - called when a buffer given by 'getbuf' is released (or NULL if there is nothing to do), so
+    //   types that can move their memory (i.e. bytearray) know when it is no longer exported
+    void (*relbuf)(ks_obj self, ks_buffer* buf);
+
 };
 
 
@@ -370,13 +430,21 @@ struct ks_str_s {
 
     #endif /* KS_STR_OFF_EVERY */
 
-    // the actual array of characters. In memory, ks_str's are allocated so that taking `->chr` just gives the address of
-    // the start of the NUL-terminated part of the string. The [SZ] is to make sure that sizeof(ks_str) will allow
-    // for enough room for 2 bytes (this is useful for the internal constants for single-length strings),
-    // and so new strings can be created with: `malloc(sizeof(*ks_str) + len_b)`
-    // Every 'character' is a code point from the Universal Character Set (UCS), but we do not use UTF32 or anything; everything
-    //   is utf8 internally
-    char chr[2];
+    // if non-NULL, this string is a view of the bytes of another string (which this holds a reference to), and 'chr'
+    //   points into the bytes of 'src' (or to a copy of them, once `ks_str_cstr()` has been called)
+    ks_str src;
+
+    // pointer to the characters of the string. Every 'character' is a code point from the
+    //   Universal Character Set (UCS), but we do not use UTF32 or anything; everything is utf8 internally
+    // NOTE: For strings that are not views, this is just `_chr`, and is NUL-terminated. Views may not be, so use
+    //   `ks_str_cstr()` to pass the string to C functions that expect a NUL-terminated string
+    char* chr;
+
+    // the actual array of characters (for strings that are not views). In memory, ks_str's are allocated so that `_chr` 
+    //   holds the NUL-terminated bytes of the string. The [SZ] is to make sure that sizeof(ks_str) will allow
+    //   for enough room for 2 bytes (this is useful for the internal constants for single-length strings),
+    //   and so new strings can be created with: `malloc(sizeof(*ks_str) + len_b)`
+    char _chr[2];
 
 };
 
@@ -478,6 +546,34 @@ typedef struct ks_bytes_s {
 }* ks_bytes;
 
 
+// ks_bytearray - mutable array of bytes, which can be grown and modified in place
+// A bytearray may also be a view of a range of another bytearray (see `ks_bytearray_view()`), in which case it
+//   shares memory with it, so writes through either are visible in both
+typedef struct ks_bytearray_s {
+    KS_OBJ_BASE
+
+    // length (in bytes) of the array
+    ks_size_t len_b;
+
+    // capacity (in bytes) of 'byt', which is grown geometrically (always 0 for views)
+    ks_size_t max_len_b;
+
+    // array of bytes, which this owns (NULL for views)
+    // NOTE: use `ks_bytearray_data()` to get the bytes of any bytearray (including views)
+    uint8_t* byt;
+
+    // if non-NULL, this is a view of the bytes [off, off+len_b) of 'src' (which this holds a reference to)
+    // NOTE: an offset is stored instead of a pointer, since 'src->byt' is reallocated when it grows
+    struct ks_bytearray_s* src;
+    ks_size_t off;
+
+    // the number of buffers (see `ks_buffer_get()`) of this bytearray, or of views of it, which are currently held.
+    //   While there are any, it can't be resized (since 'byt' may be reallocated)
+    ks_size_t n_exports;
+
+}* ks_bytearray;
+
+
 // ks_str_builder - string builder, which is a mutable type that can generate strings
 // This is used internally to reduce the overhead of string concatenation
 typedef struct {
@@ -486,8 +582,13 @@ typedef struct {
     // the length (in bytes) that the string builder is currently
     ks_size_t len;
 
-    // the data the string builder has
-    void* data;
+    // the capacity (in bytes) of 'buf', which is grown geometrically
+    ks_size_t max_len;
+
+    // the buffer the string builder has, which is allocated with the memory layout of a `ks_str`, so
+    //   that `ks_str_builder_get()` can turn it into a string without copying. The bytes are in `buf->_chr`
+    // NOTE: this is NULL if nothing has been allocated yet
+    ks_str buf;
 
 }* ks_str_builder;
 
@@ -611,15 +712,40 @@ typedef struct {
 
 
 // ks_list - a dense list of other objects, indexable from [0, len)
+// NOTE: Large lists of numbers may be stored unboxed (see `KS_LIST_KIND_*`), in which case 'elems' is NULL. Code
+//   that reads 'elems' of a list it did not create itself must call `ks_list_box()` first (or use `ks_list_get()`)
 struct ks_list_s {
     KS_OBJ_BASE
 
     // length, in elements, of the list
     ks_size_t len;
 
-    // array of the elements
+    // the capacity of 'elems' (or 'raw'), which is grown geometrically, so pushing is amortized O(1)
+    ks_size_t max_len;
+
+    // array of the elements, if 'kind' is `KS_LIST_KIND_OBJ`
+    // A reference is held to each of these
     ks_obj* elems;
 
+    // how the elements are stored (see `KS_LIST_KIND_*`)
+    int kind;
+
+    // array of the elements of an unboxed list, which are only made into objects when they are read
+    union {
+        int64_t* v64;
+        double* vf;
+    } raw;
+
+};
+
+// kinds of lists; elements are stored directly as C values if they are all the same basic type
+enum {
+    // objects, in 'elems'
+    KS_LIST_KIND_OBJ    = 0,
+    // `int` objects which fit in 64 bits, in 'raw.v64'
+    KS_LIST_KIND_INT64,
+    // `float` objects, in 'raw.vf'
+    KS_LIST_KIND_FLOAT,
 };
 
 
@@ -630,6 +756,11 @@ typedef struct {
     // length, in elements, of the tuple
     ks_size_t len;
 
+    // the hash of the tuple, which is combined from the hashes of the elements, and cached the first time
+    //   it is requested (see `ks_tuple_hash()`)
+    // NOTE: this is 0 if it has not been computed yet (a hash of 0 is stored as 1)
+    ks_hash_t v_hash;
+
     // array of the elements
     // similar to ks_str, we simply allocate the extra bytes in the tuple (since it is immutable)
     ks_obj elems[0];
@@ -679,6 +810,8 @@ struct ks_dict_s {
 
     }* entries;
 
+    // the capacity of 'entries' (which is grown geometrically)
+    ks_size_t max_n_entries;
 
     // the number of buckets in the hash table (normally, a prime number)
     ks_size_t n_buckets;
@@ -737,6 +870,9 @@ typedef struct {
 
     }* entries;
 
+    // the capacity of 'entries' (which is grown geometrically)
+    ks_size_t max_n_entries;
+
 
     // the number of buckets in the hash table (normally, a prime number)
     ks_size_t n_buckets;
@@ -747,6 +883,60 @@ typedef struct {
 }* ks_set;
 
 
+// ks_deque - double-ended queue, which is a ring buffer that can be pushed to & popped from at both ends in O(1)
+typedef struct {
+    KS_OBJ_BASE
+
+    // number of elements in the deque
+    ks_size_t len;
+
+    // the capacity of 'elems' (which is always 0 or a power of 2, so indices can be wrapped with a mask)
+    ks_size_t max_len;
+
+    // index (in 'elems') of the first element
+    ks_size_t head;
+
+    // array of elements, where element 'i' is at `elems[(head + i) & (max_len - 1)]`
+    // A reference is held to each of these
+    ks_obj* elems;
+
+}* ks_deque;
+
+
+// ks_heap - priority queue (binary min-heap), where the smallest element (according to `<`) is popped first
+typedef struct {
+    KS_OBJ_BASE
+
+    // number of elements in the heap
+    ks_size_t len;
+
+    // the capacity of 'elems' (which is grown geometrically)
+    ks_size_t max_len;
+
+    // array of elements, in heap order (i.e. `elems[i] <= elems[2*i+1]` and `elems[i] <= elems[2*i+2]`)
+    // A reference is held to each of these
+    ks_obj* elems;
+
+    // the kind of elements currently in the heap, which decides how they are compared (see `KS_HEAP_KIND_*`)
+    int kind;
+
+}* ks_heap;
+
+// kinds of heaps; elements are compared directly in C if they are all the same basic type
+enum {
+    // empty (or not yet decided)
+    KS_HEAP_KIND_NONE   = 0,
+    // all elements are `int` objects which fit in 64 bits
+    KS_HEAP_KIND_INT64,
+    // all elements are `float` objects
+    KS_HEAP_KIND_FLOAT,
+    // all elements are `str` objects
+    KS_HEAP_KIND_STR,
+    // anything else (which uses `ks_obj_lt()`)
+    KS_HEAP_KIND_OBJ,
+};
+
+
 // ks_namespace - a dictionary, but with attribute references rather than subscripting
 typedef struct {
     KS_OBJ_BASE
@@ -796,6 +986,50 @@ typedef struct {
 }* ks_pfunc;
 
 
+// ks_memoize - a wrapper around a function, which caches its results by arguments, evicting the least recently used
+//   results once there are more than 'max_len'
+typedef struct {
+    KS_OBJ_BASE
+
+    // the function being wrapped
+    ks_obj func;
+
+    // maximum number of results kept (or -1 for no limit)
+    ks_ssize_t max_len;
+
+    // number of results currently kept
+    ks_size_t len;
+
+    // hash table (separately chained), with 'n_buckets' (a power of 2) heads
+    ks_size_t n_buckets;
+    struct ks_memoize_entry {
+
+        // the arguments (the argument itself if there was exactly 1, otherwise a tuple)
+        ks_obj key;
+
+        // the hash of 'key'
+        ks_hash_t hash;
+
+        // the result of calling the function
+        ks_obj val;
+
+        // next entry in the same bucket
+        struct ks_memoize_entry* next_b;
+
+        // neighbors in the recently-used list
+        struct ks_memoize_entry *prev, *next;
+
+    }** buckets;
+
+    // the most and least recently used entries
+    struct ks_memoize_entry *first, *last;
+
+    // number of calls that were answered from the cache, and that called the function
+    int64_t hits, misses;
+
+}* ks_memoize;
+
+
 /* Enums */
 
 // ks_Enum - base class for an enumeration
@@ -1168,6 +1402,10 @@ enum {
     // result is 'children[0]'
     KS_AST_RET,
 
+    // Represents a yield statement, which makes the function it is in a generator
+    // result is 'children[0]'
+    KS_AST_YIELD,
+
     // Represents a throw statement
     // expression is 'children[0]'
     KS_AST_THROW,
@@ -1474,6 +1712,11 @@ enum {
     // 1:[op]
     KSB_RET,
 
+    // Pop off the TOS, and yield that as the next value of the currently executing generator (see 'ks_gen'),
+    //   saving the stack and program counter so that execution can be resumed after this instruction
+    // 1:[op]
+    KSB_YIELD,
+
     // Enter a 'try' block, which will cause the code to jump to +relamt if an exception is thrown
     // NOTE: The relative amount is from the point which the TRY_START instruction is encountered;
     //   not where the exception was thrown
@@ -1680,6 +1923,10 @@ typedef struct {
 
     }* meta;
 
+    // if true, the code contains a 'yield', so calling a function with this code creates a 'gen'
+    //   instead of executing it
+    bool isGen;
+
 }* ks_code;
 
 
@@ -1769,6 +2016,41 @@ typedef struct {
 ks_stack_frame ks_stack_frame_new(ks_obj func);
 
 
+// ks_gen - a generator, which is the result of calling a 'kfunc' that contains a 'yield' statement
+// Each call to `__next__` resumes the function's code until the next 'yield' (or the end of the function, which
+//   throws an 'OutOfIterError')
+typedef struct {
+    KS_OBJ_BASE
+
+    // the stack frame of the function, which holds the locals and the program counter. It is kept
+    //   between calls, and pushed on to the thread's frames while resuming
+    ks_stack_frame frame;
+
+    // the items that were on the thread's stack (above where the function started) when it yielded
+    ks_list stk;
+
+    // the exception handlers that were active when it yielded (as addresses in the bytecode)
+    int n_exc;
+    ksb** exc;
+
+    // whether the generator is currently executing
+    bool isRunning;
+
+    // whether the generator has finished (i.e. returned or threw an error)
+    bool isDone;
+
+}* ks_gen;
+
+// create a new generator that will execute 'func', with local variables 'locals' (which should already have
+//   the arguments set)
+// NOTE: Returns a new reference
+KS_API ks_gen ks_gen_new(ks_kfunc func, ks_dict locals);
+
+// resume execution of 'self' until it yields a value
+// NOTE: Returns a new reference, or NULL and throws an error (which is an 'OutOfIterError' when it finishes)
+KS_API ks_obj ks_gen_next(ks_gen self);
+
+
 
 
 /* I/O 
@@ -1804,9 +2086,42 @@ typedef struct {
     // the underlying file pointer
     FILE* _fp;
 
+    // the internal buffer, which holds 'buf_max' bytes (allocated on first use)
+    // NOTE: the buffer is either being read from (bytes [buf_pos, buf_len) have been read from `_fp`, but not
+    //   consumed yet), or being written to (bytes [0, buf_len) have been written, but not flushed to `_fp`),
+    //   which is given by 'isWriting'
+    uint8_t* buf;
+    ks_size_t buf_max, buf_pos, buf_len;
+    bool isWriting;
+
+    // whether to flush the buffer after every write containing a newline (used for terminals)
+    bool isLineBuf;
+
 }* ks_ios;
 
 
+// ks_mmap - a file mapped into memory (with `mmap()`), which exposes its contents through the buffer protocol
+// The mapping is only removed when the object is freed, so any buffers (and views, such as `nx.view`) of it
+//   stay valid as long as they hold their reference
+typedef struct {
+    KS_OBJ_BASE
+
+    // the name of the file, and the mode it was mapped with ('r', 'r+' or 'c')
+    ks_str name, mode;
+
+    // the mapped memory, which is 'len_b' bytes long (NULL if the file was empty)
+    uint8_t* data;
+    ks_size_t len_b;
+
+    // whether the mapping is read-only (otherwise, writes go to the file)
+    bool readonly;
+
+    // whether the mapping is copy-on-write (writes are only seen by this mapping, and never go to the file)
+    bool isCopy;
+
+}* ks_mmap;
+
+
 // Create a blank 'iostream', with no target
 // NOTE: Use `ks_ios_open()` to actually get a target
 // NOTE: Returns a new reference
@@ -1825,8 +2140,8 @@ KS_API bool ks_ios_extern_FILE(ks_ios self, ks_str fname, ks_str mode, FILE* _fp
 
 
 // Close 'self' (or, if already closed, do nothing)
-// NOTE: will never throw an error; all errors are ignored
-KS_API void ks_ios_close(ks_ios self);
+// NOTE: The stream is always closed, but returns false and throws an error if buffered data could not be written
+KS_API bool ks_ios_close(ks_ios self);
 
 // Return the current position (in bytes) in 'self', or -1 and throw an error
 KS_API ks_ssize_t ks_ios_tell(ks_ios self);
@@ -1868,6 +2183,39 @@ KS_API ks_ssize_t ks_ios_readb(ks_ios self, ks_ssize_t len_b, void* dest);
 // ks_free(dest);
 KS_API ks_ssize_t ks_ios_reads(ks_ios self, ks_ssize_t len_c, void** dest, ks_ssize_t* len_c_actual);
 
+// Write a given number of bytes from `src` to the iostream
+// NOTE: Returns success, or false and throws an error
+KS_API bool ks_ios_writeb(ks_ios self, ks_ssize_t len_b, const void* src);
+
+// Read a single line from the iostream (up to and including the next '\n'), and set `*out` to it (a new reference),
+//   which is a 'str' (or a 'bytes', if the mode contains 'b'). If 'keepends' is false, the line ending is removed
+// NOTE: At the end of the stream, `*out` is set to NULL and true is returned (no error is thrown)
+// NOTE: Returns success, or false and throws an error
+KS_API bool ks_ios_readline(ks_ios self, bool keepends, ks_obj* out);
+
+// Write any buffered data to the underlying file
+// NOTE: Returns success, or false and throws an error
+KS_API bool ks_ios_flush(ks_ios self);
+
+// Set the size of the internal buffer used by 'self' (any buffered data is flushed first)
+// NOTE: Returns success, or false and throws an error
+KS_API bool ks_ios_setbuf(ks_ios self, ks_ssize_t buf_max);
+
+// Write 'str(args[i])' for each argument to the iostream, seperated by 'sep' and followed by 'end' (both
+//   NUL-terminated), then flush it if 'flush' is true
+// NOTE: Strings are written directly from their memory (including any embedded NULs), without building a
+//   temporary string of the whole line
+// NOTE: Returns success, or false and throws an error
+KS_API bool ks_ios_print(ks_ios self, int n_args, ks_obj* args, const char* sep, const char* end, bool flush);
+
+
+// Map the file 'fname' into memory, with mode 'r' (read-only), 'r+' (read-write, changes are written to the file),
+//   or 'c' (copy-on-write, changes are private to the mapping, and pages are only copied once they are written)
+// NOTE: A mapping with mode 'r' only exports a read-only buffer, so consumers that need a writable one (such as
+//   `nx.view()`) require mode 'r+' or 'c'
+// NOTE: Returns new reference, or NULL if an error was thrown
+KS_API ks_mmap ks_mmap_new(ks_str fname, ks_str mode);
+
 
 
 
@@ -1875,6 +2223,11 @@ KS_API ks_ssize_t ks_ios_reads(ks_ios self, ks_ssize_t len_c, void** dest, ks_ss
 // main thread
 extern ks_thread ks_thread_main;
 
+// the standard streams, wrapping the C 'stdin', 'stdout' and 'stderr'
+// NOTE: 'stdout' is line buffered on a terminal, and block buffered otherwise; it is flushed at exit, and before
+//   `ks_printf()` writes anything
+extern ks_ios ks_stdin, ks_stdout, ks_stderr;
+
 
 // list of paths (i.e. directories) to search when importing modules, files, etc
 // See `init.c` for how this is constructed, but essentially:
@@ -1892,6 +2245,7 @@ extern ks_type
     ks_T_type,
     ks_T_str,
     ks_T_bytes,
+    ks_T_bytearray,
     ks_T_str_builder,
 
     ks_T_bool,
@@ -1906,19 +2260,33 @@ extern ks_type
     ks_T_range,
     ks_T_dict,
     ks_T_set,
+    ks_T_deque,
+    ks_T_heap,
+    ks_T_map,
+    ks_T_filter,
+    ks_T_zip,
+    ks_T_enumerate,
+    ks_T_chain,
+    ks_T_islice,
+    ks_T_takewhile,
+    ks_T_dropwhile,
+    ks_T_repeat,
     ks_T_namespace,
 
     ks_T_parser,
     ks_T_ast,
     ks_T_code,
     ks_T_kfunc,
+    ks_T_gen,
 
     ks_T_func,
     ks_T_cfunc,
     ks_T_pfunc,
+    ks_T_memoize,
 
     ks_T_logger,
     ks_T_ios,
+    ks_T_mmap,
 
     ks_T_Enum,
 
@@ -2109,6 +2477,11 @@ KS_API bool ks_obj_hash(ks_obj obj, ks_hash_t* out);
 // NOTE: Ignores any errors generated while comparing them; if there was an error, this return false but does not throw anything
 KS_API bool ks_obj_eq(ks_obj A, ks_obj B);
 
+// Calculate whether 'A < B', using direct comparisons for ints, floats, and strs (and comparing tuples
+//   lexicographically), or the `<` operator otherwise
+// NOTE: Returns 1 if it is true, 0 if it is false, or -1 and throws an error
+KS_API int ks_obj_lt(ks_obj A, ks_obj B);
+
 
 // Extented version of `ks_obj_call` that takes a non-required (i.e. NULL-able) locals dictionary
 KS_API ks_obj ks_obj_call2(ks_obj func, int n_args, ks_obj* args, ks_dict locals);
@@ -2134,6 +2507,27 @@ KS_API bool ks_obj_is_callable(ks_obj func);
 KS_API bool ks_obj_is_iterable(ks_obj obj);
 
 
+// Buffer protocol (src/buffer.c)
+
+// Return whether or not 'obj' exposes its memory through the buffer protocol
+KS_API bool ks_buffer_has(ks_obj obj);
+
+// Request the memory of 'obj', according to 'flags' (see `enum ks_buffer_flags`)
+// The memory stays valid (and 'obj' stays alive) until `ks_buffer_release()` is called, and mutable objects refuse
+//   to be resized until then (e.g. `bytearray.append()` throws an error)
+// NOTE: Returns success, or false and throws an error (TypeError if 'obj' does not support the protocol)
+KS_API bool ks_buffer_get(ks_obj obj, ks_buffer* buf, int flags);
+
+// Release a buffer acquired with `ks_buffer_get()`
+KS_API void ks_buffer_release(ks_buffer* buf);
+
+// Fill in 'buf' as a 1D buffer of 'len_b' bytes (format 'B'), for use by `getbuf` implementations
+KS_API void ks_buffer_init_bytes(ks_buffer* buf, ks_obj owner, void* data, ks_ssize_t len_b, bool readonly);
+
+// Return whether the elements of 'buf' are a single dense block (in row-major order)
+KS_API bool ks_buffer_iscontig(ks_buffer* buf);
+
+
 // Throw an object, return NULL 
 KS_API ks_obj ks_obj_throw(ks_obj obj);
 
@@ -2299,7 +2693,7 @@ enum {
 // Create a kscript int from a string in a given base (check KS_BASE_* enums)
 // If `base==KS_BASE_AUTO==0`, then if a prefix is given, that base is used (i.e. 0x, 0r, 0o, 0b). Otherwise, base 10 is assumed
 // NOTE: Returns new reference, or NULL if an error was thrown
-KS_API ks_int ks_int_new_s(char* str, int base);
+KS_API ks_int ks_int_new_s(const char* str, int base);
 
 // Create a new integer from an MPZ
 // NOTE: Returns a new reference
@@ -2341,7 +2735,11 @@ KS_API ks_complex ks_complex_new(double complex val);
 // Calculate the length (in unicode characters, defined via the number of sequences decoded) of a string
 //   of (valid) UTF8. A negative return value indicates a unicode error was thrown
 // NOTE: If `len_b<0`, then `src` is assumed to be NUL-terminated
-KS_API ks_ssize_t ks_text_utf8_len_c(const char* src, ks_size_t len_b);
+KS_API ks_ssize_t ks_text_utf8_len_c(const char* src, ks_ssize_t len_b);
+
+// Validate 'len_b' bytes of UTF8 text, checking for invalid bytes, overlong encodings, surrogates, and values past U+10FFFF
+// NOTE: Returns the length in characters, or a negative number if it was not valid UTF8 (no error is thrown)
+KS_API ks_ssize_t ks_text_utf8_validate(const char* src, ks_ssize_t len_b);
 
 // Transcode 'len_c' characters of utf8 text (located in 'src'), into utf32 (located in 'dest')
 // NOTE: it is assumed that there is enough space in both arrays; `dest` should have been allocated for
@@ -2364,6 +2762,17 @@ KS_API ks_ssize_t ks_text_utf32_to_utf8(const ks_unich* src, char* dest, ks_ssiz
 // NOTE: if len_b < 0, then it is NUL-terminated, and the length is calculated via `strlen()`
 KS_API ks_str ks_str_utf8(const char* cstr, ks_ssize_t len_b);
 
+// Construct a new 'str' object by taking ownership of 'buf', which must have been allocated via `ks_malloc(sizeof(*buf) + n)`,
+//   for some `n >= len_b`, and whose first 'len_b' bytes of `buf->_chr` are UTF-8 text. No bytes are copied
+// NOTE: 'buf' should not be used after calling this (it may be freed, or become the returned string)
+// NOTE: Returns new reference
+KS_API ks_str ks_str_adopt(ks_str buf, ks_size_t len_b);
+
+// Append 'R' to 'L' in place (reusing the memory of 'L'), and return the result
+// NOTE: This must only be called when the caller holds the only reference to 'L'; that reference is consumed
+// NOTE: Returns new reference, or NULL if an error was thrown (in which case 'L' is not consumed, and is unchanged)
+KS_API ks_str ks_str_iadd(ks_str L, ks_str R);
+
 // Construct a new 'str' object, from a C-style string.
 // NOTE: If `len<0`, then `len` is calculated by the C `strlen()` function
 // NOTE: If `cstr==NULL`, then the empty string "" is returned, and `len` is not checked
@@ -2387,6 +2796,15 @@ KS_API ks_str ks_str_chr(ks_unich chr);
 // NOTE: indices must be adjusted! a negative `len_c` returns the rest of the string starting at 'start'
 KS_API ks_str ks_str_substr(ks_str self, ks_ssize_t start, ks_ssize_t len_c);
 
+// Create a substring of another string, from a range of bytes (which must start and end on character boundaries)
+// NOTE: The whole string is returned as-is, and long substrings are views of the bytes of 'self' (so nothing is copied)
+// NOTE: Returns new reference
+KS_API ks_str ks_str_substr_b(ks_str self, ks_ssize_t start_b, ks_ssize_t len_b);
+
+// Return the bytes of 'self' as a NUL-terminated string, which is valid for as long as 'self' is
+// NOTE: This copies the bytes of a view the first time it is called for it (which changes 'self->chr')
+KS_API const char* ks_str_cstr(ks_str self);
+
 
 // Compare two strings, and return their string comparison (i.e. strcmp() in C)
 KS_API int ks_str_cmp(ks_str A, ks_str B);
@@ -2412,6 +2830,27 @@ KS_API ks_str ks_str_unescape(ks_str A);
 KS_API ks_bytes ks_bytes_new(const uint8_t* byt, ks_size_t len_b);
 
 
+// Create a new `bytearray` object, copying 'len_b' bytes from 'byt' (or, zero-filled if 'byt==NULL')
+// NOTE: Returns a new reference
+KS_API ks_bytearray ks_bytearray_new(const uint8_t* byt, ks_size_t len_b);
+
+// Create a view of the bytes [start, start+len_b) of 'src', which shares memory with it
+// NOTE: Returns a new reference
+KS_API ks_bytearray ks_bytearray_view(ks_bytearray src, ks_size_t start, ks_size_t len_b);
+
+// Return a pointer to the bytes of a bytearray, which is valid until it (or, for a view, its source) is resized
+// NOTE: Returns NULL and throws an error if 'self' is a view whose source has been shrunk past it
+KS_API uint8_t* ks_bytearray_data(ks_bytearray self);
+
+// Resize a bytearray to 'len_b' bytes, zero-filling any new bytes
+// NOTE: Returns success, or false and throws an error (for example, views cannot be resized)
+KS_API bool ks_bytearray_resize(ks_bytearray self, ks_size_t len_b);
+
+// Append 'len_b' bytes from 'byt' to the end of a bytearray (which may be in the bytearray itself)
+// NOTE: Returns success, or false and throws an error
+KS_API bool ks_bytearray_extend(ks_bytearray self, const uint8_t* byt, ks_size_t len_b);
+
+
 
 
 // Create a new string builder
@@ -2432,9 +2871,14 @@ KS_API bool ks_str_builder_add_repr(ks_str_builder self, ks_obj obj);
 KS_API bool ks_str_builder_add_fmt(ks_str_builder self, const char* fmt, ...);
 KS_API bool ks_str_builder_add_vfmt(ks_str_builder self, const char* fmt, va_list ap);
 
+// Add `fmt.format(*args)` (see `str.format()`) to the string builder
+// NOTE: Returns success
+KS_API bool ks_str_builder_add_format(ks_str_builder self, ks_str fmt, int n_args, ks_obj* args);
+
 
 
 // Get the current string the builder has been building
+// NOTE: The buffer is handed over to the result without copying, so the builder is empty afterwards
 // NOTE: Returns new reference
 KS_API ks_str ks_str_builder_get(ks_str_builder self);
 
@@ -2452,6 +2896,13 @@ KS_API ks_list ks_list_new_iter(ks_obj iter_obj);
 // Clear a list out, removing any references
 KS_API void ks_list_clear(ks_list self);
 
+// Return a reference to 'self[idx]' (which must be in range), creating the object if 'self' is unboxed
+// NOTE: Returns a new reference
+KS_API ks_obj ks_list_get(ks_list self, ks_size_t idx);
+
+// Make sure the elements of 'self' are stored as objects (boxing them if the list was unboxed), and return 'elems'
+KS_API ks_obj* ks_list_box(ks_list self);
+
 
 // Empty out `objs` (which must be iterable!), and add everything to `self`
 // NOTE: Returns success, or false and throws an error
@@ -2481,6 +2932,38 @@ KS_API bool ks_list_popu(ks_list self);
 // NOTE: Returns success, or false and throws an error
 KS_API bool ks_list_popun(ks_list self, int n);
 
+// Sort a list in place (stably), comparing `key(elem)` for each element (or the elements themselves, if 'key' is
+//   NULL or none), in descending order if 'reverse' is true
+// NOTE: Returns success, or false and throws an error
+KS_API bool ks_list_sort(ks_list self, ks_obj key, bool reverse);
+
+
+// Create a new (empty) deque
+// NOTE: Returns a new reference
+KS_API ks_deque ks_deque_new();
+
+// Push 'obj' on to the back (or, for `ks_deque_pushleft()`, the front) of the deque
+KS_API void ks_deque_push(ks_deque self, ks_obj obj);
+KS_API void ks_deque_pushleft(ks_deque self, ks_obj obj);
+
+// Pop an element off the back (or, for `ks_deque_popleft()`, the front) of the deque, returning its reference
+// NOTE: Returns NULL and throws a 'SizeError' if the deque was empty
+KS_API ks_obj ks_deque_pop(ks_deque self);
+KS_API ks_obj ks_deque_popleft(ks_deque self);
+
+
+// Create a new (empty) heap
+// NOTE: Returns a new reference
+KS_API ks_heap ks_heap_new();
+
+// Push 'obj' on to the heap
+// NOTE: Returns success, or false and throws an error (if the comparison failed)
+KS_API bool ks_heap_push(ks_heap self, ks_obj obj);
+
+// Pop the smallest element off of the heap, returning its reference
+// NOTE: Returns NULL and throws an error if the heap was empty (or a comparison failed)
+KS_API ks_obj ks_heap_pop(ks_heap self);
+
 
 // Create a new kscript tuple from an array of elements, or an empty tuple if `len==0`
 // NOTE: Returns a new reference
@@ -2497,6 +2980,13 @@ KS_API ks_tuple ks_tuple_new_n(int len, ks_obj* elems);
 // NOTE: Returns a new reference, or NULL if there was an error thrown
 KS_API ks_tuple ks_build_tuple(const char* fmt, ...);
 
+// Calculate the hash of a tuple from the hashes of its elements, caching it in the tuple
+// NOTE: Returns success, or `false` and throws an error if an element could not be hashed
+KS_API bool ks_tuple_hash(ks_tuple self, ks_hash_t* out);
+
+// Return whether two tuples are equal, element-wise (ignoring errors, like `ks_obj_eq()`)
+KS_API bool ks_tuple_eq(ks_tuple L, ks_tuple R);
+
 
 // Create a new kscript namespace from a dictionary
 // NOTE: Returns a new reference
@@ -2504,6 +2994,7 @@ KS_API ks_namespace ks_namespace_new(ks_dict attr);
 
 // Construct a new dictionary from key, val pairs (elems[0], elems[1] is the first, elems[2*i+0], elems[2*i+1] makes up the i'th pair)
 // NOTE: `len%2==0` is a requirement!
+// NOTE: The dictionary is sized for all the pairs up front, so building a dict this way never rehashes
 // NOTE: Returns new reference, or NULL if an error was thrown
 KS_API ks_dict ks_dict_new(ks_size_t len, ks_obj* elems);
 
@@ -2598,6 +3089,17 @@ KS_API ks_cfunc ks_cfunc_new_c_old(ks_cfunc_f func, const char* sig);
 // NOTE: Returns new reference, or NULL if an error was thrown
 KS_API ks_pfunc ks_pfunc_new(ks_obj func, ks_obj member_inst);
 
+// Construct a new memoized wrapper around 'func', keeping at most 'max_len' results (or -1 for no limit)
+// NOTE: Returns new reference
+KS_API ks_memoize ks_memoize_new(ks_obj func, ks_ssize_t max_len);
+
+// Call 'self(*args)', returning a cached result if 'self' has already been called with equal arguments
+// NOTE: Returns new reference, or NULL if an error was thrown
+KS_API ks_obj ks_memoize_call(ks_memoize self, int n_args, ks_obj* args);
+
+// Remove all cached results from 'self'
+KS_API void ks_memoize_clear(ks_memoize self);
+
 
 
 
@@ -2736,6 +3238,10 @@ KS_API ks_ast ks_ast_new_subscript(ks_ast obj, int n_args, ks_ast* args);
 // NOTE: Returns a new reference
 KS_API ks_ast ks_ast_new_ret(ks_ast val);
 
+// Create an AST representing a yield statement
+// NOTE: Returns a new reference
+KS_API ks_ast ks_ast_new_yield(ks_ast val);
+
 // Create an AST representing a throw statement
 // NOTE: Returns a new reference
 KS_API ks_ast ks_ast_new_throw(ks_ast expr);
@@ -2826,6 +3332,7 @@ KS_API void ksca_setitem   (ks_code self, int n_items);
 KS_API void ksca_call      (ks_code self, int n_items);
 KS_API void ksca_vcall     (ks_code self);
 KS_API void ksca_ret       (ks_code self);
+KS_API void ksca_yield     (ks_code self);
 KS_API void ksca_throw     (ks_code self);
 KS_API void ksca_assert    (ks_code self);
 KS_API void ksca_jmp       (ks_code self, int relamt);
@@ -2890,6 +3397,11 @@ KS_API bool ks_slice_getci(ks_slice self, int64_t len, int64_t* first, int64_t*
 // NOTE: Returns a new reference
 KS_API ks_range ks_range_new(ks_int start, ks_int stop, ks_int step);
 
+// Get the start, step, and number of elements of a range as C values, for iterating over it without creating
+//   objects
+// NOTE: Returns whether they all fit (this does not throw an error)
+KS_API bool ks_range_get_c(ks_range self, int64_t* start, int64_t* step, ks_size_t* len);
+
 
 /* GENERIC NUMERICS (i.e. work with all numeric types) */
 
@@ -2899,6 +3411,29 @@ KS_API ks_range ks_range_new(ks_int start, ks_int stop, ks_int step);
 // NOTE: Returns new reference, or NULL if there was an error (and throw it)
 KS_API ks_obj ks_num_parse(const char* str, int len, int base);
 
+// Maximum number of bytes written by `ks_num_fmt_double()` or `ks_num_fmt_int64()`
+#define KS_NUM_FMT_MAX 32
+
+// Scan a decimal float (i.e. '-1.5', '2e10', '.5', 'inf', 'nan') from the start of the 'len' bytes of 'str', into
+//   '*out', which is correctly rounded. Unlike `strtod()`, 'str' doesn't need to be NUL-terminated, and leading
+//   whitespace is not skipped
+// NOTE: Returns the number of bytes used, or 0 if 'str' did not start with a float (this does not throw an error)
+KS_API ks_ssize_t ks_num_scan_double(const char* str, ks_ssize_t len, double* out);
+
+// Scan a base 10 integer from the start of the 'len' bytes of 'str', into '*out'
+// NOTE: Returns the number of bytes used, or 0 if 'str' did not start with an integer, or it did not fit in an
+//   'int64_t' (this does not throw an error)
+KS_API ks_ssize_t ks_num_scan_int64(const char* str, ks_ssize_t len, int64_t* out);
+
+// Write the shortest text that reads back as exactly 'val' to 'buf' (which must have room for 'KS_NUM_FMT_MAX' bytes),
+//   i.e. '0.1', '3.0', '1e+20', '-inf', 'nan'
+// NOTE: Returns the number of bytes written (a NUL-terminator is not added)
+KS_API int ks_num_fmt_double(char* buf, double val);
+
+// Write 'val' in base 10 to 'buf' (which must have room for 'KS_NUM_FMT_MAX' bytes)
+// NOTE: Returns the number of bytes written (a NUL-terminator is not added)
+KS_API int ks_num_fmt_int64(char* buf, int64_t val);
+
 // Attempt to hash 'self'
 // Supported types:
 //   + bool
@@ -3073,6 +3608,10 @@ KS_API ks_obj ks_num_binxor(ks_obj L, ks_obj R);
  */
 KS_API ks_obj ks__exec(ks_thread self, ks_code code);
 
+// resume execution of the generator 'gen' on a thread, whose frame must already be on top of the thread's frames
+// NOTE: Returns the yielded value, or NULL and throws an error (an 'OutOfIterError' if the generator returned)
+KS_API ks_obj ks__exec_gen(ks_thread self, ks_gen gen);
+
 
 
 
@@ -3107,9 +3646,7 @@ extern ks_cfunc
     ks_F_all,
 
     ks_F_sort,
-    ks_F_map,
     ks_F_sum,
-    ks_F_filter,
 
     ks_F_chr,
     ks_F_ord,
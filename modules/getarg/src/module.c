@@ -372,7 +372,7 @@ static KS_TFUNC(Parser, parse) {
         int j;
 
         // C-style user argument
-        char* cu_argc = user_arg->chr;
+        const char* cu_argc = ks_str_cstr(user_arg);
         int cu_argl = user_arg->len_b;
 
         if (cu_argl == 2 && strncmp(cu_argc, "--", 2) == 0) {
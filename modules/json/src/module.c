@@ -0,0 +1,814 @@
+/* json/src/module.c - the 'json' module, for reading and writing JSON (https://www.json.org)
+ *
+ * Parsing builds kscript objects (dict, list, str, int, float, bool, none) directly from the text, without an
+ *   intermediate tree. Values of containers are collected on a single stack, so each list or dict is created
+ *   once, at its final size. Strings are scanned a block at a time (see 'Vectorized Helpers') for the few bytes
+ *   that can end a run of plain characters, and object keys are shared through a small cache, since the same keys
+ *   tend to repeat in every object
+ *
+ * Generating writes into a `ks_str_builder`, which `dump()` hands off to an 'ios' in chunks
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+// always begin by defining the module information
+#define MODULE_NAME "json"
+
+// include this since this is a module.
+#include "ks-module.h"
+
+#include <math.h>
+#include <errno.h>
+
+
+/* Tuning/Performance parameters */
+
+// maximum nesting of arrays/objects (which also catches cycles when generating)
+#define JSON_MAX_DEPTH 1024
+
+// number of slots in the key cache (must be a power of 2)
+#define JSON_KEY_CACHE 1024
+
+// longest key that is put in the key cache
+#define JSON_KEY_CACHE_MAX 64
+
+// number of bytes 'dump()' collects before writing them out
+#define JSON_DUMP_CHUNK (64 * 1024)
+
+
+/* Vectorized Helpers */
+
+// These check a block of 'JSON_VEC' bytes at a time, and return a mask of the bytes which are special inside of a
+//   string ('"', '\\', or a control character below 0x20). Bit 'i' (or byte 'i', for SWAR) corresponds to
+//   byte 'i', so `__builtin_ctz()` gives the first one
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+#define JSON_VEC 32
+#define JSON_VEC_SHIFT 0
+
+static inline uint64_t json_vec_special(const uint8_t* src) {
+    __m256i x = _mm256_loadu_si256((const __m256i*)src);
+    __m256i r = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\')));
+    // x <= 0x1F (unsigned)
+    r = _mm256_or_si256(r, _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(0x1F)), x));
+    return (uint32_t)_mm256_movemask_epi8(r);
+}
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+#define JSON_VEC 16
+#define JSON_VEC_SHIFT 0
+
+static inline uint64_t json_vec_special(const uint8_t* src) {
+    __m128i x = _mm_loadu_si128((const __m128i*)src);
+    __m128i r = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('"')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\\')));
+    // x <= 0x1F (unsigned)
+    r = _mm_or_si128(r, _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(0x1F)), x));
+    return (uint32_t)_mm_movemask_epi8(r);
+}
+
+#else
+
+#define JSON_VEC 8
+// bits are the high bit of each byte, so divide the bit index by 8
+#define JSON_VEC_SHIFT 3
+
+// high bit set for bytes which are zero in 'x' (only exact up to the first zero byte, which is all that is needed)
+#define JSON_SWAR_ZERO(x) (((x) - 0x0101010101010101ULL) & ~(x) & 0x8080808080808080ULL)
+
+static inline uint64_t json_vec_special(const uint8_t* src) {
+    uint64_t x;
+    memcpy(&x, src, sizeof(x));
+    // NOTE: bytes below 0x20 are those where subtracting 0x20 borrows, and that had the high bit clear
+    return JSON_SWAR_ZERO(x ^ 0x2222222222222222ULL) | JSON_SWAR_ZERO(x ^ 0x5C5C5C5C5C5C5C5CULL)
+         | ((x - 0x2020202020202020ULL) & ~x & 0x8080808080808080ULL);
+}
+
+#endif
+
+// whether a single byte is special inside of a string
+#define JSON_SPECIAL(c) ((c) == '"' || (c) == '\\' || (c) < 0x20)
+
+// return the first special byte in [cur, end), or 'end' if there is none
+static inline const uint8_t* json_scan(const uint8_t* cur, const uint8_t* end) {
+    while (end - cur >= JSON_VEC) {
+        uint64_t m = json_vec_special(cur);
+        if (m) return cur + (__builtin_ctzll(m) >> JSON_VEC_SHIFT);
+        cur += JSON_VEC;
+    }
+
+    while (cur < end && !JSON_SPECIAL(*cur)) cur++;
+    return cur;
+}
+
+
+/* Parsing */
+
+typedef struct {
+
+    // the entire text, the current position, and the end
+    const uint8_t *src, *cur, *end;
+
+    // how many arrays/objects deep the parser currently is
+    int depth;
+
+    // the values of the arrays/objects currently being parsed (objects push a key, then a value), each of which
+    //   is a reference
+    ks_obj* stk;
+    ks_size_t stk_len, stk_max;
+
+    // scratch space for strings that contain escape sequences
+    uint8_t* tmp;
+    ks_size_t tmp_max;
+
+    // recently used keys, indexed by their hash
+    ks_str keys[JSON_KEY_CACHE];
+
+} json_parser;
+
+// throw an error about the current position of 'p'
+static void* json_error(json_parser* p, const char* what) {
+    int line = 1, col = 1;
+    const uint8_t* it;
+    for (it = p->src; it < p->cur; ++it) {
+        if (*it == '\n') {
+            line++;
+            col = 1;
+        } else if ((*it & 0xC0) != 0x80) {
+            col++;
+        }
+    }
+
+    return ks_throw(ks_T_SyntaxError, "Invalid JSON: %s (at line %i, col %i)", what, line, col);
+}
+
+// skip whitespace
+static inline void json_skip(json_parser* p) {
+    while (p->cur < p->end && (*p->cur == ' ' || *p->cur == '\n' || *p->cur == '\r' || *p->cur == '\t')) p->cur++;
+}
+
+// make sure the scratch space has room for 'n' bytes
+static inline void json_tmp_reserve(json_parser* p, ks_size_t n) {
+    if (n > p->tmp_max) {
+        p->tmp_max = n + n / 2 + 64;
+        p->tmp = ks_realloc(p->tmp, p->tmp_max);
+    }
+}
+
+// push a value (which is a reference) onto the stack
+static inline void json_push(json_parser* p, ks_obj obj) {
+    if (p->stk_len >= p->stk_max) {
+        p->stk_max = p->stk_max * 2 + 16;
+        p->stk = ks_realloc(p->stk, sizeof(*p->stk) * p->stk_max);
+    }
+    p->stk[p->stk_len++] = obj;
+}
+
+// pop (and release) the values down to 'base'
+static inline void json_popto(json_parser* p, ks_size_t base) {
+    while (p->stk_len > base) {
+        p->stk_len--;
+        KS_DECREF(p->stk[p->stk_len]);
+    }
+}
+
+// read 4 hex digits
+static bool json_hex4(json_parser* p, uint32_t* out) {
+    if (p->end - p->cur < 4) return false;
+
+    uint32_t r = 0;
+    int i;
+    for (i = 0; i < 4; ++i) {
+        uint8_t c = p->cur[i];
+        r <<= 4;
+        if (c >= '0' && c <= '9') r |= c - '0';
+        else if (c >= 'a' && c <= 'f') r |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') r |= c - 'A' + 10;
+        else return false;
+    }
+
+    p->cur += 4;
+    *out = r;
+    return true;
+}
+
+// create the 'str' for the bytes of a string, sharing it with previous keys if 'isKey'
+static ks_str json_make_str(json_parser* p, const uint8_t* data, ks_size_t len_b, bool isKey) {
+    if (!isKey || len_b > JSON_KEY_CACHE_MAX) return ks_str_utf8((const char*)data, len_b);
+
+    ks_str* slot = &p->keys[ks_hash_bytes(data, len_b) & (JSON_KEY_CACHE - 1)];
+    if (*slot && (*slot)->len_b == len_b && memcmp((*slot)->chr, data, len_b) == 0) {
+        return (ks_str)KS_NEWREF(*slot);
+    }
+
+    ks_str res = ks_str_utf8((const char*)data, len_b);
+    if (*slot) KS_DECREF(*slot);
+    *slot = (ks_str)KS_NEWREF(res);
+    return res;
+}
+
+// parse a string, starting at the opening quote
+static ks_str json_parse_str(json_parser* p, bool isKey) {
+    const uint8_t* start = ++p->cur;
+    p->cur = json_scan(p->cur, p->end);
+
+    // most strings have no escapes, so they are made directly from the text
+    if (p->cur < p->end && *p->cur == '"') {
+        ks_str res = json_make_str(p, start, p->cur - start, isKey);
+        p->cur++;
+        return res;
+    }
+
+    // otherwise, build it in the scratch space
+    ks_size_t len = 0;
+    while (true) {
+        if (p->cur >= p->end) return json_error(p, "unterminated string");
+
+        ks_size_t run = p->cur - start;
+        json_tmp_reserve(p, len + run + 4);
+        memcpy(p->tmp + len, start, run);
+        len += run;
+
+        uint8_t c = *p->cur;
+        if (c == '"') break;
+        else if (c != '\\') return json_error(p, "control character in string");
+
+        // escape sequence
+        if (++p->cur >= p->end) return json_error(p, "unterminated string");
+        c = *p->cur++;
+
+        switch (c) {
+            case '"': case '\\': case '/':
+                p->tmp[len++] = c;
+                break;
+            case 'b': p->tmp[len++] = '\b'; break;
+            case 'f': p->tmp[len++] = '\f'; break;
+            case 'n': p->tmp[len++] = '\n'; break;
+            case 'r': p->tmp[len++] = '\r'; break;
+            case 't': p->tmp[len++] = '\t'; break;
+            case 'u': {
+                uint32_t cp;
+                if (!json_hex4(p, &cp)) return json_error(p, "invalid '\\u' escape");
+
+                if (cp >= 0xD800 && cp < 0xDC00) {
+                    // high surrogate, which should be followed by a low one
+                    uint32_t lo;
+                    if (p->end - p->cur >= 6 && p->cur[0] == '\\' && p->cur[1] == 'u') {
+                        p->cur += 2;
+                        if (!json_hex4(p, &lo)) return json_error(p, "invalid '\\u' escape");
+                        if (lo >= 0xDC00 && lo < 0xE000) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        } else {
+                            // not a pair, so put the second one back
+                            p->cur -= 6;
+                            cp = 0xFFFD;
+                        }
+                    } else {
+                        cp = 0xFFFD;
+                    }
+                } else if (cp >= 0xDC00 && cp < 0xE000) {
+                    // unpaired low surrogate
+                    cp = 0xFFFD;
+                }
+
+                // encode as UTF-8
+                if (cp < 0x80) {
+                    p->tmp[len++] = cp;
+                } else if (cp < 0x800) {
+                    p->tmp[len++] = 0xC0 | (cp >> 6);
+                    p->tmp[len++] = 0x80 | (cp & 0x3F);
+                } else if (cp < 0x10000) {
+                    p->tmp[len++] = 0xE0 | (cp >> 12);
+                    p->tmp[len++] = 0x80 | ((cp >> 6) & 0x3F);
+                    p->tmp[len++] = 0x80 | (cp & 0x3F);
+                } else {
+                    p->tmp[len++] = 0xF0 | (cp >> 18);
+                    p->tmp[len++] = 0x80 | ((cp >> 12) & 0x3F);
+                    p->tmp[len++] = 0x80 | ((cp >> 6) & 0x3F);
+                    p->tmp[len++] = 0x80 | (cp & 0x3F);
+                }
+                break;
+            }
+            default:
+                p->cur--;
+                return json_error(p, "invalid escape sequence");
+        }
+
+        start = p->cur;
+        p->cur = json_scan(p->cur, p->end);
+    }
+
+    p->cur++;
+    return json_make_str(p, p->tmp, len, isKey);
+}
+
+// parse a number
+static ks_obj json_parse_num(json_parser* p) {
+    const uint8_t* start = p->cur;
+    bool neg = false, isFloat = false;
+
+    if (*p->cur == '-') {
+        neg = true;
+        p->cur++;
+    }
+
+    // integer part (which can only start with '0' if it is exactly '0')
+    const uint8_t* digs = p->cur;
+    int64_t v = 0;
+    if (p->cur < p->end && *p->cur == '0') {
+        p->cur++;
+    } else if (p->cur < p->end && *p->cur >= '1' && *p->cur <= '9') {
+        while (p->cur < p->end && *p->cur >= '0' && *p->cur <= '9') {
+            // only used if there are few enough digits to not overflow
+            v = 10 * v + (*p->cur - '0');
+            p->cur++;
+        }
+    } else {
+        return json_error(p, "invalid number");
+    }
+    ks_size_t n_digs = p->cur - digs;
+
+    if (p->cur < p->end && *p->cur == '.') {
+        isFloat = true;
+        p->cur++;
+        if (p->cur >= p->end || *p->cur < '0' || *p->cur > '9') return json_error(p, "invalid number");
+        while (p->cur < p->end && *p->cur >= '0' && *p->cur <= '9') p->cur++;
+    }
+
+    if (p->cur < p->end && (*p->cur == 'e' || *p->cur == 'E')) {
+        isFloat = true;
+        p->cur++;
+        if (p->cur < p->end && (*p->cur == '+' || *p->cur == '-')) p->cur++;
+        if (p->cur >= p->end || *p->cur < '0' || *p->cur > '9') return json_error(p, "invalid number");
+        while (p->cur < p->end && *p->cur >= '0' && *p->cur <= '9') p->cur++;
+    }
+
+    if (!isFloat && n_digs <= 18) return (ks_obj)ks_int_new(neg ? -v : v);
+
+    if (isFloat) {
+        // it has already been validated, so this reads the same bytes
+        double val;
+        ks_num_scan_double((const char*)start, p->cur - start, &val);
+        return (ks_obj)ks_float_new(val);
+    }
+
+    return ks_num_parse((const char*)start, p->cur - start, KS_BASE_10);
+}
+
+// parse a literal 'word', which is 'val'
+static ks_obj json_parse_lit(json_parser* p, const char* word, int len, ks_obj val) {
+    if (p->end - p->cur < len || memcmp(p->cur, word, len) != 0) return json_error(p, "unexpected character");
+    p->cur += len;
+    return KS_NEWREF(val);
+}
+
+static ks_obj json_parse_val(json_parser* p);
+
+// parse an array, starting at the '['
+static ks_obj json_parse_arr(json_parser* p) {
+    if (++p->depth > JSON_MAX_DEPTH) return json_error(p, "nested too deeply");
+    p->cur++;
+
+    ks_size_t base = p->stk_len;
+
+    json_skip(p);
+    if (p->cur < p->end && *p->cur == ']') {
+        p->cur++;
+    } else while (true) {
+        ks_obj val = json_parse_val(p);
+        if (!val) {
+            json_popto(p, base);
+            return NULL;
+        }
+        json_push(p, val);
+
+        json_skip(p);
+        if (p->cur < p->end && *p->cur == ',') {
+            p->cur++;
+        } else if (p->cur < p->end && *p->cur == ']') {
+            p->cur++;
+            break;
+        } else {
+            json_popto(p, base);
+            return json_error(p, p->cur < p->end ? "expected ',' or ']'" : "unexpected end of input");
+        }
+    }
+
+    ks_list res = ks_list_new(p->stk_len - base, p->stk + base);
+    json_popto(p, base);
+    p->depth--;
+    return (ks_obj)res;
+}
+
+// parse an object, starting at the '{'
+static ks_obj json_parse_obj(json_parser* p) {
+    if (++p->depth > JSON_MAX_DEPTH) return json_error(p, "nested too deeply");
+    p->cur++;
+
+    ks_size_t base = p->stk_len;
+
+    json_skip(p);
+    if (p->cur < p->end && *p->cur == '}') {
+        p->cur++;
+    } else while (true) {
+        json_skip(p);
+        if (p->cur >= p->end || *p->cur != '"') {
+            json_popto(p, base);
+            return json_error(p, "expected a string key");
+        }
+
+        ks_str key = json_parse_str(p, true);
+        if (!key) {
+            json_popto(p, base);
+            return NULL;
+        }
+        json_push(p, (ks_obj)key);
+
+        json_skip(p);
+        if (p->cur >= p->end || *p->cur != ':') {
+            json_popto(p, base);
+            return json_error(p, "expected ':'");
+        }
+        p->cur++;
+
+        ks_obj val = json_parse_val(p);
+        if (!val) {
+            json_popto(p, base);
+            return NULL;
+        }
+        json_push(p, val);
+
+        json_skip(p);
+        if (p->cur < p->end && *p->cur == ',') {
+            p->cur++;
+        } else if (p->cur < p->end && *p->cur == '}') {
+            p->cur++;
+            break;
+        } else {
+            json_popto(p, base);
+            return json_error(p, p->cur < p->end ? "expected ',' or '}'" : "unexpected end of input");
+        }
+    }
+
+    // all the pairs are known, so the dict is created at its final size
+    ks_dict res = ks_dict_new(p->stk_len - base, p->stk + base);
+    json_popto(p, base);
+    p->depth--;
+    return (ks_obj)res;
+}
+
+// parse any value
+static ks_obj json_parse_val(json_parser* p) {
+    json_skip(p);
+    if (p->cur >= p->end) return json_error(p, "unexpected end of input");
+
+    switch (*p->cur) {
+        case '{': return json_parse_obj(p);
+        case '[': return json_parse_arr(p);
+        case '"': return (ks_obj)json_parse_str(p, false);
+        case 't': return json_parse_lit(p, "true", 4, KSO_TRUE);
+        case 'f': return json_parse_lit(p, "false", 5, KSO_FALSE);
+        case 'n': return json_parse_lit(p, "null", 4, KSO_NONE);
+        case '-': case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+            return json_parse_num(p);
+        default:
+            return json_error(p, "unexpected character");
+    }
+}
+
+// parse 'len_b' bytes of (valid UTF-8) JSON text
+static ks_obj json_parse(const uint8_t* src, ks_size_t len_b) {
+    json_parser p;
+    p.src = p.cur = src;
+    p.end = src + len_b;
+    p.depth = 0;
+    p.stk = NULL;
+    p.stk_len = p.stk_max = 0;
+    p.tmp = NULL;
+    p.tmp_max = 0;
+    memset(p.keys, 0, sizeof(p.keys));
+
+    ks_obj res = json_parse_val(&p);
+    if (res) {
+        json_skip(&p);
+        if (p.cur != p.end) {
+            KS_DECREF(res);
+            res = json_error(&p, "extra data after the value");
+        }
+    }
+
+    int i;
+    for (i = 0; i < JSON_KEY_CACHE; ++i) {
+        if (p.keys[i]) KS_DECREF(p.keys[i]);
+    }
+    ks_free(p.stk);
+    ks_free(p.tmp);
+
+    return res;
+}
+
+// parse any object containing text (a 'str', or anything with a buffer of UTF-8, such as 'bytes' or 'mmap')
+static ks_obj json_parse_obj_text(ks_obj obj) {
+    if (obj->type == ks_T_str) {
+        return json_parse((const uint8_t*)((ks_str)obj)->chr, ((ks_str)obj)->len_b);
+    }
+
+    ks_buffer buf;
+    if (!ks_buffer_get(obj, &buf, KS_BUFFER_CONTIG)) return NULL;
+
+    ks_obj res;
+    if (ks_text_utf8_validate((const char*)buf.data, buf.len_b) < 0) {
+        res = ks_throw(ks_T_ArgError, "JSON text was not valid UTF-8");
+    } else {
+        res = json_parse((const uint8_t*)buf.data, buf.len_b);
+    }
+
+    ks_buffer_release(&buf);
+    return res;
+}
+
+
+/* Generating */
+
+typedef struct {
+
+    // what is being written to
+    ks_str_builder sb;
+
+    // if non-NULL, full chunks of 'sb' are written to this
+    ks_ios ios;
+
+    // number of spaces to indent by (or -1 to put everything on one line)
+    int indent;
+
+    // how many arrays/objects deep the writer currently is
+    int depth;
+
+} json_writer;
+
+#define JSON_ADD(_w, _lit) ks_str_builder_add((_w)->sb, _lit, sizeof(_lit) - 1)
+
+// start a new line (if indenting)
+static bool json_newline(json_writer* w) {
+    if (w->indent < 0) return true;
+    if (!JSON_ADD(w, "\n")) return false;
+
+    int i;
+    for (i = 0; i < w->indent * w->depth; ++i) {
+        if (!JSON_ADD(w, " ")) return false;
+    }
+    return true;
+}
+
+// write out what has been built so far, if there is enough
+static bool json_spill(json_writer* w) {
+    if (!w->ios || w->sb->len < JSON_DUMP_CHUNK) return true;
+
+    bool res = ks_ios_writeb(w->ios, w->sb->len, w->sb->buf->_chr);
+    w->sb->len = 0;
+    return res;
+}
+
+// write a string (with quotes and escapes)
+static bool json_write_str(json_writer* w, const uint8_t* src, ks_size_t len_b) {
+    static const char hexdigs[] = "0123456789abcdef";
+
+    const uint8_t* end = src + len_b;
+    if (!JSON_ADD(w, "\"")) return false;
+
+    while (src < end) {
+        const uint8_t* sp = json_scan(src, end);
+        if (sp > src && !ks_str_builder_add(w->sb, (void*)src, sp - src)) return false;
+        if (sp >= end) break;
+
+        char esc[6] = { '\\', 0, 0, 0, 0, 0 };
+        int esc_len = 2;
+        switch (*sp) {
+            case '"': esc[1] = '"'; break;
+            case '\\': esc[1] = '\\'; break;
+            case '\n': esc[1] = 'n'; break;
+            case '\r': esc[1] = 'r'; break;
+            case '\t': esc[1] = 't'; break;
+            case '\b': esc[1] = 'b'; break;
+            case '\f': esc[1] = 'f'; break;
+            default:
+                esc[1] = 'u';
+                esc[2] = '0';
+                esc[3] = '0';
+                esc[4] = hexdigs[*sp >> 4];
+                esc[5] = hexdigs[*sp & 0xF];
+                esc_len = 6;
+                break;
+        }
+
+        if (!ks_str_builder_add(w->sb, esc, esc_len)) return false;
+        src = sp + 1;
+    }
+
+    return JSON_ADD(w, "\"");
+}
+
+// write a float, using the fewest digits that read back as the same value
+static bool json_write_float(json_writer* w, double val) {
+    if (!isfinite(val)) {
+        ks_throw(ks_T_ArgError, "Cannot convert non-finite float (%s) to JSON", isnan(val) ? "nan" : "inf");
+        return false;
+    }
+
+    // always has a '.' or an exponent, so it reads back as a float
+    char tmp[KS_NUM_FMT_MAX];
+    return ks_str_builder_add(w->sb, tmp, ks_num_fmt_double(tmp, val));
+}
+
+// write any object
+static bool json_write(json_writer* w, ks_obj obj) {
+    if (obj == KSO_NONE) {
+        return JSON_ADD(w, "null");
+    } else if (obj == KSO_TRUE) {
+        return JSON_ADD(w, "true");
+    } else if (obj == KSO_FALSE) {
+        return JSON_ADD(w, "false");
+    } else if (obj->type == ks_T_str) {
+        return json_write_str(w, (const uint8_t*)((ks_str)obj)->chr, ((ks_str)obj)->len_b);
+    } else if (obj->type == ks_T_int) {
+        if (!((ks_int)obj)->isLong) {
+            char tmp[KS_NUM_FMT_MAX];
+            return ks_str_builder_add(w->sb, tmp, ks_num_fmt_int64(tmp, ((ks_int)obj)->v64));
+        }
+        return ks_str_builder_add_str(w->sb, obj);
+    } else if (obj->type == ks_T_float) {
+        return json_write_float(w, ((ks_float)obj)->val);
+    } else if (obj->type == ks_T_list || obj->type == ks_T_tuple || obj->type == ks_T_dict) {
+        if (++w->depth > JSON_MAX_DEPTH) {
+            ks_throw(ks_T_ArgError, "Cannot convert to JSON: nested too deeply (or contains a cycle)");
+            return false;
+        }
+
+        bool isDict = obj->type == ks_T_dict;
+        if (!(isDict ? JSON_ADD(w, "{") : JSON_ADD(w, "["))) return false;
+
+        ks_size_t i, ct = 0;
+        if (isDict) {
+            ks_dict dict = (ks_dict)obj;
+            for (i = 0; i < dict->n_entries; ++i) {
+                struct ks_dict_entry* ent = &dict->entries[i];
+                if (!ent->key) continue;
+
+                if (ent->key->type != ks_T_str) {
+                    ks_throw(ks_T_TypeError, "Cannot convert to JSON: object keys must be 'str', not '%T'", ent->key);
+                    return false;
+                }
+
+                if (ct++ > 0 && !(w->indent < 0 ? JSON_ADD(w, ", ") : JSON_ADD(w, ","))) return false;
+                if (!json_newline(w)) return false;
+                if (!json_write_str(w, (const uint8_t*)((ks_str)ent->key)->chr, ((ks_str)ent->key)->len_b)) return false;
+                if (!JSON_ADD(w, ": ")) return false;
+                if (!json_write(w, ent->val)) return false;
+                if (!json_spill(w)) return false;
+            }
+        } else {
+            ks_size_t len = obj->type == ks_T_list ? ((ks_list)obj)->len : ((ks_tuple)obj)->len;
+            for (i = 0; i < len; ++i) {
+                if (ct++ > 0 && !(w->indent < 0 ? JSON_ADD(w, ", ") : JSON_ADD(w, ","))) return false;
+                if (!json_newline(w)) return false;
+
+                // (the elements of unboxed lists are only made into objects one at a time)
+                ks_obj ob = obj->type == ks_T_list ? ks_list_get((ks_list)obj, i) : KS_NEWREF(((ks_tuple)obj)->elems[i]);
+                bool ok = json_write(w, ob);
+                KS_DECREF(ob);
+                if (!ok || !json_spill(w)) return false;
+            }
+        }
+
+        w->depth--;
+        if (ct > 0 && !json_newline(w)) return false;
+        return isDict ? JSON_ADD(w, "}") : JSON_ADD(w, "]");
+    } else {
+        ks_throw(ks_T_TypeError, "Cannot convert '%T' object to JSON", obj);
+        return false;
+    }
+}
+
+// get the 'indent' argument
+static bool json_get_indent(ks_obj indent, int* out) {
+    if (indent == KSO_NONE) {
+        *out = -1;
+        return true;
+    }
+
+    int64_t v64;
+    if (!ks_num_get_int64(indent, &v64)) return false;
+    if (v64 < 0 || v64 > 64) {
+        ks_throw(ks_T_ArgError, "'indent' must be between 0 and 64 (or none)");
+        return false;
+    }
+
+    *out = v64;
+    return true;
+}
+
+
+/* Module Functions */
+
+// json.loads(text) - parse JSON text (a 'str', or an object with a buffer of UTF-8 text, such as 'bytes' or 'mmap')
+static KS_TFUNC(json, loads) {
+    ks_obj text;
+    KS_GETARGS("text", &text)
+
+    return json_parse_obj_text(text);
+}
+
+// json.load(ios) - read the rest of 'ios' and parse it as JSON
+static KS_TFUNC(json, load) {
+    ks_ios ios;
+    KS_GETARGS("ios:*", &ios, ks_T_ios)
+
+    // read it in blocks, as raw bytes
+    uint8_t* data = NULL;
+    ks_ssize_t len_b = 0, max_len_b = 0;
+    while (true) {
+        if (max_len_b - len_b < JSON_DUMP_CHUNK) {
+            max_len_b = 2 * max_len_b + JSON_DUMP_CHUNK;
+            data = ks_realloc(data, max_len_b);
+        }
+
+        ks_ssize_t n = ks_ios_readb(ios, max_len_b - len_b, data + len_b);
+        if (n < 0) {
+            ks_free(data);
+            return NULL;
+        }
+
+        len_b += n;
+        if (len_b < max_len_b) break;
+    }
+
+    ks_obj res;
+    if (ks_text_utf8_validate((const char*)data, len_b) < 0) {
+        res = ks_throw(ks_T_ArgError, "JSON text read from %R was not valid UTF-8", ios->name);
+    } else {
+        res = json_parse(data, len_b);
+    }
+
+    ks_free(data);
+    return res;
+}
+
+// json.dumps(obj, indent=none) - convert 'obj' to JSON text
+static KS_TFUNC(json, dumps) {
+    ks_obj obj, indent = KSO_NONE;
+    KS_GETARGS("obj ?indent", &obj, &indent)
+
+    json_writer w = { .sb = NULL, .ios = NULL, .depth = 0 };
+    if (!json_get_indent(indent, &w.indent)) return NULL;
+
+    w.sb = ks_str_builder_new();
+    if (!json_write(&w, obj)) {
+        KS_DECREF(w.sb);
+        return NULL;
+    }
+
+    ks_str res = ks_str_builder_get(w.sb);
+    KS_DECREF(w.sb);
+    return (ks_obj)res;
+}
+
+// json.dump(obj, ios, indent=none) - write 'obj' as JSON text to 'ios'
+static KS_TFUNC(json, dump) {
+    ks_obj obj, indent = KSO_NONE;
+    ks_ios ios;
+    KS_GETARGS("obj ios:* ?indent", &obj, &ios, ks_T_ios, &indent)
+
+    json_writer w = { .sb = NULL, .ios = ios, .depth = 0 };
+    if (!json_get_indent(indent, &w.indent)) return NULL;
+
+    w.sb = ks_str_builder_new();
+    bool res = json_write(&w, obj) && ks_ios_writeb(ios, w.sb->len, w.sb->len > 0 ? w.sb->buf->_chr : "");
+    KS_DECREF(w.sb);
+
+    if (!res) return NULL;
+
+    return KSO_NONE;
+}
+
+
+// now, export them all
+static ks_module get_module() {
+
+    ks_module mod = ks_module_new(MODULE_NAME, "JSON parsing and generation");
+
+    ks_dict_set_c(mod->attr, KS_KEYVALS(
+        /* functions */
+        {"loads",           (ks_obj)ks_cfunc_new_c_old(json_loads_, "json.loads(text)")},
+        {"load",            (ks_obj)ks_cfunc_new_c_old(json_load_, "json.load(ios)")},
+        {"dumps",           (ks_obj)ks_cfunc_new_c_old(json_dumps_, "json.dumps(obj, indent=none)")},
+        {"dump",            (ks_obj)ks_cfunc_new_c_old(json_dump_, "json.dump(obj, ios, indent=none)")},
+    ));
+
+    return mod;
+}
+
+// boiler plate code
+MODULE_INIT(get_module)
@@ -235,6 +235,12 @@ KS_API libc_function libc_make_function(ks_type func_type, void (*val)());
 // Or, a negative value indicates error
 KS_API ks_ssize_t libc_get_size(ks_type of);
 
+// Fill in 'buf' (see `ks_buffer`) to describe 'n' elements starting at the address of 'self', so that C code
+//   can pass the memory to anything that consumes buffers. Since pointers don't know how many elements they point
+//   to, this is not the type's `getbuf` (which would have to guess)
+// NOTE: Returns success, or false and throws an error. Release it with `ks_buffer_release()`
+KS_API bool libc_pointer_getbuf(libc_pointer self, ks_ssize_t n, ks_buffer* buf);
+
 KS_API void libc_init_types();
 
 
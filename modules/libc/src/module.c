@@ -91,7 +91,7 @@ static KS_TFUNC(libc, dlopen) {
     KS_GETARGS("fname:* ?flags:i64", &fname, ks_T_str, &flags);
 
     // TODO: add flags
-    void* res = dlopen(fname->chr, flags);
+    void* res = dlopen(ks_str_cstr(fname), flags);
     my_errno = errno;
 
     return (ks_obj)libc_make_pointer(libc_T_void_p, res);
@@ -127,7 +127,7 @@ static KS_TFUNC(libc, dlsym) {
     KS_GETARGS("handle:* symbol:*", &handle, libc_T_pointer, &symbol, ks_T_str);
 
     // TODO: add flags
-    void* res = dlsym(handle->val, symbol->chr);
+    void* res = dlsym(handle->val, ks_str_cstr(symbol));
     my_errno = errno;
 
     return (ks_obj)libc_make_pointer(libc_T_void_p, res);
@@ -151,7 +151,7 @@ static KS_TFUNC(libc, size) {
 
 // now, export them all
 static ks_module get_module() {
-    ks_module mod = ks_module_new(MODULE_NAME);
+    ks_module mod = ks_module_new(MODULE_NAME, "Bindings for the C library");
 
     libc_init_types();
 
@@ -213,6 +213,43 @@ ks_ssize_t libc_get_size(ks_type of) {
     }
 }
 
+bool libc_pointer_getbuf(libc_pointer self, ks_ssize_t n, ks_buffer* buf) {
+    ks_type of = my_gettypeof(self->type);
+    if (!of) return false;
+
+    const char* fmt = NULL;
+    ks_ssize_t itemsize = 1;
+
+    /**/ if (of == libc_T_void || of == libc_T_uchar) fmt = "B";
+    else if (of == libc_T_char) fmt = "b";
+    else if (of == libc_T_short) fmt = "h", itemsize = sizeof(short);
+    else if (of == libc_T_ushort) fmt = "H", itemsize = sizeof(short);
+    else if (of == libc_T_int) fmt = "i", itemsize = sizeof(int);
+    else if (of == libc_T_uint) fmt = "I", itemsize = sizeof(int);
+    else if (of == libc_T_long && sizeof(long) == 8) fmt = "q", itemsize = 8;
+    else if (of == libc_T_ulong && sizeof(long) == 8) fmt = "Q", itemsize = 8;
+
+    if (!fmt) {
+        ks_throw(ks_T_TypeError, "Pointer type '%S' cannot be used as a buffer", self->type);
+        KS_DECREF(of);
+        return false;
+    }
+    KS_DECREF(of);
+
+    if (n < 0) {
+        ks_throw(ks_T_SizeError, "Buffer size must be non-negative (got %z)", n);
+        return false;
+    }
+
+    ks_buffer_init_bytes(buf, KS_NEWREF(self), self->val, n * itemsize, false);
+    buf->fmt = fmt;
+    buf->itemsize = itemsize;
+    buf->_shape1 = n;
+    buf->_stride1 = itemsize;
+
+    return true;
+}
+
 
 // Create a pointer type
 ks_type libc_make_pointer_type(ks_type of) {
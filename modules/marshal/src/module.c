@@ -0,0 +1,907 @@
+/* marshal/src/module.c - the 'marshal' module, for saving objects in a compact binary format
+ *
+ * The format is a header ('KSMA', the format version, and the byte order), followed by a single tagged value:
+ *
+ *   'N', 'T', 'F'         none, true, false
+ *   'i' <zigzag varint>   int (which fits in 64 bits)
+ *   'I' <sign> <varint n> <n bytes>
+ *                         int (of any size, as the magnitude in little endian bytes)
+ *   'd' <8 bytes>         float
+ *   'c' <16 bytes>        complex
+ *   's' <varint n> <n bytes>
+ *                         str (as UTF-8)
+ *   'b' <varint n> <n bytes>
+ *                         bytes
+ *   'l', 't', 'S' <varint n> <n values>
+ *                         list, tuple, set
+ *   'D' <varint n> <n keys and values>
+ *                         dict
+ *   'A' <varint n> <n bytes of format> <varint rank> <rank varints> <padding> <data>
+ *                         nx.array (or nx.view), whose data is padded to a multiple of 16 bytes from the start, and
+ *                         is written as one raw block
+ *   'R' <varint idx>      a reference to the 'idx'th object that was written (which is how shared objects and
+ *                         cycles are stored)
+ *
+ * Since array data is aligned and stored as-is, `marshal.load()` of a file maps it into memory (copy-on-write),
+ *   and the arrays in it are `nx.view`s of the mapping, so they are never copied (or even read) up front
+ *
+ * NOTE: This module is linked against 'nx' (see `build.ini`), and imports it when loaded to get the array types
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+// always begin by defining the module information
+#define MODULE_NAME "marshal"
+
+// include this since this is a module.
+#include "ks-module.h"
+
+// for the C-API of arrays
+#include "nx.h"
+
+
+/* Tuning/Performance parameters */
+
+// the version of the format that is written (and the newest that can be read)
+#define MARSHAL_VERSION 1
+
+// maximum nesting of containers
+#define MARSHAL_MAX_DEPTH 1024
+
+// alignment (in bytes) of array data, from the start of the data
+#define MARSHAL_ALIGN 16
+
+// number of bytes that are collected before being written to an 'ios' (and read from one at a time)
+#define MARSHAL_CHUNK (64 * 1024)
+
+
+// the 'nx' types, if that module could be imported
+static ks_type marshal_nx_array = NULL, marshal_nx_view = NULL;
+
+// byte order flag in the header (numbers and array data are stored in the native byte order)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define MARSHAL_ORDER 'B'
+#else
+#define MARSHAL_ORDER 'L'
+#endif
+
+
+/* Writing */
+
+// an entry in the table of objects already written
+typedef struct {
+
+    ks_obj obj;
+    ks_size_t idx;
+
+} marshal_memo_ent;
+
+typedef struct {
+
+    // bytes which have not been written out yet
+    uint8_t* buf;
+    ks_size_t len, max_len;
+
+    // if non-NULL, 'buf' is written to this once it is full
+    ks_ios ios;
+
+    // total bytes in the output so far (including those already written)
+    ks_size_t pos;
+
+    // objects already written, as a hash table (open addressing) from the object to its index
+    marshal_memo_ent* memo;
+    ks_size_t memo_len, memo_max;
+
+    int depth;
+
+} marshal_writer;
+
+// write out 'buf' to the 'ios'
+static bool mw_flush(marshal_writer* w) {
+    if (!w->ios || w->len == 0) return true;
+    bool res = ks_ios_writeb(w->ios, w->len, w->buf);
+    w->len = 0;
+    return res;
+}
+
+// make room for 'n' more bytes in 'buf'
+static inline bool mw_reserve(marshal_writer* w, ks_size_t n) {
+    if (w->len + n <= w->max_len) return true;
+
+    // when writing to an 'ios', write out what is there rather than growing
+    if (w->ios && w->len > 0) {
+        if (!mw_flush(w)) return false;
+        if (n <= w->max_len) return true;
+    }
+
+    w->max_len = w->len + n + (w->len + n) / 2 + 64;
+    w->buf = ks_realloc(w->buf, w->max_len);
+    return true;
+}
+
+// add raw bytes
+static bool mw_raw(marshal_writer* w, const void* data, ks_size_t n) {
+    if (w->ios && n >= MARSHAL_CHUNK) {
+        // big blocks go straight to the output
+        if (!mw_flush(w)) return false;
+        w->pos += n;
+        return ks_ios_writeb(w->ios, n, data);
+    }
+
+    if (!mw_reserve(w, n)) return false;
+    memcpy(w->buf + w->len, data, n);
+    w->len += n;
+    w->pos += n;
+    return true;
+}
+
+// add a single byte
+static inline bool mw_byte(marshal_writer* w, uint8_t c) {
+    if (!mw_reserve(w, 1)) return false;
+    w->buf[w->len++] = c;
+    w->pos++;
+    return true;
+}
+
+// add an unsigned varint (7 bits at a time, with the high bit set on all but the last byte)
+static inline bool mw_varint(marshal_writer* w, uint64_t v) {
+    if (!mw_reserve(w, 10)) return false;
+    while (v >= 0x80) {
+        w->buf[w->len++] = (v & 0x7F) | 0x80;
+        w->pos++;
+        v >>= 7;
+    }
+    w->buf[w->len++] = v;
+    w->pos++;
+    return true;
+}
+
+// add a tag followed by a length-prefixed block
+static bool mw_block(marshal_writer* w, uint8_t tag, const void* data, ks_size_t n) {
+    return mw_byte(w, tag) && mw_varint(w, n) && mw_raw(w, data, n);
+}
+
+// look up 'obj' in the memo, returning the slot it is (or would be) in
+static ks_size_t mw_memo_slot(marshal_writer* w, ks_obj obj) {
+    ks_size_t i = ((uintptr_t)obj >> 4) & (w->memo_max - 1);
+    while (w->memo[i].obj && w->memo[i].obj != obj) i = (i + 1) & (w->memo_max - 1);
+    return i;
+}
+
+// if 'obj' was already written, write a reference to it and return true; otherwise, give it the next index
+static bool mw_memo(marshal_writer* w, ks_obj obj, bool* wasRef) {
+    if (2 * (w->memo_len + 1) > w->memo_max) {
+        // grow (and rehash) the table
+        ks_size_t old_max = w->memo_max, i;
+        marshal_memo_ent* old = w->memo;
+        w->memo_max = old_max ? 2 * old_max : 256;
+        w->memo = ks_malloc(sizeof(*w->memo) * w->memo_max);
+        memset(w->memo, 0, sizeof(*w->memo) * w->memo_max);
+        for (i = 0; i < old_max; ++i) {
+            if (old[i].obj) w->memo[mw_memo_slot(w, old[i].obj)] = old[i];
+        }
+        ks_free(old);
+    }
+
+    ks_size_t i = mw_memo_slot(w, obj);
+    if (w->memo[i].obj) {
+        *wasRef = true;
+        return mw_byte(w, 'R') && mw_varint(w, w->memo[i].idx);
+    }
+
+    w->memo[i].obj = obj;
+    w->memo[i].idx = w->memo_len++;
+    *wasRef = false;
+    return true;
+}
+
+// write an array (from the buffer of an 'nx.array' or 'nx.view')
+static bool mw_array(marshal_writer* w, ks_obj obj) {
+    ks_buffer buf;
+    if (!ks_buffer_get(obj, &buf, KS_BUFFER_NONE)) return false;
+
+    bool res = mw_block(w, 'A', buf.fmt, strlen(buf.fmt)) && mw_varint(w, buf.ndim);
+    int i;
+    for (i = 0; res && i < buf.ndim; ++i) res = mw_varint(w, buf.shape[i]);
+
+    // pad so the data is aligned
+    while (res && w->pos % MARSHAL_ALIGN != 0) res = mw_byte(w, 0);
+
+    // check whether it is dense
+    bool isDense = true;
+    ks_ssize_t sz = buf.itemsize;
+    for (i = buf.ndim - 1; i >= 0; --i) {
+        if (buf.shape[i] > 1 && buf.strides[i] != sz) isDense = false;
+        sz *= buf.shape[i];
+    }
+
+    if (res && isDense) {
+        res = mw_raw(w, buf.data, buf.len_b);
+    } else if (res && buf.len_b > 0) {
+        // go through every element, in order
+        ks_ssize_t* idx = ks_malloc(sizeof(*idx) * buf.ndim);
+        for (i = 0; i < buf.ndim; ++i) idx[i] = 0;
+        ks_ssize_t n = buf.len_b / buf.itemsize, j;
+        for (j = 0; res && j < n; ++j) {
+            uint8_t* ptr = buf.data;
+            for (i = 0; i < buf.ndim; ++i) ptr += idx[i] * buf.strides[i];
+            res = mw_raw(w, ptr, buf.itemsize);
+
+            for (i = buf.ndim - 1; i >= 0 && ++idx[i] >= buf.shape[i]; --i) idx[i] = 0;
+        }
+        ks_free(idx);
+    }
+
+    ks_buffer_release(&buf);
+    return res;
+}
+
+// write any object
+static bool mw_obj(marshal_writer* w, ks_obj obj) {
+    if (obj == KSO_NONE) {
+        return mw_byte(w, 'N');
+    } else if (obj == KSO_TRUE) {
+        return mw_byte(w, 'T');
+    } else if (obj == KSO_FALSE) {
+        return mw_byte(w, 'F');
+    } else if (obj->type == ks_T_int) {
+        ks_int v = (ks_int)obj;
+        if (!v->isLong) return mw_byte(w, 'i') && mw_varint(w, ((uint64_t)v->v64 << 1) ^ (uint64_t)(v->v64 >> 63));
+
+        // magnitude, as little endian bytes
+        size_t n = (mpz_sizeinbase(v->vz, 2) + 7) / 8;
+        uint8_t* tmp = ks_malloc(n);
+        mpz_export(tmp, &n, -1, 1, 0, 0, v->vz);
+        bool res = mw_byte(w, 'I') && mw_byte(w, mpz_sgn(v->vz) < 0) && mw_varint(w, n) && mw_raw(w, tmp, n);
+        ks_free(tmp);
+        return res;
+    } else if (obj->type == ks_T_float) {
+        return mw_byte(w, 'd') && mw_raw(w, &((ks_float)obj)->val, sizeof(double));
+    } else if (obj->type == ks_T_complex) {
+        return mw_byte(w, 'c') && mw_raw(w, &((ks_complex)obj)->val, sizeof(double complex));
+    }
+
+    // everything else is memoized
+    bool wasRef;
+    if (!mw_memo(w, obj, &wasRef)) return false;
+    if (wasRef) return true;
+
+    if (obj->type == ks_T_str) {
+        return mw_block(w, 's', ((ks_str)obj)->chr, ((ks_str)obj)->len_b);
+    } else if (obj->type == ks_T_bytes) {
+        return mw_block(w, 'b', ((ks_bytes)obj)->byt, ((ks_bytes)obj)->len_b);
+    } else if (obj->type == marshal_nx_array || obj->type == marshal_nx_view) {
+        return mw_array(w, obj);
+    }
+
+    if (++w->depth > MARSHAL_MAX_DEPTH) {
+        ks_throw(ks_T_ArgError, "Cannot marshal object: nested too deeply");
+        return false;
+    }
+
+    ks_size_t i;
+    bool res = true;
+    if (obj->type == ks_T_list || obj->type == ks_T_tuple) {
+        ks_size_t len = obj->type == ks_T_list ? ((ks_list)obj)->len : ((ks_tuple)obj)->len;
+
+        res = mw_byte(w, obj->type == ks_T_list ? 'l' : 't') && mw_varint(w, len);
+        for (i = 0; res && i < len; ++i) {
+            // (the elements of unboxed lists are only made into objects one at a time)
+            ks_obj ob = obj->type == ks_T_list ? ks_list_get((ks_list)obj, i) : KS_NEWREF(((ks_tuple)obj)->elems[i]);
+            res = mw_obj(w, ob);
+            KS_DECREF(ob);
+        }
+    } else if (obj->type == ks_T_dict) {
+        ks_dict dict = (ks_dict)obj;
+        ks_size_t n = 0;
+        for (i = 0; i < dict->n_entries; ++i) if (dict->entries[i].key) n++;
+
+        res = mw_byte(w, 'D') && mw_varint(w, n);
+        for (i = 0; res && i < dict->n_entries; ++i) {
+            if (dict->entries[i].key) res = mw_obj(w, dict->entries[i].key) && mw_obj(w, dict->entries[i].val);
+        }
+    } else if (obj->type == ks_T_set) {
+        ks_set set = (ks_set)obj;
+        ks_size_t n = 0;
+        for (i = 0; i < set->n_entries; ++i) if (set->entries[i].key) n++;
+
+        res = mw_byte(w, 'S') && mw_varint(w, n);
+        for (i = 0; res && i < set->n_entries; ++i) {
+            if (set->entries[i].key) res = mw_obj(w, set->entries[i].key);
+        }
+    } else {
+        ks_throw(ks_T_TypeError, "Cannot marshal '%T' object", obj);
+        res = false;
+    }
+
+    w->depth--;
+    return res;
+}
+
+// write the header and 'obj'
+static bool mw_dump(marshal_writer* w, ks_obj obj) {
+    w->len = 0;
+    w->max_len = w->ios ? MARSHAL_CHUNK : 0;
+    w->buf = w->max_len > 0 ? ks_malloc(w->max_len) : NULL;
+    w->pos = 0;
+    w->memo = NULL;
+    w->memo_len = w->memo_max = 0;
+    w->depth = 0;
+
+    bool res = mw_raw(w, "KSMA", 4) && mw_varint(w, MARSHAL_VERSION) && mw_byte(w, MARSHAL_ORDER) && mw_obj(w, obj) && mw_flush(w);
+
+    ks_free(w->memo);
+    return res;
+}
+
+
+/* Reading */
+
+typedef struct {
+
+    // the bytes available to read next, and the offset of 'cur' from the start of the data
+    const uint8_t *cur, *end;
+    ks_size_t pos;
+
+    // if non-NULL, where more bytes are read from (into 'buf')
+    ks_ios ios;
+    uint8_t* buf;
+    ks_size_t buf_max;
+
+    // if non-NULL, the (writable) object which owns the memory, so arrays can be views of it
+    ks_obj owner;
+
+    // objects read so far (which 'R' refers to), and the marker held in the memo for a tuple or set which is still
+    //   being read
+    ks_list memo;
+    ks_obj unfinished;
+
+    int depth;
+
+} marshal_reader;
+
+// throw an error about invalid data
+static void* mr_error(marshal_reader* r, const char* what) {
+    return ks_throw(ks_T_ArgError, "Invalid marshal data: %s (at byte %z)", what, r->pos);
+}
+
+// make sure there are 'n' bytes available at 'cur'
+static bool mr_need(marshal_reader* r, ks_size_t n) {
+    if ((ks_size_t)(r->end - r->cur) >= n) return true;
+    if (!r->ios) {
+        mr_error(r, "unexpected end of data");
+        return false;
+    }
+
+    // move what is left to the start, and read more
+    ks_size_t left = r->end - r->cur;
+    if (left > 0) memmove(r->buf, r->cur, left);
+    r->cur = r->buf;
+    r->end = r->buf + left;
+
+    while (left < n) {
+        if (left == r->buf_max) {
+            // grow as the data actually arrives, rather than trusting 'n' (which may come from corrupt data)
+            ks_size_t new_max = r->buf_max > n - r->buf_max ? n : 2 * r->buf_max;
+            uint8_t* new_buf = ks_realloc(r->buf, new_max);
+            if (!new_buf) {
+                ks_throw(ks_T_OutOfMemError, "Failed to allocate %z bytes while reading marshal data", new_max);
+                return false;
+            }
+            r->buf = new_buf;
+            r->buf_max = new_max;
+            r->cur = r->buf;
+            r->end = r->buf + left;
+        }
+
+        ks_ssize_t got = ks_ios_readb(r->ios, r->buf_max - left, r->buf + left);
+        if (got < 0) return false;
+        if (got == 0) {
+            mr_error(r, "unexpected end of data");
+            return false;
+        }
+        left += got;
+        r->end = r->buf + left;
+    }
+
+    return true;
+}
+
+// skip 'n' bytes (which must be available)
+static inline void mr_skip(marshal_reader* r, ks_size_t n) {
+    r->cur += n;
+    r->pos += n;
+}
+
+// read an unsigned varint
+static bool mr_varint(marshal_reader* r, uint64_t* out) {
+    uint64_t v = 0;
+    int sh;
+    for (sh = 0; sh < 64; sh += 7) {
+        if (!mr_need(r, 1)) return false;
+        uint8_t c = *r->cur;
+        mr_skip(r, 1);
+        v |= (uint64_t)(c & 0x7F) << sh;
+        if (!(c & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+
+    mr_error(r, "varint is too long");
+    return false;
+}
+
+// read a length (which must be possible for the data to hold)
+static bool mr_len(marshal_reader* r, ks_size_t* out) {
+    uint64_t v;
+    if (!mr_varint(r, &v)) return false;
+    if (!r->ios && v > (uint64_t)(r->end - r->cur)) {
+        mr_error(r, "length is past the end of the data");
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+// copy 'n' bytes into 'dest', reading straight from the 'ios' past what is buffered
+static bool mr_copy(marshal_reader* r, void* dest, ks_size_t n) {
+    ks_size_t have = r->end - r->cur;
+    if (have > n) have = n;
+    memcpy(dest, r->cur, have);
+    mr_skip(r, have);
+
+    if (have < n) {
+        if (!r->ios) {
+            mr_error(r, "unexpected end of data");
+            return false;
+        }
+        ks_ssize_t got = ks_ios_readb(r->ios, n - have, (uint8_t*)dest + have);
+        if (got < 0) return false;
+        r->pos += got;
+        if ((ks_size_t)got < n - have) {
+            mr_error(r, "unexpected end of data");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// read 'n' bytes into a new allocation, which is grown as the data arrives (so a corrupt length fails at the end of
+//   the data, instead of allocating all of it up front)
+static void* mr_read_alloc(marshal_reader* r, ks_size_t n) {
+    ks_size_t have = 0, max = n < MARSHAL_CHUNK ? n : MARSHAL_CHUNK;
+    uint8_t* data = ks_malloc(max > 0 ? max : 1);
+    while (data && have < n) {
+        if (have == max) {
+            max = max > n - max ? n : 2 * max;
+            uint8_t* new_data = ks_realloc(data, max);
+            if (!new_data) {
+                ks_free(data);
+                data = NULL;
+                break;
+            }
+            data = new_data;
+        }
+
+        if (!mr_copy(r, data + have, max - have)) {
+            ks_free(data);
+            return NULL;
+        }
+        have = max;
+    }
+
+    if (!data) return ks_throw(ks_T_OutOfMemError, "Failed to allocate %z bytes while reading marshal data", max);
+    return data;
+}
+
+// read an array
+static ks_obj mr_array(marshal_reader* r) {
+    if (!marshal_nx_array) return ks_throw(ks_T_ImportError, "Reading arrays requires the 'nx' module");
+
+    ks_size_t fmt_len;
+    if (!mr_len(r, &fmt_len) || !mr_need(r, fmt_len)) return NULL;
+    if (fmt_len > 15) return mr_error(r, "invalid array format");
+    char fmt[16];
+    memcpy(fmt, r->cur, fmt_len);
+    fmt[fmt_len] = '\0';
+    mr_skip(r, fmt_len);
+
+    nx_dtype dtype = nx_dtype_from_bufmt(fmt);
+    if (!dtype) return NULL;
+
+    uint64_t rank;
+    if (!mr_varint(r, &rank)) return NULL;
+    if (rank < 1 || rank > 64) return mr_error(r, "invalid array rank");
+
+    nx_size_t dim[64], stride[64];
+    uint64_t total = dtype->size;
+    int i;
+    for (i = 0; i < rank; ++i) {
+        uint64_t d;
+        if (!mr_varint(r, &d)) return NULL;
+        dim[i] = d;
+        if (d > 0 && total > UINT64_MAX / d) return mr_error(r, "array is too large");
+        total *= d;
+    }
+    for (i = rank - 1; i >= 0; --i) stride[i] = i == rank - 1 ? dtype->size : stride[i + 1] * dim[i + 1];
+
+    // skip padding
+    ks_size_t pad = (MARSHAL_ALIGN - r->pos % MARSHAL_ALIGN) % MARSHAL_ALIGN;
+    if (!mr_need(r, pad)) return NULL;
+    mr_skip(r, pad);
+
+    if (!r->ios && total > (uint64_t)(r->end - r->cur)) return mr_error(r, "array data is past the end of the data");
+
+    if (r->owner) {
+        // view the memory directly
+        nx_view res = nx_view_new(r->owner, (nxar_t){
+            .data = (void*)r->cur,
+            .dtype = dtype,
+            .rank = rank,
+            .dim = dim,
+            .stride = stride,
+        });
+        mr_skip(r, total);
+        return (ks_obj)res;
+    }
+
+    void* data = mr_read_alloc(r, total);
+    if (!data) return NULL;
+
+    return (ks_obj)nx_array_new_take(dtype, rank, dim, data);
+}
+
+static ks_obj mr_obj(marshal_reader* r);
+
+// read 'n' objects into a new array (which is grown as they are read, rather than trusting 'n')
+static ks_obj* mr_objs(marshal_reader* r, ks_size_t n) {
+    ks_size_t i, max = 0;
+    ks_obj* elems = NULL;
+    for (i = 0; i < n; ++i) {
+        if (i == max) {
+            max = max > 0 ? 2 * max : 16;
+            ks_obj* new_elems = ks_realloc(elems, sizeof(*elems) * max);
+            if (!new_elems) {
+                ks_throw(ks_T_OutOfMemError, "Failed to allocate %z objects while reading marshal data", max);
+                break;
+            }
+            elems = new_elems;
+        }
+
+        if (!(elems[i] = mr_obj(r))) break;
+    }
+
+    if (i < n) {
+        while (i > 0) KS_DECREF(elems[--i]);
+        ks_free(elems);
+        return NULL;
+    }
+    return elems ? elems : ks_malloc(sizeof(*elems));
+}
+
+// read the body of a container with tag 'tag'
+static ks_obj mr_container(marshal_reader* r, uint8_t tag) {
+    ks_size_t n, i;
+    if (!mr_len(r, &n)) return NULL;
+
+    // remember the position in the memo now, so the elements (which may refer to it) are numbered after it
+    ks_size_t idx = r->memo->len;
+
+    if (tag == 'l') {
+        // lists are created first, so they can contain themselves
+        ks_list res = ks_list_new(0, NULL);
+        ks_list_push(r->memo, (ks_obj)res);
+        for (i = 0; i < n; ++i) {
+            ks_obj elem = mr_obj(r);
+            if (!elem) {
+                KS_DECREF(res);
+                return NULL;
+            }
+            ks_list_push(res, elem);
+            KS_DECREF(elem);
+        }
+        return (ks_obj)res;
+    } else if (tag == 'D') {
+        ks_dict res = ks_dict_new(0, NULL);
+        ks_list_push(r->memo, (ks_obj)res);
+        for (i = 0; i < n; ++i) {
+            ks_obj key = mr_obj(r);
+            if (!key) {
+                KS_DECREF(res);
+                return NULL;
+            }
+            ks_obj val = mr_obj(r);
+            if (!val) {
+                KS_DECREF(key);
+                KS_DECREF(res);
+                return NULL;
+            }
+
+            bool ok = ks_dict_set(res, key, val);
+            KS_DECREF(key);
+            KS_DECREF(val);
+            if (!ok) {
+                KS_DECREF(res);
+                return NULL;
+            }
+        }
+        return (ks_obj)res;
+    }
+
+    // tuples and sets are made once their elements are known, so the spot in the memo is marked until then
+    ks_list_push(r->memo, r->unfinished);
+
+    ks_obj* elems = mr_objs(r, n);
+    if (!elems) return NULL;
+
+    ks_obj res = tag == 't' ? (ks_obj)ks_tuple_new(n, elems) : (ks_obj)ks_set_new(n, elems);
+    for (i = 0; i < n; ++i) KS_DECREF(elems[i]);
+    ks_free(elems);
+    if (!res) return NULL;
+
+    KS_DECREF(r->memo->elems[idx]);
+    r->memo->elems[idx] = KS_NEWREF(res);
+    return res;
+}
+
+// read any object
+static ks_obj mr_obj(marshal_reader* r) {
+    if (!mr_need(r, 1)) return NULL;
+    uint8_t tag = *r->cur;
+    mr_skip(r, 1);
+
+    uint64_t v;
+    ks_size_t n;
+    ks_obj res;
+    switch (tag) {
+        case 'N': return KSO_NONE;
+        case 'T': return KSO_TRUE;
+        case 'F': return KSO_FALSE;
+
+        case 'i':
+            if (!mr_varint(r, &v)) return NULL;
+            return (ks_obj)ks_int_new((int64_t)(v >> 1) ^ -(int64_t)(v & 1));
+
+        case 'I': {
+            if (!mr_need(r, 1)) return NULL;
+            bool neg = *r->cur != 0;
+            mr_skip(r, 1);
+            if (!mr_len(r, &n) || !mr_need(r, n)) return NULL;
+
+            mpz_t z;
+            mpz_init(z);
+            mpz_import(z, n, -1, 1, 0, 0, r->cur);
+            if (neg) mpz_neg(z, z);
+            mr_skip(r, n);
+            return (ks_obj)ks_int_new_mpz_n(z);
+        }
+
+        case 'd': {
+            double val;
+            if (!mr_need(r, sizeof(val))) return NULL;
+            memcpy(&val, r->cur, sizeof(val));
+            mr_skip(r, sizeof(val));
+            return (ks_obj)ks_float_new(val);
+        }
+
+        case 'c': {
+            double complex val;
+            if (!mr_need(r, sizeof(val))) return NULL;
+            memcpy(&val, r->cur, sizeof(val));
+            mr_skip(r, sizeof(val));
+            return (ks_obj)ks_complex_new(val);
+        }
+
+        case 's':
+            if (!mr_len(r, &n) || !mr_need(r, n)) return NULL;
+            if (ks_text_utf8_validate((const char*)r->cur, n) < 0) return mr_error(r, "str was not valid UTF-8");
+            res = (ks_obj)ks_str_utf8((const char*)r->cur, n);
+            mr_skip(r, n);
+            ks_list_push(r->memo, res);
+            return res;
+
+        case 'b':
+            if (!mr_len(r, &n) || !mr_need(r, n)) return NULL;
+            res = (ks_obj)ks_bytes_new(r->cur, n);
+            mr_skip(r, n);
+            ks_list_push(r->memo, res);
+            return res;
+
+        case 'A':
+            if (!(res = mr_array(r))) return NULL;
+            ks_list_push(r->memo, res);
+            return res;
+
+        case 'R':
+            if (!mr_varint(r, &v)) return NULL;
+            if (v >= r->memo->len) return mr_error(r, "invalid reference");
+            if (r->memo->elems[v] == r->unfinished) return mr_error(r, "cyclic reference through an immutable container");
+            return KS_NEWREF(r->memo->elems[v]);
+
+        case 'l': case 't': case 'S': case 'D':
+            if (++r->depth > MARSHAL_MAX_DEPTH) return mr_error(r, "nested too deeply");
+            res = mr_container(r, tag);
+            r->depth--;
+            return res;
+
+        default:
+            r->cur--;
+            r->pos--;
+            return mr_error(r, "unknown tag");
+    }
+}
+
+// read (and check) the header
+static bool mr_header(marshal_reader* r) {
+    if (!mr_need(r, 4)) return false;
+    if (memcmp(r->cur, "KSMA", 4) != 0) {
+        mr_error(r, "missing 'KSMA' header");
+        return false;
+    }
+    mr_skip(r, 4);
+
+    uint64_t version;
+    if (!mr_varint(r, &version)) return false;
+    if (version < 1 || version > MARSHAL_VERSION) {
+        ks_throw(ks_T_ArgError, "Unsupported marshal format version %l (this version reads versions 1 through %i)", (int64_t)version, MARSHAL_VERSION);
+        return false;
+    }
+
+    if (!mr_need(r, 1)) return false;
+    if (*r->cur != MARSHAL_ORDER) {
+        ks_throw(ks_T_ArgError, "Marshal data was written with a different byte order");
+        return false;
+    }
+    mr_skip(r, 1);
+
+    return true;
+}
+
+// read the header and an object
+static ks_obj mr_load(marshal_reader* r) {
+    r->memo = ks_list_new(0, NULL);
+    // a new object, which can't be confused with anything read
+    r->unfinished = (ks_obj)ks_list_new(0, NULL);
+    r->depth = 0;
+
+    ks_obj res = mr_header(r) ? mr_obj(r) : NULL;
+
+    KS_DECREF(r->memo);
+    KS_DECREF(r->unfinished);
+    return res;
+}
+
+// initialize a reader over a block of memory
+static void mr_init_mem(marshal_reader* r, const void* data, ks_size_t len_b, ks_obj owner) {
+    r->cur = data;
+    r->end = r->cur + len_b;
+    r->pos = 0;
+    r->ios = NULL;
+    r->buf = NULL;
+    r->buf_max = 0;
+    r->owner = owner;
+}
+
+
+/* Module Functions */
+
+// marshal.dumps(obj) - convert 'obj' to 'bytes'
+static KS_TFUNC(marshal, dumps) {
+    ks_obj obj;
+    KS_GETARGS("obj", &obj)
+
+    marshal_writer w;
+    w.ios = NULL;
+    if (!mw_dump(&w, obj)) {
+        ks_free(w.buf);
+        return NULL;
+    }
+
+    ks_bytes res = ks_bytes_new(w.buf, w.len);
+    ks_free(w.buf);
+    return (ks_obj)res;
+}
+
+// marshal.dump(obj, ios) - write 'obj' to 'ios'
+static KS_TFUNC(marshal, dump) {
+    ks_obj obj;
+    ks_ios ios;
+    KS_GETARGS("obj ios:*", &obj, &ios, ks_T_ios)
+
+    marshal_writer w;
+    w.ios = ios;
+    bool res = mw_dump(&w, obj);
+    ks_free(w.buf);
+
+    if (!res) return NULL;
+    return KSO_NONE;
+}
+
+// marshal.loads(data) - read an object from 'data' (which may be any object with a buffer, such as 'bytes')
+static KS_TFUNC(marshal, loads) {
+    ks_obj data;
+    KS_GETARGS("data", &data)
+
+    ks_buffer buf;
+    if (!ks_buffer_get(data, &buf, KS_BUFFER_CONTIG)) return NULL;
+
+    marshal_reader r;
+    mr_init_mem(&r, buf.data, buf.len_b, NULL);
+    ks_obj res = mr_load(&r);
+
+    ks_buffer_release(&buf);
+    return res;
+}
+
+// marshal.load(src) - read an object from 'src', which is an 'ios', or the name of a file (which is mapped into
+//   memory, and arrays in it are views of the mapping rather than copies)
+static KS_TFUNC(marshal, load) {
+    ks_obj src;
+    KS_GETARGS("src", &src)
+
+    marshal_reader r;
+    ks_obj res;
+    if (src->type == ks_T_ios) {
+        r.cur = r.end = NULL;
+        r.pos = 0;
+        r.ios = (ks_ios)src;
+        r.buf_max = MARSHAL_CHUNK;
+        r.buf = ks_malloc(r.buf_max);
+        r.owner = NULL;
+
+        res = mr_load(&r);
+        ks_free(r.buf);
+        return res;
+    } else if (src->type == ks_T_str) {
+        // copy-on-write, so the views can be written to (without changing the file)
+        ks_str mode = ks_str_new("c");
+        ks_mmap m = ks_mmap_new((ks_str)src, mode);
+        KS_DECREF(mode);
+        if (!m) return NULL;
+
+        mr_init_mem(&r, m->data, m->len_b, (ks_obj)m);
+        res = mr_load(&r);
+
+        KS_DECREF(m);
+        return res;
+    }
+
+    return ks_throw(ks_T_TypeError, "'src' must be an 'ios' or a file name, not '%T'", src);
+}
+
+
+// now, export them all
+static ks_module get_module() {
+
+    // the array types are only created when 'nx' is imported (even though this module is linked against it)
+    ks_module mod_nx = ks_module_import("nx");
+    if (!mod_nx) {
+        ks_catch_ignore();
+    } else {
+        // NOTE: these references are kept for as long as the module is loaded
+        marshal_nx_array = (ks_type)ks_dict_get_c(mod_nx->attr, "array");
+        marshal_nx_view = (ks_type)ks_dict_get_c(mod_nx->attr, "view");
+        if (!marshal_nx_array || !marshal_nx_view) ks_catch_ignore();
+        KS_DECREF(mod_nx);
+    }
+
+    ks_module mod = ks_module_new(MODULE_NAME, "Compact binary serialization of objects");
+
+    ks_dict_set_c(mod->attr, KS_KEYVALS(
+        /* constants */
+        {"VERSION",         (ks_obj)ks_int_new(MARSHAL_VERSION)},
+
+        /* functions */
+        {"dumps",           (ks_obj)ks_cfunc_new_c_old(marshal_dumps_, "marshal.dumps(obj)")},
+        {"dump",            (ks_obj)ks_cfunc_new_c_old(marshal_dump_, "marshal.dump(obj, ios)")},
+        {"loads",           (ks_obj)ks_cfunc_new_c_old(marshal_loads_, "marshal.loads(data)")},
+        {"load",            (ks_obj)ks_cfunc_new_c_old(marshal_load_, "marshal.load(src)")},
+    ));
+
+    return mod;
+}
+
+// boiler plate code
+MODULE_INIT(get_module)
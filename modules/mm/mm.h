@@ -140,9 +140,9 @@ KS_API bool mm_Stream_open(mm_Stream self, char* url);
 
 /* I/O */
 
-// Read a file as a binary object, and return the whole thing
+// Read a file as a bytearray, and return the whole thing
 // NOTE: Returns a new reference
-KS_API ks_blob mm_read_file(char* fname);
+KS_API ks_bytearray mm_read_file(char* fname);
 
 // Read, then decode an image file to an array, then return the array
 // By default, a tensor of (h, w, d) is returned, with `d` being the number of channels
@@ -51,30 +51,37 @@ static bool my_setfrom_pix_fmt(int pix_fmt, void* pix, int w, int h, int linesz,
 }
 
 
-// read whole file as a blob
-ks_blob mm_read_file(char* fname) {
-    ks_iostream ios = ks_iostream_new();
+// read whole file as a bytearray
+ks_bytearray mm_read_file(char* fname) {
+    ks_ios ios = ks_ios_new();
 
     // attempt to open the file
-    if (!ks_iostream_open(ios, fname, "rb")) {
+    ks_str fname_str = ks_str_new(fname), mode_str = ks_str_new("rb");
+    bool isOpen = ks_ios_open(ios, fname_str, mode_str);
+    KS_DECREF(fname_str);
+    KS_DECREF(mode_str);
+    if (!isOpen) {
         KS_DECREF(ios);
         return NULL;
     }
 
-    ks_ssize_t sz_ios = ks_iostream_size(ios);
+    ks_ssize_t sz_ios = ks_ios_size(ios);
     if (sz_ios < 0) {
         KS_DECREF(ios);
         return NULL;
     }
 
-    // read data
-    ks_blob res = ks_iostream_readblob_n(ios, sz_ios);
+    // read data directly into the result
+    ks_bytearray res = ks_bytearray_new(NULL, sz_ios);
+    ks_ssize_t sz_read = ks_ios_readb(ios, sz_ios, res->byt);
+    KS_DECREF(ios);
 
-    if (!res) {
-        KS_DECREF(ios);
+    if (sz_read < 0) {
+        KS_DECREF(res);
         return NULL;
     }
 
+    ks_bytearray_resize(res, sz_read);
     return res;
 }
 
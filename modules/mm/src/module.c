@@ -18,13 +18,13 @@
 ks_type mm_Enum_MediaType = NULL;
 
 
-// mm.read_file(fname) -> read an entire file (by default, as a blob)
+// mm.read_file(fname) -> read an entire file (as a bytearray)
 static KS_TFUNC(mm, read_file) {
     KS_REQ_N_ARGS(n_args, 1);
     ks_str fname;
     if (!ks_parse_params(n_args, args, "fname%s", &fname)) return NULL;
 
-    return (ks_obj)mm_read_file(fname->chr);
+    return (ks_obj)mm_read_file(ks_str_cstr(fname));
 }
 
 static bool my_setfrom_pi(enum AVSampleFormat smp_fmt, void** samples, int len, int chn, double* output) {
@@ -172,7 +172,7 @@ static KS_TFUNC(mm, read_audio) {
     // decode data
     int size = 0, channels = 0, hz = 0;
     double* data = NULL;
-    if (!decode_audio_file(fname->chr, &data, &size, &channels, &hz)) {
+    if (!decode_audio_file(ks_str_cstr(fname), &data, &size, &channels, &hz)) {
         return NULL;
     }
  
@@ -211,7 +211,7 @@ static KS_TFUNC(mm, read_image) {
     ks_str fname;
     if (!ks_parse_params(n_args, args, "fname%s", &fname)) return NULL;
 
-    return (ks_obj)mm_read_image(fname->chr, 0);
+    return (ks_obj)mm_read_image(ks_str_cstr(fname), 0);
 }
 
 // mm.write_image(img, fname) -> write image to file
@@ -228,7 +228,7 @@ static KS_TFUNC(mm, write_image) {
         return NULL;
     }
 
-    bool rst = mm_write_image(fname->chr, img_ar, 0);
+    bool rst = mm_write_image(ks_str_cstr(fname), img_ar, 0);
     KS_DECREF(refadd);
 
     if (!rst) return NULL;
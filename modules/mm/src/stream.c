@@ -86,7 +86,7 @@ static KS_TFUNC(stream, new) {
     mm_Stream self = mm_Stream_new();
 
     // attempt to open a stream
-    if (!mm_Stream_open(self, url->chr)) {
+    if (!mm_Stream_open(self, ks_str_cstr(url))) {
         KS_DECREF(self);
         return NULL;
     }
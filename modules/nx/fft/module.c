@@ -22,7 +22,7 @@ static KS_TFUNC(fft, fftN) {
     ks_list dels = ks_list_new(0, NULL);
 
     // convert them to C arrays
-    if (!nx_get_nxar(aA, &Ar, dels) || (aB != KSO_NONE && !nx_get_nxar(aB, &Br, dels))) {
+    if (!nx_get_nxar(aA, &Ar, dels) || (aB != KSO_NONE && !nx_get_nxar_out(aB, &Br, dels))) {
         KS_DECREF(dels);
         return NULL;
     }
@@ -136,7 +136,7 @@ static KS_TFUNC(fft, ifftN) {
     ks_list dels = ks_list_new(0, NULL);
 
     // convert them to C arrays
-    if (!nx_get_nxar(aA, &Ar, dels) || (aB != KSO_NONE && !nx_get_nxar(aB, &Br, dels))) {
+    if (!nx_get_nxar(aA, &Ar, dels) || (aB != KSO_NONE && !nx_get_nxar_out(aB, &Br, dels))) {
         KS_DECREF(dels);
         return NULL;
     }
@@ -241,7 +241,7 @@ static KS_TFUNC(fft, ifftN) {
 // add the FFT module to `nxmod`
 void nx_mod_add_fft(ks_module nxmod) {
 
-    ks_module submod = ks_module_new("nx." SUBMOD);
+    ks_module submod = ks_module_new("nx." SUBMOD, "Fast Fourier Transform routines");
 
     nx_T_init_fft_plan();
 
@@ -758,7 +758,7 @@ bool nx_fft_plan_do(nx_fft_plan plan, nxar_t A, nxar_t B, int* axes) {
 
         #else
 
-        ks_throw(ks_type_InternalError, "nx_fft_plan_t had ptype==NX_FFT_PLAN_ND_FFTW3, but it was not compiled with FFTW3 support!");
+        ks_throw(ks_T_InternalError, "nx_fft_plan_t had ptype==NX_FFT_PLAN_ND_FFTW3, but it was not compiled with FFTW3 support!");
         return false;
         #endif
 
@@ -13,7 +13,7 @@
 void nx_mod_add_la(ks_module nxmod) {
 
 
-    ks_module submod = ks_module_new("nx." SUBMOD);
+    ks_module submod = ks_module_new("nx." SUBMOD, "Linear algebra routines");
 
     ks_dict_set_c(submod->attr, KS_KEYVALS(
 
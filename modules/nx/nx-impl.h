@@ -165,5 +165,8 @@ void nx_T_init_fft_plan();
 void nx_mod_add_fft(ks_module nxmod);
 void nx_mod_add_la(ks_module nxmod);
 
+// adding functions from other files
+void nx_mod_add_csv(ks_module nxmod);
+
 
 #endif
@@ -190,6 +190,10 @@ typedef struct {
     // pointer to the array data (which the view does not own)
     ks_obj data_src;
 
+    // if the view is of the memory of an object with the buffer protocol, the buffer (which is held until the view is
+    //   freed, so the memory stays where it is). Otherwise, 'buf.owner' is NULL
+    ks_buffer buf;
+
 }* nx_view;
 
 // declaring the types
@@ -268,6 +272,13 @@ KS_API nx_dtype nx_dtype_make_fp(char* name, int bits);
 // NOTE: Returns a new reference
 KS_API nx_dtype nx_dtype_make_cplx(char* name, int bits);
 
+// Return the buffer protocol format string for a dtype (see `ks_buffer`), or NULL if there is none
+KS_API const char* nx_dtype_get_bufmt(nx_dtype self);
+
+// Return the dtype corresponding to a buffer protocol format string
+// NOTE: Does not return a new reference; returns NULL and throws an error if there is none
+KS_API nx_dtype nx_dtype_from_bufmt(const char* fmt);
+
 
 
 
@@ -284,6 +295,11 @@ KS_API nx_array nx_array_new(enum nx_dtype dtype, int N, nx_size_t* dim, void* d
 // NOTE: Returns a new reference
 KS_API nx_array nx_array_new(nxar_t nxar);
 
+// Create a new dense array with dimensions 'dim', which takes ownership of 'data' (which must have been allocated
+//   with `ks_malloc()`, and is freed by the array)
+// NOTE: Returns a new reference
+KS_API nx_array nx_array_new_take(nx_dtype dtype, int rank, nx_size_t* dim, void* data);
+
 // Create a new nx array from a kscript object (use NX_DTYPE_KIND_NONE to auto-detect)
 // The rules are:
 // If 'obj' is iterable:
@@ -300,6 +316,11 @@ KS_API nx_array nx_array_from_obj(ks_obj obj, nx_dtype dtype);
 // NOTE: Returns a new reference
 KS_API nx_view nx_view_new(ks_obj ref, nxar_t nxar);
 
+// Create a new view of the memory in 'buf' (from `ks_buffer_get()`), which the view takes (and releases when it is
+//   freed, or right away if there was an error)
+// NOTE: Returns a new reference, or NULL if an error was thrown
+KS_API nx_view nx_view_new_buffer(ks_buffer* buf);
+
 
 
 /* nxar_t */
@@ -310,6 +331,15 @@ KS_API nx_view nx_view_new(ks_obj ref, nxar_t nxar);
 // NOTE: Returns whether it was successful, or false and throws an error
 KS_API bool nx_get_nxar(ks_obj obj, nxar_t* nxar, ks_list refadd);
 
+// Convert 'obj' into a nxar_t that results will be written to, which is the same as `nx_get_nxar()`, except that
+//   objects with the buffer protocol must give writable memory
+// NOTE: Returns whether it was successful, or false and throws an error
+KS_API bool nx_get_nxar_out(ks_obj obj, nxar_t* nxar, ks_list refadd);
+
+// Fill in a buffer protocol request for an nxar (used by `nx.array` and `nx.view`)
+// NOTE: Returns success, or false and throws an error
+KS_API bool nx_nxar_getbuf(nxar_t nxar, ks_buffer* buf, int flags);
+
 
 // Implementation of nxar[*idxs]
 // NOTE: returns new reference, or NULL and throws an error
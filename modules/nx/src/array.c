@@ -105,6 +105,33 @@ nx_array nx_array_new(nxar_t nxar) {
 }
 
 
+// Create a new dense array that takes ownership of 'data'
+nx_array nx_array_new_take(nx_dtype dtype, int rank, nx_size_t* dim, void* data) {
+    nx_array self = KS_ALLOC_OBJ(nx_array);
+    KS_INIT_OBJ(self, nx_T_array);
+
+    self->dtype = dtype;
+    KS_INCREF(dtype);
+
+    self->rank = rank;
+    self->dim = ks_malloc(sizeof(*self->dim) * rank);
+    self->stride = ks_malloc(sizeof(*self->stride) * rank);
+    memcpy(self->dim, dim, sizeof(*self->dim) * rank);
+
+    // last dimension is immediate stride
+    self->stride[rank - 1] = dtype->size;
+
+    int i;
+    for (i = rank - 2; i >= 0; --i) {
+        self->stride[i] = self->stride[i + 1] * self->dim[i + 1];
+    }
+
+    self->data = data;
+
+    return self;
+}
+
+
 // recursive internal procedure for filling array from recursive iterators
 static bool my_array_fill(nx_dtype dtype, nx_array* resp, ks_obj cur, int* idx, int dep, int* max_dep, ks_ssize_t** dims) {
 
@@ -205,14 +232,33 @@ static bool my_array_fill(nx_dtype dtype, nx_array* resp, ks_obj cur, int* idx,
 // create a nx array from an object
 nx_array nx_array_from_obj(ks_obj obj, nx_dtype dtype) {
 
-    if (obj->type == nx_T_array || obj->type == nx_T_view) {
+    if (obj->type == nx_T_array || obj->type == nx_T_view || ks_buffer_has(obj)) {
+        // copy directly from the memory of the object (for buffers, this is a single pass, instead of
+        //   creating an object per element)
         nxar_t obj_ar;
         ks_list refadd = ks_list_new(0, NULL);
         if (!nx_get_nxar(obj, &obj_ar, refadd)) {
             KS_DECREF(refadd);
             return NULL;
         }
-        nx_array res = nx_array_new(obj_ar);
+
+        nx_array res = NULL;
+        if (dtype == NULL || dtype == obj_ar.dtype) {
+            res = nx_array_new(obj_ar);
+        } else {
+            // convert to the requested type
+            res = nx_array_new((nxar_t){
+                .data = NULL,
+                .dtype = dtype,
+                .rank = obj_ar.rank,
+                .dim = obj_ar.dim,
+                .stride = NULL,
+            });
+            if (res && !nx_T_cast(obj_ar, NXAR_ARRAY(res))) {
+                KS_DECREF(res);
+                res = NULL;
+            }
+        }
         KS_DECREF(refadd);
 
         return res;
@@ -224,6 +270,49 @@ nx_array nx_array_from_obj(ks_obj obj, nx_dtype dtype) {
             dtype = nx_dtype_fp32;
         }
 
+        if (obj->type == ks_T_list && ((ks_list)obj)->kind != KS_LIST_KIND_OBJ) {
+            // unboxed list, so its elements are already an array of C values
+            ks_list l = (ks_list)obj;
+            nx_size_t n = l->len, stride = sizeof(*l->raw.v64);
+            nxar_t src = (nxar_t){
+                .data = l->raw.v64,
+                .dtype = l->kind == KS_LIST_KIND_INT64 ? nx_dtype_sint64 : nx_dtype_fp64,
+                .rank = 1,
+                .dim = &n,
+                .stride = &stride,
+            };
+
+            nx_array res = nx_array_new((nxar_t){ .rank = 1, .dtype = dtype, .dim = &n, .stride = NULL, .data = NULL });
+            if (res && !nx_T_cast(src, NXAR_ARRAY(res))) {
+                KS_DECREF(res);
+                res = NULL;
+            }
+
+            return res;
+        } else if ((obj->type == ks_T_list || obj->type == ks_T_tuple) && (dtype->kind == NX_DTYPE_KIND_CINT || dtype->kind == NX_DTYPE_KIND_CFLOAT)) {
+            // flat list of numbers, so convert each directly into the data (instead of recursing)
+            ks_size_t n = obj->type == ks_T_list ? ((ks_list)obj)->len : ((ks_tuple)obj)->len;
+            ks_obj* elems = obj->type == ks_T_list ? ((ks_list)obj)->elems : ((ks_tuple)obj)->elems;
+
+            ks_size_t i;
+            for (i = 0; i < n; ++i) {
+                if (!(elems[i]->type == ks_T_int && !((ks_int)elems[i])->isLong) && elems[i]->type != ks_T_float) break;
+            }
+
+            if (n > 0 && i == n) {
+                nx_array res = nx_array_new((nxar_t){ .rank = 1, .dtype = dtype, .dim = (nx_size_t[]){ n }, .stride = NULL, .data = NULL });
+
+                for (i = 0; i < n; ++i) {
+                    if (!nx_cast_to(elems[i], dtype, (void*)((intptr_t)res->data + dtype->size * i))) {
+                        KS_DECREF(res);
+                        return NULL;
+                    }
+                }
+
+                return res;
+            }
+        }
+
         // current dimensional index
         int idx = 0;
         
@@ -407,6 +496,11 @@ static KS_TFUNC(array, pow) {
     return nx_F_pow->func(n_args, args);
 }
 
+// buffer protocol: the elements of the array
+static bool array_getbuf(ks_obj self, ks_buffer* buf, int flags) {
+    return nx_nxar_getbuf(NXAR_ARRAY((nx_array)self), buf, flags);
+}
+
 KS_TYPE_DECLFWD(nx_T_array);
 
 
@@ -432,5 +526,7 @@ void nx_T_init_array() {
         {"__div__",                (ks_obj)ks_cfunc_new_c_old(array_div_, "nx.array.__div__(L, R)")},
         {"__pow__",                (ks_obj)ks_cfunc_new_c_old(array_pow_, "nx.array.__pow__(L, R)")},
     ));
+
+    nx_T_array->getbuf = array_getbuf;
 }
 
@@ -0,0 +1,605 @@
+/* src/csv.c - implementation of `nx.csv()`, which reads CSV data into columns
+ *
+ * The text is never split into `str` objects for numeric data: each field is parsed straight from the bytes into a
+ *   growing buffer for its column, which then becomes the data of an `nx.array` (of `nx.sint64` or `nx.fp64`)
+ *   without being copied again. Columns start out as integers, become floats if a field is only valid as a float
+ *   (or is empty, which is NaN), and fall back to a `list` of `str` if a field is not a number at all
+ *
+ * For large inputs, the data is split into chunks (at newlines) that are parsed by separate threads. The threads
+ *   only touch their own buffers, not kscript objects, so all objects are created afterwards, by the calling
+ *   thread. Columns that were inferred differently in different chunks are reconciled then: integers are widened
+ *   to floats, and chunks that parsed a string column as numbers are parsed again
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#include "../nx-impl.h"
+
+#include <math.h>
+#include <pthread.h>
+
+
+/* Tuning/Performance parameters */
+
+// most threads that will be used
+#define NX_CSV_MAX_THREADS 64
+
+// smallest chunk (in bytes) worth giving to its own thread
+#define NX_CSV_MIN_CHUNK (1024 * 1024)
+
+
+// kinds of columns, in the order they are promoted
+enum {
+    CSV_INT     = 0,
+    CSV_FLOAT   = 1,
+    CSV_STR     = 2,
+};
+
+// flags for a field
+enum {
+    CSV_QUOTED  = 0x01,
+    // the field contains '""', which must be replaced by '"'
+    CSV_ESCAPED = 0x02,
+};
+
+// results of parsing a chunk
+enum {
+    CSV_OK      = 0,
+    // a column became a string column, so the chunk must be parsed again
+    CSV_RESTART = 1,
+    CSV_ERR_FIELDS = 2,
+    CSV_ERR_QUOTE = 3,
+};
+
+// a field of a string column
+typedef struct {
+
+    // position in the data, and length in bytes
+    ks_size_t pos;
+    ks_size_t len;
+
+    int flags;
+
+} csv_span;
+
+// a column, as parsed from one chunk
+typedef struct {
+
+    int kind;
+
+    // values (for CSV_INT and CSV_FLOAT), which are converted in place when the column becomes CSV_FLOAT
+    union {
+        int64_t i;
+        double f;
+    }* vals;
+
+    // fields (for CSV_STR)
+    csv_span* spans;
+
+    nx_size_t len, max_len;
+
+} csv_col;
+
+// a chunk of rows, which is parsed by a single thread
+typedef struct {
+
+    // the entire input, and the range [start, end) that this chunk covers (which begins at the start of a row)
+    const char* data;
+    ks_size_t start, end;
+
+    int n_cols;
+    char delim;
+
+    // the kind each column starts out as (which is raised to CSV_STR when a chunk must be parsed again)
+    int* start_kind;
+
+    // the columns that were parsed
+    csv_col* cols;
+    nx_size_t n_rows;
+
+    // what went wrong (if not CSV_OK), and in which row of the chunk
+    int err;
+    nx_size_t err_row;
+
+} csv_chunk;
+
+
+// read the field starting at '*pos', and move past it (and the delimiter or newline after it)
+// Returns 1 if it was the last field on the row, 0 if there are more, or -1 if it was malformed
+static int csv_field(const char* data, ks_size_t* pos, ks_size_t end, char delim, ks_size_t* fpos, ks_size_t* flen, int* flags) {
+    ks_size_t p = *pos;
+    *flags = 0;
+
+    if (p < end && data[p] == '"') {
+        // quoted field, which may contain delimiters, newlines, and '""'
+        *flags |= CSV_QUOTED;
+        *fpos = ++p;
+        while (true) {
+            const char* q = memchr(data + p, '"', end - p);
+            if (!q) return -1;
+            p = q - data;
+            if (p + 1 < end && data[p + 1] == '"') {
+                *flags |= CSV_ESCAPED;
+                p += 2;
+            } else {
+                break;
+            }
+        }
+        *flen = p - *fpos;
+        p++;
+
+        if (p < end && data[p] == '\r') p++;
+        if (p < end && data[p] != delim && data[p] != '\n') return -1;
+    } else {
+        *fpos = p;
+        while (p < end && data[p] != delim && data[p] != '\n') p++;
+        *flen = p - *fpos;
+
+        // allow '\r\n' line endings
+        if (*flen > 0 && data[p - 1] == '\r' && (p >= end || data[p] == '\n')) (*flen)--;
+    }
+
+    if (p >= end) {
+        *pos = p;
+        return 1;
+    } else if (data[p] == delim) {
+        *pos = p + 1;
+        return 0;
+    } else {
+        *pos = p + 1;
+        return 1;
+    }
+}
+
+// skip blank lines starting at 'pos'
+static ks_size_t csv_skip_blank(const char* data, ks_size_t pos, ks_size_t end) {
+    while (pos < end) {
+        if (data[pos] == '\n') pos++;
+        else if (data[pos] == '\r' && pos + 1 < end && data[pos + 1] == '\n') pos += 2;
+        else break;
+    }
+    return pos;
+}
+
+// skip the whitespace around a numeric field (like `strtod()`, but on both sides), so that `a, b` spacing still
+//   gives numeric columns
+static void csv_trim(const char** src, ks_size_t* len) {
+    while (*len > 0 && isspace((unsigned char)**src)) {
+        (*src)++;
+        (*len)--;
+    }
+    while (*len > 0 && isspace((unsigned char)(*src)[*len - 1])) (*len)--;
+}
+
+// parse an integer field
+static bool csv_parse_int(const char* src, ks_size_t len, int64_t* out) {
+    csv_trim(&src, &len);
+    return len > 0 && ks_num_scan_int64(src, len, out) == len;
+}
+
+// parse a float field (empty fields are NaN)
+static bool csv_parse_float(const char* src, ks_size_t len, double* out) {
+    csv_trim(&src, &len);
+    if (len == 0) {
+        *out = NAN;
+        return true;
+    }
+
+    return ks_num_scan_double(src, len, out) == len;
+}
+
+// add a field to column 'col' of 'c'
+// Returns CSV_OK, or CSV_RESTART if the column had to become a string column
+static int csv_add(csv_chunk* c, int col, ks_size_t fpos, ks_size_t flen, int flags) {
+    csv_col* cc = &c->cols[col];
+    const char* src = c->data + fpos;
+
+    if (cc->len >= cc->max_len) {
+        cc->max_len = 2 * cc->max_len + 256;
+        if (cc->kind == CSV_STR) cc->spans = ks_realloc(cc->spans, sizeof(*cc->spans) * cc->max_len);
+        else cc->vals = ks_realloc(cc->vals, sizeof(*cc->vals) * cc->max_len);
+    }
+
+    if (cc->kind == CSV_STR) {
+        cc->spans[cc->len++] = (csv_span){ .pos = fpos, .len = flen, .flags = flags };
+        return CSV_OK;
+    }
+
+    // numbers can't have '""' in them
+    if (flags & CSV_ESCAPED) {
+        c->start_kind[col] = CSV_STR;
+        return CSV_RESTART;
+    }
+
+    if (cc->kind == CSV_INT) {
+        if (csv_parse_int(src, flen, &cc->vals[cc->len].i)) {
+            cc->len++;
+            return CSV_OK;
+        }
+
+        double f;
+        if (!csv_parse_float(src, flen, &f)) {
+            c->start_kind[col] = CSV_STR;
+            return CSV_RESTART;
+        }
+
+        // widen the values so far
+        nx_size_t i;
+        for (i = 0; i < cc->len; ++i) cc->vals[i].f = (double)cc->vals[i].i;
+        cc->kind = CSV_FLOAT;
+        cc->vals[cc->len++].f = f;
+        return CSV_OK;
+    }
+
+    if (!csv_parse_float(src, flen, &cc->vals[cc->len].f)) {
+        c->start_kind[col] = CSV_STR;
+        return CSV_RESTART;
+    }
+    cc->len++;
+    return CSV_OK;
+}
+
+// parse all of the rows in a chunk
+static int csv_parse_chunk(csv_chunk* c) {
+    int i;
+    for (i = 0; i < c->n_cols; ++i) {
+        csv_col* cc = &c->cols[i];
+        if ((cc->kind == CSV_STR) != (c->start_kind[i] == CSV_STR)) {
+            // the buffer holds the wrong type
+            ks_free(cc->vals);
+            ks_free(cc->spans);
+            cc->vals = NULL;
+            cc->spans = NULL;
+            cc->max_len = 0;
+        }
+        cc->kind = c->start_kind[i];
+        cc->len = 0;
+    }
+    c->n_rows = 0;
+
+    ks_size_t pos = c->start, fpos, flen;
+    int flags, st, r;
+    while ((pos = csv_skip_blank(c->data, pos, c->end)) < c->end) {
+        int col = 0;
+        do {
+            st = csv_field(c->data, &pos, c->end, c->delim, &fpos, &flen, &flags);
+            if (st < 0) {
+                c->err_row = c->n_rows;
+                return c->err = CSV_ERR_QUOTE;
+            } else if (col >= c->n_cols) {
+                c->err_row = c->n_rows;
+                return c->err = CSV_ERR_FIELDS;
+            }
+
+            if ((r = csv_add(c, col++, fpos, flen, flags)) != CSV_OK) return r;
+        } while (st == 0);
+
+        // short rows are filled in with empty fields
+        while (col < c->n_cols) {
+            if ((r = csv_add(c, col++, pos, 0, 0)) != CSV_OK) return r;
+        }
+
+        c->n_rows++;
+    }
+
+    return c->err = CSV_OK;
+}
+
+// thread entry point, which parses a chunk
+static void* csv_worker(void* _c) {
+    csv_chunk* c = _c;
+    while (csv_parse_chunk(c) == CSV_RESTART) {}
+    return NULL;
+}
+
+// parse all the chunks, each on their own thread (if there is more than one)
+static void csv_run(int n_chunks, csv_chunk* chunks) {
+    if (n_chunks == 1) {
+        csv_worker(&chunks[0]);
+        return;
+    }
+
+    pthread_t threads[NX_CSV_MAX_THREADS];
+    bool started[NX_CSV_MAX_THREADS];
+
+    int i;
+    for (i = 0; i < n_chunks; ++i) {
+        // if a thread can't be started, just do it here
+        started[i] = pthread_create(&threads[i], NULL, csv_worker, &chunks[i]) == 0;
+        if (!started[i]) csv_worker(&chunks[i]);
+    }
+
+    for (i = 0; i < n_chunks; ++i) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+}
+
+// create a 'str' from a field
+static ks_str csv_make_str(const char* data, csv_span sp) {
+    const char* src = data + sp.pos;
+    if (ks_text_utf8_validate(src, sp.len) < 0) {
+        return ks_throw(ks_T_ArgError, "Invalid CSV: field was not valid UTF-8");
+    }
+
+    if (!(sp.flags & CSV_ESCAPED)) return ks_str_utf8(src, sp.len);
+
+    // replace '""' with '"'
+    char* tmp = ks_malloc(sp.len);
+    ks_size_t i, j = 0;
+    for (i = 0; i < sp.len; ++i) {
+        tmp[j++] = src[i];
+        if (src[i] == '"') i++;
+    }
+
+    ks_str res = ks_str_utf8(tmp, j);
+    ks_free(tmp);
+    return res;
+}
+
+// combine a column from all of the chunks into a single object
+static ks_obj csv_make_col(int n_chunks, csv_chunk* chunks, int col, nx_size_t n_rows) {
+    int kind = chunks[0].cols[col].kind, i;
+    for (i = 1; i < n_chunks; ++i) {
+        if (chunks[i].cols[col].kind > kind) kind = chunks[i].cols[col].kind;
+    }
+
+    if (kind == CSV_STR) {
+        ks_obj* elems = ks_malloc(sizeof(*elems) * (n_rows > 0 ? n_rows : 1));
+        nx_size_t ct = 0, j;
+        for (i = 0; i < n_chunks; ++i) {
+            csv_col* cc = &chunks[i].cols[col];
+            for (j = 0; j < cc->len; ++j) {
+                if (!(elems[ct] = (ks_obj)csv_make_str(chunks[i].data, cc->spans[j]))) {
+                    while (ct > 0) KS_DECREF(elems[--ct]);
+                    ks_free(elems);
+                    return NULL;
+                }
+                ct++;
+            }
+        }
+
+        ks_list res = ks_list_new(ct, elems);
+        for (j = 0; j < ct; ++j) KS_DECREF(elems[j]);
+        ks_free(elems);
+        return (ks_obj)res;
+    }
+
+    // take the first chunk's buffer, and add the rest to the end
+    csv_col* c0 = &chunks[0].cols[col];
+    void* data = c0->vals;
+    c0->vals = NULL;
+    c0->max_len = 0;
+    if (n_chunks > 1 || !data) data = ks_realloc(data, sizeof(*c0->vals) * (n_rows > 0 ? n_rows : 1));
+
+    int64_t* di = data;
+    double* df = data;
+    nx_size_t ct = 0, j;
+    for (i = 0; i < n_chunks; ++i) {
+        csv_col* cc = &chunks[i].cols[col];
+        if (i > 0) memcpy(&di[ct], cc->vals, sizeof(*cc->vals) * cc->len);
+        if (kind == CSV_FLOAT && cc->kind == CSV_INT) {
+            for (j = ct; j < ct + cc->len; ++j) df[j] = (double)di[j];
+        }
+        ct += cc->len;
+    }
+
+    return (ks_obj)nx_array_new_take(kind == CSV_INT ? nx_dtype_sint64 : nx_dtype_fp64, 1, &n_rows, data);
+}
+
+// parse CSV text into a dict of columns
+static ks_obj csv_read(const char* data, ks_size_t len, char delim, bool header, int n_threads) {
+    ks_dict res = ks_dict_new(0, NULL);
+
+    ks_size_t pos = csv_skip_blank(data, 0, len), fpos, flen;
+    if (pos >= len) return (ks_obj)res;
+
+    // the first row decides how many columns there are
+    ks_list names = ks_list_new(0, NULL);
+    ks_size_t body = pos;
+    int st, flags;
+    do {
+        st = csv_field(data, &pos, len, delim, &fpos, &flen, &flags);
+        if (st < 0) {
+            KS_DECREF(names);
+            KS_DECREF(res);
+            return ks_throw(ks_T_ArgError, "Invalid CSV: unterminated or malformed quoted field in row 1");
+        }
+
+        ks_obj name = header ? (ks_obj)csv_make_str(data, (csv_span){ .pos = fpos, .len = flen, .flags = flags }) : (ks_obj)ks_int_new(names->len);
+        if (!name) {
+            KS_DECREF(names);
+            KS_DECREF(res);
+            return NULL;
+        }
+
+        // each name is reserved in the result, so that a repeated one (which would replace a column) is an error
+        if (ks_dict_has(res, name)) {
+            ks_throw(ks_T_ArgError, "Invalid CSV: the column name %R is given more than once in the header", name);
+            KS_DECREF(name);
+            KS_DECREF(names);
+            KS_DECREF(res);
+            return NULL;
+        }
+        ks_dict_set(res, name, KSO_NONE);
+
+        ks_list_push(names, name);
+        KS_DECREF(name);
+    } while (st == 0);
+    if (header) body = pos;
+
+    int n_cols = names->len, i, j;
+
+    // split into chunks at newlines
+    // NOTE: quoted fields may have newlines in them, which can't be told apart from the end of a row without
+    //   scanning from the beginning, so those are always read as one chunk
+    if (n_threads > NX_CSV_MAX_THREADS) n_threads = NX_CSV_MAX_THREADS;
+    if ((ks_ssize_t)n_threads > (ks_ssize_t)((len - body) / NX_CSV_MIN_CHUNK)) n_threads = (len - body) / NX_CSV_MIN_CHUNK;
+    if (n_threads < 1 || memchr(data + body, '"', len - body)) n_threads = 1;
+
+    csv_chunk* chunks = ks_malloc(sizeof(*chunks) * n_threads);
+    int n_chunks = 0;
+    ks_size_t start = body;
+    // NOTE: there is always at least one chunk (which may be empty), so every column gets made
+    for (i = 0; i < n_threads && (i == 0 || start < len); ++i) {
+        ks_size_t end = len;
+        if (i < n_threads - 1) {
+            end = body + (len - body) / n_threads * (i + 1);
+            if (end < start) end = start;
+            const char* nl = memchr(data + end, '\n', len - end);
+            end = nl ? (nl - data) + 1 : len;
+        }
+
+        csv_chunk* c = &chunks[n_chunks++];
+        c->data = data;
+        c->start = start;
+        c->end = end;
+        c->n_cols = n_cols;
+        c->delim = delim;
+        c->start_kind = ks_malloc(sizeof(*c->start_kind) * n_cols);
+        c->cols = ks_malloc(sizeof(*c->cols) * n_cols);
+        for (j = 0; j < n_cols; ++j) {
+            c->start_kind[j] = CSV_INT;
+            c->cols[j] = (csv_col){ .kind = CSV_INT, .vals = NULL, .spans = NULL, .len = 0, .max_len = 0 };
+        }
+        c->n_rows = 0;
+        c->err = CSV_OK;
+
+        start = end;
+    }
+
+    csv_run(n_chunks, chunks);
+
+    // make sure each string column was parsed as strings in every chunk
+    if (n_chunks > 1) {
+        bool again = false;
+        for (j = 0; j < n_cols; ++j) {
+            bool isStr = false;
+            for (i = 0; i < n_chunks; ++i) isStr = isStr || chunks[i].cols[j].kind == CSV_STR;
+            if (isStr) for (i = 0; i < n_chunks; ++i) {
+                if (chunks[i].cols[j].kind != CSV_STR) {
+                    chunks[i].start_kind[j] = CSV_STR;
+                    again = true;
+                }
+            }
+        }
+        if (again) csv_run(n_chunks, chunks);
+    }
+
+    // check for errors, and count the rows
+    nx_size_t n_rows = 0;
+    ks_obj ret = (ks_obj)res;
+    for (i = 0; i < n_chunks; ++i) {
+        if (chunks[i].err != CSV_OK) {
+            int64_t row = n_rows + chunks[i].err_row + (header ? 2 : 1);
+            if (chunks[i].err == CSV_ERR_FIELDS) {
+                ret = ks_throw(ks_T_ArgError, "Invalid CSV: row %l has more than %i fields", row, n_cols);
+            } else {
+                ret = ks_throw(ks_T_ArgError, "Invalid CSV: unterminated or malformed quoted field in row %l", row);
+            }
+            break;
+        }
+        n_rows += chunks[i].n_rows;
+    }
+
+    for (j = 0; ret && j < n_cols; ++j) {
+        ks_obj col = csv_make_col(n_chunks, chunks, j, n_rows);
+        if (!col) {
+            ret = NULL;
+            break;
+        }
+
+        ks_dict_set(res, names->elems[j], col);
+        KS_DECREF(col);
+    }
+
+    for (i = 0; i < n_chunks; ++i) {
+        for (j = 0; j < n_cols; ++j) {
+            ks_free(chunks[i].cols[j].vals);
+            ks_free(chunks[i].cols[j].spans);
+        }
+        ks_free(chunks[i].cols);
+        ks_free(chunks[i].start_kind);
+    }
+    ks_free(chunks);
+    KS_DECREF(names);
+
+    if (!ret) KS_DECREF(res);
+    return ret;
+}
+
+
+// nx.csv(src, delim=',', header=true, threads=1) - read CSV data from 'src' (a file name, an 'ios', or an
+//   object with a buffer, such as 'bytes'), and return a dict of the columns
+static KS_TFUNC(nx, csv) {
+    ks_obj src, header = KSO_TRUE;
+    ks_str delim = NULL;
+    int64_t n_threads = 1;
+    KS_GETARGS("src ?delim:* ?header ?threads:i64", &src, &delim, ks_T_str, &header, &n_threads)
+
+    if (delim && (delim->len_b != 1 || (delim->chr[0] & 0x80) || delim->chr[0] == '"' || delim->chr[0] == '\n')) {
+        return ks_throw(ks_T_ArgError, "'delim' must be a single ASCII character (not a quote or newline)");
+    }
+    char c_delim = delim ? delim->chr[0] : ',';
+
+    int truthy = ks_obj_truthy(header);
+    if (truthy < 0) return NULL;
+
+    ks_obj res;
+    if (src->type == ks_T_ios) {
+        // read the rest of the stream
+        char* data = NULL;
+        ks_ssize_t len = 0, max_len = 0;
+        while (true) {
+            if (max_len - len < NX_CSV_MIN_CHUNK) {
+                max_len = 2 * max_len + NX_CSV_MIN_CHUNK;
+                data = ks_realloc(data, max_len);
+            }
+
+            ks_ssize_t n = ks_ios_readb((ks_ios)src, max_len - len, data + len);
+            if (n < 0) {
+                ks_free(data);
+                return NULL;
+            }
+
+            len += n;
+            if (len < max_len) break;
+        }
+
+        res = csv_read(data, len, c_delim, truthy, n_threads);
+        ks_free(data);
+        return res;
+    }
+
+    // map files, rather than reading them
+    ks_obj bsrc = src;
+    if (src->type == ks_T_str) {
+        ks_str mode = ks_str_new("r");
+        bsrc = (ks_obj)ks_mmap_new((ks_str)src, mode);
+        KS_DECREF(mode);
+        if (!bsrc) return NULL;
+    }
+
+    ks_buffer buf;
+    if (!ks_buffer_get(bsrc, &buf, KS_BUFFER_CONTIG)) {
+        if (bsrc != src) KS_DECREF(bsrc);
+        return NULL;
+    }
+
+    res = csv_read(buf.data, buf.len_b, c_delim, truthy, n_threads);
+
+    ks_buffer_release(&buf);
+    if (bsrc != src) KS_DECREF(bsrc);
+    return res;
+}
+
+
+// add `csv()` to `nxmod`
+void nx_mod_add_csv(ks_module nxmod) {
+
+    ks_dict_set_c(nxmod->attr, KS_KEYVALS(
+
+        {"csv",         (ks_obj)ks_cfunc_new_c_old(nx_csv_, "nx.csv(src, delim=',', header=true, threads=1)")},
+
+    ));
+
+}
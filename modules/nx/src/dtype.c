@@ -129,6 +129,45 @@ nx_dtype nx_dtype_make_cplx(char* name, int bits) {
 }
 
 
+// Return the buffer protocol format for a dtype
+const char* nx_dtype_get_bufmt(nx_dtype self) {
+    if (self->kind == NX_DTYPE_KIND_CINT) {
+        bool sg = self->s_cint.isSigned;
+        switch (self->size) {
+            case 1: return sg ? "b" : "B";
+            case 2: return sg ? "h" : "H";
+            case 4: return sg ? "i" : "I";
+            case 8: return sg ? "q" : "Q";
+        }
+    } else if (self->kind == NX_DTYPE_KIND_CFLOAT) {
+        if (self->size == 4) return "f";
+        if (self->size == 8) return "d";
+    } else if (self->kind == NX_DTYPE_KIND_CCOMPLEX) {
+        if (self->size == 8) return "Zf";
+        if (self->size == 16) return "Zd";
+    }
+    return NULL;
+}
+
+// Return the dtype for a buffer protocol format
+nx_dtype nx_dtype_from_bufmt(const char* fmt) {
+    /**/ if (strcmp(fmt, "b") == 0) return nx_dtype_sint8;
+    else if (strcmp(fmt, "B") == 0) return nx_dtype_uint8;
+    else if (strcmp(fmt, "h") == 0) return nx_dtype_sint16;
+    else if (strcmp(fmt, "H") == 0) return nx_dtype_uint16;
+    else if (strcmp(fmt, "i") == 0) return nx_dtype_sint32;
+    else if (strcmp(fmt, "I") == 0) return nx_dtype_uint32;
+    else if (strcmp(fmt, "q") == 0) return nx_dtype_sint64;
+    else if (strcmp(fmt, "Q") == 0) return nx_dtype_uint64;
+    else if (strcmp(fmt, "f") == 0) return nx_dtype_fp32;
+    else if (strcmp(fmt, "d") == 0) return nx_dtype_fp64;
+    else if (strcmp(fmt, "Zf") == 0) return nx_dtype_cplx_fp32;
+    else if (strcmp(fmt, "Zd") == 0) return nx_dtype_cplx_fp64;
+
+    return ks_throw(ks_T_TypeError, "Unsupported buffer format '%s'", fmt);
+}
+
+
 // dtype.__new__(obj)
 static KS_TFUNC(dtype, new) {
     ks_obj obj;
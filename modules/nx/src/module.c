@@ -117,7 +117,7 @@ static KS_TFUNC(nx, add) {
     ks_list dels = ks_list_new(0, NULL);
 
     // convert them to C arrays
-    if (!nx_get_nxar(aA, &Ar, dels) || !nx_get_nxar(aB, &Br, dels) || (aC && !nx_get_nxar(aC, &Cr, dels))) {
+    if (!nx_get_nxar(aA, &Ar, dels) || !nx_get_nxar(aB, &Br, dels) || (aC && !nx_get_nxar_out(aC, &Cr, dels))) {
         KS_DECREF(dels);
         return NULL;
     }
@@ -187,7 +187,7 @@ static KS_TFUNC(nx, sub) {
     ks_list dels = ks_list_new(0, NULL);
 
     // convert them to C arrays
-    if (!nx_get_nxar(aA, &Ar, dels) || !nx_get_nxar(aB, &Br, dels) || (aC && !nx_get_nxar(aC, &Cr, dels))) {
+    if (!nx_get_nxar(aA, &Ar, dels) || !nx_get_nxar(aB, &Br, dels) || (aC && !nx_get_nxar_out(aC, &Cr, dels))) {
         KS_DECREF(dels);
         return NULL;
     }
@@ -254,7 +254,7 @@ static KS_TFUNC(nx, mul) {
     ks_list dels = ks_list_new(0, NULL);
 
     // convert them to C arrays
-    if (!nx_get_nxar(aA, &Ar, dels) || !nx_get_nxar(aB, &Br, dels) || (aC && !nx_get_nxar(aC, &Cr, dels))) {
+    if (!nx_get_nxar(aA, &Ar, dels) || !nx_get_nxar(aB, &Br, dels) || (aC && !nx_get_nxar_out(aC, &Cr, dels))) {
         KS_DECREF(dels);
         return NULL;
     }
@@ -320,7 +320,7 @@ static KS_TFUNC(nx, div) {
     ks_list dels = ks_list_new(0, NULL);
 
     // convert them to C arrays
-    if (!nx_get_nxar(aA, &Ar, dels) || !nx_get_nxar(aB, &Br, dels) || (aC && !nx_get_nxar(aC, &Cr, dels))) {
+    if (!nx_get_nxar(aA, &Ar, dels) || !nx_get_nxar(aB, &Br, dels) || (aC && !nx_get_nxar_out(aC, &Cr, dels))) {
         KS_DECREF(dels);
         return NULL;
     }
@@ -387,7 +387,7 @@ static KS_TFUNC(nx, pow) {
     ks_list dels = ks_list_new(0, NULL);
 
     // convert them to C arrays
-    if (!nx_get_nxar(aA, &Ar, dels) || !nx_get_nxar(aB, &Br, dels) || (aC && !nx_get_nxar(aC, &Cr, dels))) {
+    if (!nx_get_nxar(aA, &Ar, dels) || !nx_get_nxar(aB, &Br, dels) || (aC && !nx_get_nxar_out(aC, &Cr, dels))) {
         KS_DECREF(dels);
         return NULL;
     }
@@ -455,7 +455,7 @@ static KS_TFUNC(nx, abs) {
     ks_list dels = ks_list_new(0, NULL);
 
     // convert them to C arrays
-    if (!nx_get_nxar(aA, &Ar, dels) || (aB && !nx_get_nxar(aB, &Br, dels))) {
+    if (!nx_get_nxar(aA, &Ar, dels) || (aB && !nx_get_nxar_out(aB, &Br, dels))) {
         KS_DECREF(dels);
         return NULL;
     }
@@ -506,7 +506,7 @@ static ks_module get_module() {
 
     // create enum
 
-    ks_module mod = ks_module_new(MODULE_NAME);
+    ks_module mod = ks_module_new(MODULE_NAME, "Numerics library for tensors, arrays, matrices, etc");
 
     // set up types
     nx_T_init_dtype();
@@ -555,6 +555,8 @@ static ks_module get_module() {
     nx_mod_add_fft(mod);
     nx_mod_add_la(mod);
 
+    nx_mod_add_csv(mod);
+
     return mod;
 }
 
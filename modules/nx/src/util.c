@@ -9,7 +9,8 @@
 #include "../nx-impl.h"
 
 
-bool nx_get_nxar(ks_obj obj, nxar_t* nxar, ks_list refadd) {
+// convert 'obj', requesting buffers with 'flags'
+static bool my_get_nxar(ks_obj obj, nxar_t* nxar, ks_list refadd, int flags) {
 
     if (obj->type == nx_T_array) {
         *nxar = NXAR_ARRAY((nx_array)obj);
@@ -17,6 +18,19 @@ bool nx_get_nxar(ks_obj obj, nxar_t* nxar, ks_list refadd) {
     } else if (obj->type == nx_T_view) {
         *nxar = NXAR_VIEW((nx_view)obj);
         return true;
+    } else if (ks_buffer_has(obj)) {
+        // use the memory of the object directly, through a view that holds the buffer
+        ks_buffer buf;
+        if (!ks_buffer_get(obj, &buf, flags)) return false;
+
+        nx_view view = nx_view_new_buffer(&buf);
+        if (!view) return false;
+
+        *nxar = NXAR_VIEW(view);
+        ks_list_push(refadd, (ks_obj)view);
+        KS_DECREF(view);
+        return true;
+
     } else if (ks_num_is_numeric(obj) || ks_obj_is_iterable(obj)) {
         // convert to object
         nx_array new_arr = nx_array_from_obj(obj, NX_DTYPE_KIND_NONE);
@@ -31,6 +45,38 @@ bool nx_get_nxar(ks_obj obj, nxar_t* nxar, ks_list refadd) {
     }
 }
 
+bool nx_get_nxar(ks_obj obj, nxar_t* nxar, ks_list refadd) {
+    return my_get_nxar(obj, nxar, refadd, KS_BUFFER_NONE);
+}
+
+bool nx_get_nxar_out(ks_obj obj, nxar_t* nxar, ks_list refadd) {
+    return my_get_nxar(obj, nxar, refadd, KS_BUFFER_WRITABLE);
+}
+
+
+bool nx_nxar_getbuf(nxar_t nxar, ks_buffer* buf, int flags) {
+    const char* fmt = nx_dtype_get_bufmt(nxar.dtype);
+    if (!fmt) {
+        ks_throw(ks_T_TypeError, "dtype '%S' has no buffer format", nxar.dtype);
+        return false;
+    }
+
+    buf->owner = nxar.src_obj;
+    buf->data = nxar.data;
+    buf->fmt = fmt;
+    buf->itemsize = nxar.dtype->size;
+    buf->readonly = false;
+    buf->ndim = nxar.rank;
+    buf->shape = nxar.dim;
+    buf->strides = nxar.stride;
+
+    buf->len_b = buf->itemsize;
+    int i;
+    for (i = 0; i < nxar.rank; ++i) buf->len_b *= nxar.dim[i];
+
+    return true;
+}
+
 
 ks_obj nx_nxar_getitem(nxar_t nxar, int N, ks_obj* idxs) {
 
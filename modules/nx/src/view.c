@@ -30,10 +30,32 @@ nx_view nx_view_new(ks_obj ref, nxar_t nxar) {
     }
 
     self->data_src = KS_NEWREF(ref);
+    self->buf.owner = NULL;
 
     return self;
 }
 
+// Create a new view of a buffer
+nx_view nx_view_new_buffer(ks_buffer* buf) {
+    nx_dtype dtype = nx_dtype_from_bufmt(buf->fmt);
+    if (!dtype) {
+        ks_buffer_release(buf);
+        return NULL;
+    }
+
+    nx_view self = nx_view_new(buf->owner, (nxar_t){
+        .data = buf->data,
+        .dtype = dtype,
+        .rank = buf->ndim,
+        .dim = buf->shape,
+        .stride = buf->strides,
+    });
+
+    // NOTE: 'shape' and 'strides' may point into 'buf' itself, but they have already been copied
+    self->buf = *buf;
+    return self;
+}
+
 
 // nx.view.__new__(obj)
 static KS_TFUNC(view, new) {
@@ -45,6 +67,11 @@ static KS_TFUNC(view, new) {
     } else if (obj->type == nx_T_array) {
         nx_array obj_arr = (nx_array)obj;
         return (ks_obj)nx_view_new((ks_obj)obj_arr, NXAR_ARRAY(obj_arr));
+    } else if (ks_buffer_has(obj)) {
+        // view the memory of another object (which must be writable, since views can be assigned to)
+        ks_buffer buf;
+        if (!ks_buffer_get(obj, &buf, KS_BUFFER_WRITABLE)) return NULL;
+        return (ks_obj)nx_view_new_buffer(&buf);
     } else {
         KS_THROW_TYPE_ERR(obj, nx_T_view);
     }
@@ -56,6 +83,7 @@ static KS_TFUNC(view, free) {
     KS_GETARGS("self:*", &self, nx_T_view);
 
     KS_DECREF(self->data_src);
+    ks_buffer_release(&self->buf);
 
     ks_free(self->dim);
     ks_free(self->stride);
@@ -149,6 +177,11 @@ static KS_TFUNC(view, pow) {
     return nx_F_pow->func(n_args, args);
 }
 
+// buffer protocol: the elements the view refers to
+static bool view_getbuf(ks_obj self, ks_buffer* buf, int flags) {
+    return nx_nxar_getbuf(NXAR_VIEW((nx_view)self), buf, flags);
+}
+
 
 void nx_T_init_view() {
 
@@ -168,5 +201,7 @@ void nx_T_init_view() {
         {"__pow__",           (ks_obj)ks_cfunc_new_c_old(view_pow_, "nx.view.__pow__(L, R)")},
     ));
 
+    nx_T_view->getbuf = view_getbuf;
+
 }
 
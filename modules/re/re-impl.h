@@ -0,0 +1,323 @@
+/* modules/re/re-impl.h - the internal implementation header for the 're' (regular expression) module
+ *
+ * A pattern is compiled once into a program ('re_prog') of simple instructions over codepoints, which several
+ *   engines can run directly over the UTF-8 bytes of a string:
+ *
+ *   * A lazily built DFA, whose states are created (and cached in the program) the first time they are reached,
+ *       so repeated searches only cost a table lookup per ASCII byte. It is used whenever the pattern has no
+ *       backreferences or assertions (other than a leading '^'), and finds where a match starts and ends
+ *   * A Pike VM, which runs every thread in lockstep (so it is still linear), and records the position of groups.
+ *       It is used for the groups of a long match the DFA found, and for patterns with assertions
+ *   * A backtracking matcher, which is used for patterns with backreferences, and for the groups of short matches
+ *       (where it remembers which instructions it has tried at each position, so it is also linear)
+ *
+ * Before any of them, a literal prefix (found with `memchr()`), or the set of bytes a match can start with, is used
+ *   to skip over positions that can't start a match
+ *
+ * All positions are byte offsets into the string; converting them to character indices is left to the caller
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#pragma once
+#ifndef RE_IMPL_H__
+#define RE_IMPL_H__
+
+#include <ks.h>
+
+
+/* Tuning/Performance parameters */
+
+// maximum number of instructions in a program
+#define RE_MAX_INST 20000
+
+// maximum number of states each DFA keeps before it is flushed (and rebuilt as it is used)
+#define RE_DFA_MAX_STATES 2048
+
+// maximum number of steps the backtracking matcher may take for one search
+#define RE_BT_MAX_STEPS 50000000
+
+// maximum size (in bits, one per thread state per byte) of a match that the backtracking matcher fills in the groups
+//   of, instead of the Pike VM
+#define RE_BT_MAX_VISITED (256 * 1024)
+
+// maximum nesting of loops whose body may match empty that is told apart when searching. Deeper loops still stop,
+//   but may do so one empty iteration early
+#define RE_MAX_LOOP_DEPTH 8
+
+
+/* Flags (given to `re.compile()`) */
+
+enum {
+    // ASCII letters match both cases
+    RE_IGNORECASE   = 0x01,
+
+    // '^' and '$' also match at the start and end of every line
+    RE_MULTILINE    = 0x02,
+
+    // '.' also matches '\n'
+    RE_DOTALL       = 0x04,
+
+};
+
+
+/* Programs */
+
+// instruction opcodes
+enum {
+    // match the codepoint 'x'
+    RE_OP_CHAR,
+
+    // match any character except '\n'
+    RE_OP_ANY,
+
+    // match any character
+    RE_OP_ANYNL,
+
+    // match a character in class 'x' (an index into 'classes')
+    RE_OP_CLASS,
+
+    // continue at 'x', and then at 'y' (so 'x' is preferred)
+    RE_OP_SPLIT,
+
+    // continue at 'x'
+    RE_OP_JMP,
+
+    // record the current position in capture slot 'x'
+    RE_OP_SAVE,
+
+    // assertions, which don't consume any characters
+    RE_OP_BOL,      // '^'
+    RE_OP_MBOL,     // '^' in multiline mode
+    RE_OP_EOL,      // '$'
+    RE_OP_MEOL,     // '$' in multiline mode
+    RE_OP_BOS,      // '\A'
+    RE_OP_EOS,      // '\Z'
+    RE_OP_WORDB,    // '\b'
+    RE_OP_NWORDB,   // '\B'
+
+    // match the same text as group 'x'
+    RE_OP_BACKREF,
+
+    // the start of an iteration of a loop whose body may match the empty string
+    // Each thread counts the iterations it has started since it last consumed a character (i.e. the loops it is
+    //   going around without having moved), which is how the end of an iteration tells whether it was empty
+    RE_OP_MARK,
+
+    // the end of an iteration of such a loop, which goes around again (at the next instruction) only if it consumed
+    //   something. After an empty iteration, the loop is left (at 'y') instead
+    RE_OP_PROGRESS,
+
+    // the end of a successful match
+    RE_OP_MATCH,
+
+};
+
+// re_inst - a single instruction
+typedef struct {
+
+    // one of the 'RE_OP_*' values
+    int op;
+
+    // arguments (see the opcodes)
+    int x, y;
+
+} re_inst;
+
+// re_class - a set of characters, i.e. '[a-z_]'
+typedef struct {
+
+    // whether the ranges describe the characters that are NOT in the class
+    bool neg;
+
+    // membership of ASCII characters (with 'neg' already applied)
+    uint64_t ascii[2];
+
+    // sorted, non-overlapping, inclusive ranges of codepoints
+    int n_ranges;
+    ks_unich (*ranges)[2];
+
+} re_class;
+
+// how to run a program
+enum {
+    // the match must start at the given position
+    RE_HOW_MATCH,
+
+    // the match may start at or after the given position
+    RE_HOW_SEARCH,
+
+    // the match must start at the given position, and end at the end of the string
+    RE_HOW_FULL,
+
+};
+
+// kinds of DFA
+enum {
+    // the end of the preferred match starting at a given position
+    RE_DFA_FIRST,
+
+    // whether a match starting at a given position reaches the end of the string
+    RE_DFA_FULL,
+
+    // the end of the match that ends first, starting at or after a given position
+    RE_DFA_EARLY,
+
+    RE_DFA_N
+};
+
+// re_dstate - a DFA state, which is the set of program threads (in order of preference) alive at some position
+typedef struct {
+
+    // index of the next state on each ASCII character, or -1 if it has not been computed yet
+    int next[128];
+
+    // whether a match has ended here
+    bool match;
+
+    // the instructions of each thread
+    int n;
+    int pcs[];
+
+} re_dstate;
+
+// re_dfa - a lazily built DFA (for one of the 'RE_DFA_*' kinds)
+typedef struct {
+
+    // the kind of DFA
+    int kind;
+
+    // the states that have been built, and a hash table of their indices (or -1 for empty slots)
+    int n_states;
+    re_dstate** states;
+    int n_table;
+    int* table;
+
+    // index of the initial state, or -1 if it has not been built
+    int start;
+
+    // incremented every time the states are flushed
+    int epoch;
+
+    // scratch space for building a state (the 'stack' and 'mark' have an entry for each state of each instruction,
+    //   see 'loop_depth')
+    int n_buf;
+    int* buf;
+    int* stack;
+    uint32_t* mark;
+    uint32_t gen;
+    bool bmatch, cut;
+
+} re_dfa;
+
+// re_prog - a compiled regular expression
+typedef struct {
+
+    // flags it was compiled with
+    int flags;
+
+    // the instructions, starting at 0
+    int n_inst;
+    re_inst* inst;
+
+    // the character classes used by 'RE_OP_CLASS'
+    int n_classes;
+    re_class* classes;
+
+    // number of groups (not including the entire match, which is group 0)
+    int n_groups;
+
+    // how deeply loops with an 'RE_OP_MARK' are nested (at most 'RE_MAX_LOOP_DEPTH'), so a thread at some
+    //   instruction is in one of 'loop_depth + 1' states
+    int loop_depth;
+
+    // the names of groups, mapping 'str' to 'int', or NULL if no groups were named
+    ks_dict names;
+
+    // whether there are backreferences, or assertions
+    bool has_backref, has_assert;
+
+    // whether the pattern started with '^' (outside of multiline mode), which was removed from the instructions, and
+    //   means a match can only begin at the start of the string
+    bool bol_anchor;
+
+    // if 'n_prefix > 0', the UTF-8 bytes that every match begins with
+    int n_prefix;
+    uint8_t* prefix;
+
+    // if 'has_first', every match begins with a byte in 'first'
+    bool has_first;
+    uint64_t first[4];
+
+    // the DFAs, which are built as they are used (NULL until they are first needed)
+    re_dfa* dfa[RE_DFA_N];
+
+} re_prog;
+
+
+/* Functions */
+
+// Compile 'pattern' with 'flags'
+// NOTE: Returns a new program, or NULL if an error was thrown
+re_prog* re_prog_new(ks_str pattern, int flags);
+
+// Free a program made by `re_prog_new()`
+void re_prog_free(re_prog* prog);
+
+// Run 'prog' on the 'len' bytes of UTF-8 in 'src', starting at the byte offset 'pos' (as described by 'how', one
+//   of the 'RE_HOW_*' values). If a match was found, 'caps' is filled with the start and end of the match and of each
+//   group (so it must have room for `2 * (prog->n_groups + 1)` values), or -1 for groups that did not participate
+// NOTE: Returns 1 if a match was found, 0 if not, or -1 if an error was thrown
+int re_prog_exec(re_prog* prog, const char* src, ks_size_t len, ks_size_t pos, int how, ks_ssize_t* caps);
+
+
+// Decode a single UTF-8 sequence (which must be valid) from 'src' into 'c', and return its length in bytes
+static inline int re_utf8(const uint8_t* src, ks_unich* c) {
+    if (src[0] < 0x80) {
+        *c = src[0];
+        return 1;
+    } else if (src[0] < 0xE0) {
+        *c = ((src[0] & 0x1F) << 6) | (src[1] & 0x3F);
+        return 2;
+    } else if (src[0] < 0xF0) {
+        *c = ((src[0] & 0x0F) << 12) | ((src[1] & 0x3F) << 6) | (src[2] & 0x3F);
+        return 3;
+    } else {
+        *c = ((src[0] & 0x07) << 18) | ((src[1] & 0x3F) << 12) | ((src[2] & 0x3F) << 6) | (src[3] & 0x3F);
+        return 4;
+    }
+}
+
+// Length (in bytes) of the UTF-8 sequence beginning with 'b'
+static inline int re_utf8_len(uint8_t b) {
+    return b < 0x80 ? 1 : b < 0xE0 ? 2 : b < 0xF0 ? 3 : 4;
+}
+
+// Return whether 'c' is in 'cls'
+static inline bool re_class_has(re_class* cls, ks_unich c) {
+    if (c < 128) return (cls->ascii[c >> 6] >> (c & 63)) & 1;
+
+    // binary search the ranges
+    int lo = 0, hi = cls->n_ranges - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (c < cls->ranges[mid][0]) hi = mid - 1;
+        else if (c > cls->ranges[mid][1]) lo = mid + 1;
+        else return !cls->neg;
+    }
+    return cls->neg;
+}
+
+// Return whether instruction 'pc' (which must consume a character) matches 'c'
+static inline bool re_inst_match(re_prog* prog, int pc, ks_unich c) {
+    re_inst* in = &prog->inst[pc];
+    switch (in->op) {
+        case RE_OP_CHAR:  return c == in->x;
+        case RE_OP_ANY:   return c != '\n';
+        case RE_OP_ANYNL: return true;
+        case RE_OP_CLASS: return re_class_has(&prog->classes[in->x], c);
+        default:          return false;
+    }
+}
+
+#endif /* RE_IMPL_H__ */
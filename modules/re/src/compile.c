@@ -0,0 +1,1069 @@
+/* src/compile.c - compiling regular expressions into programs
+ *
+ * The pattern is parsed into a small syntax tree (so repetitions can emit their operand more than once), which is
+ *   then turned into instructions (see 're-impl.h'). Afterwards, the program is inspected for a literal prefix and
+ *   the set of bytes a match can start with, which searches use to skip ahead
+ *
+ * Supported syntax (which is a subset of Python's):
+ *
+ *   * literals, '.', '^', '$', '|', and groups: '(...)', '(?:...)', '(?P<name>...)' (or '(?<name>...)')
+ *   * classes: '[abc]', '[^a-z]', with '\d', '\w' and '\s' (and their negations) inside or outside of them
+ *   * repetition: '*', '+', '?', '{m}', '{m,}', '{m,n}', '{,n}', each of which can be made lazy with a trailing '?'
+ *   * assertions: '\b', '\B', '\A', '\Z'
+ *   * backreferences: '\1' ... '\99', '(?P=name)'
+ *   * escapes: '\n', '\t', '\r', '\f', '\v', '\a', '\0', '\xHH', '\uHHHH', '\UHHHHHHHH', and escaped punctuation
+ *   * flags at the start of the pattern: '(?i)', '(?m)', '(?s)' (or several, like '(?im)')
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#include "../re-impl.h"
+
+
+// maximum nesting of groups
+#define RE_MAX_DEPTH 256
+
+// maximum count in '{m,n}'
+#define RE_MAX_REPEAT 1000
+
+
+/* Syntax Tree */
+
+// kinds of nodes
+enum {
+    N_EMPTY,
+    N_CHAR,     // codepoint 'x'
+    N_ANY,      // '.', which includes '\n' if 'x' is nonzero
+    N_CLASS,    // class 'x'
+    N_CAT,      // children in sequence
+    N_ALT,      // one of the children
+    N_GROUP,    // capturing group 'x' around the child
+    N_REPEAT,   // the child repeated between 'x' and 'y' (or -1 for no limit) times
+    N_ASSERT,   // the assertion with opcode 'x'
+    N_BACKREF,  // backreference to group 'x'
+};
+
+// re_node - a node in the syntax tree
+typedef struct {
+
+    // one of the 'N_*' values
+    int type;
+
+    // arguments (see the kinds of nodes)
+    int x, y;
+
+    // for 'N_REPEAT', whether to prefer more repetitions
+    bool greedy;
+
+    // the first child, and the next sibling, or -1 if there are none
+    int kid, next;
+
+} re_node;
+
+// temporary list of ranges, which becomes a class
+typedef struct {
+    int n, max;
+    ks_unich (*r)[2];
+} re_ranges;
+
+// re_parser - state of the compiler
+typedef struct {
+
+    // the pattern, and the current byte offset into it
+    ks_str pattern;
+    const uint8_t* src;
+    ks_size_t len, pos;
+
+    // the flags that are active
+    int flags;
+
+    // the syntax tree
+    int n_nodes, max_nodes;
+    re_node* nodes;
+
+    // the program being generated
+    re_prog* prog;
+    int max_inst, max_classes;
+
+    // how many loops with an 'RE_OP_MARK' the instructions being generated are inside
+    int loop_nest;
+
+} re_parser;
+
+
+// throw an error at the current position, and return NULL
+static void* re_err(re_parser* p, const char* what) {
+    return ks_throw(ks_T_SyntaxError, "Invalid regex %R: %s (at position %i)", p->pattern, what, (int)ks_text_utf8_len_c(p->pattern->chr, p->pos));
+}
+
+// add a node, and return its index
+static int re_node_new(re_parser* p, int type, int x, int y) {
+    if (p->n_nodes >= p->max_nodes) {
+        p->max_nodes = p->max_nodes * 2 + 16;
+        p->nodes = ks_realloc(p->nodes, sizeof(*p->nodes) * p->max_nodes);
+    }
+    int i = p->n_nodes++;
+    p->nodes[i] = (re_node){ .type = type, .x = x, .y = y, .greedy = true, .kid = -1, .next = -1 };
+    return i;
+}
+
+// append 'kid' to the children of 'node' (whose last child is '*last', or -1)
+static void re_node_add(re_parser* p, int node, int* last, int kid) {
+    if (*last < 0) p->nodes[node].kid = kid;
+    else p->nodes[*last].next = kid;
+    *last = kid;
+}
+
+
+/* Classes */
+
+static void re_ranges_add(re_ranges* rs, ks_unich lo, ks_unich hi) {
+    if (rs->n >= rs->max) {
+        rs->max = rs->max * 2 + 8;
+        rs->r = ks_realloc(rs->r, sizeof(*rs->r) * rs->max);
+    }
+    rs->r[rs->n][0] = lo;
+    rs->r[rs->n][1] = hi;
+    rs->n++;
+}
+
+static int re_range_cmp(const void* A, const void* B) {
+    const ks_unich* a = A, *b = B;
+    return a[0] < b[0] ? -1 : a[0] > b[0] ? 1 : 0;
+}
+
+// sort and merge the ranges
+static void re_ranges_norm(re_ranges* rs) {
+    if (rs->n == 0) return;
+    qsort(rs->r, rs->n, sizeof(*rs->r), re_range_cmp);
+
+    int i, j = 0;
+    for (i = 1; i < rs->n; ++i) {
+        if (rs->r[i][0] <= rs->r[j][1] + 1) {
+            if (rs->r[i][1] > rs->r[j][1]) rs->r[j][1] = rs->r[i][1];
+        } else {
+            j++;
+            rs->r[j][0] = rs->r[i][0];
+            rs->r[j][1] = rs->r[i][1];
+        }
+    }
+    rs->n = j + 1;
+}
+
+// add the members of '\d', '\w' or '\s' (or, for the uppercase letters, the characters that are not members)
+static void re_ranges_add_named(re_ranges* rs, char which) {
+    re_ranges tmp = { 0, 0, NULL };
+    switch (which | 0x20) {
+        case 'd':
+            re_ranges_add(&tmp, '0', '9');
+            break;
+        case 'w':
+            re_ranges_add(&tmp, '0', '9');
+            re_ranges_add(&tmp, 'A', 'Z');
+            re_ranges_add(&tmp, '_', '_');
+            re_ranges_add(&tmp, 'a', 'z');
+            break;
+        case 's':
+            re_ranges_add(&tmp, '\t', '\r');
+            re_ranges_add(&tmp, ' ', ' ');
+            break;
+    }
+
+    if (which >= 'a') {
+        int i;
+        for (i = 0; i < tmp.n; ++i) re_ranges_add(rs, tmp.r[i][0], tmp.r[i][1]);
+    } else {
+        // add the gaps between the (sorted) ranges
+        ks_unich c = 0;
+        int i;
+        for (i = 0; i < tmp.n; ++i) {
+            if (tmp.r[i][0] > c) re_ranges_add(rs, c, tmp.r[i][0] - 1);
+            c = tmp.r[i][1] + 1;
+        }
+        re_ranges_add(rs, c, 0x10FFFF);
+    }
+
+    ks_free(tmp.r);
+}
+
+// turn 'rs' into a class of the program (taking ownership of the ranges), and return its index
+static int re_class_new(re_parser* p, re_ranges* rs, bool neg) {
+    // ASCII letters in the class also match the other case
+    if (p->flags & RE_IGNORECASE) {
+        int i, n = rs->n;
+        for (i = 0; i < n; ++i) {
+            ks_unich lo = rs->r[i][0], hi = rs->r[i][1];
+            if (lo <= 'z' && hi >= 'a') re_ranges_add(rs, (lo > 'a' ? lo : 'a') - 32, (hi < 'z' ? hi : 'z') - 32);
+            if (lo <= 'Z' && hi >= 'A') re_ranges_add(rs, (lo > 'A' ? lo : 'A') + 32, (hi < 'Z' ? hi : 'Z') + 32);
+        }
+    }
+    re_ranges_norm(rs);
+
+    re_prog* prog = p->prog;
+    if (prog->n_classes >= p->max_classes) {
+        p->max_classes = p->max_classes * 2 + 4;
+        prog->classes = ks_realloc(prog->classes, sizeof(*prog->classes) * p->max_classes);
+    }
+
+    int idx = prog->n_classes++;
+    re_class* cls = &prog->classes[idx];
+    cls->neg = neg;
+    cls->n_ranges = rs->n;
+    cls->ranges = rs->r;
+
+    // fill in the table for ASCII (as if negation didn't matter, then flip it)
+    cls->ascii[0] = cls->ascii[1] = 0;
+    int i;
+    for (i = 0; i < rs->n && rs->r[i][0] < 128; ++i) {
+        ks_unich c, hi = rs->r[i][1] < 127 ? rs->r[i][1] : 127;
+        for (c = rs->r[i][0]; c <= hi; ++c) cls->ascii[c >> 6] |= 1ULL << (c & 63);
+    }
+    if (neg) {
+        cls->ascii[0] = ~cls->ascii[0];
+        cls->ascii[1] = ~cls->ascii[1];
+    }
+
+    rs->n = rs->max = 0;
+    rs->r = NULL;
+    return idx;
+}
+
+
+/* Parsing */
+
+static int re_parse_alt(re_parser* p, int depth);
+
+// peek at the next byte (or -1 at the end)
+static int re_peek(re_parser* p) {
+    return p->pos < p->len ? p->src[p->pos] : -1;
+}
+
+// parse hex digits for an escape like '\xHH'
+static bool re_parse_hex(re_parser* p, int n, ks_unich* out) {
+    ks_unich c = 0;
+    int i;
+    for (i = 0; i < n; ++i) {
+        int ch = re_peek(p), v;
+        if (ch >= '0' && ch <= '9') v = ch - '0';
+        else if (ch >= 'a' && ch <= 'f') v = ch - 'a' + 10;
+        else if (ch >= 'A' && ch <= 'F') v = ch - 'A' + 10;
+        else {
+            re_err(p, "incomplete hex escape");
+            return false;
+        }
+        c = c * 16 + v;
+        p->pos++;
+    }
+    if (c > 0x10FFFF) {
+        re_err(p, "hex escape is not a valid codepoint");
+        return false;
+    }
+    *out = c;
+    return true;
+}
+
+// parse an escape that stands for a single character (after the '\'), i.e. '\n', '\x41', '\.'
+static bool re_parse_esc_char(re_parser* p, ks_unich* out) {
+    ks_unich c;
+    p->pos += re_utf8(p->src + p->pos, &c);
+    switch (c) {
+        case 'n': *out = '\n'; return true;
+        case 't': *out = '\t'; return true;
+        case 'r': *out = '\r'; return true;
+        case 'f': *out = '\f'; return true;
+        case 'v': *out = '\v'; return true;
+        case 'a': *out = '\a'; return true;
+        case '0': *out = '\0'; return true;
+        case 'x': return re_parse_hex(p, 2, out);
+        case 'u': return re_parse_hex(p, 4, out);
+        case 'U': return re_parse_hex(p, 8, out);
+    }
+
+    // other ASCII letters and digits are reserved
+    if (c < 128 && ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) {
+        p->pos--;
+        re_err(p, "bad escape");
+        return false;
+    }
+
+    *out = c;
+    return true;
+}
+
+// make a node for the character 'c'
+static int re_char_node(re_parser* p, ks_unich c) {
+    if ((p->flags & RE_IGNORECASE) && c < 128 && ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')) {
+        re_ranges rs = { 0, 0, NULL };
+        re_ranges_add(&rs, c, c);
+        return re_node_new(p, N_CLASS, re_class_new(p, &rs, false), 0);
+    }
+    return re_node_new(p, N_CHAR, c, 0);
+}
+
+// parse a class, after the '['
+static int re_parse_class(re_parser* p) {
+    re_ranges rs = { 0, 0, NULL };
+    bool neg = false;
+    if (re_peek(p) == '^') {
+        neg = true;
+        p->pos++;
+    }
+
+    // a ']' right at the start is a literal
+    bool first = true;
+    while (true) {
+        int ch = re_peek(p);
+        if (ch < 0) {
+            ks_free(rs.r);
+            re_err(p, "unterminated character set");
+            return -1;
+        }
+        if (ch == ']' && !first) {
+            p->pos++;
+            break;
+        }
+        first = false;
+
+        ks_unich lo;
+        if (ch == '\\') {
+            p->pos++;
+            int e = re_peek(p);
+            if (e == 'd' || e == 'D' || e == 'w' || e == 'W' || e == 's' || e == 'S') {
+                p->pos++;
+                re_ranges_add_named(&rs, e);
+                continue;
+            } else if (e < 0) {
+                ks_free(rs.r);
+                re_err(p, "bad escape (end of pattern)");
+                return -1;
+            } else if (e == 'b') {
+                // inside of a class, '\b' is a backspace
+                p->pos++;
+                lo = '\b';
+            } else if (!re_parse_esc_char(p, &lo)) {
+                ks_free(rs.r);
+                return -1;
+            }
+        } else {
+            p->pos += re_utf8(p->src + p->pos, &lo);
+        }
+
+        // check for a range (a '-' right before the ']' is a literal)
+        ks_unich hi = lo;
+        if (re_peek(p) == '-' && p->pos + 1 < p->len && p->src[p->pos + 1] != ']') {
+            p->pos++;
+            if (re_peek(p) == '\\') {
+                p->pos++;
+                if (re_peek(p) < 0 || !re_parse_esc_char(p, &hi)) {
+                    ks_free(rs.r);
+                    if (re_peek(p) < 0) re_err(p, "bad escape (end of pattern)");
+                    return -1;
+                }
+            } else {
+                p->pos += re_utf8(p->src + p->pos, &hi);
+            }
+            if (hi < lo) {
+                ks_free(rs.r);
+                re_err(p, "bad character range");
+                return -1;
+            }
+        }
+        re_ranges_add(&rs, lo, hi);
+    }
+
+    return re_node_new(p, N_CLASS, re_class_new(p, &rs, neg), 0);
+}
+
+// parse a group name (after the '<' or '='), and the terminator 'end'
+static ks_str re_parse_name(re_parser* p, char end) {
+    ks_size_t start = p->pos;
+    while (p->pos < p->len) {
+        int ch = p->src[p->pos];
+        if (ch == '_' || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (p->pos > start && ch >= '0' && ch <= '9')) {
+            p->pos++;
+        } else {
+            break;
+        }
+    }
+    if (p->pos == start || re_peek(p) != end) return re_err(p, "bad group name");
+
+    ks_str name = ks_str_utf8((char*)p->src + start, p->pos - start);
+    p->pos++;
+    return name;
+}
+
+// parse a group, after the '('
+static int re_parse_group(re_parser* p, int depth) {
+    int group = -1;
+
+    if (re_peek(p) == '?') {
+        p->pos++;
+        int ch = re_peek(p);
+        if (ch == ':') {
+            // non-capturing
+            p->pos++;
+        } else if (ch == 'P' && p->pos + 1 < p->len && p->src[p->pos + 1] == '=') {
+            // named backreference, '(?P=name)'
+            p->pos += 2;
+            ks_str name = re_parse_name(p, ')');
+            if (!name) return -1;
+            ks_obj idx = p->prog->names ? ks_dict_get(p->prog->names, (ks_obj)name) : NULL;
+            KS_DECREF(name);
+            if (!idx) {
+                re_err(p, "unknown group name");
+                return -1;
+            }
+            int64_t v;
+            ks_num_get_int64(idx, &v);
+            KS_DECREF(idx);
+            return re_node_new(p, N_BACKREF, (int)v, 0);
+        } else if (ch == '<' || (ch == 'P' && p->pos + 1 < p->len && p->src[p->pos + 1] == '<')) {
+            // named group, '(?P<name>...)' or '(?<name>...)'
+            p->pos += ch == 'P' ? 2 : 1;
+            ks_str name = re_parse_name(p, '>');
+            if (!name) return -1;
+
+            if (!p->prog->names) p->prog->names = ks_dict_new(0, NULL);
+            if (ks_dict_has(p->prog->names, (ks_obj)name)) {
+                KS_DECREF(name);
+                re_err(p, "redefinition of group name");
+                return -1;
+            }
+
+            group = ++p->prog->n_groups;
+            ks_int gi = ks_int_new(group);
+            ks_dict_set(p->prog->names, (ks_obj)name, (ks_obj)gi);
+            KS_DECREF(gi);
+            KS_DECREF(name);
+        } else if (ch == 'i' || ch == 'm' || ch == 's') {
+            // flags, which are only allowed at the start
+            if (p->pos != 2) {
+                re_err(p, "flags must be at the start of the pattern");
+                return -1;
+            }
+            while (true) {
+                ch = re_peek(p);
+                if (ch == 'i') p->flags |= RE_IGNORECASE;
+                else if (ch == 'm') p->flags |= RE_MULTILINE;
+                else if (ch == 's') p->flags |= RE_DOTALL;
+                else if (ch == ')') break;
+                else {
+                    re_err(p, "unknown flag");
+                    return -1;
+                }
+                p->pos++;
+            }
+            p->pos++;
+            return re_node_new(p, N_EMPTY, 0, 0);
+        } else if (ch == '=' || ch == '!' || (ch == '<' && p->pos + 1 < p->len && (p->src[p->pos + 1] == '=' || p->src[p->pos + 1] == '!'))) {
+            re_err(p, "lookaround assertions are not supported");
+            return -1;
+        } else {
+            re_err(p, "unknown extension");
+            return -1;
+        }
+    } else {
+        group = ++p->prog->n_groups;
+    }
+
+    int kid = re_parse_alt(p, depth + 1);
+    if (kid < 0) return -1;
+    if (re_peek(p) != ')') {
+        re_err(p, "missing ), unterminated subpattern");
+        return -1;
+    }
+    p->pos++;
+
+    if (group < 0) return kid;
+
+    int node = re_node_new(p, N_GROUP, group, 0);
+    p->nodes[node].kid = kid;
+    return node;
+}
+
+// parse an atom (a single character, class, group, or assertion)
+static int re_parse_atom(re_parser* p, int depth) {
+    int ch = re_peek(p);
+    switch (ch) {
+        case '(':
+            p->pos++;
+            return re_parse_group(p, depth);
+        case '[':
+            p->pos++;
+            return re_parse_class(p);
+        case '.':
+            p->pos++;
+            return re_node_new(p, N_ANY, (p->flags & RE_DOTALL) != 0, 0);
+        case '^':
+            p->pos++;
+            return re_node_new(p, N_ASSERT, (p->flags & RE_MULTILINE) ? RE_OP_MBOL : RE_OP_BOL, 0);
+        case '$':
+            p->pos++;
+            return re_node_new(p, N_ASSERT, (p->flags & RE_MULTILINE) ? RE_OP_MEOL : RE_OP_EOL, 0);
+        case '*':
+        case '+':
+        case '?':
+            re_err(p, "nothing to repeat");
+            return -1;
+        case '\\':
+            break;
+        default: {
+            ks_unich c;
+            p->pos += re_utf8(p->src + p->pos, &c);
+            return re_char_node(p, c);
+        }
+    }
+
+    // escapes
+    p->pos++;
+    ch = re_peek(p);
+    if (ch < 0) {
+        re_err(p, "bad escape (end of pattern)");
+        return -1;
+    }
+
+    switch (ch) {
+        case 'd': case 'D': case 'w': case 'W': case 's': case 'S': {
+            p->pos++;
+            re_ranges rs = { 0, 0, NULL };
+            re_ranges_add_named(&rs, ch | 0x20);
+            return re_node_new(p, N_CLASS, re_class_new(p, &rs, ch < 'a'), 0);
+        }
+        case 'b':
+            p->pos++;
+            return re_node_new(p, N_ASSERT, RE_OP_WORDB, 0);
+        case 'B':
+            p->pos++;
+            return re_node_new(p, N_ASSERT, RE_OP_NWORDB, 0);
+        case 'A':
+            p->pos++;
+            return re_node_new(p, N_ASSERT, RE_OP_BOS, 0);
+        case 'Z':
+            p->pos++;
+            return re_node_new(p, N_ASSERT, RE_OP_EOS, 0);
+    }
+
+    if (ch >= '1' && ch <= '9') {
+        // backreference (of 1 or 2 digits)
+        int n = ch - '0';
+        p->pos++;
+        if (re_peek(p) >= '0' && re_peek(p) <= '9') n = n * 10 + (p->src[p->pos++] - '0');
+        if (n > p->prog->n_groups) {
+            re_err(p, "invalid group reference");
+            return -1;
+        }
+        return re_node_new(p, N_BACKREF, n, 0);
+    }
+
+    ks_unich c;
+    if (!re_parse_esc_char(p, &c)) return -1;
+    return re_char_node(p, c);
+}
+
+// try to parse a '{m,n}' quantifier (after the '{'), or leave the position alone and return false if it isn't one
+static bool re_parse_braces(re_parser* p, int* min, int* max) {
+    ks_size_t start = p->pos;
+    int lo = -1, hi = -1;
+
+    int v = 0, nd = 0;
+    while (re_peek(p) >= '0' && re_peek(p) <= '9') {
+        if (v <= RE_MAX_REPEAT) v = v * 10 + (p->src[p->pos] - '0');
+        p->pos++;
+        nd++;
+    }
+    if (nd > 0) lo = v;
+
+    if (re_peek(p) == '}') {
+        if (nd == 0) {
+            p->pos = start;
+            return false;
+        }
+        p->pos++;
+        *min = *max = lo;
+        return true;
+    } else if (re_peek(p) != ',') {
+        p->pos = start;
+        return false;
+    }
+    p->pos++;
+
+    v = nd = 0;
+    while (re_peek(p) >= '0' && re_peek(p) <= '9') {
+        if (v <= RE_MAX_REPEAT) v = v * 10 + (p->src[p->pos] - '0');
+        p->pos++;
+        nd++;
+    }
+    if (nd > 0) hi = v;
+
+    if (re_peek(p) != '}') {
+        p->pos = start;
+        return false;
+    }
+    p->pos++;
+
+    *min = lo < 0 ? 0 : lo;
+    *max = hi;
+    return true;
+}
+
+// parse an atom, and any quantifiers after it
+static int re_parse_repeat(re_parser* p, int depth) {
+    int node = re_parse_atom(p, depth);
+    if (node < 0) return -1;
+
+    bool quantified = false;
+    while (true) {
+        int ch = re_peek(p), min, max;
+        ks_size_t start = p->pos;
+        if (ch == '*') {
+            p->pos++;
+            min = 0; max = -1;
+        } else if (ch == '+') {
+            p->pos++;
+            min = 1; max = -1;
+        } else if (ch == '?') {
+            p->pos++;
+            min = 0; max = 1;
+        } else if (ch == '{') {
+            p->pos++;
+            if (!re_parse_braces(p, &min, &max)) {
+                // just a literal '{'
+                p->pos = start;
+                break;
+            }
+        } else {
+            break;
+        }
+
+        if (quantified) {
+            p->pos = start;
+            re_err(p, "multiple repeat");
+            return -1;
+        }
+        if (p->nodes[node].type == N_ASSERT || p->nodes[node].type == N_EMPTY) {
+            p->pos = start;
+            re_err(p, "nothing to repeat");
+            return -1;
+        }
+        if (min > RE_MAX_REPEAT || max > RE_MAX_REPEAT) {
+            p->pos = start;
+            re_err(p, "repetition count is too large");
+            return -1;
+        }
+        if (max >= 0 && max < min) {
+            p->pos = start;
+            re_err(p, "min repeat greater than max repeat");
+            return -1;
+        }
+
+        int rep = re_node_new(p, N_REPEAT, min, max);
+        p->nodes[rep].kid = node;
+        if (re_peek(p) == '?') {
+            p->pos++;
+            p->nodes[rep].greedy = false;
+        }
+        node = rep;
+        quantified = true;
+    }
+
+    return node;
+}
+
+// parse a sequence of atoms
+static int re_parse_cat(re_parser* p, int depth) {
+    int node = re_node_new(p, N_CAT, 0, 0), last = -1;
+    while (p->pos < p->len && p->src[p->pos] != '|' && p->src[p->pos] != ')') {
+        int kid = re_parse_repeat(p, depth);
+        if (kid < 0) return -1;
+        re_node_add(p, node, &last, kid);
+    }
+    return node;
+}
+
+// parse alternatives, separated by '|'
+static int re_parse_alt(re_parser* p, int depth) {
+    if (depth > RE_MAX_DEPTH) {
+        re_err(p, "too many nested groups");
+        return -1;
+    }
+
+    int first = re_parse_cat(p, depth);
+    if (first < 0 || re_peek(p) != '|') return first;
+
+    int node = re_node_new(p, N_ALT, 0, 0), last = -1;
+    re_node_add(p, node, &last, first);
+    while (re_peek(p) == '|') {
+        p->pos++;
+        int kid = re_parse_cat(p, depth);
+        if (kid < 0) return -1;
+        re_node_add(p, node, &last, kid);
+    }
+    return node;
+}
+
+
+/* Generating Instructions */
+
+// add an instruction, and return its index (or -1 if an error was thrown)
+static int re_emit(re_parser* p, int op, int x, int y) {
+    re_prog* prog = p->prog;
+    if (prog->n_inst >= RE_MAX_INST) {
+        ks_throw(ks_T_SizeError, "Regex %R is too large (more than %i instructions)", p->pattern, RE_MAX_INST);
+        return -1;
+    }
+    if (prog->n_inst >= p->max_inst) {
+        p->max_inst = p->max_inst * 2 + 16;
+        prog->inst = ks_realloc(prog->inst, sizeof(*prog->inst) * p->max_inst);
+    }
+
+    int i = prog->n_inst++;
+    prog->inst[i] = (re_inst){ .op = op, .x = x, .y = y };
+    return i;
+}
+
+// whether 'node' can match the empty string
+static bool re_nullable(re_parser* p, int node) {
+    re_node* N = &p->nodes[node];
+    int kid;
+
+    switch (N->type) {
+        case N_CHAR:
+        case N_ANY:
+        case N_CLASS:
+            return false;
+        case N_CAT:
+            for (kid = N->kid; kid >= 0; kid = p->nodes[kid].next) {
+                if (!re_nullable(p, kid)) return false;
+            }
+            return true;
+        case N_ALT:
+            for (kid = N->kid; kid >= 0; kid = p->nodes[kid].next) {
+                if (re_nullable(p, kid)) return true;
+            }
+            return false;
+        case N_GROUP:
+            return re_nullable(p, N->kid);
+        case N_REPEAT:
+            return N->x == 0 || re_nullable(p, N->kid);
+        default:
+            // empty, assertions, and backreferences (which may refer to an empty group)
+            return true;
+    }
+}
+
+static bool re_gen_loop(re_parser* p, int kid, int* prog_pc);
+
+// generate instructions for 'node'
+static bool re_gen(re_parser* p, int node) {
+    re_node* N = &p->nodes[node];
+    re_inst* inst;
+    int i, kid;
+
+    switch (N->type) {
+        case N_EMPTY:
+            return true;
+        case N_CHAR:
+            return re_emit(p, RE_OP_CHAR, N->x, 0) >= 0;
+        case N_ANY:
+            return re_emit(p, N->x ? RE_OP_ANYNL : RE_OP_ANY, 0, 0) >= 0;
+        case N_CLASS:
+            return re_emit(p, RE_OP_CLASS, N->x, 0) >= 0;
+        case N_ASSERT:
+            return re_emit(p, N->x, 0, 0) >= 0;
+        case N_BACKREF:
+            return re_emit(p, RE_OP_BACKREF, N->x, 0) >= 0;
+
+        case N_CAT:
+            for (kid = N->kid; kid >= 0; kid = p->nodes[kid].next) {
+                if (!re_gen(p, kid)) return false;
+            }
+            return true;
+
+        case N_GROUP:
+            if (re_emit(p, RE_OP_SAVE, 2 * N->x, 0) < 0) return false;
+            if (!re_gen(p, N->kid)) return false;
+            return re_emit(p, RE_OP_SAVE, 2 * N->x + 1, 0) >= 0;
+
+        case N_ALT: {
+            // each alternative (but the last) is 'SPLIT next, other; <alternative>; JMP end', and the jumps are
+            //   chained through their 'x' until the end is known
+            int jumps = -1;
+            for (kid = N->kid; kid >= 0; kid = p->nodes[kid].next) {
+                if (p->nodes[kid].next < 0) {
+                    if (!re_gen(p, kid)) return false;
+                    break;
+                }
+                int sp = re_emit(p, RE_OP_SPLIT, 0, 0);
+                if (sp < 0 || !re_gen(p, kid)) return false;
+                int jmp = re_emit(p, RE_OP_JMP, jumps, 0);
+                if (jmp < 0) return false;
+                jumps = jmp;
+
+                inst = &p->prog->inst[sp];
+                inst->x = sp + 1;
+                inst->y = p->prog->n_inst;
+            }
+            while (jumps >= 0) {
+                inst = &p->prog->inst[jumps];
+                jumps = inst->x;
+                inst->x = p->prog->n_inst;
+            }
+            return true;
+        }
+
+        case N_REPEAT: {
+            int min = N->x, max = N->y, sp;
+            bool greedy = N->greedy;
+            kid = N->kid;
+
+            // if the body can match empty, an iteration that consumes nothing ends the loop, or else a backtracking
+            //   search could go around it forever without moving
+            bool loop = max < 0 && re_nullable(p, kid);
+            int prog_pc = -1;
+
+            if (max < 0 && min > 0) {
+                // 'min - 1' copies, then 'L: <kid>; SPLIT L, next'
+                for (i = 0; i < min - 1; ++i) {
+                    if (!re_gen(p, kid)) return false;
+                }
+                int L = p->prog->n_inst;
+                if (!(loop ? re_gen_loop(p, kid, &prog_pc) : re_gen(p, kid))) return false;
+                if ((sp = re_emit(p, RE_OP_SPLIT, 0, 0)) < 0) return false;
+                inst = &p->prog->inst[sp];
+                inst->x = greedy ? L : sp + 1;
+                inst->y = greedy ? sp + 1 : L;
+                if (loop) p->prog->inst[prog_pc].y = sp + 1;
+                return true;
+            } else if (max < 0) {
+                // 'L: SPLIT body, next; body: <kid>; JMP L'
+                if ((sp = re_emit(p, RE_OP_SPLIT, 0, 0)) < 0) return false;
+                if (!(loop ? re_gen_loop(p, kid, &prog_pc) : re_gen(p, kid))) return false;
+                if (re_emit(p, RE_OP_JMP, sp, 0) < 0) return false;
+                inst = &p->prog->inst[sp];
+                inst->x = greedy ? sp + 1 : p->prog->n_inst;
+                inst->y = greedy ? p->prog->n_inst : sp + 1;
+                if (loop) p->prog->inst[prog_pc].y = p->prog->n_inst;
+                return true;
+            }
+
+            // 'min' copies, then 'max - min' optional copies, which all skip to the end
+            for (i = 0; i < min; ++i) {
+                if (!re_gen(p, kid)) return false;
+            }
+            int first = p->prog->n_inst;
+            for (i = min; i < max; ++i) {
+                if (re_emit(p, RE_OP_SPLIT, -1, 0) < 0) return false;
+                if (!re_gen(p, kid)) return false;
+            }
+
+            // the optional copies may contain other splits, so find the ones that were added here (which have
+            //   an 'x' of -1)
+            int end = p->prog->n_inst;
+            for (i = first; i < end; ++i) {
+                inst = &p->prog->inst[i];
+                if (inst->op == RE_OP_SPLIT && inst->x == -1) {
+                    inst->x = greedy ? i + 1 : end;
+                    inst->y = greedy ? end : i + 1;
+                }
+            }
+            return true;
+        }
+    }
+
+    return true;
+}
+
+// generate 'MARK; <kid>; PROGRESS' for the body of a loop that may match empty, and set '*prog_pc' to the
+//   'RE_OP_PROGRESS' (whose exit the caller fills in)
+static bool re_gen_loop(re_parser* p, int kid, int* prog_pc) {
+    if (re_emit(p, RE_OP_MARK, 0, 0) < 0) return false;
+
+    p->loop_nest++;
+    if (p->loop_nest > p->prog->loop_depth && p->loop_nest <= RE_MAX_LOOP_DEPTH) p->prog->loop_depth = p->loop_nest;
+    bool ok = re_gen(p, kid);
+    p->loop_nest--;
+
+    return ok && (*prog_pc = re_emit(p, RE_OP_PROGRESS, 0, 0)) >= 0;
+}
+
+
+/* Analysis */
+
+// find the literal prefix, and the set of first bytes of matches
+static void re_analyze(re_prog* prog) {
+    int pc, i;
+
+    for (pc = 0; pc < prog->n_inst; ++pc) {
+        int op = prog->inst[pc].op;
+        if (op == RE_OP_BACKREF) prog->has_backref = true;
+        else if (op >= RE_OP_BOL && op <= RE_OP_NWORDB) prog->has_assert = true;
+    }
+
+    // literal prefix: the characters on the path from the start, up until the first branch
+    uint8_t pre[64];
+    int n_pre = 0;
+    pc = 0;
+    while (pc < prog->n_inst) {
+        re_inst* in = &prog->inst[pc];
+        if (in->op == RE_OP_SAVE) {
+            pc++;
+        } else if (in->op == RE_OP_CHAR && n_pre + 4 <= (int)sizeof(pre)) {
+            n_pre += ks_text_utf32_to_utf8(&in->x, (char*)pre + n_pre, 1);
+            pc++;
+        } else {
+            break;
+        }
+    }
+    if (n_pre > 0) {
+        prog->n_prefix = n_pre;
+        prog->prefix = ks_malloc(n_pre);
+        memcpy(prog->prefix, pre, n_pre);
+        return;
+    }
+
+    // first bytes: the characters that can be reached from the start, without consuming anything
+    int* stack = ks_malloc(sizeof(*stack) * (2 * prog->n_inst + 1));
+    bool* seen = ks_malloc(sizeof(*seen) * prog->n_inst);
+    memset(seen, 0, sizeof(*seen) * prog->n_inst);
+    memset(prog->first, 0, sizeof(prog->first));
+
+    bool ok = true;
+    int sp = 0;
+    stack[sp++] = 0;
+    while (ok && sp > 0) {
+        pc = stack[--sp];
+        if (seen[pc]) continue;
+        seen[pc] = true;
+
+        re_inst* in = &prog->inst[pc];
+        switch (in->op) {
+            case RE_OP_SPLIT:
+                stack[sp++] = in->y;
+                stack[sp++] = in->x;
+                break;
+            case RE_OP_JMP:
+                stack[sp++] = in->x;
+                break;
+            case RE_OP_PROGRESS:
+                stack[sp++] = in->y;
+                stack[sp++] = pc + 1;
+                break;
+            case RE_OP_CHAR: {
+                char u[4];
+                ks_text_utf32_to_utf8(&in->x, u, 1);
+                uint8_t b = u[0];
+                prog->first[b >> 6] |= 1ULL << (b & 63);
+                break;
+            }
+            case RE_OP_CLASS: {
+                re_class* cls = &prog->classes[in->x];
+                prog->first[0] |= cls->ascii[0];
+                prog->first[1] |= cls->ascii[1];
+
+                // any lead byte of a non-ASCII character may start a match
+                if (cls->neg || (cls->n_ranges > 0 && cls->ranges[cls->n_ranges - 1][1] >= 128)) {
+                    for (i = 0xC2; i <= 0xF4; ++i) prog->first[i >> 6] |= 1ULL << (i & 63);
+                }
+                break;
+            }
+            case RE_OP_ANY:
+            case RE_OP_ANYNL:
+            case RE_OP_BACKREF:
+            case RE_OP_MATCH:
+                // could start with almost anything (or nothing at all)
+                ok = false;
+                break;
+            default:
+                // saves and assertions don't consume anything
+                stack[sp++] = pc + 1;
+                break;
+        }
+    }
+
+    if (ok) {
+        int ct = 0;
+        for (i = 0; i < 4; ++i) ct += __builtin_popcountll(prog->first[i]);
+        prog->has_first = ct < 200;
+    }
+
+    ks_free(stack);
+    ks_free(seen);
+}
+
+
+/* Export */
+
+re_prog* re_prog_new(ks_str pattern, int flags) {
+    re_prog* prog = ks_malloc(sizeof(*prog));
+    memset(prog, 0, sizeof(*prog));
+
+    re_parser p;
+    p.pattern = pattern;
+    p.src = (const uint8_t*)pattern->chr;
+    p.len = pattern->len_b;
+    p.pos = 0;
+    p.flags = flags;
+    p.n_nodes = p.max_nodes = 0;
+    p.nodes = NULL;
+    p.prog = prog;
+    p.max_inst = p.max_classes = 0;
+    p.loop_nest = 0;
+
+    int root = re_parse_alt(&p, 0);
+    if (root >= 0 && p.pos < p.len) {
+        // only a ')' can stop the parser early
+        re_err(&p, "unbalanced parenthesis");
+        root = -1;
+    }
+    if (root < 0) {
+        ks_free(p.nodes);
+        re_prog_free(prog);
+        return NULL;
+    }
+
+    // inline flags count as if they were given
+    prog->flags = p.flags;
+
+    // a leading '^' means the match can only start at the beginning, which the searches handle instead
+    re_node* R = &p.nodes[root];
+    if (R->type == N_CAT && R->kid >= 0 && p.nodes[R->kid].type == N_EMPTY) R->kid = p.nodes[R->kid].next;
+    if (R->type == N_ASSERT && R->x == RE_OP_BOL) {
+        prog->bol_anchor = true;
+        R->type = N_EMPTY;
+    } else if (R->type == N_CAT && R->kid >= 0 && p.nodes[R->kid].type == N_ASSERT && p.nodes[R->kid].x == RE_OP_BOL) {
+        prog->bol_anchor = true;
+        R->kid = p.nodes[R->kid].next;
+    }
+
+    bool ok = re_emit(&p, RE_OP_SAVE, 0, 0) >= 0 && re_gen(&p, root) && re_emit(&p, RE_OP_SAVE, 1, 0) >= 0 && re_emit(&p, RE_OP_MATCH, 0, 0) >= 0;
+    ks_free(p.nodes);
+    if (!ok) {
+        re_prog_free(prog);
+        return NULL;
+    }
+
+    re_analyze(prog);
+    return prog;
+}
+
+void re_prog_free(re_prog* prog) {
+    int i, j;
+    for (i = 0; i < RE_DFA_N; ++i) {
+        re_dfa* d = prog->dfa[i];
+        if (!d) continue;
+        for (j = 0; j < d->n_states; ++j) ks_free(d->states[j]);
+        ks_free(d->states);
+        ks_free(d->table);
+        ks_free(d->buf);
+        ks_free(d->stack);
+        ks_free(d->mark);
+        ks_free(d);
+    }
+
+    for (i = 0; i < prog->n_classes; ++i) ks_free(prog->classes[i].ranges);
+    ks_free(prog->classes);
+    ks_free(prog->inst);
+    ks_free(prog->prefix);
+    if (prog->names) KS_DECREF(prog->names);
+    ks_free(prog);
+}
@@ -0,0 +1,634 @@
+/* src/exec.c - running compiled programs (see 're-impl.h' for the engines)
+ *
+ * The DFA is built lazily: each state is the ordered list of threads (instructions waiting for a character) that
+ *   are alive at a position, and the transition for a character is computed the first time it is taken. Transitions
+ *   on ASCII bytes are stored in the state, so after a warm-up the inner loop is one table lookup per byte; other
+ *   characters are decoded and computed each time (which is no slower than the Pike VM). When too many states have
+ *   been built, they are all thrown away, and rebuilt as they are used
+ *
+ * Threads are kept in order of preference, so a match that is found cuts off the threads after it. That makes the
+ *   DFA (and the Pike VM) find the same match a backtracking matcher would, rather than the longest one
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#include "../re-impl.h"
+
+
+/* Prefilter */
+
+// return the first position at or after 'i' where a match could begin, or -1 if there is none
+static ks_ssize_t re_skip(re_prog* prog, const uint8_t* s, ks_size_t len, ks_size_t i) {
+    if (prog->n_prefix > 0) {
+        int n = prog->n_prefix;
+        while (i + n <= len) {
+            const uint8_t* p = memchr(s + i, prog->prefix[0], len - n - i + 1);
+            if (!p) return -1;
+            if (memcmp(p + 1, prog->prefix + 1, n - 1) == 0) return p - s;
+            i = p - s + 1;
+        }
+        return -1;
+    } else if (prog->has_first) {
+        for (; i < len; ++i) {
+            if ((prog->first[s[i] >> 6] >> (s[i] & 63)) & 1) return i;
+        }
+        return -1;
+    }
+
+    return i;
+}
+
+
+/* Assertions */
+
+// whether the byte 'b' is part of a word (only ASCII characters are)
+static inline bool re_isword(uint8_t b) {
+    return b == '_' || (b >= '0' && b <= '9') || ((b | 0x20) >= 'a' && (b | 0x20) <= 'z');
+}
+
+// whether the assertion 'op' holds at position 'i'
+static bool re_assert(int op, const uint8_t* s, ks_size_t len, ks_size_t i) {
+    bool a, b;
+    switch (op) {
+        case RE_OP_BOL:
+        case RE_OP_BOS:
+            return i == 0;
+        case RE_OP_MBOL:
+            return i == 0 || s[i - 1] == '\n';
+        case RE_OP_EOL:
+            return i == len || (i + 1 == len && s[i] == '\n');
+        case RE_OP_MEOL:
+            return i == len || s[i] == '\n';
+        case RE_OP_EOS:
+            return i == len;
+        case RE_OP_WORDB:
+        case RE_OP_NWORDB:
+            a = i > 0 && re_isword(s[i - 1]);
+            b = i < len && re_isword(s[i]);
+            return (a != b) == (op == RE_OP_WORDB);
+    }
+    return false;
+}
+
+
+/* DFA */
+
+// get (or create) the DFA of 'kind'
+static re_dfa* re_dfa_get(re_prog* prog, int kind) {
+    re_dfa* d = prog->dfa[kind];
+    if (d) return d;
+
+    d = prog->dfa[kind] = ks_malloc(sizeof(*d));
+    d->kind = kind;
+    d->n_states = 0;
+    d->states = ks_malloc(sizeof(*d->states) * RE_DFA_MAX_STATES);
+    d->n_table = 2 * RE_DFA_MAX_STATES;
+    d->table = ks_malloc(sizeof(*d->table) * d->n_table);
+    memset(d->table, 0xFF, sizeof(*d->table) * d->n_table);
+    d->start = -1;
+    d->epoch = 0;
+
+    int n = prog->n_inst * (prog->loop_depth + 1);
+    d->n_buf = 0;
+    d->buf = ks_malloc(sizeof(*d->buf) * prog->n_inst);
+    d->stack = ks_malloc(sizeof(*d->stack) * (2 * n + 1));
+    d->mark = ks_malloc(sizeof(*d->mark) * n);
+    memset(d->mark, 0, sizeof(*d->mark) * n);
+    d->gen = 0;
+
+    return d;
+}
+
+// throw away every state
+static void re_dfa_flush(re_dfa* d) {
+    int i;
+    for (i = 0; i < d->n_states; ++i) ks_free(d->states[i]);
+    d->n_states = 0;
+    memset(d->table, 0xFF, sizeof(*d->table) * d->n_table);
+    d->start = -1;
+    d->epoch++;
+}
+
+// begin building a new state
+static void re_dfa_begin(re_prog* prog, re_dfa* d) {
+    d->n_buf = 0;
+    d->bmatch = d->cut = false;
+    if (++d->gen == 0) {
+        memset(d->mark, 0, sizeof(*d->mark) * prog->n_inst * (prog->loop_depth + 1));
+        d->gen = 1;
+    }
+}
+
+// return the state of a thread at 'pc', which has started 'c' loop iterations without consuming anything (see
+//   'RE_OP_MARK'), as a single index
+// NOTE: what a thread does once it consumes a character (or matches) doesn't depend on 'c', so those instructions
+//   only have one state
+static inline int re_tstate(re_prog* prog, int pc, int c) {
+    int op = prog->inst[pc].op;
+    if (op <= RE_OP_CLASS || op == RE_OP_MATCH) c = 0;
+    else if (c > prog->loop_depth) c = prog->loop_depth;
+    return pc * (prog->loop_depth + 1) + c;
+}
+
+// add the threads reachable from 'pc' (without consuming anything) to the state being built, in order of preference
+static void re_dfa_add(re_prog* prog, re_dfa* d, int pc) {
+    int nc = prog->loop_depth + 1, sp = 0;
+    d->stack[sp++] = re_tstate(prog, pc, 0);
+    while (sp > 0 && !d->cut) {
+        int st = d->stack[--sp];
+        if (d->mark[st] == d->gen) continue;
+        d->mark[st] = d->gen;
+
+        pc = st / nc;
+        int c = st % nc;
+        re_inst* in = &prog->inst[pc];
+        switch (in->op) {
+            case RE_OP_SPLIT:
+                d->stack[sp++] = re_tstate(prog, in->y, c);
+                d->stack[sp++] = re_tstate(prog, in->x, c);
+                break;
+            case RE_OP_JMP:
+                d->stack[sp++] = re_tstate(prog, in->x, c);
+                break;
+            case RE_OP_SAVE:
+                d->stack[sp++] = re_tstate(prog, pc + 1, c);
+                break;
+            case RE_OP_MARK:
+                d->stack[sp++] = re_tstate(prog, pc + 1, c + 1);
+                break;
+            case RE_OP_PROGRESS:
+                // nothing is consumed while a state is built, so the iteration was empty if it began here
+                d->stack[sp++] = c > 0 ? re_tstate(prog, in->y, c - 1) : re_tstate(prog, pc + 1, 0);
+                break;
+            case RE_OP_MATCH:
+                d->bmatch = true;
+                // less preferred threads can never be chosen over this match
+                if (d->kind == RE_DFA_FIRST) d->cut = true;
+                break;
+            default:
+                d->buf[d->n_buf++] = pc;
+                break;
+        }
+    }
+}
+
+// find (or create) the state that was built, and return its index
+static int re_dfa_intern(re_dfa* d) {
+    uint32_t h = 2166136261u ^ d->bmatch;
+    int i;
+    for (i = 0; i < d->n_buf; ++i) h = (h ^ (uint32_t)d->buf[i]) * 16777619u;
+
+    int mask = d->n_table - 1, j = h & mask;
+    while (d->table[j] >= 0) {
+        re_dstate* s = d->states[d->table[j]];
+        if (s->match == d->bmatch && s->n == d->n_buf && memcmp(s->pcs, d->buf, sizeof(*d->buf) * d->n_buf) == 0) return d->table[j];
+        j = (j + 1) & mask;
+    }
+
+    if (d->n_states >= RE_DFA_MAX_STATES) {
+        re_dfa_flush(d);
+        j = h & mask;
+    }
+
+    re_dstate* s = ks_malloc(sizeof(*s) + sizeof(*s->pcs) * d->n_buf);
+    memset(s->next, 0xFF, sizeof(s->next));
+    s->match = d->bmatch;
+    s->n = d->n_buf;
+    memcpy(s->pcs, d->buf, sizeof(*d->buf) * d->n_buf);
+
+    int idx = d->n_states++;
+    d->states[idx] = s;
+    d->table[j] = idx;
+    return idx;
+}
+
+// return the index of the initial state
+static int re_dfa_start(re_prog* prog, re_dfa* d) {
+    if (d->start < 0) {
+        re_dfa_begin(prog, d);
+        re_dfa_add(prog, d, 0);
+        int st = re_dfa_intern(d);
+        d->start = st;
+    }
+    return d->start;
+}
+
+// compute the state after state 'si' reads 'c', and return its index
+static int re_dfa_step(re_prog* prog, re_dfa* d, int si, ks_unich c) {
+    re_dstate* s = d->states[si];
+    int epoch = d->epoch, i;
+
+    re_dfa_begin(prog, d);
+    for (i = 0; i < s->n && !d->cut; ++i) {
+        if (re_inst_match(prog, s->pcs[i], c)) re_dfa_add(prog, d, s->pcs[i] + 1);
+    }
+
+    // a new match may begin at every position (and is the least preferred)
+    if (d->kind == RE_DFA_EARLY) re_dfa_add(prog, d, 0);
+
+    int ns = re_dfa_intern(d);
+
+    // 's' is only still valid if the states were not flushed
+    if (c < 128 && d->epoch == epoch) s->next[c] = ns;
+    return ns;
+}
+
+// run the DFA of 'kind' from 'pos', and return:
+//   * RE_DFA_FIRST: the end of the preferred match
+//   * RE_DFA_FULL: 'len', if there is a match that ends there
+//   * RE_DFA_EARLY: the end of the match that ends first
+// Or, -1 if there was no such match
+static ks_ssize_t re_dfa_run(re_prog* prog, int kind, const uint8_t* s, ks_size_t len, ks_size_t pos) {
+    re_dfa* d = re_dfa_get(prog, kind);
+    int si = re_dfa_start(prog, d);
+    re_dstate* st = d->states[si];
+
+    ks_ssize_t last = -1;
+    if (st->match) {
+        if (kind == RE_DFA_EARLY) return pos;
+        last = pos;
+    }
+
+    ks_size_t i = pos;
+    while (i < len && st->n > 0) {
+        uint8_t b = s[i];
+        if (b < 0x80) {
+            int ns = st->next[b];
+            si = ns >= 0 ? ns : re_dfa_step(prog, d, si, b);
+            i++;
+        } else {
+            ks_unich c;
+            i += re_utf8(s + i, &c);
+            si = re_dfa_step(prog, d, si, c);
+        }
+
+        st = d->states[si];
+        if (st->match) {
+            if (kind == RE_DFA_EARLY) return i;
+            last = i;
+        }
+    }
+
+    if (kind == RE_DFA_FULL) return (i == len && st->match) ? (ks_ssize_t)len : -1;
+    return last;
+}
+
+
+/* Pike VM */
+
+// re_tlist - a list of threads (which are waiting for a character, or have matched), in order of preference
+typedef struct {
+    int n;
+    int* pcs;
+
+    // the capture slots of each thread
+    ks_ssize_t* caps;
+
+    // the states (see `re_tstate()`) that were reached while filling the list, which are the ones whose 'seen'
+    //   entry is 'gen'
+    uint32_t* seen;
+    uint32_t gen;
+
+} re_tlist;
+
+// empty 'l' (of a program with 'n' thread states), so it can be filled at another position
+static void re_tlist_clear(re_tlist* l, int n) {
+    l->n = 0;
+    if (++l->gen == 0) {
+        memset(l->seen, 0, sizeof(*l->seen) * n);
+        l->gen = 1;
+    }
+}
+
+// state of the Pike VM
+typedef struct {
+    re_prog* prog;
+    const uint8_t* s;
+    ks_size_t len;
+    int nsave;
+} re_pike;
+
+// add the thread at 'pc' (with captures 'cap', and which has started 'c' loop iterations at position 'i'), and the
+//   threads reachable from it, to 'l'
+static void re_pike_add(re_pike* vm, re_tlist* l, int pc, int c, ks_ssize_t* cap, ks_size_t i) {
+    int st = re_tstate(vm->prog, pc, c);
+    if (l->seen[st] == l->gen) return;
+    l->seen[st] = l->gen;
+
+    re_inst* in = &vm->prog->inst[pc];
+    int k;
+    switch (in->op) {
+        case RE_OP_SPLIT:
+            re_pike_add(vm, l, in->x, c, cap, i);
+            re_pike_add(vm, l, in->y, c, cap, i);
+            break;
+        case RE_OP_JMP:
+            re_pike_add(vm, l, in->x, c, cap, i);
+            break;
+        case RE_OP_SAVE: {
+            ks_ssize_t old = cap[in->x];
+            cap[in->x] = i;
+            re_pike_add(vm, l, pc + 1, c, cap, i);
+            cap[in->x] = old;
+            break;
+        }
+        case RE_OP_MARK:
+            re_pike_add(vm, l, pc + 1, c + 1, cap, i);
+            break;
+        case RE_OP_PROGRESS:
+            if (c > 0) re_pike_add(vm, l, in->y, c - 1, cap, i);
+            else re_pike_add(vm, l, pc + 1, 0, cap, i);
+            break;
+        case RE_OP_CHAR:
+        case RE_OP_ANY:
+        case RE_OP_ANYNL:
+        case RE_OP_CLASS:
+        case RE_OP_MATCH:
+            k = l->n++;
+            l->pcs[k] = pc;
+            memcpy(l->caps + (ks_size_t)k * vm->nsave, cap, sizeof(*cap) * vm->nsave);
+            break;
+        default:
+            if (re_assert(in->op, vm->s, vm->len, i)) re_pike_add(vm, l, pc + 1, c, cap, i);
+            break;
+    }
+}
+
+static int re_pike_exec(re_prog* prog, const uint8_t* s, ks_size_t len, ks_size_t pos, int how, ks_ssize_t* caps) {
+    re_pike vm = { prog, s, len, 2 * (prog->n_groups + 1) };
+    int n = prog->n_inst, ns = n * (prog->loop_depth + 1), j;
+
+    re_tlist lists[2], *clist = &lists[0], *nlist = &lists[1], *tmp;
+    for (j = 0; j < 2; ++j) {
+        lists[j].pcs = ks_malloc(sizeof(int) * n);
+        lists[j].caps = ks_malloc(sizeof(ks_ssize_t) * n * vm.nsave);
+        lists[j].seen = ks_malloc(sizeof(uint32_t) * ns);
+        memset(lists[j].seen, 0, sizeof(uint32_t) * ns);
+        lists[j].gen = 0;
+        re_tlist_clear(&lists[j], ns);
+    }
+    ks_ssize_t* cap = ks_malloc(sizeof(*cap) * vm.nsave);
+
+    bool matched = false;
+    ks_size_t i = pos;
+    while (true) {
+        if (!matched && (how == RE_HOW_SEARCH || i == pos)) {
+            if (clist->n == 0 && how == RE_HOW_SEARCH) {
+                // nothing is running, so skip to where a match could begin
+                ks_ssize_t ni = re_skip(prog, s, len, i);
+                if (ni < 0) break;
+                i = ni;
+                re_tlist_clear(clist, ns);
+            }
+            for (j = 0; j < vm.nsave; ++j) cap[j] = -1;
+            re_pike_add(&vm, clist, 0, 0, cap, i);
+        }
+        if (clist->n == 0) {
+            // no thread is alive, but a match may still begin at a later position
+            if (matched || how != RE_HOW_SEARCH || i >= len) break;
+            i += re_utf8_len(s[i]);
+            continue;
+        }
+
+        ks_unich c = -1;
+        int cl = i < len ? re_utf8(s + i, &c) : 0;
+
+        re_tlist_clear(nlist, ns);
+        for (j = 0; j < clist->n; ++j) {
+            int pc = clist->pcs[j];
+            int op = prog->inst[pc].op;
+            if (op == RE_OP_MATCH) {
+                if (how == RE_HOW_FULL && i != len) continue;
+                matched = true;
+                memcpy(caps, clist->caps + (ks_size_t)j * vm.nsave, sizeof(*caps) * vm.nsave);
+                // less preferred threads can never be chosen over this match
+                break;
+            } else if (cl > 0 && op <= RE_OP_CLASS && re_inst_match(prog, pc, c)) {
+                re_pike_add(&vm, nlist, pc + 1, 0, clist->caps + (ks_size_t)j * vm.nsave, i + cl);
+            }
+        }
+
+        tmp = clist;
+        clist = nlist;
+        nlist = tmp;
+
+        if (i >= len) break;
+        i += cl;
+    }
+
+    for (j = 0; j < 2; ++j) {
+        ks_free(lists[j].pcs);
+        ks_free(lists[j].caps);
+        ks_free(lists[j].seen);
+    }
+    ks_free(cap);
+
+    return matched ? 1 : 0;
+}
+
+
+/* Backtracking */
+
+// an entry on the backtracking stack: either a thread to try (which has started 'c' loop iterations at 'i'), or (if
+//   'slot >= 0') a capture slot to restore
+typedef struct {
+    int pc, slot, c;
+    ks_ssize_t i;
+} re_bt_ent;
+
+// try to match at exactly 'start', counting steps in '*steps'
+// NOTE: If 'visited' is given (which must have a bit for every state (see `re_tstate()`) at every position from 'start'
+//   to 'len', all cleared), each state is only tried once at each position, so it takes linear time. That is only
+//   correct without backreferences, since otherwise whether a thread matches depends on its captures
+static int re_bt_exec(re_prog* prog, const uint8_t* s, ks_size_t len, ks_size_t start, int how, ks_ssize_t* caps, int64_t* steps, uint32_t* visited) {
+    int nsave = 2 * (prog->n_groups + 1), j;
+    for (j = 0; j < nsave; ++j) caps[j] = -1;
+
+    int sp = 0, max_sp = 64;
+    re_bt_ent* stk = ks_malloc(sizeof(*stk) * max_sp);
+    stk[sp++] = (re_bt_ent){ 0, -1, 0, start };
+
+    int res = 0;
+    while (sp > 0 && res == 0) {
+        re_bt_ent e = stk[--sp];
+        if (e.slot >= 0) {
+            caps[e.slot] = e.i;
+            continue;
+        }
+
+        int pc = e.pc, c = e.c;
+        ks_size_t i = e.i;
+        bool alive = true;
+        while (alive && res == 0) {
+            if (++*steps > RE_BT_MAX_STEPS) {
+                ks_throw(ks_T_SizeError, "Regex took too many steps (more than %l) to match", (int64_t)RE_BT_MAX_STEPS);
+                res = -1;
+                break;
+            }
+            if (sp + 1 >= max_sp) {
+                max_sp *= 2;
+                stk = ks_realloc(stk, sizeof(*stk) * max_sp);
+            }
+            if (visited) {
+                ks_size_t bit = (ks_size_t)re_tstate(prog, pc, c) * (len - start + 1) + (i - start);
+                if (visited[bit / 32] & (1u << (bit % 32))) {
+                    alive = false;
+                    break;
+                }
+                visited[bit / 32] |= 1u << (bit % 32);
+            }
+
+            re_inst* in = &prog->inst[pc];
+            switch (in->op) {
+                case RE_OP_CHAR:
+                case RE_OP_ANY:
+                case RE_OP_ANYNL:
+                case RE_OP_CLASS:
+                    if (i < len) {
+                        ks_unich ch;
+                        int cl = re_utf8(s + i, &ch);
+                        if (re_inst_match(prog, pc, ch)) {
+                            i += cl;
+                            pc++;
+                            c = 0;
+                            break;
+                        }
+                    }
+                    alive = false;
+                    break;
+                case RE_OP_SPLIT:
+                    stk[sp++] = (re_bt_ent){ in->y, -1, c, i };
+                    pc = in->x;
+                    break;
+                case RE_OP_JMP:
+                    pc = in->x;
+                    break;
+                case RE_OP_SAVE:
+                    stk[sp++] = (re_bt_ent){ 0, in->x, 0, caps[in->x] };
+                    caps[in->x] = i;
+                    pc++;
+                    break;
+                case RE_OP_MARK:
+                    c++;
+                    pc++;
+                    break;
+                case RE_OP_PROGRESS:
+                    if (c > 0) {
+                        c--;
+                        pc = in->y;
+                    } else {
+                        pc++;
+                    }
+                    break;
+                case RE_OP_BACKREF: {
+                    ks_ssize_t a = caps[2 * in->x], b = caps[2 * in->x + 1];
+                    if (a < 0 || b < 0 || i + (b - a) > len) {
+                        alive = false;
+                        break;
+                    }
+                    ks_ssize_t k, n = b - a;
+                    if (prog->flags & RE_IGNORECASE) {
+                        for (k = 0; k < n; ++k) {
+                            uint8_t x = s[a + k], y = s[i + k];
+                            if (x != y && !((x | 0x20) >= 'a' && (x | 0x20) <= 'z' && (x | 0x20) == (y | 0x20))) break;
+                        }
+                    } else {
+                        k = memcmp(s + a, s + i, n) == 0 ? n : 0;
+                    }
+                    if (k < n) {
+                        alive = false;
+                        break;
+                    }
+                    i += n;
+                    pc++;
+                    if (n > 0) c = 0;
+                    break;
+                }
+                case RE_OP_MATCH:
+                    if (how == RE_HOW_FULL && i != len) alive = false;
+                    else res = 1;
+                    break;
+                default:
+                    if (re_assert(in->op, s, len, i)) pc++;
+                    else alive = false;
+                    break;
+            }
+        }
+    }
+
+    ks_free(stk);
+    return res;
+}
+
+
+/* Export */
+
+int re_prog_exec(re_prog* prog, const char* src, ks_size_t len, ks_size_t pos, int how, ks_ssize_t* caps) {
+    const uint8_t* s = (const uint8_t*)src;
+    if (pos > len) return 0;
+
+    if (prog->bol_anchor) {
+        // a leading '^' only matches at the very start
+        if (pos != 0) return 0;
+        if (how == RE_HOW_SEARCH) how = RE_HOW_MATCH;
+    }
+
+    if (prog->has_backref) {
+        int64_t steps = 0;
+        ks_size_t i = pos;
+        while (true) {
+            if (how == RE_HOW_SEARCH) {
+                ks_ssize_t ni = re_skip(prog, s, len, i);
+                if (ni < 0) return 0;
+                i = ni;
+            }
+            int res = re_bt_exec(prog, s, len, i, how, caps, &steps, NULL);
+            if (res != 0) return res;
+            if (how != RE_HOW_SEARCH || i >= len) return 0;
+            i += re_utf8_len(s[i]);
+        }
+    }
+
+    if (prog->has_assert) return re_pike_exec(prog, s, len, pos, how, caps);
+
+    ks_ssize_t start = pos, end;
+    if (how == RE_HOW_FULL) {
+        if (re_dfa_run(prog, RE_DFA_FULL, s, len, pos) < 0) return 0;
+        end = len;
+    } else if (how == RE_HOW_MATCH) {
+        end = re_dfa_run(prog, RE_DFA_FIRST, s, len, pos);
+        if (end < 0) return 0;
+    } else {
+        start = re_skip(prog, s, len, pos);
+        if (start < 0) return 0;
+
+        // one pass finds whether there is a match at all, and where the first one ends, which the preferred
+        //   match can't start after
+        ks_ssize_t early = re_dfa_run(prog, RE_DFA_EARLY, s, len, start);
+        if (early < 0) return 0;
+
+        while ((end = re_dfa_run(prog, RE_DFA_FIRST, s, len, start)) < 0) {
+            if (start >= early) return 0;
+            start = re_skip(prog, s, len, start + re_utf8_len(s[start]));
+            if (start < 0) return 0;
+        }
+    }
+
+    if (prog->n_groups > 0) {
+        // the DFA doesn't keep track of groups, so run another engine over just the match, which must end at 'end'
+        ks_size_t nbits = (ks_size_t)prog->n_inst * (prog->loop_depth + 1) * (end - start + 1);
+        if (nbits > RE_BT_MAX_VISITED) return re_pike_exec(prog, s, end, start, RE_HOW_FULL, caps);
+
+        // short matches are faster to backtrack over
+        uint32_t* visited = ks_malloc(sizeof(*visited) * (nbits / 32 + 1));
+        memset(visited, 0, sizeof(*visited) * (nbits / 32 + 1));
+        int64_t steps = 0;
+        int res = re_bt_exec(prog, s, end, start, RE_HOW_FULL, caps, &steps, visited);
+        ks_free(visited);
+        return res;
+    }
+
+    caps[0] = start;
+    caps[1] = end;
+    return 1;
+}
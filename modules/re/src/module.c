@@ -0,0 +1,1037 @@
+/* re/src/module.c - the 're' module, for regular expressions
+ *
+ * Patterns are compiled once (see 'src/compile.c') into a 're.Regex', which keeps the program and the DFA states
+ *   that have been built for it (see 'src/exec.c'), so using the same object again is cheap. The module-level
+ *   functions (`re.search()`, `re.sub()`, ...) look patterns up in a cache of compiled objects
+ *
+ * Matching works on the UTF-8 bytes of a 'str' directly, and matches only hold onto the string and the byte offsets
+ *   of their groups. Strings for groups (and the pieces from `findall()`, `split()`, ...) are substrings of the
+ *   original, which reuse its bytes when they can (see `ks_str_substr_b()`)
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+// always begin by defining the module information
+#define MODULE_NAME "re"
+
+// include this since this is a module.
+#include "ks-module.h"
+
+#include "../re-impl.h"
+
+
+/* Tuning/Performance parameters */
+
+// number of patterns the module-level functions keep compiled (after which, the cache is emptied)
+#define RE_CACHE_MAX 256
+
+
+// re.Regex - a compiled regular expression
+typedef struct {
+    KS_OBJ_BASE
+
+    // the pattern it was compiled from
+    ks_str pattern;
+
+    // the flags given when compiling
+    int flags;
+
+    // the compiled program
+    re_prog* prog;
+
+}* re_Regex;
+
+// re.Match - the result of a successful match
+typedef struct {
+    KS_OBJ_BASE
+
+    // the expression that matched
+    re_Regex re;
+
+    // the string that was searched
+    ks_str str;
+
+    // the byte offsets of the start and end of each group (group 0 being the entire match), or -1 for groups that
+    //   did not participate
+    ks_ssize_t* caps;
+
+}* re_Match;
+
+// re.MatchIter - an iterator over the matches in a string, from `re.finditer()`
+typedef struct {
+    KS_OBJ_BASE
+
+    // the expression being searched for
+    re_Regex re;
+
+    // the string being searched
+    ks_str str;
+
+    // the byte offset to search from next (which is past the end of the string once there are no more matches)
+    ks_size_t pos;
+
+}* re_MatchIter;
+
+
+KS_TYPE_DECLFWD(re_T_Regex);
+KS_TYPE_DECLFWD(re_T_Match);
+KS_TYPE_DECLFWD(re_T_MatchIter);
+
+// compiled patterns, keyed by 'pattern' (or '(pattern, flags)', when there are flags)
+static ks_dict re_cache = NULL;
+
+// the empty string, which groups that did not participate are in `findall()`
+static ks_str re_empty = NULL;
+
+
+/* Helpers */
+
+// compile a new 're.Regex'
+static re_Regex re_new(ks_str pattern, int flags) {
+    re_prog* prog = re_prog_new(pattern, flags);
+    if (!prog) return NULL;
+
+    re_Regex self = KS_ALLOC_OBJ(re_Regex);
+    KS_INIT_OBJ(self, re_T_Regex);
+
+    self->pattern = (ks_str)KS_NEWREF(pattern);
+    self->flags = flags;
+    self->prog = prog;
+
+    return self;
+}
+
+// get a compiled 're.Regex' for 'obj' (which is a 're.Regex' already, or a pattern), using the cache
+static re_Regex re_get(ks_obj obj, ks_obj flags_obj) {
+    int64_t flags = 0;
+    if (flags_obj && !ks_num_get_int64(flags_obj, &flags)) return NULL;
+
+    if (obj->type == re_T_Regex) {
+        if (flags != 0) return ks_throw(ks_T_ArgError, "Cannot give flags with a compiled 're.Regex'");
+        return (re_Regex)KS_NEWREF(obj);
+    } else if (obj->type != ks_T_str) {
+        return ks_throw(ks_T_TypeError, "Expected the pattern to be a 'str' or 're.Regex', but got '%T'", obj);
+    }
+
+    ks_obj key = flags == 0 ? KS_NEWREF(obj) : (ks_obj)ks_tuple_new_n(2, (ks_obj[]){ KS_NEWREF(obj), (ks_obj)ks_int_new(flags) });
+    re_Regex self = (re_Regex)ks_dict_get(re_cache, key);
+    if (self) {
+        KS_DECREF(key);
+        return self;
+    }
+
+    self = re_new((ks_str)obj, flags);
+    if (!self) {
+        KS_DECREF(key);
+        return NULL;
+    }
+
+    if (re_cache->n_entries >= RE_CACHE_MAX) {
+        KS_DECREF(re_cache);
+        re_cache = ks_dict_new(0, NULL);
+    }
+    ks_dict_set(re_cache, key, (ks_obj)self);
+    KS_DECREF(key);
+
+    return self;
+}
+
+// convert the character index 'pos' in 's' to a byte offset (negative positions are treated as 0)
+static ks_size_t re_pos_b(ks_str s, int64_t pos) {
+    if (pos <= 0) return 0;
+    if (pos >= s->len_c) return s->len_b;
+    if (KS_STR_ISASCII(s)) return pos;
+
+    struct ks_str_citer cit = ks_str_citer_make(s);
+    ks_str_citer_seek(&cit, pos);
+    return cit.cbyi;
+}
+
+// convert the byte offset 'off' in 's' to a character index (or -1 stays -1)
+static int64_t re_pos_c(ks_str s, ks_ssize_t off) {
+    if (off <= 0 || KS_STR_ISASCII(s)) return off;
+    return ks_text_utf8_len_c(s->chr, off);
+}
+
+// where to search from after a match, in 's'
+// NOTE: after an empty match, the next search starts at the next character, so it doesn't find the same match
+static ks_size_t re_advance(ks_str s, ks_ssize_t* caps) {
+    if (caps[1] != caps[0]) return caps[1];
+    return caps[1] < s->len_b ? caps[1] + re_utf8_len(s->chr[caps[1]]) : s->len_b + 1;
+}
+
+// return the text of group 'g', or 'defa' if it did not participate
+static ks_obj re_group_get(ks_str s, ks_ssize_t* caps, int g, ks_obj defa) {
+    if (caps[2 * g] < 0 || caps[2 * g + 1] < 0) return KS_NEWREF(defa);
+    return (ks_obj)ks_str_substr_b(s, caps[2 * g], caps[2 * g + 1] - caps[2 * g]);
+}
+
+// turn 'obj' (a group number or name) into the index of a group in 're'
+static bool re_group_idx(re_Regex re, ks_obj obj, int* out) {
+    if (obj->type == ks_T_str) {
+        ks_obj idx = re->prog->names ? ks_dict_get(re->prog->names, obj) : NULL;
+        if (!idx) {
+            ks_throw(ks_T_KeyError, "No group named %R", obj);
+            return false;
+        }
+        int64_t v;
+        ks_num_get_int64(idx, &v);
+        KS_DECREF(idx);
+        *out = v;
+        return true;
+    }
+
+    int64_t v;
+    if (!ks_num_get_int64(obj, &v)) return false;
+    if (v < 0 || v > re->prog->n_groups) {
+        ks_throw(ks_T_KeyError, "No group %l (there are %i)", v, re->prog->n_groups);
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+// create a new 're.Match' (taking ownership of 'caps')
+static re_Match re_match_new(re_Regex re, ks_str s, ks_ssize_t* caps) {
+    re_Match self = KS_ALLOC_OBJ(re_Match);
+    KS_INIT_OBJ(self, re_T_Match);
+
+    self->re = (re_Regex)KS_NEWREF(re);
+    self->str = (ks_str)KS_NEWREF(s);
+    self->caps = caps;
+
+    return self;
+}
+
+// allocate room for the captures of 're'
+static ks_ssize_t* re_caps_new(re_Regex re) {
+    return ks_malloc(sizeof(ks_ssize_t) * 2 * (re->prog->n_groups + 1));
+}
+
+// run 're' on 's' from the byte offset 'pos', and return a 're.Match' (or none)
+static ks_obj re_run(re_Regex re, ks_str s, ks_size_t pos, int how) {
+    ks_ssize_t* caps = re_caps_new(re);
+    int res = re_prog_exec(re->prog, s->chr, s->len_b, pos, how, caps);
+    if (res <= 0) {
+        ks_free(caps);
+        return res < 0 ? NULL : KSO_NONE;
+    }
+
+    return (ks_obj)re_match_new(re, s, caps);
+}
+
+// implementation of 'findall'
+static ks_obj re_findall(re_Regex re, ks_str s, ks_size_t pos) {
+    ks_list res = ks_list_new(0, NULL);
+    ks_ssize_t* caps = re_caps_new(re);
+    int ng = re->prog->n_groups, i;
+
+    while (pos <= s->len_b) {
+        int r = re_prog_exec(re->prog, s->chr, s->len_b, pos, RE_HOW_SEARCH, caps);
+        if (r < 0) {
+            KS_DECREF(res);
+            ks_free(caps);
+            return NULL;
+        } else if (r == 0) {
+            break;
+        }
+
+        // the whole match, the only group, or a tuple of the groups
+        ks_obj item;
+        if (ng <= 1) {
+            item = re_group_get(s, caps, ng, (ks_obj)re_empty);
+        } else {
+            ks_tuple tup = ks_tuple_new_n(ng, NULL);
+            for (i = 0; i < ng; ++i) tup->elems[i] = re_group_get(s, caps, i + 1, (ks_obj)re_empty);
+            item = (ks_obj)tup;
+        }
+        ks_list_push(res, item);
+        KS_DECREF(item);
+
+        pos = re_advance(s, caps);
+    }
+
+    ks_free(caps);
+    return (ks_obj)res;
+}
+
+// a piece of a replacement template: either literal text, or a group
+typedef struct {
+    // the group, or -1 for literal text
+    int group;
+
+    // the range of the literal text in the template's buffer
+    ks_size_t start, len;
+
+} re_tpiece;
+
+// parse the replacement template 'repl' (i.e. '<\1>', '\g<name>')
+static bool re_template(re_Regex re, ks_str repl, int* n_pieces, re_tpiece** pieces, char** text) {
+    const char* src = repl->chr;
+    ks_size_t i = 0, n = repl->len_b, n_text = 0;
+    int np = 0;
+    *pieces = ks_malloc(sizeof(**pieces) * (n + 1));
+    *text = ks_malloc(n + 1);
+
+    // add a character to the literal text
+    #define ADD_TEXT(_c) do { \
+        if (np == 0 || (*pieces)[np - 1].group >= 0) (*pieces)[np++] = (re_tpiece){ -1, n_text, 0 }; \
+        (*text)[n_text++] = (_c); \
+        (*pieces)[np - 1].len++; \
+    } while (0)
+
+    while (i < n) {
+        char c = src[i++];
+        if (c != '\\' || i >= n) {
+            ADD_TEXT(c);
+            continue;
+        }
+
+        c = src[i++];
+        int g = -1;
+        if (c >= '0' && c <= '9') {
+            g = c - '0';
+            if (i < n && src[i] >= '0' && src[i] <= '9') g = g * 10 + (src[i++] - '0');
+        } else if (c == 'g' && i < n && src[i] == '<') {
+            ks_size_t start = ++i;
+            while (i < n && src[i] != '>') i++;
+            if (i >= n) {
+                ks_throw(ks_T_ArgError, "Missing '>' in group reference in replacement %R", repl);
+                return false;
+            }
+            ks_str name = ks_str_utf8(src + start, i - start);
+            i++;
+
+            bool ok;
+            if (name->len_b > 0 && name->chr[0] >= '0' && name->chr[0] <= '9') {
+                ks_int gi = ks_int_new_s(name->chr, 10);
+                ok = gi && re_group_idx(re, (ks_obj)gi, &g);
+                if (gi) KS_DECREF(gi);
+            } else {
+                ok = re_group_idx(re, (ks_obj)name, &g);
+            }
+            KS_DECREF(name);
+            if (!ok) return false;
+        } else if (c == 'n') {
+            ADD_TEXT('\n');
+            continue;
+        } else if (c == 't') {
+            ADD_TEXT('\t');
+            continue;
+        } else if (c == '\\') {
+            ADD_TEXT('\\');
+            continue;
+        } else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            ks_throw(ks_T_ArgError, "Bad escape '\\%c' in replacement %R", c, repl);
+            return false;
+        } else {
+            // other escapes are left alone
+            ADD_TEXT('\\');
+            ADD_TEXT(c);
+            continue;
+        }
+
+        if (g > re->prog->n_groups) {
+            ks_throw(ks_T_KeyError, "No group %i (there are %i) in replacement %R", g, re->prog->n_groups, repl);
+            return false;
+        }
+        (*pieces)[np++] = (re_tpiece){ g, 0, 0 };
+    }
+
+    #undef ADD_TEXT
+
+    *n_pieces = np;
+    return true;
+}
+
+// implementation of 'sub'
+static ks_obj re_sub(re_Regex re, ks_obj repl, ks_str s, int64_t count) {
+    int n_pieces = 0, i;
+    re_tpiece* pieces = NULL;
+    char* text = NULL;
+
+    bool is_func = repl->type != ks_T_str;
+    if (is_func && !ks_obj_is_callable(repl)) return ks_throw(ks_T_TypeError, "Expected the replacement to be a 'str' or callable, but got '%T'", repl);
+    if (!is_func && !re_template(re, (ks_str)repl, &n_pieces, &pieces, &text)) {
+        ks_free(pieces);
+        ks_free(text);
+        return NULL;
+    }
+
+    ks_ssize_t* caps = re_caps_new(re);
+    ks_str_builder sb = NULL;
+    ks_size_t pos = 0, last = 0;
+    int64_t n = 0;
+    bool ok = true;
+
+    while (pos <= s->len_b && (count <= 0 || n < count)) {
+        int r = re_prog_exec(re->prog, s->chr, s->len_b, pos, RE_HOW_SEARCH, caps);
+        if (r < 0) {
+            ok = false;
+            break;
+        } else if (r == 0) {
+            break;
+        }
+
+        if (!sb) sb = ks_str_builder_new();
+        ks_str_builder_add(sb, s->chr + last, caps[0] - last);
+        last = caps[1];
+        pos = re_advance(s, caps);
+
+        if (is_func) {
+            // the match takes the captures, so the next search needs new ones
+            ks_obj m = (ks_obj)re_match_new(re, s, caps);
+            caps = re_caps_new(re);
+
+            ks_obj rs = ks_obj_call(repl, 1, &m);
+            KS_DECREF(m);
+            if (!rs) {
+                ok = false;
+                break;
+            } else if (rs->type != ks_T_str) {
+                ks_throw(ks_T_TypeError, "Replacement function returned '%T' (expected 'str')", rs);
+                KS_DECREF(rs);
+                ok = false;
+                break;
+            }
+            ks_str_builder_add(sb, ((ks_str)rs)->chr, ((ks_str)rs)->len_b);
+            KS_DECREF(rs);
+        } else {
+            for (i = 0; i < n_pieces; ++i) {
+                re_tpiece* p = &pieces[i];
+                if (p->group < 0) {
+                    ks_str_builder_add(sb, text + p->start, p->len);
+                } else if (caps[2 * p->group] >= 0 && caps[2 * p->group + 1] >= 0) {
+                    ks_str_builder_add(sb, s->chr + caps[2 * p->group], caps[2 * p->group + 1] - caps[2 * p->group]);
+                }
+            }
+        }
+
+        n++;
+    }
+
+    ks_free(pieces);
+    ks_free(text);
+    ks_free(caps);
+
+    if (!ok) {
+        if (sb) KS_DECREF(sb);
+        return NULL;
+    }
+
+    // nothing was replaced, so the string can be returned as-is
+    if (!sb) return KS_NEWREF(s);
+
+    ks_str_builder_add(sb, s->chr + last, s->len_b - last);
+    ks_str res = ks_str_builder_get(sb);
+    KS_DECREF(sb);
+    return (ks_obj)res;
+}
+
+// implementation of 'split'
+static ks_obj re_split(re_Regex re, ks_str s, int64_t maxsplit) {
+    ks_list res = ks_list_new(0, NULL);
+    ks_ssize_t* caps = re_caps_new(re);
+    ks_size_t pos = 0, last = 0;
+    int64_t n = 0;
+    int i;
+
+    while (pos <= s->len_b && (maxsplit <= 0 || n < maxsplit)) {
+        int r = re_prog_exec(re->prog, s->chr, s->len_b, pos, RE_HOW_SEARCH, caps);
+        if (r < 0) {
+            KS_DECREF(res);
+            ks_free(caps);
+            return NULL;
+        } else if (r == 0) {
+            break;
+        }
+
+        // the text before the match, then any groups
+        ks_obj item = (ks_obj)ks_str_substr_b(s, last, caps[0] - last);
+        ks_list_push(res, item);
+        KS_DECREF(item);
+        for (i = 1; i <= re->prog->n_groups; ++i) {
+            item = re_group_get(s, caps, i, KSO_NONE);
+            ks_list_push(res, item);
+            KS_DECREF(item);
+        }
+
+        last = caps[1];
+        pos = re_advance(s, caps);
+        n++;
+    }
+
+    ks_obj item = (ks_obj)ks_str_substr_b(s, last, s->len_b - last);
+    ks_list_push(res, item);
+    KS_DECREF(item);
+
+    ks_free(caps);
+    return (ks_obj)res;
+}
+
+// create an iterator over the matches of 're' in 's', starting at the byte offset 'pos'
+static ks_obj re_finditer(re_Regex re, ks_str s, ks_size_t pos) {
+    re_MatchIter self = KS_ALLOC_OBJ(re_MatchIter);
+    KS_INIT_OBJ(self, re_T_MatchIter);
+
+    self->re = (re_Regex)KS_NEWREF(re);
+    self->str = (ks_str)KS_NEWREF(s);
+    self->pos = pos;
+
+    return (ks_obj)self;
+}
+
+
+/* re.Regex */
+
+// re.Regex.__new__(pattern, flags=0) - compile a pattern
+static KS_TFUNC(Regex, new) {
+    ks_str pattern;
+    int64_t flags = 0;
+    KS_GETARGS("pattern:* ?flags:i64", &pattern, ks_T_str, &flags)
+
+    return (ks_obj)re_new(pattern, flags);
+}
+
+// re.Regex.__free__(self) - free obj
+static KS_TFUNC(Regex, free) {
+    re_Regex self;
+    KS_GETARGS("self:*", &self, re_T_Regex)
+
+    re_prog_free(self->prog);
+    KS_DECREF(self->pattern);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// re.Regex.__str__(self) - to string
+static KS_TFUNC(Regex, str) {
+    re_Regex self;
+    KS_GETARGS("self:*", &self, re_T_Regex)
+
+    if (self->flags == 0) return (ks_obj)ks_fmt_c("re.compile(%R)", self->pattern);
+    return (ks_obj)ks_fmt_c("re.compile(%R, %i)", self->pattern, self->flags);
+}
+
+// re.Regex.__getattr__(self, attr) - get an attribute
+static KS_TFUNC(Regex, getattr) {
+    re_Regex self;
+    ks_str attr;
+    KS_GETARGS("self:* attr:*", &self, re_T_Regex, &attr, ks_T_str)
+
+    if (ks_str_eq_c(attr, "pattern", 7)) {
+        return KS_NEWREF(self->pattern);
+    } else if (ks_str_eq_c(attr, "flags", 5)) {
+        return (ks_obj)ks_int_new(self->prog->flags);
+    } else if (ks_str_eq_c(attr, "groups", 6)) {
+        return (ks_obj)ks_int_new(self->prog->n_groups);
+    } else if (ks_str_eq_c(attr, "groupindex", 10)) {
+        ks_dict res = ks_dict_new(0, NULL);
+        if (self->prog->names) ks_dict_merge(res, self->prog->names);
+        return (ks_obj)res;
+    }
+
+    // otherwise, look up methods (i.e. 'search')
+    ks_obj ret = ks_type_get(re_T_Regex, attr);
+    if (!ret) KS_THROW_ATTR_ERR(self, attr);
+
+    if (ks_obj_is_callable(ret)) {
+        ks_obj mem = (ks_obj)ks_pfunc_new(ret, (ks_obj)self);
+        KS_DECREF(ret);
+        return mem;
+    }
+
+    return ret;
+}
+
+// re.Regex.match(self, s, pos=0) - match at the start of 's' (or at 'pos'), returning a 're.Match' or none
+static KS_TFUNC(Regex, match) {
+    re_Regex self;
+    ks_str s;
+    int64_t pos = 0;
+    KS_GETARGS("self:* s:* ?pos:i64", &self, re_T_Regex, &s, ks_T_str, &pos)
+
+    return re_run(self, s, re_pos_b(s, pos), RE_HOW_MATCH);
+}
+
+// re.Regex.search(self, s, pos=0) - find the first match in 's' (starting at 'pos'), returning a 're.Match' or none
+static KS_TFUNC(Regex, search) {
+    re_Regex self;
+    ks_str s;
+    int64_t pos = 0;
+    KS_GETARGS("self:* s:* ?pos:i64", &self, re_T_Regex, &s, ks_T_str, &pos)
+
+    return re_run(self, s, re_pos_b(s, pos), RE_HOW_SEARCH);
+}
+
+// re.Regex.fullmatch(self, s, pos=0) - match all of 's' (from 'pos'), returning a 're.Match' or none
+static KS_TFUNC(Regex, fullmatch) {
+    re_Regex self;
+    ks_str s;
+    int64_t pos = 0;
+    KS_GETARGS("self:* s:* ?pos:i64", &self, re_T_Regex, &s, ks_T_str, &pos)
+
+    return re_run(self, s, re_pos_b(s, pos), RE_HOW_FULL);
+}
+
+// re.Regex.findall(self, s, pos=0) - return a list of every match in 's' (or its groups)
+static KS_TFUNC(Regex, findall) {
+    re_Regex self;
+    ks_str s;
+    int64_t pos = 0;
+    KS_GETARGS("self:* s:* ?pos:i64", &self, re_T_Regex, &s, ks_T_str, &pos)
+
+    return re_findall(self, s, re_pos_b(s, pos));
+}
+
+// re.Regex.finditer(self, s, pos=0) - return an iterator over the matches in 's'
+static KS_TFUNC(Regex, finditer) {
+    re_Regex self;
+    ks_str s;
+    int64_t pos = 0;
+    KS_GETARGS("self:* s:* ?pos:i64", &self, re_T_Regex, &s, ks_T_str, &pos)
+
+    return re_finditer(self, s, re_pos_b(s, pos));
+}
+
+// re.Regex.sub(self, repl, s, count=0) - replace (at most 'count', if it is positive) matches in 's' with 'repl'
+static KS_TFUNC(Regex, sub) {
+    re_Regex self;
+    ks_obj repl;
+    ks_str s;
+    int64_t count = 0;
+    KS_GETARGS("self:* repl s:* ?count:i64", &self, re_T_Regex, &repl, &s, ks_T_str, &count)
+
+    return re_sub(self, repl, s, count);
+}
+
+// re.Regex.split(self, s, maxsplit=0) - split 's' at (at most 'maxsplit', if it is positive) matches
+static KS_TFUNC(Regex, split) {
+    re_Regex self;
+    ks_str s;
+    int64_t maxsplit = 0;
+    KS_GETARGS("self:* s:* ?maxsplit:i64", &self, re_T_Regex, &s, ks_T_str, &maxsplit)
+
+    return re_split(self, s, maxsplit);
+}
+
+
+/* re.Match */
+
+// re.Match.__free__(self) - free obj
+static KS_TFUNC(Match, free) {
+    re_Match self;
+    KS_GETARGS("self:*", &self, re_T_Match)
+
+    KS_DECREF(self->re);
+    KS_DECREF(self->str);
+    ks_free(self->caps);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// re.Match.__str__(self) - to string
+static KS_TFUNC(Match, str) {
+    re_Match self;
+    KS_GETARGS("self:*", &self, re_T_Match)
+
+    ks_obj text = re_group_get(self->str, self->caps, 0, KSO_NONE);
+    ks_str res = ks_fmt_c("<re.Match span=(%l, %l), match=%R>", re_pos_c(self->str, self->caps[0]), re_pos_c(self->str, self->caps[1]), text);
+    KS_DECREF(text);
+    return (ks_obj)res;
+}
+
+// re.Match.__getattr__(self, attr) - get an attribute
+static KS_TFUNC(Match, getattr) {
+    re_Match self;
+    ks_str attr;
+    KS_GETARGS("self:* attr:*", &self, re_T_Match, &attr, ks_T_str)
+
+    if (ks_str_eq_c(attr, "re", 2)) {
+        return KS_NEWREF(self->re);
+    } else if (ks_str_eq_c(attr, "string", 6)) {
+        return KS_NEWREF(self->str);
+    }
+
+    // otherwise, look up methods (i.e. 'group')
+    ks_obj ret = ks_type_get(re_T_Match, attr);
+    if (!ret) KS_THROW_ATTR_ERR(self, attr);
+
+    if (ks_obj_is_callable(ret)) {
+        ks_obj mem = (ks_obj)ks_pfunc_new(ret, (ks_obj)self);
+        KS_DECREF(ret);
+        return mem;
+    }
+
+    return ret;
+}
+
+// re.Match.group(self, *gs) - return the text of the entire match (with no arguments), a single group, or a tuple
+//   of groups (with multiple arguments). Groups that did not participate are none
+static KS_TFUNC(Match, group) {
+    re_Match self;
+    int n_gs;
+    ks_obj* gs;
+    KS_GETARGS("self:* *gs", &self, re_T_Match, &n_gs, &gs)
+
+    int g = 0, i;
+    if (n_gs == 0) return re_group_get(self->str, self->caps, 0, KSO_NONE);
+    if (n_gs == 1) {
+        if (!re_group_idx(self->re, gs[0], &g)) return NULL;
+        return re_group_get(self->str, self->caps, g, KSO_NONE);
+    }
+
+    ks_tuple res = ks_tuple_new_n(n_gs, NULL);
+    for (i = 0; i < n_gs; ++i) {
+        if (!re_group_idx(self->re, gs[i], &g)) {
+            res->len = i;
+            KS_DECREF(res);
+            return NULL;
+        }
+        res->elems[i] = re_group_get(self->str, self->caps, g, KSO_NONE);
+    }
+    return (ks_obj)res;
+}
+
+// re.Match.__getitem__(self, g) - return the text of a group
+static KS_TFUNC(Match, getitem) {
+    re_Match self;
+    ks_obj gobj;
+    KS_GETARGS("self:* g", &self, re_T_Match, &gobj)
+
+    int g;
+    if (!re_group_idx(self->re, gobj, &g)) return NULL;
+    return re_group_get(self->str, self->caps, g, KSO_NONE);
+}
+
+// re.Match.groups(self, default=none) - return a tuple of the text of every group (using 'default' for those that
+//   did not participate)
+static KS_TFUNC(Match, groups) {
+    re_Match self;
+    ks_obj defa = KSO_NONE;
+    KS_GETARGS("self:* ?default", &self, re_T_Match, &defa)
+
+    int i, n = self->re->prog->n_groups;
+    ks_tuple res = ks_tuple_new_n(n, NULL);
+    for (i = 0; i < n; ++i) res->elems[i] = re_group_get(self->str, self->caps, i + 1, defa);
+    return (ks_obj)res;
+}
+
+// re.Match.groupdict(self, default=none) - return a dict of the text of every named group
+static KS_TFUNC(Match, groupdict) {
+    re_Match self;
+    ks_obj defa = KSO_NONE;
+    KS_GETARGS("self:* ?default", &self, re_T_Match, &defa)
+
+    ks_dict res = ks_dict_new(0, NULL);
+    ks_dict names = self->re->prog->names;
+    if (!names) return (ks_obj)res;
+
+    ks_size_t i;
+    for (i = 0; i < names->n_entries; ++i) {
+        ks_obj key = names->entries[i].key;
+        if (!key) continue;
+
+        int64_t g;
+        ks_num_get_int64(names->entries[i].val, &g);
+        ks_obj text = re_group_get(self->str, self->caps, g, defa);
+        ks_dict_set(res, key, text);
+        KS_DECREF(text);
+    }
+
+    return (ks_obj)res;
+}
+
+// re.Match.start(self, g=0) - return the index where a group starts (or -1 if it did not participate)
+static KS_TFUNC(Match, start) {
+    re_Match self;
+    ks_obj gobj = NULL;
+    KS_GETARGS("self:* ?g", &self, re_T_Match, &gobj)
+
+    int g = 0;
+    if (gobj && !re_group_idx(self->re, gobj, &g)) return NULL;
+    return (ks_obj)ks_int_new(re_pos_c(self->str, self->caps[2 * g]));
+}
+
+// re.Match.end(self, g=0) - return the index where a group ends (or -1 if it did not participate)
+static KS_TFUNC(Match, end) {
+    re_Match self;
+    ks_obj gobj = NULL;
+    KS_GETARGS("self:* ?g", &self, re_T_Match, &gobj)
+
+    int g = 0;
+    if (gobj && !re_group_idx(self->re, gobj, &g)) return NULL;
+    return (ks_obj)ks_int_new(re_pos_c(self->str, self->caps[2 * g + 1]));
+}
+
+// re.Match.span(self, g=0) - return '(start, end)' of a group (or '(-1, -1)' if it did not participate)
+static KS_TFUNC(Match, span) {
+    re_Match self;
+    ks_obj gobj = NULL;
+    KS_GETARGS("self:* ?g", &self, re_T_Match, &gobj)
+
+    int g = 0;
+    if (gobj && !re_group_idx(self->re, gobj, &g)) return NULL;
+
+    ks_int a = ks_int_new(re_pos_c(self->str, self->caps[2 * g]));
+    ks_int b = ks_int_new(re_pos_c(self->str, self->caps[2 * g + 1]));
+    return (ks_obj)ks_tuple_new_n(2, (ks_obj[]){ (ks_obj)a, (ks_obj)b });
+}
+
+
+/* re.MatchIter */
+
+// re.MatchIter.__free__(self) - free obj
+static KS_TFUNC(MatchIter, free) {
+    re_MatchIter self;
+    KS_GETARGS("self:*", &self, re_T_MatchIter)
+
+    KS_DECREF(self->re);
+    KS_DECREF(self->str);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// re.MatchIter.__next__(self) - return the next match
+static KS_TFUNC(MatchIter, next) {
+    re_MatchIter self;
+    KS_GETARGS("self:*", &self, re_T_MatchIter)
+
+    if (self->pos > self->str->len_b) return ks_throw(ks_T_OutOfIterError, "");
+
+    ks_ssize_t* caps = re_caps_new(self->re);
+    int res = re_prog_exec(self->re->prog, self->str->chr, self->str->len_b, self->pos, RE_HOW_SEARCH, caps);
+    if (res <= 0) {
+        ks_free(caps);
+        if (res < 0) return NULL;
+
+        self->pos = self->str->len_b + 1;
+        return ks_throw(ks_T_OutOfIterError, "");
+    }
+
+    self->pos = re_advance(self->str, caps);
+    return (ks_obj)re_match_new(self->re, self->str, caps);
+}
+
+
+/* Module Functions */
+
+// re.compile(pattern, flags=0) - return a compiled 're.Regex' for 'pattern' (which may be cached)
+static KS_FUNC(compile) {
+    ks_obj pattern, flags = NULL;
+    KS_GETARGS("pattern ?flags", &pattern, &flags)
+
+    return (ks_obj)re_get(pattern, flags);
+}
+
+// re.match(pattern, s, flags=0) - match 'pattern' at the start of 's'
+static KS_FUNC(match) {
+    ks_obj pattern, flags = NULL;
+    ks_str s;
+    KS_GETARGS("pattern s:* ?flags", &pattern, &s, ks_T_str, &flags)
+
+    re_Regex re = re_get(pattern, flags);
+    if (!re) return NULL;
+    ks_obj res = re_run(re, s, 0, RE_HOW_MATCH);
+    KS_DECREF(re);
+    return res;
+}
+
+// re.search(pattern, s, flags=0) - find the first match of 'pattern' in 's'
+static KS_FUNC(search) {
+    ks_obj pattern, flags = NULL;
+    ks_str s;
+    KS_GETARGS("pattern s:* ?flags", &pattern, &s, ks_T_str, &flags)
+
+    re_Regex re = re_get(pattern, flags);
+    if (!re) return NULL;
+    ks_obj res = re_run(re, s, 0, RE_HOW_SEARCH);
+    KS_DECREF(re);
+    return res;
+}
+
+// re.fullmatch(pattern, s, flags=0) - match 'pattern' against all of 's'
+static KS_FUNC(fullmatch) {
+    ks_obj pattern, flags = NULL;
+    ks_str s;
+    KS_GETARGS("pattern s:* ?flags", &pattern, &s, ks_T_str, &flags)
+
+    re_Regex re = re_get(pattern, flags);
+    if (!re) return NULL;
+    ks_obj res = re_run(re, s, 0, RE_HOW_FULL);
+    KS_DECREF(re);
+    return res;
+}
+
+// re.findall(pattern, s, flags=0) - return a list of every match of 'pattern' in 's' (or its groups)
+static KS_FUNC(findall) {
+    ks_obj pattern, flags = NULL;
+    ks_str s;
+    KS_GETARGS("pattern s:* ?flags", &pattern, &s, ks_T_str, &flags)
+
+    re_Regex re = re_get(pattern, flags);
+    if (!re) return NULL;
+    ks_obj res = re_findall(re, s, 0);
+    KS_DECREF(re);
+    return res;
+}
+
+// re.finditer(pattern, s, flags=0) - return an iterator over the matches of 'pattern' in 's'
+static KS_FUNC(finditer) {
+    ks_obj pattern, flags = NULL;
+    ks_str s;
+    KS_GETARGS("pattern s:* ?flags", &pattern, &s, ks_T_str, &flags)
+
+    re_Regex re = re_get(pattern, flags);
+    if (!re) return NULL;
+    ks_obj res = re_finditer(re, s, 0);
+    KS_DECREF(re);
+    return res;
+}
+
+// re.sub(pattern, repl, s, count=0, flags=0) - replace matches of 'pattern' in 's' with 'repl'
+static KS_FUNC(sub) {
+    ks_obj pattern, repl, flags = NULL;
+    ks_str s;
+    int64_t count = 0;
+    KS_GETARGS("pattern repl s:* ?count:i64 ?flags", &pattern, &repl, &s, ks_T_str, &count, &flags)
+
+    re_Regex re = re_get(pattern, flags);
+    if (!re) return NULL;
+    ks_obj res = re_sub(re, repl, s, count);
+    KS_DECREF(re);
+    return res;
+}
+
+// re.split(pattern, s, maxsplit=0, flags=0) - split 's' at matches of 'pattern'
+static KS_FUNC(split) {
+    ks_obj pattern, flags = NULL;
+    ks_str s;
+    int64_t maxsplit = 0;
+    KS_GETARGS("pattern s:* ?maxsplit:i64 ?flags", &pattern, &s, ks_T_str, &maxsplit, &flags)
+
+    re_Regex re = re_get(pattern, flags);
+    if (!re) return NULL;
+    ks_obj res = re_split(re, s, maxsplit);
+    KS_DECREF(re);
+    return res;
+}
+
+// re.escape(s) - return 's' with every character that has a special meaning in a pattern escaped
+static KS_FUNC(escape) {
+    ks_str s;
+    KS_GETARGS("s:*", &s, ks_T_str)
+
+    ks_str_builder sb = ks_str_builder_new();
+    ks_size_t i, last = 0;
+    for (i = 0; i < s->len_b; ++i) {
+        char c = s->chr[i];
+        if (strchr("\\.^$|?*+()[]{}-#&~ \t\n\r\v\f", c) && c != '\0') {
+            ks_str_builder_add(sb, s->chr + last, i - last);
+            ks_str_builder_add(sb, "\\", 1);
+            last = i;
+        }
+    }
+    ks_str_builder_add(sb, s->chr + last, s->len_b - last);
+
+    ks_str res = ks_str_builder_get(sb);
+    KS_DECREF(sb);
+    return (ks_obj)res;
+}
+
+// re.purge() - forget the patterns the module-level functions have compiled
+static KS_FUNC(purge) {
+    KS_GETARGS("")
+
+    KS_DECREF(re_cache);
+    re_cache = ks_dict_new(0, NULL);
+
+    return KSO_NONE;
+}
+
+
+// now, export them all
+static ks_module get_module() {
+
+    ks_module mod = ks_module_new(MODULE_NAME, "Regular expressions");
+
+    re_cache = ks_dict_new(0, NULL);
+    re_empty = ks_str_new("");
+
+    ks_type_init_c(re_T_Regex, "re.Regex", ks_T_object, KS_KEYVALS(
+        {"__new__",         (ks_obj)ks_cfunc_new_c_old(Regex_new_, "re.Regex.__new__(pattern, flags=0)")},
+        {"__free__",        (ks_obj)ks_cfunc_new_c_old(Regex_free_, "re.Regex.__free__(self)")},
+        {"__str__",         (ks_obj)ks_cfunc_new_c_old(Regex_str_, "re.Regex.__str__(self)")},
+        {"__repr__",        (ks_obj)ks_cfunc_new_c_old(Regex_str_, "re.Regex.__repr__(self)")},
+        {"__getattr__",     (ks_obj)ks_cfunc_new_c_old(Regex_getattr_, "re.Regex.__getattr__(self, attr)")},
+
+        {"match",           (ks_obj)ks_cfunc_new_c_old(Regex_match_, "re.Regex.match(self, s, pos=0)")},
+        {"search",          (ks_obj)ks_cfunc_new_c_old(Regex_search_, "re.Regex.search(self, s, pos=0)")},
+        {"fullmatch",       (ks_obj)ks_cfunc_new_c_old(Regex_fullmatch_, "re.Regex.fullmatch(self, s, pos=0)")},
+        {"findall",         (ks_obj)ks_cfunc_new_c_old(Regex_findall_, "re.Regex.findall(self, s, pos=0)")},
+        {"finditer",        (ks_obj)ks_cfunc_new_c_old(Regex_finditer_, "re.Regex.finditer(self, s, pos=0)")},
+        {"sub",             (ks_obj)ks_cfunc_new_c_old(Regex_sub_, "re.Regex.sub(self, repl, s, count=0)")},
+        {"split",           (ks_obj)ks_cfunc_new_c_old(Regex_split_, "re.Regex.split(self, s, maxsplit=0)")},
+    ));
+
+    ks_type_init_c(re_T_Match, "re.Match", ks_T_object, KS_KEYVALS(
+        {"__free__",        (ks_obj)ks_cfunc_new_c_old(Match_free_, "re.Match.__free__(self)")},
+        {"__str__",         (ks_obj)ks_cfunc_new_c_old(Match_str_, "re.Match.__str__(self)")},
+        {"__repr__",        (ks_obj)ks_cfunc_new_c_old(Match_str_, "re.Match.__repr__(self)")},
+        {"__getattr__",     (ks_obj)ks_cfunc_new_c_old(Match_getattr_, "re.Match.__getattr__(self, attr)")},
+        {"__getitem__",     (ks_obj)ks_cfunc_new_c_old(Match_getitem_, "re.Match.__getitem__(self, g)")},
+
+        {"group",           (ks_obj)ks_cfunc_new_c_old(Match_group_, "re.Match.group(self, *gs)")},
+        {"groups",          (ks_obj)ks_cfunc_new_c_old(Match_groups_, "re.Match.groups(self, default=none)")},
+        {"groupdict",       (ks_obj)ks_cfunc_new_c_old(Match_groupdict_, "re.Match.groupdict(self, default=none)")},
+        {"start",           (ks_obj)ks_cfunc_new_c_old(Match_start_, "re.Match.start(self, g=0)")},
+        {"end",             (ks_obj)ks_cfunc_new_c_old(Match_end_, "re.Match.end(self, g=0)")},
+        {"span",            (ks_obj)ks_cfunc_new_c_old(Match_span_, "re.Match.span(self, g=0)")},
+    ));
+
+    ks_type_init_c(re_T_MatchIter, "re.MatchIter", ks_T_object, KS_KEYVALS(
+        {"__free__",        (ks_obj)ks_cfunc_new_c_old(MatchIter_free_, "re.MatchIter.__free__(self)")},
+        {"__next__",        (ks_obj)ks_cfunc_new_c_old(MatchIter_next_, "re.MatchIter.__next__(self)")},
+    ));
+
+    ks_dict_set_c(mod->attr, KS_KEYVALS(
+        /* types */
+        {"Regex",           (ks_obj)re_T_Regex},
+        {"Match",           (ks_obj)re_T_Match},
+        {"MatchIter",       (ks_obj)re_T_MatchIter},
+
+        /* flags */
+        {"I",               (ks_obj)ks_int_new(RE_IGNORECASE)},
+        {"IGNORECASE",      (ks_obj)ks_int_new(RE_IGNORECASE)},
+        {"M",               (ks_obj)ks_int_new(RE_MULTILINE)},
+        {"MULTILINE",       (ks_obj)ks_int_new(RE_MULTILINE)},
+        {"S",               (ks_obj)ks_int_new(RE_DOTALL)},
+        {"DOTALL",          (ks_obj)ks_int_new(RE_DOTALL)},
+
+        /* functions */
+        {"compile",         (ks_obj)ks_cfunc_new_c_old(compile_, "re.compile(pattern, flags=0)")},
+        {"match",           (ks_obj)ks_cfunc_new_c_old(match_, "re.match(pattern, s, flags=0)")},
+        {"search",          (ks_obj)ks_cfunc_new_c_old(search_, "re.search(pattern, s, flags=0)")},
+        {"fullmatch",       (ks_obj)ks_cfunc_new_c_old(fullmatch_, "re.fullmatch(pattern, s, flags=0)")},
+        {"findall",         (ks_obj)ks_cfunc_new_c_old(findall_, "re.findall(pattern, s, flags=0)")},
+        {"finditer",        (ks_obj)ks_cfunc_new_c_old(finditer_, "re.finditer(pattern, s, flags=0)")},
+        {"sub",             (ks_obj)ks_cfunc_new_c_old(sub_, "re.sub(pattern, repl, s, count=0, flags=0)")},
+        {"split",           (ks_obj)ks_cfunc_new_c_old(split_, "re.split(pattern, s, maxsplit=0, flags=0)")},
+        {"escape",          (ks_obj)ks_cfunc_new_c_old(escape_, "re.escape(s)")},
+        {"purge",           (ks_obj)ks_cfunc_new_c_old(purge_, "re.purge()")},
+    ));
+
+    return mod;
+}
+
+// boiler plate code
+MODULE_INIT(get_module)
@@ -185,7 +185,7 @@ static KS_TFUNC(Socket, connect) {
     // (TODO: perhaps make this a function?)
     if (ks_str_eq_c(address, "localhost", 9)|| ks_str_eq_c(address, "", 0)) {
         serv_addr.sin_addr.s_addr = INADDR_ANY;
-    } else if (inet_pton(self->af_type, address->chr, &serv_addr.sin_addr) <= 0) {
+    } else if (inet_pton(self->af_type, ks_str_cstr(address), &serv_addr.sin_addr) <= 0) {
         return ks_throw(ks_T_IOError, "Could not resolve address given ('%S')", address);
     }
 
@@ -221,7 +221,7 @@ static KS_TFUNC(Socket, bind) {
     // (TODO: perhaps make this a function?)
     if (ks_str_eq_c(address, "localhost", 9)|| ks_str_eq_c(address, "", 0)) {
         self->sa_addr.sin_addr.s_addr = INADDR_ANY;
-    } else if (inet_pton(self->af_type, address->chr, &self->sa_addr.sin_addr) <= 0) {
+    } else if (inet_pton(self->af_type, ks_str_cstr(address), &self->sa_addr.sin_addr) <= 0) {
         return ks_throw(ks_T_IOError, "Could not resolve address given ('%S')", address);
     }
 
@@ -308,48 +308,55 @@ static KS_TFUNC(Socket, accept) {
 
 /* Socket.send(self, msg)
  *
- * Sends a given message (which is converted to a string if it is not already one)
+ * Sends a given message, which may be anything supporting the buffer protocol ('bytes', 'bytearray', 'str', ...),
+ *   which is sent directly from its memory, or anything else (which is converted to a string first)
  * 
  */
 static KS_TFUNC(Socket, send) {
     sock_Socket self;
     ks_obj msg;
     KS_GETARGS("self:* msg", &self, sock_T_Socket, &msg)
-    ks_obj msg_obj = args[1];
-    ks_str msg_str = NULL;
 
     // make sure it's valid
     if (!self->is_bound && !self->is_connected) {
         return ks_throw(ks_T_IOError, "Cant send before the socket is bound!");
     }
 
-    // ensure we have a string
-    if (msg_obj->type == ks_T_str) {
-        msg_str = (ks_str)KS_NEWREF(msg_obj);
+    // the memory being sent
+    ks_buffer buf;
+
+    if (ks_buffer_has(msg)) {
+        if (!ks_buffer_get(msg, &buf, KS_BUFFER_CONTIG)) return NULL;
     } else {
-        msg_str = ks_fmt_c("%S", msg_obj);
+        // convert it to a string
+        ks_str msg_str = ks_fmt_c("%S", msg);
         if (!msg_str) return NULL;
+        bool res = ks_buffer_get((ks_obj)msg_str, &buf, KS_BUFFER_CONTIG);
+        KS_DECREF(msg_str);
+        if (!res) return NULL;
     }
 
+    const uint8_t* data = buf.data;
+    ssize_t data_len = buf.len_b;
+
     ssize_t total_sent = 0;
-    do {
+    while (total_sent < data_len) {
         // actually send bytes
-        ssize_t actual_sz = send(self->sockfd, &msg_str->chr[total_sent], msg_str->len_b - total_sent, 0);
+        ssize_t actual_sz = send(self->sockfd, data + total_sent, data_len - total_sent, 0);
 
         // check and ensure message went through
         if (actual_sz < 0) {
-            KS_DECREF(msg_str);
+            ks_buffer_release(&buf);
             return ks_throw(ks_T_IOError, "Could not send from socket (reason: %s)", strerror(errno));
         }
 
 
         total_sent += actual_sz;
 
-    } while (total_sent < msg_str->len_b);
+    }
 
 
-    // remove created string reference
-    KS_DECREF(msg_str);
+    ks_buffer_release(&buf);
 
 
     return KSO_NONE;
@@ -389,6 +396,10 @@ static KS_TFUNC(Socket, recv) {
 
 
     // convert to a string
+    if (ks_text_utf8_validate(tmpbuf, sum_sz) < 0) {
+        ks_free(tmpbuf);
+        return ks_throw(ks_T_ArgError, "Data recieved from socket was not valid UTF-8");
+    }
     ks_str res = ks_str_utf8(tmpbuf, sum_sz);
     ks_free(tmpbuf);
 
@@ -397,6 +408,37 @@ static KS_TFUNC(Socket, recv) {
 
 
 
+/* Socket.recv_into(self, buf)
+ *
+ * Recieves data directly into a writable buffer (such as a 'bytearray'), without allocating, and returns the
+ *   number of bytes recieved (which may be less than its size)
+ * 
+ */
+static KS_TFUNC(Socket, recv_into) {
+    sock_Socket self;
+    ks_obj obj;
+    KS_GETARGS("self:* buf", &self, sock_T_Socket, &obj)
+
+    // make sure it's valid
+    if (!self->is_bound && !self->is_connected) {
+        return ks_throw(ks_T_IOError, "Cant recv before the socket is bound!");
+    }
+
+    ks_buffer buf;
+    if (!ks_buffer_get(obj, &buf, KS_BUFFER_WRITABLE | KS_BUFFER_CONTIG)) return NULL;
+
+    ssize_t actual_sz = recv(self->sockfd, buf.data, buf.len_b, 0);
+    ks_buffer_release(&buf);
+
+    if (actual_sz < 0) {
+        return ks_throw(ks_T_IOError, "Could not recv into socket (reason: %s)", strerror(errno));
+    }
+
+    return (ks_obj)ks_int_new(actual_sz);
+}
+
+
+
 /* Socket.get_name(self)
  *
  * Return a textual name for the socket
@@ -483,7 +525,7 @@ static KS_TFUNC(Socket, handle_forever) {
 // now, export them all
 static ks_module get_module() {
     
-    ks_module mod = ks_module_new(MODULE_NAME);
+    ks_module mod = ks_module_new(MODULE_NAME, "Sockets and networking");
 
     ks_type_init_c(sock_T_Socket, "sock.Socket", ks_T_object, KS_KEYVALS(
         {"__new__",             (ks_obj)ks_cfunc_new_c_old(Socket_new_, "sock.Socket.__new__()")},
@@ -497,6 +539,7 @@ static ks_module get_module() {
 
         {"send",                (ks_obj)ks_cfunc_new_c_old(Socket_send_, "sock.Socket.send(self, msg)")},
         {"recv",                (ks_obj)ks_cfunc_new_c_old(Socket_recv_, "sock.Socket.recv(self, sz)")},
+        {"recv_into",           (ks_obj)ks_cfunc_new_c_old(Socket_recv_into_, "sock.Socket.recv_into(self, buf)")},
 
         {"get_name",            (ks_obj)ks_cfunc_new_c_old(Socket_get_name_, "sock.Socket.get_name(self)")},
         {"get_port",            (ks_obj)ks_cfunc_new_c_old(Socket_get_port_, "sock.Socket.get_port(self)")},
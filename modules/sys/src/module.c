@@ -35,7 +35,7 @@ static KS_TFUNC(sys, shell) {
     ks_GIL_unlock();
 
     // use the 'system' call here; popen might not always be available
-    int res = system(cmd->chr);
+    int res = system(ks_str_cstr(cmd));
 
     // acquire it back before calling any more functions
     ks_GIL_lock();
@@ -0,0 +1,74 @@
+/* buffer.c - implementation of the buffer protocol, which lets C code access the memory of objects directly
+ *
+ * Types that store raw data (str, bytes, bytearray, nx.array, ...) set `type->getbuf`, and consumers (I/O, sockets,
+ *   numerics, ...) call `ks_buffer_get()` instead of special-casing each type or converting to `bytes` first
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#include "ks-impl.h"
+
+
+bool ks_buffer_has(ks_obj obj) {
+    return obj->type->getbuf != NULL;
+}
+
+bool ks_buffer_get(ks_obj obj, ks_buffer* buf, int flags) {
+    if (!obj->type->getbuf) {
+        ks_throw(ks_T_TypeError, "'%T' object does not support the buffer protocol", obj);
+        return false;
+    }
+
+    if (!obj->type->getbuf(obj, buf, flags)) return false;
+
+    if ((flags & KS_BUFFER_WRITABLE) && buf->readonly) {
+        if (obj->type->relbuf) obj->type->relbuf(obj, buf);
+        ks_throw(ks_T_TypeError, "'%T' object is read-only, but a writable buffer was requested", obj);
+        return false;
+    }
+
+    if ((flags & KS_BUFFER_CONTIG) && !ks_buffer_iscontig(buf)) {
+        if (obj->type->relbuf) obj->type->relbuf(obj, buf);
+        ks_throw(ks_T_TypeError, "'%T' object is not contiguous, but a contiguous buffer was requested", obj);
+        return false;
+    }
+
+    buf->owner = KS_NEWREF(obj);
+    return true;
+}
+
+void ks_buffer_release(ks_buffer* buf) {
+    if (buf->owner) {
+        if (buf->owner->type->relbuf) buf->owner->type->relbuf(buf->owner, buf);
+        KS_DECREF(buf->owner);
+        buf->owner = NULL;
+    }
+}
+
+void ks_buffer_init_bytes(ks_buffer* buf, ks_obj owner, void* data, ks_ssize_t len_b, bool readonly) {
+    buf->owner = owner;
+    buf->data = data;
+    buf->len_b = len_b;
+    buf->fmt = "B";
+    buf->itemsize = 1;
+    buf->readonly = readonly;
+    buf->ndim = 1;
+    buf->_shape1 = len_b;
+    buf->_stride1 = 1;
+    buf->shape = &buf->_shape1;
+    buf->strides = &buf->_stride1;
+}
+
+bool ks_buffer_iscontig(ks_buffer* buf) {
+    // expected stride of the current dimension, working from the last (fastest moving) one
+    ks_ssize_t expect = buf->itemsize;
+
+    int i;
+    for (i = buf->ndim - 1; i >= 0; --i) {
+        // dimensions of size 1 may have any stride
+        if (buf->shape[i] != 1 && buf->strides[i] != expect) return false;
+        expect *= buf->shape[i];
+    }
+
+    return true;
+}
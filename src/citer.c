@@ -41,7 +41,15 @@ ks_obj ks_citer_next(struct ks_citer* cit) {
     // done
     if (cit->done || cit->threwErr) return NULL;
 
-    ks_obj next_obj = ks_F_next->func(1, &cit->iter_obj);
+    ks_obj next_obj;
+    if (cit->iter_obj->type == ks_T_ios) {
+        // read lines directly, which signals the end without throwing an 'OutOfIterError'
+        if (!ks_ios_readline((ks_ios)cit->iter_obj, true, &next_obj)) cit->threwErr = true;
+        if (!next_obj) cit->done = true;
+        return next_obj;
+    }
+
+    next_obj = ks_F_next->func(1, &cit->iter_obj);
     if (!next_obj) {
         // no matter what, we're done now
         cit->done = true;
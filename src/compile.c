@@ -378,6 +378,25 @@ static bool ast_emit(ks_ast self, em_state* st, ks_code to) {
         RESET_STK(0);
 
 
+    } else if (self->kind == KS_AST_YIELD) {
+        // do a yield
+
+        // first, calculate the value
+        if (!ast_emit((ks_ast)self->children->elems[0], st, to)) return false;
+
+        // ensure the function emitted one 
+        assert(start_len + 1 == st->stk_len && "'yield' expr was not emitted correctly!");
+
+        // yield the value, which consumes it
+        ksca_yield(to);
+        st->stk_len--;
+
+        // add meta data
+        ks_code_add_meta(to, self->tok);
+
+        // mark it, so that the function is called as a generator
+        to->isGen = true;
+
     } else if (self->kind == KS_AST_THROW) {
         // do a throw
 
@@ -129,7 +129,7 @@ typedef struct {
 } exc_handler;
 
 
-/* ks__exec -> perform execution on a thread
+/* my_exec -> perform execution on a thread
  *
  * This function makes a lot of assumptions, such as:
  *   * You are on a thread currently
@@ -139,8 +139,11 @@ typedef struct {
  * If any of these are not met, it will just abort (no exceptions generated),
  *   because this IS this code that generates exceptions, it's okay to safeguard it like this
  * 
+ * If 'gen' is non-NULL, then execution is resumed from the generator's saved state (instead of starting
+ *   at the beginning of 'code'), and a 'yield' saves the state back into it
+ * 
  */
-ks_obj ks__exec(ks_thread self, ks_code code) {
+static ks_obj my_exec(ks_thread self, ks_code code, ks_gen gen) {
     // thread to execute on
     assert(self != NULL && "'ks__exec()' called without a thread");
     assert(self->frames->len > 0 && "No stack frames available!");
@@ -158,8 +161,8 @@ ks_obj ks__exec(ks_thread self, ks_code code) {
     // start program counter at the beginning
     #define c_pc (c_frame->pc)
 
-    // set program counter to the start of the bytecode
-    c_pc = code->bc;
+    // set program counter to the start of the bytecode (generators keep theirs in the frame)
+    if (!gen) c_pc = code->bc;
 
     // current index into the exception handler stack
     int exc_i = -1;
@@ -218,6 +221,16 @@ ks_obj ks__exec(ks_thread self, ks_code code) {
     // starting length
     int start_stk_len = self->stk->len;
 
+    if (gen) {
+        // restore the state the generator had when it yielded
+        ks_list_pushn(self->stk, gen->stk->len, gen->stk->elems);
+        ks_list_clear(gen->stk);
+
+        for (i = 0; i < gen->n_exc; ++i) {
+            exchs[++exc_i] = (exc_handler){ .to_c_pc = gen->exc[i] };
+        }
+    }
+
 
     // label to dispatch from
     dispatch: ;
@@ -503,6 +516,31 @@ ks_obj ks__exec(ks_thread self, ks_code code) {
 
         VMED_CASE_END
 
+        VMED_CASE_START(KSB_YIELD)
+            VMED_CONSUME(ksb, op);
+
+            if (!gen) {
+                ks_throw(ks_T_Error, "'yield' used outside of a function");
+                goto EXC;
+            }
+
+            // save the stack above where we started, and the active exception handlers
+            ks_list_pushn(gen->stk, self->stk->len - start_stk_len - 1, &self->stk->elems[start_stk_len]);
+
+            gen->n_exc = exc_i - start_ecs;
+            gen->exc = ks_realloc(gen->exc, sizeof(*gen->exc) * gen->n_exc);
+            for (i = 0; i < gen->n_exc; ++i) {
+                gen->exc[i] = exchs[start_ecs + 1 + i].to_c_pc;
+            }
+
+            // now, pop off the TOS and give that back, without finishing the generator
+            ret_val = ks_list_pop(self->stk);
+            ks_list_popun(self->stk, self->stk->len - start_stk_len);
+            ks_free(args);
+            return ret_val;
+
+        VMED_CASE_END
+
 
         /* -- Exceptions/Errors/Handlers -- */
 
@@ -808,8 +846,12 @@ ks_obj ks__exec(ks_thread self, ks_code code) {
 
             assert(ks_obj_is_iterable(top) && "'iter_next', TOS was not an iterable!");
 
-            ks_obj top_next = ks_F_next->func(1, &top);
-            if (!top_next) {
+            ks_obj top_next;
+            if (top->type == ks_T_ios) {
+                // read lines directly, which signals the end without throwing an 'OutOfIterError'
+                if (!ks_ios_readline((ks_ios)top, true, &top_next)) goto EXC;
+                if (!top_next) c_pc += op_i32.arg;
+            } else if (!(top_next = ks_F_next->func(1, &top))) {
                 // exception was raised, check if it is 'OutOfIterError'
                 if (self->exc && self->exc->type == ks_T_OutOfIterError) {
                     // ignore it and break out of the loop
@@ -820,10 +862,13 @@ ks_obj ks__exec(ks_thread self, ks_code code) {
                     // handle unrelated exception
                     goto EXC;
                 }
-            } else {
+            }
+
+            if (top_next) {
 
                 // otherwise, push back on 'top_iter'
                 ks_list_push(self->stk, top_next);
+                KS_DECREF(top_next);
 
             }
 
@@ -845,7 +890,29 @@ ks_obj ks__exec(ks_thread self, ks_code code) {
         }
 
         // implement all the operators
-        T_BOP_CASE(KSB_BOP_ADD, "+", ks_F_add, {});
+        T_BOP_CASE(KSB_BOP_ADD, "+", ks_F_add, {
+            // for `x = x + y` with strings, if the only other reference to 'L' is the local variable about to be
+            //   overwritten, release that and append in place, so that repeated concatenation is linear, not quadratic
+            if (L->type == ks_T_str && R->type == ks_T_str && L->refcnt == 2 && *c_pc == KSB_STORE && c_frame->locals != NULL) {
+                ks_str name = (ks_str)code->v_const->elems[((ksb_i32*)c_pc)->arg];
+                ks_obj cur = ks_dict_get_h(c_frame->locals, (ks_obj)name, name->v_hash);
+                if (cur != NULL) KS_DECREF(cur);
+                if (cur == L) {
+                    // drop the variable's reference; the following 'store' will set it again
+                    ks_dict_set_h(c_frame->locals, (ks_obj)name, name->v_hash, KSO_NONE);
+                    ks_obj ret = (ks_obj)ks_str_iadd((ks_str)L, (ks_str)R);
+                    if (!ret) {
+                        // 'L' was not consumed, so give the variable its value back
+                        ks_dict_set_h(c_frame->locals, (ks_obj)name, name->v_hash, L);
+                        KS_DECREF(L); KS_DECREF(R);
+                        goto EXC;
+                    }
+                    ks_list_push(self->stk, ret);
+                    KS_DECREF(R); KS_DECREF(ret);
+                    VMED_NEXT();
+                }
+            }
+        });
         T_BOP_CASE(KSB_BOP_SUB, "-", ks_F_sub, {});
         T_BOP_CASE(KSB_BOP_MUL, "*", ks_F_mul, {});
         T_BOP_CASE(KSB_BOP_DIV, "/", ks_F_div, {});
@@ -927,6 +994,15 @@ ks_obj ks__exec(ks_thread self, ks_code code) {
 
     RET: ;
 
+    if (gen) {
+        // returning (or throwing an error) finishes the generator, and the return value is not used
+        gen->isDone = true;
+        if (ret_val) {
+            KS_DECREF(ret_val);
+            ret_val = ks_throw(ks_T_OutOfIterError, "");
+        }
+    }
+
 
 
     // rewind stack, just in case
@@ -940,3 +1016,11 @@ ks_obj ks__exec(ks_thread self, ks_code code) {
     return ret_val;
 }
 
+ks_obj ks__exec(ks_thread self, ks_code code) {
+    return my_exec(self, code, NULL);
+}
+
+ks_obj ks__exec_gen(ks_thread self, ks_gen gen) {
+    return my_exec(self, gen->frame->code, gen);
+}
+
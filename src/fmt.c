@@ -31,6 +31,7 @@ ks_str ks_fmt_c(const char* fmt, ...) {
 // ks_*printf(...) - prints out, similar to C-style ones, but using the `ks_fmt_*` methods
 void ks_vfprintf(FILE* fp, const char* fmt, va_list ap) {
     ks_str fmt_str = ks_fmt_vc(fmt, ap);
+    if (fp == stdout || fp == stderr) ks_ios_sync_std();
     fprintf(fp, "%s", fmt_str->chr);
     KS_DECREF(fmt_str);
 }
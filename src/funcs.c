@@ -34,9 +34,7 @@ ks_cfunc
     ks_F_all = NULL,
 
     ks_F_sort = NULL,
-    ks_F_map = NULL,
     ks_F_sum = NULL,
-    ks_F_filter = NULL,
 
     ks_F_chr = NULL,
     ks_F_ord = NULL,
@@ -79,8 +77,8 @@ ks_cfunc
 
 /* Misc. Kscript Functions */
 
-// number of bytes written to the stdout
-static int64_t _print_numbytes = 0;
+// number of times 'print()' has written to stdout
+static int64_t _print_count = 0;
 
 // print (*args) -> print arguments
 static KS_FUNC(print) {
@@ -88,25 +86,10 @@ static KS_FUNC(print) {
     ks_obj* extra;
     KS_GETARGS("*args", &n_extra, &extra)
 
-    ks_str_builder sb = ks_str_builder_new();
+    // write straight into the stdout buffer
+    if (!ks_ios_print(ks_stdout, n_extra, extra, " ", "\n", false)) return NULL;
 
-    int i;
-    for (i = 0; i < n_extra; ++i) {
-        if (i > 0) ks_str_builder_add(sb, " ", 1);
-        if (!ks_str_builder_add_str(sb, extra[i])) {
-            KS_DECREF(sb);
-            return NULL;
-        }
-    }
-
-    ks_str toprint = ks_str_builder_get(sb);
-    KS_DECREF(sb);
-
-    _print_numbytes += toprint->len_b + 1;
-
-    // print out to console
-    printf("%s\n", toprint->chr);
-    KS_DECREF(toprint);
+    _print_count++;
 
     return KSO_NONE;
 }
@@ -151,7 +134,10 @@ static KS_FUNC(next) {
     ks_obj obj;
     KS_GETARGS("obj", &obj)
 
-    if (obj->type->__next__ != NULL) {
+    if (obj->type == ks_T_gen) {
+        // resume directly, rather than calling 'gen.__next__'
+        return ks_gen_next((ks_gen)obj);
+    } else if (obj->type->__next__ != NULL) {
         // create an iterable and return it
         return ks_obj_call(obj->type->__next__, 1, &obj);
     } else {
@@ -355,13 +341,20 @@ static KS_FUNC(import) {
     ks_str name;
     KS_GETARGS("name:*", &name, ks_T_str);
 
-    return (ks_obj)ks_module_import(name->chr);
+    return (ks_obj)ks_module_import(ks_str_cstr(name));
 }
 
 
 /* Iterables */
 
 
+// add 'Rv' to '*Lv', returning false if it would overflow
+static bool my_add_int64(int64_t* Lv, int64_t Rv) {
+    if ((Rv > 0 && *Lv > INT64_MAX - Rv) || (Rv < 0 && *Lv < INT64_MIN - Rv)) return false;
+    *Lv += Rv;
+    return true;
+}
+
 // sum(objs, initial=none) - compute the sum of objs
 static KS_FUNC(sum) {
     ks_obj objs, initial = KSO_NONE; 
@@ -371,6 +364,97 @@ static KS_FUNC(sum) {
     // (or 0)
     ks_obj res = initial == KSO_NONE ? NULL : KS_NEWREF(initial);
 
+    if (objs->type == ks_T_range && (initial == KSO_NONE || (initial->type == ks_T_int && !((ks_int)initial)->isLong))) {
+        // add up a range of integers without creating them
+        int64_t start, step, iv = initial == KSO_NONE ? 0 : ((ks_int)initial)->v64;
+        ks_size_t n, i;
+        if (ks_range_get_c((ks_range)objs, &start, &step, &n)) {
+            for (i = 0; i < n && my_add_int64(&iv, start + (int64_t)i * step); ++i) ;
+
+            if (i == n) {
+                if (res) KS_DECREF(res);
+                return (ks_obj)ks_int_new(iv);
+            }
+        }
+    } else if (objs->type == ks_T_list || objs->type == ks_T_tuple) {
+        ks_size_t n = objs->type == ks_T_list ? ((ks_list)objs)->len : ((ks_tuple)objs)->len;
+        ks_list l = objs->type == ks_T_list ? (ks_list)objs : NULL;
+        int kind = l ? l->kind : KS_LIST_KIND_OBJ;
+        ks_obj* elems = l ? l->elems : ((ks_tuple)objs)->elems;
+        ks_size_t i = 0;
+
+        // the running total is kept as a C value while the elements are ints (that fit) and floats, and
+        //   becomes a float once a float is added (just like the `+` operator)
+        int64_t iv = 0;
+        double fv = 0.0;
+        bool isFloat = false, canFast = true;
+
+        if (initial == KSO_NONE) {
+        } else if (initial->type == ks_T_int && !((ks_int)initial)->isLong) {
+            iv = ((ks_int)initial)->v64;
+        } else if (initial->type == ks_T_float) {
+            fv = ((ks_float)initial)->val;
+            isFloat = true;
+        } else {
+            canFast = false;
+        }
+
+        for (; canFast && i < n; ++i) {
+            // get the element as a C value (unboxed lists already hold them)
+            int64_t ev = 0;
+            double ef = 0.0;
+            bool eFloat;
+            if (kind == KS_LIST_KIND_INT64) {
+                ev = l->raw.v64[i];
+                eFloat = false;
+            } else if (kind == KS_LIST_KIND_FLOAT) {
+                ef = l->raw.vf[i];
+                eFloat = true;
+            } else if (elems[i]->type == ks_T_int && !((ks_int)elems[i])->isLong) {
+                ev = ((ks_int)elems[i])->v64;
+                eFloat = false;
+            } else if (elems[i]->type == ks_T_float) {
+                ef = ((ks_float)elems[i])->val;
+                eFloat = true;
+            } else {
+                break;
+            }
+
+            if (!eFloat) {
+                if (isFloat) fv += ev;
+                else if (!my_add_int64(&iv, ev)) break;
+            } else {
+                if (!isFloat) {
+                    fv = iv;
+                    isFloat = true;
+                }
+                fv += ef;
+            }
+        }
+
+        if (canFast && i > 0) {
+            // box the partial sum, and continue with the rest of the elements
+            if (res) KS_DECREF(res);
+            res = isFloat ? (ks_obj)ks_float_new(fv) : (ks_obj)ks_int_new(iv);
+        }
+
+        // NOTE: `+` may modify 'objs', so re-read the elements each time
+        for (; i < (l ? l->len : ((ks_tuple)objs)->len); ++i) {
+            ks_obj ob = l ? ks_list_get(l, i) : KS_NEWREF(((ks_tuple)objs)->elems[i]);
+            if (!res) {
+                res = ob;
+            } else {
+                ks_obj new_res = ks_F_add->func(2, (ks_obj[]){ res, ob });
+                KS_DECREF(res);
+                KS_DECREF(ob);
+                if (!new_res) return NULL;
+                res = new_res;
+            }
+        }
+
+        return res ? res : (ks_obj)ks_int_new(0);
+    }
+
     // iterate through the entire iterable
     struct ks_citer cit = ks_citer_make(objs);
     ks_obj ob = NULL;
@@ -405,99 +489,26 @@ static KS_FUNC(sum) {
 }
 
 
-// map(func, objs) - apply `func` to `objs`
-// TODO: should this be an async object, similar to python, or always produce a list?
-static KS_FUNC(map) {
-    ks_obj func, objs;
-    KS_GETARGS("func objs", &func, &objs);
+// sorted(objs, key=none, reverse=false) - return a sorted list of 'objs' (see `list.sort()`)
+static KS_FUNC(sorted) {
+    ks_obj objs, key = KSO_NONE, reverse = KSO_FALSE;
+    KS_GETARGS("objs ?key ?reverse", &objs, &key, &reverse);
 
-    // create result list
-    ks_list res = ks_list_new(0, NULL);
+    int rev = ks_obj_truthy(reverse);
+    if (rev < 0) return NULL;
 
-    // iterate through the entire iterable
-    struct ks_citer cit = ks_citer_make(objs);
-    ks_obj ob = NULL;
-    while (ob = ks_citer_next(&cit)) {
-        // apply the function to this object
-        ks_obj new_ob = ks_obj_call(func, 1, &ob);
-        KS_DECREF(ob);
-        // handle an error
-        if (!new_ob) {
-            cit.threwErr = true;
-            break;
-        }
-
-        // add it to the result
-        ks_list_push(res, new_ob);
-        KS_DECREF(new_ob);
-    }
+    ks_list res = ks_list_new_iter(objs);
+    if (!res) return NULL;
 
-    ks_citer_done(&cit);
-
-    // if there was an error, exit out
-    if (cit.threwErr) {
-        KS_DECREF(res);
-        return NULL;
-    }
-
-    // otherwise, return the result
-    return (ks_obj)res;
-}
-
-
-// filter(func, objs) - filter `objs` based on `func`, i.e. if `func(obj)` is truthy,
-//   add `obj` to the output
-// TODO: should this be an async object, similar to python, or always produce a list?
-static KS_FUNC(filter) {
-    ks_obj func, objs;
-    KS_GETARGS("func objs", &func, &objs);
-
-    // create result list
-    ks_list res = ks_list_new(0, NULL);
-
-    // iterate through the entire iterable
-    struct ks_citer cit = ks_citer_make(objs);
-    ks_obj ob = NULL;
-    while (ob = ks_citer_next(&cit)) {
-        // apply the function to this object
-        ks_obj new_ob = ks_obj_call(func, 1, &ob);
-        // handle an error
-        if (!new_ob) {
-            cit.threwErr = true;
-            KS_DECREF(ob);
-            break;
-        }
-
-        // determine truthiness
-        int tru = ks_obj_truthy(new_ob);
-        KS_DECREF(new_ob);
-
-        // error in determining truthiness
-        if (tru < 0) {
-            cit.threwErr = true;
-            KS_DECREF(ob);
-            break;
-        }
-
-        // add original object
-        if (tru) ks_list_push(res, ob);
-        KS_DECREF(ob);
-    }
-
-    ks_citer_done(&cit);
-
-    // if there was an error, exit out
-    if (cit.threwErr) {
+    if (!ks_list_sort(res, key, rev == 1)) {
         KS_DECREF(res);
         return NULL;
     }
 
-    // otherwise, return the result
     return (ks_obj)res;
 }
 
 
-
 // issub(a, b) - return whether `a` is a sub type of `b`
 static KS_FUNC(issub) {
     ks_type a, b;
@@ -789,12 +800,12 @@ static char* match_gen(const char* text, int state) {
             if (this_key && this_key->type == ks_T_str) {
 
                 // is a string; good
-                if (text_split->len == 0 || strncmp(this_key->chr, ((ks_str)text_split->elems[text_split->len - 1])->chr, ((ks_str)text_split->elems[text_split->len - 1])->len_b) == 0) {
+                if (text_split->len == 0 || strncmp(ks_str_cstr(this_key), ((ks_str)text_split->elems[text_split->len - 1])->chr, ((ks_str)text_split->elems[text_split->len - 1])->len_b) == 0) {
 
                     // NOTE: need to use malloc(), since readline frees it
                     char* new_match = malloc(text_prefix->len_b + this_key->len_b + RLM_BUF + slen + 1);
                     //snprintf(new_match, this_key->len_b + RLM_BUF, "%*s%s", (int)this_key->len_b, this_key->chr, ks_obj_is_callable(this_val) ? "(" : "");
-                    snprintf(new_match, this_key->len_b + RLM_BUF, "%*s%*s%s", (int)text_prefix->len_b, text_prefix->chr, (int)this_key->len_b, this_key->chr, ks_obj_is_callable(this_val) ? "(" : "");
+                    snprintf(new_match, this_key->len_b + RLM_BUF, "%*s%*s%s", (int)text_prefix->len_b, ks_str_cstr(text_prefix), (int)this_key->len_b, ks_str_cstr(this_key), ks_obj_is_callable(this_val) ? "(" : "");
                     return new_match;
                 }
             }
@@ -940,7 +951,7 @@ static void run_interactive_expr(ks_str expr, ks_str src_name) {
     // if this is true, we should only print if nothing else has printed in that time,
     //   to avoid double printing
     bool doPrintIffy = false;
-    int64_t start_nbytes = _print_numbytes;
+    int64_t start_count = _print_count;
 
     // get whether its an actual terminal screen
     bool isTTY = isatty(STDIN_FILENO);
@@ -985,7 +996,7 @@ static void run_interactive_expr(ks_str expr, ks_str src_name) {
     } else {
         if (doPrint) {
 
-            if (doPrintIffy && _print_numbytes != start_nbytes) {
+            if (doPrintIffy && _print_count != start_count) {
                 // do nothing
             } else {
                 ks_printf("%S\n", ret);
@@ -1197,7 +1208,7 @@ static KS_FUNC(exec_file) {
     KS_GETARGS("fname:*", &fname, ks_T_str)
 
     // 1. Read the entire file
-    ks_str src_code = ks_readfile(fname->chr, "r");
+    ks_str src_code = ks_readfile(ks_str_cstr(fname), "r");
     if (!src_code) return NULL;
 
     ks_debug("ks", "read file '%S', got: " COL_DIM "'%S'" COL_RESET "", fname, src_code);
@@ -1278,8 +1289,7 @@ void ks_init_funcs() {
 
 
     ks_F_sum = ks_cfunc_new_c_old(sum_, "sum(objs, initial=none)");
-    ks_F_map = ks_cfunc_new_c_old(map_, "map(func, objs)");
-    ks_F_filter = ks_cfunc_new_c_old(filter_, "filter(func, objs)");
+    ks_F_sort = ks_cfunc_new_c_old(sorted_, "sorted(objs, key=none, reverse=false)");
 
     ks_F_getattr = ks_cfunc_new_c_old(getattr_, "getattr(obj, key)");
     ks_F_setattr = ks_cfunc_new_c_old(setattr_, "setattr(obj, key, val)");
@@ -74,6 +74,7 @@ bool ks_init(int verbose) {
     ks_init_T_complex();
     ks_init_T_str();
     ks_init_T_bytes();
+    ks_init_T_bytearray();
     ks_init_T_Enum();
 
     ks_init_T_str_builder();
@@ -84,17 +85,23 @@ bool ks_init(int verbose) {
     ks_init_T_range();
     ks_init_T_dict();
     ks_init_T_set();
+    ks_init_T_deque();
+    ks_init_T_heap();
+    ks_init_T_iters();
     ks_init_T_namespace();
     ks_init_T_cfunc();
     ks_init_T_pfunc();
+    ks_init_T_memoize();
     ks_init_T_thread();
     ks_init_T_parser();
     ks_init_T_ast();
     ks_init_T_code();
     ks_init_T_stack_frame();
     ks_init_T_kfunc();
+    ks_init_T_gen();
     ks_init_T_module();
     ks_init_T_ios();
+    ks_init_T_mmap();
 
     // initialize others
     ks_init_funcs();
@@ -206,6 +213,7 @@ bool ks_init(int verbose) {
 
         {"str",                    KS_NEWREF(ks_T_str)},
         {"bytes",                  KS_NEWREF(ks_T_bytes)},
+        {"bytearray",              KS_NEWREF(ks_T_bytearray)},
 
         {"logger",                 KS_NEWREF(ks_T_logger)},
 
@@ -215,11 +223,24 @@ bool ks_init(int verbose) {
         {"range",                  KS_NEWREF(ks_T_range)},
         {"dict",                   KS_NEWREF(ks_T_dict)},
         {"set",                    KS_NEWREF(ks_T_set)},
+        {"deque",                  KS_NEWREF(ks_T_deque)},
+        {"heap",                   KS_NEWREF(ks_T_heap)},
+        {"map",                    KS_NEWREF(ks_T_map)},
+        {"filter",                 KS_NEWREF(ks_T_filter)},
+        {"zip",                    KS_NEWREF(ks_T_zip)},
+        {"enumerate",              KS_NEWREF(ks_T_enumerate)},
+        {"chain",                  KS_NEWREF(ks_T_chain)},
+        {"islice",                 KS_NEWREF(ks_T_islice)},
+        {"takewhile",              KS_NEWREF(ks_T_takewhile)},
+        {"dropwhile",              KS_NEWREF(ks_T_dropwhile)},
+        {"repeat",                 KS_NEWREF(ks_T_repeat)},
+        {"memoize",                KS_NEWREF(ks_T_memoize)},
         {"namespace",              KS_NEWREF(ks_T_namespace)},
 
         {"type",                   KS_NEWREF(ks_T_type)},
         {"thread",                 KS_NEWREF(ks_T_thread)},
         {"ios",                    KS_NEWREF(ks_T_ios)},
+        {"mmap",                   KS_NEWREF(ks_T_mmap)},
 
         {"Enum",                   KS_NEWREF(ks_T_Enum)},
 
@@ -265,8 +286,7 @@ bool ks_init(int verbose) {
         {"all",                    KS_NEWREF(ks_F_all)},
 
         {"sum",                    KS_NEWREF(ks_F_sum)},
-        {"map",                    KS_NEWREF(ks_F_map)},
-        {"filter",                 KS_NEWREF(ks_F_filter)},
+        {"sorted",                 KS_NEWREF(ks_F_sort)},
 
 
         /* Misc. Variables */
@@ -202,21 +202,30 @@ ks_obj ks_num_parse(const char* str, int len, int base) {
         if (base == 2 || base == 8) {
             return ks_throw(ks_T_ArgError, "Invalid float number: Only base 10 and 16 floats are supported, not %i", olen, ostr, base);
         }
-        
-        // convert to literal
-        char* tmp_str = ks_malloc(olen + 1);
-        memcpy(tmp_str, ostr, olen);
-        tmp_str[olen] = '\0';
 
-        char* endptr = NULL;
-        double rv = strtold(tmp_str, &endptr);
+        double rv;
+        ks_ssize_t n;
+        if (base == KS_BASE_10) {
+            // correctly rounded, without copying
+            n = ks_num_scan_double(ostr, olen, &rv);
+        } else {
+            // convert to literal
+            char* tmp_str = ks_malloc(olen + 1);
+            memcpy(tmp_str, ostr, olen);
+            tmp_str[olen] = '\0';
 
-        if (endptr && *endptr == 'i') {
+            char* endptr = NULL;
+            rv = strtod(tmp_str, &endptr);
+            n = endptr ? endptr - tmp_str : 0;
+            ks_free(tmp_str);
+        }
+
+        if (n > 0 && n < olen && ostr[n] == 'i') {
             isComplex = true;
-            endptr++;
+            n++;
         }
 
-        if (!endptr || endptr != tmp_str + olen) {
+        if (n <= 0 || n != olen) {
             return ks_throw(ks_T_ArgError, "Invalid float number: '%*s'", olen, ostr);
         }
 
@@ -226,6 +235,11 @@ ks_obj ks_num_parse(const char* str, int len, int base) {
         // numerical base; integer
         int64_t v64 = 0;
 
+        // most integers are short and in base 10, so parse them 8 digits at a time
+        if (base == KS_BASE_10 && len > 0 && *str != '-' && *str != '+' && ks_num_scan_int64(ostr, olen, &v64) == olen) {
+            return (ks_obj)ks_int_new(v64);
+        }
+
         i = 0;
         // parse out main value
         while (i < len) {
@@ -233,14 +247,13 @@ ks_obj ks_num_parse(const char* str, int len, int base) {
             // check for invalid/out of range digit
             if (dig < 0 || dig >= base) return ks_throw(ks_T_ArgError, "Invalid format for base %i integer: '%*s'", base, olen, ostr);
 
-            int64_t old_v64 = v64;
-            // calculate new value in 64 bits
-            v64 = base * v64 + dig;
-
-            if (v64 < old_v64) {
+            if (v64 > (INT64_MAX - dig) / base) {
                 // overflow
                 goto do_mpz_str;
             }
+
+            // calculate new value in 64 bits
+            v64 = base * v64 + dig;
             i++;
         }
 
@@ -259,7 +272,9 @@ ks_obj ks_num_parse(const char* str, int len, int base) {
         tmp_str[len] = '\0';
 
         // set from string
-        if (mpz_set_str(self, tmp_str, base) < 0) {
+        int rc = mpz_set_str(self, tmp_str, base);
+        ks_free(tmp_str);
+        if (rc < 0) {
             mpz_clear(self);
             return ks_throw(ks_T_ArgError, "Invalid format for base %i integer: '%*s'", base, olen, ostr);
         }
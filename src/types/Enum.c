@@ -118,7 +118,7 @@ static KS_TFUNC(Enum, create) {
     KS_GETARGS("name:* vals:*", &name, ks_T_str, &vals, ks_T_dict)
 
     // create empty type
-    ks_type enumtype = ks_Enum_create_c(name->chr, KS_ENUMVALS());
+    ks_type enumtype = ks_Enum_create_c(ks_str_cstr(name), KS_ENUMVALS());
 
     // get dictionaries required
     ks_str attr = ks_str_new("_enum_name2num");
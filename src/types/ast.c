@@ -151,6 +151,20 @@ ks_ast ks_ast_new_ret(ks_ast val) {
     return self;
 }
 
+// construct a new AST representing a yield statement
+ks_ast ks_ast_new_yield(ks_ast val) {
+    ks_ast self = KS_ALLOC_OBJ(ks_ast);
+    KS_INIT_OBJ(self, ks_T_ast);
+
+    // set specific variables
+    self->kind = KS_AST_YIELD;
+    self->tok = (struct ks_tok){ -1, -1 };
+    self->children = ks_list_new(1, (ks_obj*)&val);
+    self->dflag = 0;
+
+    return self;
+}
+
 // construct a new AST representing a throw statement
 ks_ast ks_ast_new_throw(ks_ast val) {
     ks_ast self = KS_ALLOC_OBJ(ks_ast);
@@ -0,0 +1,873 @@
+/* bytearray.c - mutable byte array type
+ *
+ * A bytearray owns a buffer which is grown geometrically, so appending to it is amortized O(1). A bytearray may also
+ *   be a view of a range of another bytearray (see `bytearray.view()`), which shares the memory instead of copying it.
+ *   Views hold an offset into their source (rather than a pointer), so they stay valid when the source is reallocated
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#include "ks-impl.h"
+
+
+/* Tuning/Performance parameters */
+
+// minimum capacity (in bytes) to allocate for a non-empty bytearray
+#define KS_BYTEARRAY_MIN 16
+
+
+// Create a new bytearray
+ks_bytearray ks_bytearray_new(const uint8_t* byt, ks_size_t len_b) {
+    ks_bytearray self = KS_ALLOC_OBJ(ks_bytearray);
+    KS_INIT_OBJ(self, ks_T_bytearray);
+
+    self->len_b = 0;
+    self->max_len_b = 0;
+    self->byt = NULL;
+    self->src = NULL;
+    self->off = 0;
+    self->n_exports = 0;
+
+    ks_bytearray_resize(self, len_b);
+    if (byt != NULL && len_b > 0) memcpy(self->byt, byt, len_b);
+
+    return self;
+}
+
+// Create a view of a bytearray
+ks_bytearray ks_bytearray_view(ks_bytearray src, ks_size_t start, ks_size_t len_b) {
+    ks_bytearray self = KS_ALLOC_OBJ(ks_bytearray);
+    KS_INIT_OBJ(self, ks_T_bytearray);
+
+    // views of views refer directly to the original
+    if (src->src != NULL) {
+        start += src->off;
+        src = src->src;
+    }
+
+    self->len_b = len_b;
+    self->max_len_b = 0;
+    self->byt = NULL;
+    self->src = (ks_bytearray)KS_NEWREF(src);
+    self->off = start;
+    self->n_exports = 0;
+
+    return self;
+}
+
+// Return a pointer to the bytes of a bytearray
+uint8_t* ks_bytearray_data(ks_bytearray self) {
+    if (self->src == NULL) return self->byt;
+
+    // ensure the source still contains the range that was viewed
+    if (self->off + self->len_b > self->src->len_b) {
+        ks_throw(ks_T_SizeError, "bytearray view of [%z, %z) is no longer valid, because its source has been shrunk to %z bytes", (ks_ssize_t)self->off, (ks_ssize_t)(self->off + self->len_b), (ks_ssize_t)self->src->len_b);
+        return NULL;
+    }
+
+    return self->src->byt + self->off;
+}
+
+// Resize a bytearray
+bool ks_bytearray_resize(ks_bytearray self, ks_size_t len_b) {
+    if (self->src != NULL) {
+        if (len_b == self->len_b) return true;
+        ks_throw(ks_T_SizeError, "bytearray views cannot be resized");
+        return false;
+    }
+
+    // consumers of the buffer hold a pointer to 'byt'
+    if (len_b != self->len_b && self->n_exports > 0) {
+        ks_throw(ks_T_SizeError, "bytearray cannot be resized while its buffer is held (for example, by an 'nx.view')");
+        return false;
+    }
+
+    if (len_b > self->max_len_b) {
+        // grow geometrically, so repeated appends are amortized O(1)
+        ks_size_t new_max = self->max_len_b * 2;
+        if (new_max < len_b) new_max = len_b;
+        if (new_max < KS_BYTEARRAY_MIN) new_max = KS_BYTEARRAY_MIN;
+
+        self->max_len_b = new_max;
+        self->byt = ks_realloc(self->byt, self->max_len_b);
+    }
+
+    // zero-fill any new bytes
+    if (len_b > self->len_b) memset(self->byt + self->len_b, 0, len_b - self->len_b);
+
+    self->len_b = len_b;
+    return true;
+}
+
+// Append bytes to a bytearray
+bool ks_bytearray_extend(ks_bytearray self, const uint8_t* byt, ks_size_t len_b) {
+    if (len_b == 0) return true;
+
+    // 'byt' may point into this bytearray's own buffer, which may be reallocated
+    bool isSelf = self->byt != NULL && byt >= self->byt && byt < self->byt + self->max_len_b;
+    ks_size_t self_off = isSelf ? byt - self->byt : 0;
+
+    ks_size_t start = self->len_b;
+    if (!ks_bytearray_resize(self, start + len_b)) return false;
+
+    memmove(self->byt + start, isSelf ? self->byt + self_off : byt, len_b);
+    return true;
+}
+
+
+/* Misc. Utilities */
+
+// get the bytes of a 'bytes-like' object (a bytes, bytearray, or str (as UTF-8)), and return whether it was one
+// NOTE: If 'obj' is a bytearray view that is no longer valid, an error is thrown and 'true' is returned, with '*byt==NULL'
+static bool ba_getbytes(ks_obj obj, const uint8_t** byt, ks_size_t* len_b) {
+    /**/ if (obj->type == ks_T_bytes) {
+        *byt = ((ks_bytes)obj)->byt;
+        *len_b = ((ks_bytes)obj)->len_b;
+    } else if (obj->type == ks_T_bytearray) {
+        *byt = ks_bytearray_data((ks_bytearray)obj);
+        *len_b = ((ks_bytearray)obj)->len_b;
+    } else if (obj->type == ks_T_str) {
+        *byt = (const uint8_t*)((ks_str)obj)->chr;
+        *len_b = ((ks_str)obj)->len_b;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+// get a single byte value from 'obj'
+// NOTE: Returns success, or false and throws an error
+static bool ba_getbyte(ks_obj obj, uint8_t* out) {
+    int64_t v64;
+    if (!ks_num_get_int64(obj, &v64)) return false;
+    if (v64 < 0 || v64 > 255) {
+        ks_throw(ks_T_ArgError, "Byte values must be in range(256), but got %i", (int)v64);
+        return false;
+    }
+
+    *out = (uint8_t)v64;
+    return true;
+}
+
+// append the contents of 'obj' (which is bytes-like, or an iterable of byte values) to 'self'
+// NOTE: Returns success, or false and throws an error
+static bool ba_extend_obj(ks_bytearray self, ks_obj obj) {
+    const uint8_t* byt;
+    ks_size_t len_b;
+    if (ba_getbytes(obj, &byt, &len_b)) {
+        return byt != NULL && ks_bytearray_extend(self, byt, len_b);
+    }
+
+    if (ks_buffer_has(obj)) {
+        // other exporters (e.g. `nx.array`) give their raw memory
+        ks_buffer buf;
+        if (!ks_buffer_get(obj, &buf, KS_BUFFER_CONTIG)) return false;
+        bool res = ks_bytearray_extend(self, buf.data, buf.len_b);
+        ks_buffer_release(&buf);
+        return res;
+    }
+
+    if (!ks_obj_is_iterable(obj)) {
+        ks_throw(ks_T_TypeError, "'%T' object is not bytes-like, or an iterable of byte values", obj);
+        return false;
+    }
+
+    struct ks_citer cit = ks_citer_make(obj);
+    ks_obj ob;
+    while ((ob = ks_citer_next(&cit)) != NULL) {
+        uint8_t c;
+        if (!ba_getbyte(ob, &c) || !ks_bytearray_extend(self, &c, 1)) cit.threwErr = true;
+        KS_DECREF(ob);
+    }
+
+    ks_citer_done(&cit);
+    return !cit.threwErr;
+}
+
+// get a (possibly negative) byte index into 'self', which must be within [0, len_b]
+// NOTE: Returns success, or false and throws an error
+static bool ba_getidx(ks_bytearray self, ks_obj idx, ks_size_t* out) {
+    int64_t v64;
+    if (!ks_num_get_int64(idx, &v64)) return false;
+    if (v64 < 0) v64 += self->len_b;
+    if (v64 < 0 || v64 > self->len_b) {
+        ks_throw(ks_T_KeyError, "'%T' object given invalid index: '%S'", self, idx);
+        return false;
+    }
+
+    *out = v64;
+    return true;
+}
+
+
+/* Packing */
+
+// Formats are made of an optional byte order ('<' for little endian, '>' or '!' for big endian, '=' or '@' for
+//   native), then a list of (optionally repeated, like '4B') codes:
+//   b/B - int8/uint8, h/H - int16/uint16, i/I - int32/uint32, q/Q - int64/uint64, f - float32, d - float64
+// Whitespace is ignored
+
+// iterate through the items in a format
+struct ba_fmt {
+
+    // the current position in the format string
+    const char* fmt;
+
+    // whether the items are little endian
+    bool isLE;
+
+    // the current code, and how many times it repeats
+    char code;
+    int64_t rep;
+
+};
+
+// return the size of the item 'code', or 0 if it is not valid
+static int ba_codesize(char code) {
+    switch (code) {
+        case 'b': case 'B': return 1;
+        case 'h': case 'H': return 2;
+        case 'i': case 'I': case 'f': return 4;
+        case 'q': case 'Q': case 'd': return 8;
+        default: return 0;
+    }
+}
+
+// begin iterating through a format
+static void ba_fmt_begin(struct ba_fmt* it, const char* fmt) {
+    static const uint16_t ba_endian_check = 1;
+    it->isLE = *(const uint8_t*)&ba_endian_check == 1;
+
+    while (*fmt == ' ') fmt++;
+    /**/ if (*fmt == '<') { it->isLE = true; fmt++; }
+    else if (*fmt == '>' || *fmt == '!') { it->isLE = false; fmt++; }
+    else if (*fmt == '=' || *fmt == '@') { fmt++; }
+
+    it->fmt = fmt;
+    it->code = '\0';
+    it->rep = 0;
+}
+
+// get the next code in the format (setting 'it->code' and 'it->rep'), returning 1 if there was one, 0 if the format
+//   is done, or -1 if an error was thrown
+static int ba_fmt_next(struct ba_fmt* it) {
+    while (*it->fmt == ' ') it->fmt++;
+    if (!*it->fmt) return 0;
+
+    it->rep = 1;
+    if (isdigit(*it->fmt)) {
+        it->rep = 0;
+        while (isdigit(*it->fmt)) it->rep = 10 * it->rep + (*it->fmt++ - '0');
+    }
+
+    it->code = *it->fmt;
+    if (!ba_codesize(it->code)) {
+        ks_throw(ks_T_ArgError, "Invalid pack format code: '%c'", it->code ? it->code : '?');
+        return -1;
+    }
+    it->fmt++;
+
+    return 1;
+}
+
+// calculate the total size (in bytes) and number of items in a format
+// NOTE: Returns success, or false and throws an error
+static bool ba_fmt_size(const char* fmt, ks_size_t* size, ks_size_t* n_items) {
+    struct ba_fmt it;
+    ba_fmt_begin(&it, fmt);
+
+    *size = *n_items = 0;
+
+    int st;
+    while ((st = ba_fmt_next(&it)) > 0) {
+        *size += it.rep * ba_codesize(it.code);
+        *n_items += it.rep;
+    }
+
+    return st == 0;
+}
+
+// store the 'sz' low bytes of 'v' at 'dest'
+static void ba_store(uint8_t* dest, uint64_t v, int sz, bool isLE) {
+    int i;
+    for (i = 0; i < sz; ++i) {
+        dest[isLE ? i : sz - 1 - i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+// load 'sz' bytes from 'src'
+static uint64_t ba_load(const uint8_t* src, int sz, bool isLE) {
+    uint64_t v = 0;
+    int i;
+    for (i = 0; i < sz; ++i) {
+        v |= (uint64_t)src[isLE ? i : sz - 1 - i] << (8 * i);
+    }
+    return v;
+}
+
+// pack a single item 'obj' as 'code' into 'dest'
+// NOTE: Returns success, or false and throws an error
+static bool ba_pack1(uint8_t* dest, char code, bool isLE, ks_obj obj) {
+    int sz = ba_codesize(code);
+
+    if (code == 'f' || code == 'd') {
+        double v;
+        if (!ks_num_get_double(obj, &v)) return false;
+
+        uint64_t bits;
+        if (code == 'f') {
+            float vf = v;
+            uint32_t b32;
+            memcpy(&b32, &vf, 4);
+            bits = b32;
+        } else {
+            memcpy(&bits, &v, 8);
+        }
+
+        ba_store(dest, bits, sz, isLE);
+        return true;
+    }
+
+    int64_t v;
+    if (code == 'Q') {
+        // handle the full unsigned range
+        mpz_t vz;
+        mpz_init(vz);
+        if (!ks_num_get_mpz(obj, vz)) {
+            mpz_clear(vz);
+            return false;
+        }
+        if (mpz_sgn(vz) < 0 || mpz_sizeinbase(vz, 2) > 64) {
+            mpz_clear(vz);
+            ks_throw(ks_T_ArgError, "Value %S is out of range for pack code '%c'", obj, code);
+            return false;
+        }
+
+        uint64_t vu = 0;
+        mpz_export(&vu, NULL, -1, sizeof(vu), 0, 0, vz);
+        mpz_clear(vz);
+
+        ba_store(dest, vu, sz, isLE);
+        return true;
+    }
+
+    if (!ks_num_get_int64(obj, &v)) return false;
+
+    // check the range of the code
+    int64_t lo, hi;
+    if (code == 'q') {
+        lo = INT64_MIN;
+        hi = INT64_MAX;
+    } else if (islower(code)) {
+        lo = -((int64_t)1 << (8 * sz - 1));
+        hi = ((int64_t)1 << (8 * sz - 1)) - 1;
+    } else {
+        lo = 0;
+        hi = ((int64_t)1 << (8 * sz)) - 1;
+    }
+
+    if (v < lo || v > hi) {
+        ks_throw(ks_T_ArgError, "Value %S is out of range for pack code '%c'", obj, code);
+        return false;
+    }
+
+    ba_store(dest, (uint64_t)v, sz, isLE);
+    return true;
+}
+
+// unpack a single item as 'code' from 'src'
+// NOTE: Returns a new reference
+static ks_obj ba_unpack1(const uint8_t* src, char code, bool isLE) {
+    int sz = ba_codesize(code);
+    uint64_t bits = ba_load(src, sz, isLE);
+
+    if (code == 'f') {
+        uint32_t b32 = bits;
+        float vf;
+        memcpy(&vf, &b32, 4);
+        return (ks_obj)ks_float_new(vf);
+    } else if (code == 'd') {
+        double v;
+        memcpy(&v, &bits, 8);
+        return (ks_obj)ks_float_new(v);
+    } else if (code == 'Q' && bits > INT64_MAX) {
+        mpz_t vz;
+        mpz_init(vz);
+        mpz_import(vz, 1, -1, sizeof(bits), 0, 0, &bits);
+        return (ks_obj)ks_int_new_mpz_n(vz);
+    } else if (islower(code) && sz < 8) {
+        // sign extend
+        int64_t v = (int64_t)(bits << (64 - 8 * sz)) >> (64 - 8 * sz);
+        return (ks_obj)ks_int_new(v);
+    } else {
+        return (ks_obj)ks_int_new((int64_t)bits);
+    }
+}
+
+
+/* Object Methods */
+
+// bytearray.__new__(obj=none) - create a new bytearray from bytes-like data, an iterable of byte values, or an
+//   integer number of zero bytes
+static KS_TFUNC(bytearray, new) {
+    ks_obj obj = KSO_NONE;
+    KS_GETARGS("?obj", &obj)
+
+    if (obj == KSO_NONE) return (ks_obj)ks_bytearray_new(NULL, 0);
+
+    if (ks_num_is_integral(obj)) {
+        int64_t len_b;
+        if (!ks_num_get_int64(obj, &len_b)) return NULL;
+        if (len_b < 0) return ks_throw(ks_T_ArgError, "Cannot create a bytearray of negative size");
+        return (ks_obj)ks_bytearray_new(NULL, len_b);
+    }
+
+    ks_bytearray self = ks_bytearray_new(NULL, 0);
+    if (!ba_extend_obj(self, obj)) {
+        KS_DECREF(self);
+        return NULL;
+    }
+
+    return (ks_obj)self;
+}
+
+// bytearray.__free__(self) - free obj
+static KS_TFUNC(bytearray, free) {
+    ks_bytearray self;
+    KS_GETARGS("self:*", &self, ks_T_bytearray)
+
+    ks_free(self->byt);
+    if (self->src != NULL) KS_DECREF(self->src);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// bytearray.__repr__(self) - get repr
+static KS_TFUNC(bytearray, repr) {
+    ks_bytearray self;
+    KS_GETARGS("self:*", &self, ks_T_bytearray)
+
+    uint8_t* byt = ks_bytearray_data(self);
+    if (!byt && self->len_b > 0) return NULL;
+
+    ks_str_builder sb = ks_str_builder_new();
+    ks_str_builder_add(sb, "bytearray(b'", 12);
+
+    // hex digits
+    static const char ba_hexdig[] = "0123456789ABCDEF";
+
+    ks_size_t i;
+    for (i = 0; i < self->len_b; ++i) {
+        char tmp[4] = { '\\', 'x', ba_hexdig[byt[i] / 16], ba_hexdig[byt[i] % 16] };
+        ks_str_builder_add(sb, tmp, 4);
+    }
+    ks_str_builder_add(sb, "')", 2);
+
+    ks_str ret = ks_str_builder_get(sb);
+    KS_DECREF(sb);
+    return (ks_obj)ret;
+}
+
+// bytearray.__bytes__(self) - convert to (immutable) bytes
+static KS_TFUNC(bytearray, bytes) {
+    ks_bytearray self;
+    KS_GETARGS("self:*", &self, ks_T_bytearray)
+
+    uint8_t* byt = ks_bytearray_data(self);
+    if (!byt && self->len_b > 0) return NULL;
+
+    return (ks_obj)ks_bytes_new(byt, self->len_b);
+}
+
+// bytearray.__len__(self) - get length
+static KS_TFUNC(bytearray, len) {
+    ks_bytearray self;
+    KS_GETARGS("self:*", &self, ks_T_bytearray)
+
+    return (ks_obj)ks_int_new(self->len_b);
+}
+
+// bytearray.__eq__(L, R) - whether two bytes-like objects have the same contents
+static KS_TFUNC(bytearray, eq) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    const uint8_t *lb = NULL, *rb = NULL;
+    ks_size_t ll = 0, rl = 0;
+    if ((L->type == ks_T_bytearray || L->type == ks_T_bytes) && (R->type == ks_T_bytearray || R->type == ks_T_bytes)
+        && ba_getbytes(L, &lb, &ll) && ba_getbytes(R, &rb, &rl)) {
+        if ((!lb && ll > 0) || (!rb && rl > 0)) return NULL;
+
+        return KSO_BOOL(ll == rl && (ll == 0 || memcmp(lb, rb, ll) == 0));
+    }
+
+    KS_THROW_BOP_ERR("==", L, R);
+}
+
+// bytearray.__ne__(L, R) - whether two bytes-like objects have different contents
+static KS_TFUNC(bytearray, ne) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    ks_obj res = bytearray_eq_(2, (ks_obj[]){ L, R });
+    if (!res) return NULL;
+
+    bool isEq = res == KSO_TRUE;
+    KS_DECREF(res);
+    return KSO_BOOL(!isEq);
+}
+
+// bytearray.__add__(L, R) - concatenate into a new bytearray
+static KS_TFUNC(bytearray, add) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    const uint8_t *lb, *rb;
+    ks_size_t ll, rl;
+    if (ba_getbytes(L, &lb, &ll) && ba_getbytes(R, &rb, &rl) && L->type != ks_T_str && R->type != ks_T_str) {
+        if ((!lb && ll > 0) || (!rb && rl > 0)) return NULL;
+
+        ks_bytearray ret = ks_bytearray_new(NULL, ll + rl);
+        if (ll > 0) memcpy(ret->byt, lb, ll);
+        if (rl > 0) memcpy(ret->byt + ll, rb, rl);
+        return (ks_obj)ret;
+    }
+
+    KS_THROW_BOP_ERR("+", L, R);
+}
+
+// bytearray.__getitem__(self, idx) - get a byte value, or a copy of a slice
+static KS_TFUNC(bytearray, getitem) {
+    ks_bytearray self;
+    ks_obj idx;
+    KS_GETARGS("self:* idx", &self, ks_T_bytearray, &idx)
+
+    uint8_t* byt = ks_bytearray_data(self);
+    if (!byt && self->len_b > 0) return NULL;
+
+    if (idx->type == ks_T_slice) {
+        int64_t first, last, delta;
+        if (!ks_slice_getci((ks_slice)idx, self->len_b, &first, &last, &delta)) return NULL;
+
+        ks_bytearray ret = ks_bytearray_new(NULL, (last - first) / delta);
+
+        int64_t i, ct = 0;
+        for (i = first; i != last; i += delta, ct++) {
+            ret->byt[ct] = byt[i];
+        }
+
+        return (ks_obj)ret;
+    }
+
+    ks_size_t i;
+    if (!ba_getidx(self, idx, &i)) return NULL;
+    if (i >= self->len_b) KS_THROW_INDEX_ERR(self, idx);
+
+    return (ks_obj)ks_int_new(byt[i]);
+}
+
+// bytearray.__setitem__(self, idx, val) - set a byte value, or replace a slice with bytes-like data (which may be a
+//   different length, if the slice is contiguous and 'self' is not a view)
+static KS_TFUNC(bytearray, setitem) {
+    ks_bytearray self;
+    ks_obj idx, val;
+    KS_GETARGS("self:* idx val", &self, ks_T_bytearray, &idx, &val)
+
+    uint8_t* byt = ks_bytearray_data(self);
+    if (!byt && self->len_b > 0) return NULL;
+
+    if (idx->type != ks_T_slice) {
+        ks_size_t i;
+        if (!ba_getidx(self, idx, &i)) return NULL;
+        if (i >= self->len_b) KS_THROW_INDEX_ERR(self, idx);
+
+        uint8_t c;
+        if (!ba_getbyte(val, &c)) return NULL;
+
+        byt[i] = c;
+        return KSO_NONE;
+    }
+
+    int64_t first, last, delta;
+    if (!ks_slice_getci((ks_slice)idx, self->len_b, &first, &last, &delta)) return NULL;
+    ks_size_t n = (last - first) / delta;
+
+    // get the replacement data, copying it in case it shares memory with 'self'
+    ks_bytearray rep = ks_bytearray_new(NULL, 0);
+    if (!ba_extend_obj(rep, val)) {
+        KS_DECREF(rep);
+        return NULL;
+    }
+
+    if (delta == 1) {
+        // contiguous, so the length may change
+        if (rep->len_b != n) {
+            ks_size_t old_len = self->len_b;
+            if (!ks_bytearray_resize(self, old_len - n + rep->len_b)) {
+                KS_DECREF(rep);
+                return NULL;
+            }
+
+            // move the tail into place
+            memmove(self->byt + first + rep->len_b, self->byt + first + n, old_len - first - n);
+            byt = self->byt;
+        }
+
+        if (rep->len_b > 0) memcpy(byt + first, rep->byt, rep->len_b);
+
+    } else {
+        if (rep->len_b != n) {
+            KS_DECREF(rep);
+            return ks_throw(ks_T_SizeError, "Cannot assign %z bytes to an extended slice of %z bytes", (ks_ssize_t)rep->len_b, (ks_ssize_t)n);
+        }
+
+        int64_t i, ct = 0;
+        for (i = first; i != last; i += delta, ct++) {
+            byt[i] = rep->byt[ct];
+        }
+    }
+
+    KS_DECREF(rep);
+    return KSO_NONE;
+}
+
+
+// bytearray.append(self, byte) - append a single byte value
+static KS_TFUNC(bytearray, append) {
+    ks_bytearray self;
+    ks_obj byte;
+    KS_GETARGS("self:* byte", &self, ks_T_bytearray, &byte)
+
+    uint8_t c;
+    if (!ba_getbyte(byte, &c)) return NULL;
+    if (!ks_bytearray_extend(self, &c, 1)) return NULL;
+
+    return KSO_NONE;
+}
+
+// bytearray.extend(self, data) - append bytes-like data, or an iterable of byte values
+static KS_TFUNC(bytearray, extend) {
+    ks_bytearray self;
+    ks_obj data;
+    KS_GETARGS("self:* data", &self, ks_T_bytearray, &data)
+
+    if (!ba_extend_obj(self, data)) return NULL;
+
+    return KSO_NONE;
+}
+
+// bytearray.view(self, start=0, end=none) - return a view of a range of bytes, which shares memory with 'self'
+static KS_TFUNC(bytearray, view) {
+    ks_bytearray self;
+    ks_obj start = KSO_NONE, end = KSO_NONE;
+    KS_GETARGS("self:* ?start ?end", &self, ks_T_bytearray, &start, &end)
+
+    ks_size_t start_b = 0, end_b = self->len_b;
+    if (start != KSO_NONE && !ba_getidx(self, start, &start_b)) return NULL;
+    if (end != KSO_NONE && !ba_getidx(self, end, &end_b)) return NULL;
+    if (end_b < start_b) end_b = start_b;
+
+    return (ks_obj)ks_bytearray_view(self, start_b, end_b - start_b);
+}
+
+// bytearray.pack(self, fmt, offset, *vals) - pack values into the bytes at 'offset' (growing, if it is past the end)
+static KS_TFUNC(bytearray, pack) {
+    ks_bytearray self;
+    ks_str fmt;
+    ks_obj offset;
+    int n_vals;
+    ks_obj* vals;
+    KS_GETARGS("self:* fmt:* offset *vals", &self, ks_T_bytearray, &fmt, ks_T_str, &offset, &n_vals, &vals)
+
+    ks_size_t off;
+    if (!ba_getidx(self, offset, &off)) return NULL;
+
+    ks_size_t size, n_items;
+    if (!ba_fmt_size(ks_str_cstr(fmt), &size, &n_items)) return NULL;
+    if (n_items != n_vals) return ks_throw(ks_T_ArgError, "Pack format %R requires %z values, but %i were given", fmt, (ks_ssize_t)n_items, n_vals);
+
+    if (off + size > self->len_b && !ks_bytearray_resize(self, off + size)) return NULL;
+    uint8_t* byt = ks_bytearray_data(self);
+    if (!byt && self->len_b > 0) return NULL;
+
+    struct ba_fmt it;
+    ba_fmt_begin(&it, ks_str_cstr(fmt));
+
+    int vi = 0;
+    while (ba_fmt_next(&it) > 0) {
+        int64_t j;
+        for (j = 0; j < it.rep; ++j) {
+            if (!ba_pack1(byt + off, it.code, it.isLE, vals[vi++])) return NULL;
+            off += ba_codesize(it.code);
+        }
+    }
+
+    return KSO_NONE;
+}
+
+// bytearray.unpack(self, fmt, offset=0) - unpack values from the bytes at 'offset', returning a tuple
+static KS_TFUNC(bytearray, unpack) {
+    ks_bytearray self;
+    ks_str fmt;
+    ks_obj offset = KSO_NONE;
+    KS_GETARGS("self:* fmt:* ?offset", &self, ks_T_bytearray, &fmt, ks_T_str, &offset)
+
+    ks_size_t off = 0;
+    if (offset != KSO_NONE && !ba_getidx(self, offset, &off)) return NULL;
+
+    ks_size_t size, n_items;
+    if (!ba_fmt_size(ks_str_cstr(fmt), &size, &n_items)) return NULL;
+    if (off + size > self->len_b) return ks_throw(ks_T_SizeError, "Unpack format %R requires %z bytes at offset %z, but only %z are available", fmt, (ks_ssize_t)size, (ks_ssize_t)off, (ks_ssize_t)(self->len_b - off));
+
+    uint8_t* byt = ks_bytearray_data(self);
+    if (!byt && self->len_b > 0) return NULL;
+
+    ks_tuple ret = ks_tuple_new_n(n_items, NULL);
+
+    struct ba_fmt it;
+    ba_fmt_begin(&it, ks_str_cstr(fmt));
+
+    ks_size_t vi = 0;
+    while (ba_fmt_next(&it) > 0) {
+        int64_t j;
+        for (j = 0; j < it.rep; ++j) {
+            ret->elems[vi++] = ba_unpack1(byt + off, it.code, it.isLE);
+            off += ba_codesize(it.code);
+        }
+    }
+
+    return (ks_obj)ret;
+}
+
+
+/* iterator type */
+
+// ks_bytearray_iter - type describing a bytearray iterator
+typedef struct {
+    KS_OBJ_BASE
+
+    // the object being iterated
+    ks_bytearray self;
+
+    // current position
+    ks_size_t pos;
+
+}* ks_bytearray_iter;
+
+// declare type
+KS_TYPE_DECLFWD(ks_T_bytearray_iter);
+
+// bytearray_iter.__free__(self) - free obj
+static KS_TFUNC(bytearray_iter, free) {
+    ks_bytearray_iter self;
+    KS_GETARGS("self:*", &self, ks_T_bytearray_iter)
+
+    KS_DECREF(self->self);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// bytearray_iter.__next__(self) - return next byte value
+static KS_TFUNC(bytearray_iter, next) {
+    ks_bytearray_iter self;
+    KS_GETARGS("self:*", &self, ks_T_bytearray_iter)
+
+    // check for out of bounds (the bytearray may have been resized while iterating)
+    if (self->pos >= self->self->len_b) return ks_throw(ks_T_OutOfIterError, "");
+
+    uint8_t* byt = ks_bytearray_data(self->self);
+    if (!byt) return NULL;
+
+    return (ks_obj)ks_int_new(byt[self->pos++]);
+}
+
+// bytearray.__iter__(self) - return iterator
+static KS_TFUNC(bytearray, iter) {
+    ks_bytearray self;
+    KS_GETARGS("self:*", &self, ks_T_bytearray)
+
+    ks_bytearray_iter ret = KS_ALLOC_OBJ(ks_bytearray_iter);
+    KS_INIT_OBJ(ret, ks_T_bytearray_iter);
+
+    ret->self = self;
+    KS_INCREF(self);
+    ret->pos = 0;
+
+    return (ks_obj)ret;
+}
+
+
+// buffer protocol: the (writable) bytes, shared with any views
+static bool bytearray_getbuf(ks_obj self, ks_buffer* buf, int flags) {
+    // an empty bytearray may not have any memory, so it gets a (zero-length) placeholder
+    static uint8_t empty[1];
+
+    uint8_t* byt = ks_bytearray_data((ks_bytearray)self);
+    if (!byt) {
+        // only a view that is no longer valid has thrown an error
+        if (((ks_bytearray)self)->src != NULL) return false;
+        byt = empty;
+    }
+
+    ks_buffer_init_bytes(buf, self, byt, ((ks_bytearray)self)->len_b, false);
+
+    // the memory belongs to the source of a view, so that is what can't be resized
+    ks_bytearray root = ((ks_bytearray)self)->src ? ((ks_bytearray)self)->src : (ks_bytearray)self;
+    root->n_exports++;
+    return true;
+}
+
+// buffer protocol: allow resizing again, once all the buffers are released
+static void bytearray_relbuf(ks_obj self, ks_buffer* buf) {
+    ks_bytearray root = ((ks_bytearray)self)->src ? ((ks_bytearray)self)->src : (ks_bytearray)self;
+    root->n_exports--;
+}
+
+
+/* export */
+
+KS_TYPE_DECLFWD(ks_T_bytearray);
+
+void ks_init_T_bytearray() {
+
+    ks_type_init_c(ks_T_bytearray, "bytearray", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(bytearray_new_, "bytearray.__new__(obj=none)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(bytearray_free_, "bytearray.__free__(self)")},
+        {"__iter__",               (ks_obj)ks_cfunc_new_c_old(bytearray_iter_, "bytearray.__iter__(self)")},
+
+        {"__repr__",               (ks_obj)ks_cfunc_new_c_old(bytearray_repr_, "bytearray.__repr__(self)")},
+        {"__str__",                (ks_obj)ks_cfunc_new_c_old(bytearray_repr_, "bytearray.__str__(self)")},
+        {"__bytes__",              (ks_obj)ks_cfunc_new_c_old(bytearray_bytes_, "bytearray.__bytes__(self)")},
+        {"__len__",                (ks_obj)ks_cfunc_new_c_old(bytearray_len_, "bytearray.__len__(self)")},
+
+        {"__eq__",                 (ks_obj)ks_cfunc_new_c_old(bytearray_eq_, "bytearray.__eq__(L, R)")},
+        {"__ne__",                 (ks_obj)ks_cfunc_new_c_old(bytearray_ne_, "bytearray.__ne__(L, R)")},
+        {"__add__",                (ks_obj)ks_cfunc_new_c_old(bytearray_add_, "bytearray.__add__(L, R)")},
+
+        {"__getitem__",            (ks_obj)ks_cfunc_new_c_old(bytearray_getitem_, "bytearray.__getitem__(self, idx)")},
+        {"__setitem__",            (ks_obj)ks_cfunc_new_c_old(bytearray_setitem_, "bytearray.__setitem__(self, idx, val)")},
+
+        {"append",                 (ks_obj)ks_cfunc_new_c_old(bytearray_append_, "bytearray.append(self, byte)")},
+        {"extend",                 (ks_obj)ks_cfunc_new_c_old(bytearray_extend_, "bytearray.extend(self, data)")},
+        {"view",                   (ks_obj)ks_cfunc_new_c_old(bytearray_view_, "bytearray.view(self, start=0, end=none)")},
+
+        {"pack",                   (ks_obj)ks_cfunc_new_c_old(bytearray_pack_, "bytearray.pack(self, fmt, offset, *vals)")},
+        {"unpack",                 (ks_obj)ks_cfunc_new_c_old(bytearray_unpack_, "bytearray.unpack(self, fmt, offset=0)")},
+    ));
+
+    ks_T_bytearray->getbuf = bytearray_getbuf;
+    ks_T_bytearray->relbuf = bytearray_relbuf;
+
+    ks_type_init_c(ks_T_bytearray_iter, "bytearray_iter", ks_T_object, KS_KEYVALS(
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(bytearray_iter_free_, "bytearray_iter.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(bytearray_iter_next_, "bytearray_iter.__next__(self)")},
+    ));
+
+}
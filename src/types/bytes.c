@@ -11,12 +11,12 @@
 #define KS_BYTE_MAX 255
 
 // global singletons (+ 1 for empty constant)
-static struct ks_bytes_s KS_BYTES[KS_BYTE_MAX + 1];
+static struct ks_bytes_s KS_BYTES[KS_BYTE_MAX + 2];
 
 
 // Create new bytes array
 ks_bytes ks_bytes_new(const uint8_t* byt, ks_size_t len_b) {
-    /**/ if (len_b == 0) return &KS_BYTES[KS_BYTE_MAX];
+    /**/ if (len_b == 0) return &KS_BYTES[KS_BYTE_MAX + 1];
     else if (len_b == 1) return &KS_BYTES[*byt];
     else {
         // construct it
@@ -74,7 +74,7 @@ static KS_TFUNC(bytes, repr) {
     ks_str_builder_add_fmt(sb, "b'");
 
     // hex digits
-    static const char bytes_hexdig[] = "012345689ABCDEF";
+    static const char bytes_hexdig[] = "0123456789ABCDEF";
 
     ks_size_t i;
     for (i = 0; i < self->len_b; ++i) {
@@ -97,6 +97,51 @@ static KS_TFUNC(bytes, len) {
 }
 
 
+// get the bytes of 'obj', if it is a bytes or bytearray, returning whether it was one
+// NOTE: If 'obj' is a bytearray view that is no longer valid, an error is thrown and '*byt' is set to NULL
+static bool bytes_get(ks_obj obj, const uint8_t** byt, ks_size_t* len_b) {
+    /**/ if (obj->type == ks_T_bytes) {
+        *byt = ((ks_bytes)obj)->byt;
+        *len_b = ((ks_bytes)obj)->len_b;
+    } else if (obj->type == ks_T_bytearray) {
+        *byt = ks_bytearray_data((ks_bytearray)obj);
+        *len_b = ((ks_bytearray)obj)->len_b;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+// bytes.__eq__(L, R) - whether two bytes-like objects have the same contents
+static KS_TFUNC(bytes, eq) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    const uint8_t *lb, *rb;
+    ks_size_t ll, rl;
+    if (bytes_get(L, &lb, &ll) && bytes_get(R, &rb, &rl)) {
+        if ((!lb && ll > 0) || (!rb && rl > 0)) return NULL;
+        return KSO_BOOL(ll == rl && (ll == 0 || memcmp(lb, rb, ll) == 0));
+    }
+
+    KS_THROW_BOP_ERR("==", L, R);
+}
+
+// bytes.__ne__(L, R) - whether two bytes-like objects have different contents
+static KS_TFUNC(bytes, ne) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    ks_obj res = bytes_eq_(2, (ks_obj[]){ L, R });
+    if (!res) return NULL;
+
+    bool isEq = res == KSO_TRUE;
+    KS_DECREF(res);
+    return KSO_BOOL(!isEq);
+}
+
+
 /* iterator type */
 
 // ks_bytes_iter - type describing a string iterator
@@ -154,6 +199,14 @@ static KS_TFUNC(bytes, iter) {
 }
 
 
+// buffer protocol: the (immutable) bytes
+static bool bytes_getbuf(ks_obj self, ks_buffer* buf, int flags) {
+    ks_bytes b = (ks_bytes)self;
+    ks_buffer_init_bytes(buf, self, b->byt, b->len_b, true);
+    return true;
+}
+
+
 /* export */
 
 KS_TYPE_DECLFWD(ks_T_bytes);
@@ -162,7 +215,7 @@ void ks_init_T_bytes() {
 
     // initialize global singletons
     int i;
-    for (i = 0; i < KS_BYTE_MAX; ++i) {
+    for (i = 0; i <= KS_BYTE_MAX; ++i) {
         ks_bytes tc = &KS_BYTES[i];
         KS_INIT_OBJ(tc, ks_T_bytes);
         tc->len_b = 1;
@@ -186,8 +239,13 @@ void ks_init_T_bytes() {
         {"__str__",                (ks_obj)ks_cfunc_new_c_old(bytes_repr_, "bytes.__str__(self)")},
         {"__len__",                (ks_obj)ks_cfunc_new_c_old(bytes_len_, "bytes.__len__(self)")},
 
+        {"__eq__",                 (ks_obj)ks_cfunc_new_c_old(bytes_eq_, "bytes.__eq__(L, R)")},
+        {"__ne__",                 (ks_obj)ks_cfunc_new_c_old(bytes_ne_, "bytes.__ne__(L, R)")},
+
     ));
 
+    ks_T_bytes->getbuf = bytes_getbuf;
+
     ks_type_init_c(ks_T_bytes_iter, "bytes_iter", ks_T_object, KS_KEYVALS(
         {"__free__",               (ks_obj)ks_cfunc_new_c_old(bytes_iter_free_, "bytes_iter.__free__(self)")},
         {"__next__",               (ks_obj)ks_cfunc_new_c_old(bytes_iter_next_, "bytes_iter.__next__(self)")},
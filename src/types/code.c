@@ -33,6 +33,8 @@ ks_code ks_code_new(ks_list v_const, ks_parser parser) {
     self->meta_n = 0;
     self->meta = NULL;
 
+    self->isGen = false;
+
     return self;
 }
 
@@ -106,6 +108,7 @@ void ksca_list_add_iter (ks_code self) KSCA_B(KSB_LIST_ADD_ITER)
 void ksca_buildstr  (ks_code self, int n_items) KSCA_B_I32(KSB_BUILDSTR, n_items)
 
 void ksca_ret    (ks_code self) KSCA_B(KSB_RET)
+void ksca_yield  (ks_code self) KSCA_B(KSB_YIELD)
 void ksca_throw  (ks_code self) KSCA_B(KSB_THROW)
 void ksca_assert (ks_code self) KSCA_B(KSB_ASSERT)
 void ksca_jmp    (ks_code self, int relamt) KSCA_B_I32(KSB_JMP, relamt)
@@ -257,6 +260,10 @@ static KS_TFUNC(code, str) {
             ks_str_builder_add_fmt(sb, "ret");
             break;
 
+        case KSB_YIELD:
+            ks_str_builder_add_fmt(sb, "yield");
+            break;
+
         case KSB_THROW:
             ks_str_builder_add_fmt(sb, "throw");
             break;
@@ -22,39 +22,23 @@ static KS_TFUNC(complex, str) {
     ks_complex self;
     KS_GETARGS("self:*", &self, ks_T_complex)
 
-    char cstr[260];
+    char cstr[2 * KS_NUM_FMT_MAX + 4];
     int len = 0;
     if (fabs(creal(self->val)) < 1e-14) {
         // just imaginary part
-
-        snprintf(cstr, 255, "%.9lf", cimag(self->val));
-        len = strlen(cstr);
-
-        while (len > 1 && cstr[len - 1] == '0' && cstr[len - 2] != '.') {
-            len--;
-        }
-
+        len += ks_num_fmt_double(cstr + len, cimag(self->val));
         cstr[len++] = 'i';
-        cstr[len] = '\0';
 
     } else {
         // real + imaginary, even if imaginary is 0, so it is obvious it is a complex number
-        snprintf(cstr, 255, "(%.9lf", creal(self->val));
-
-        len = strlen(cstr);
-        while (len > 1 && cstr[len - 1] == '0' && cstr[len - 2] != '.') {
-            len--;
-        }
+        cstr[len++] = '(';
+        len += ks_num_fmt_double(cstr + len, creal(self->val));
 
         // now, print out imaginary
-        snprintf(cstr+len, 255-len, "%+.9lf", cimag(self->val));
-        len = strlen(cstr);
-        while (len > 1 && cstr[len - 1] == '0' && cstr[len - 2] != '.') {
-            len--;
-        }
+        if (!signbit(cimag(self->val))) cstr[len++] = '+';
+        len += ks_num_fmt_double(cstr + len, cimag(self->val));
         cstr[len++] = 'i';
         cstr[len++] = ')';
-        cstr[len] = '\0';
 
     }
 
@@ -0,0 +1,381 @@
+/* deque.c - implementation of the 'deque' type, a double-ended queue
+ *
+ * The elements are stored in a ring buffer whose capacity is a power of 2, so pushing & popping at either end is
+ *   O(1) (amortized, when growing), unlike a list, where removing from the front moves every other element
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#include "ks-impl.h"
+
+
+/* Tuning/Performance parameters */
+
+// smallest capacity allocated
+#define KS_DEQUE_MIN_LEN 8
+
+
+// get the element at (logical) index 'i'
+#define DEQUE_AT(_self, _i) ((_self)->elems[((_self)->head + (_i)) & ((_self)->max_len - 1)])
+
+
+// Create a new (empty) deque
+ks_deque ks_deque_new() {
+    ks_deque self = KS_ALLOC_OBJ(ks_deque);
+    KS_INIT_OBJ(self, ks_T_deque);
+
+    self->len = 0;
+    self->max_len = 0;
+    self->head = 0;
+    self->elems = NULL;
+
+    return self;
+}
+
+// ensure there is room for one more element
+static void deque_grow(ks_deque self) {
+    if (self->len < self->max_len) return;
+
+    ks_size_t new_max_len = self->max_len == 0 ? KS_DEQUE_MIN_LEN : 2 * self->max_len;
+    ks_obj* new_elems = ks_malloc(sizeof(*new_elems) * new_max_len);
+
+    // unwrap the elements so they start at 0
+    ks_size_t i;
+    for (i = 0; i < self->len; ++i) new_elems[i] = DEQUE_AT(self, i);
+
+    ks_free(self->elems);
+    self->elems = new_elems;
+    self->max_len = new_max_len;
+    self->head = 0;
+}
+
+void ks_deque_push(ks_deque self, ks_obj obj) {
+    deque_grow(self);
+
+    DEQUE_AT(self, self->len) = KS_NEWREF(obj);
+    self->len++;
+}
+
+void ks_deque_pushleft(ks_deque self, ks_obj obj) {
+    deque_grow(self);
+
+    self->head = (self->head - 1) & (self->max_len - 1);
+    self->elems[self->head] = KS_NEWREF(obj);
+    self->len++;
+}
+
+ks_obj ks_deque_pop(ks_deque self) {
+    if (self->len < 1) return ks_throw(ks_T_SizeError, "'deque' object had no elements to pop!");
+
+    self->len--;
+    return DEQUE_AT(self, self->len);
+}
+
+ks_obj ks_deque_popleft(ks_deque self) {
+    if (self->len < 1) return ks_throw(ks_T_SizeError, "'deque' object had no elements to pop!");
+
+    ks_obj ret = self->elems[self->head];
+    self->head = (self->head + 1) & (self->max_len - 1);
+    self->len--;
+    return ret;
+}
+
+// remove all elements
+static void deque_clear(ks_deque self) {
+    ks_size_t i;
+    for (i = 0; i < self->len; ++i) KS_DECREF(DEQUE_AT(self, i));
+
+    self->len = 0;
+    self->head = 0;
+}
+
+// push all of 'objs' on to the back (or front, if 'left') of 'self'
+// NOTE: Returns success, or false and throws an error
+static bool deque_extend(ks_deque self, ks_obj objs, bool left) {
+    if (objs == (ks_obj)self) {
+        // take a snapshot first, since iterating would see the new elements
+        ks_list snap = ks_list_new_iter(objs);
+        if (!snap) return false;
+        bool res = deque_extend(self, (ks_obj)snap, left);
+        KS_DECREF(snap);
+        return res;
+    }
+
+    struct ks_citer cit = ks_citer_make(objs);
+    ks_obj ob;
+    while ((ob = ks_citer_next(&cit)) != NULL) {
+        if (left) ks_deque_pushleft(self, ob);
+        else ks_deque_push(self, ob);
+        KS_DECREF(ob);
+    }
+
+    ks_citer_done(&cit);
+    return !cit.threwErr;
+}
+
+// get a (possibly negative) index into 'self'
+// NOTE: Returns success, or false and throws an error
+static bool deque_getidx(ks_deque self, ks_obj idx, ks_size_t* out) {
+    int64_t v64;
+    if (!ks_num_get_int64(idx, &v64)) return false;
+    if (v64 < 0) v64 += self->len;
+    if (v64 < 0 || v64 >= self->len) {
+        ks_throw(ks_T_KeyError, "'%T' object given invalid index: '%S'", self, idx);
+        return false;
+    }
+
+    *out = v64;
+    return true;
+}
+
+
+// deque.__new__(objs=none) - create a new deque
+static KS_TFUNC(deque, new) {
+    ks_obj objs = KSO_NONE;
+    KS_GETARGS("?objs", &objs)
+
+    ks_deque self = ks_deque_new();
+
+    if (objs != KSO_NONE && !deque_extend(self, objs, false)) {
+        KS_DECREF(self);
+        return NULL;
+    }
+
+    return (ks_obj)self;
+}
+
+// deque.__free__(self) - free obj
+static KS_TFUNC(deque, free) {
+    ks_deque self;
+    KS_GETARGS("self:*", &self, ks_T_deque)
+
+    deque_clear(self);
+    ks_free(self->elems);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// deque.__str__(self) - to string
+static KS_TFUNC(deque, str) {
+    ks_deque self;
+    KS_GETARGS("self:*", &self, ks_T_deque)
+
+    ks_str_builder sb = ks_str_builder_new();
+
+    ks_str_builder_add(sb, "deque([", 7);
+
+    ks_size_t i;
+    for (i = 0; i < self->len; ++i) {
+        if (i > 0) ks_str_builder_add(sb, ", ", 2);
+        ks_str_builder_add_repr(sb, DEQUE_AT(self, i));
+    }
+
+    ks_str_builder_add(sb, "])", 2);
+
+    ks_str ret = ks_str_builder_get(sb);
+    KS_DECREF(sb);
+    return (ks_obj)ret;
+}
+
+// deque.__len__(self) - get length
+static KS_TFUNC(deque, len) {
+    ks_deque self;
+    KS_GETARGS("self:*", &self, ks_T_deque)
+
+    return (ks_obj)ks_int_new(self->len);
+}
+
+// deque.__getitem__(self, idx) - get an element (which is O(1), at any index)
+static KS_TFUNC(deque, getitem) {
+    ks_deque self;
+    ks_obj idx;
+    KS_GETARGS("self:* idx", &self, ks_T_deque, &idx)
+
+    ks_size_t i;
+    if (!deque_getidx(self, idx, &i)) return NULL;
+
+    return KS_NEWREF(DEQUE_AT(self, i));
+}
+
+// deque.__setitem__(self, idx, val) - set an element
+static KS_TFUNC(deque, setitem) {
+    ks_deque self;
+    ks_obj idx, val;
+    KS_GETARGS("self:* idx val", &self, ks_T_deque, &idx, &val)
+
+    ks_size_t i;
+    if (!deque_getidx(self, idx, &i)) return NULL;
+
+    KS_INCREF(val);
+    KS_DECREF(DEQUE_AT(self, i));
+    DEQUE_AT(self, i) = val;
+
+    return KS_NEWREF(val);
+}
+
+// deque.push(self, *objs) - push objects on to the back
+static KS_TFUNC(deque, push) {
+    ks_deque self;
+    int n_objs;
+    ks_obj* objs;
+    KS_GETARGS("self:* *objs", &self, ks_T_deque, &n_objs, &objs)
+
+    int i;
+    for (i = 0; i < n_objs; ++i) ks_deque_push(self, objs[i]);
+
+    return KSO_NONE;
+}
+
+// deque.pushleft(self, *objs) - push objects on to the front (so the last one given ends up first)
+static KS_TFUNC(deque, pushleft) {
+    ks_deque self;
+    int n_objs;
+    ks_obj* objs;
+    KS_GETARGS("self:* *objs", &self, ks_T_deque, &n_objs, &objs)
+
+    int i;
+    for (i = 0; i < n_objs; ++i) ks_deque_pushleft(self, objs[i]);
+
+    return KSO_NONE;
+}
+
+// deque.pop(self) - pop an object off of the back
+static KS_TFUNC(deque, pop) {
+    ks_deque self;
+    KS_GETARGS("self:*", &self, ks_T_deque)
+
+    return ks_deque_pop(self);
+}
+
+// deque.popleft(self) - pop an object off of the front
+static KS_TFUNC(deque, popleft) {
+    ks_deque self;
+    KS_GETARGS("self:*", &self, ks_T_deque)
+
+    return ks_deque_popleft(self);
+}
+
+// deque.extend(self, objs) - push all of 'objs' on to the back
+static KS_TFUNC(deque, extend) {
+    ks_deque self;
+    ks_obj objs;
+    KS_GETARGS("self:* objs", &self, ks_T_deque, &objs)
+
+    if (!deque_extend(self, objs, false)) return NULL;
+
+    return KSO_NONE;
+}
+
+// deque.extendleft(self, objs) - push all of 'objs' on to the front (in reverse order)
+static KS_TFUNC(deque, extendleft) {
+    ks_deque self;
+    ks_obj objs;
+    KS_GETARGS("self:* objs", &self, ks_T_deque, &objs)
+
+    if (!deque_extend(self, objs, true)) return NULL;
+
+    return KSO_NONE;
+}
+
+// deque.clear(self) - remove all elements
+static KS_TFUNC(deque, clear) {
+    ks_deque self;
+    KS_GETARGS("self:*", &self, ks_T_deque)
+
+    deque_clear(self);
+
+    return KSO_NONE;
+}
+
+
+/* Iterator Type */
+
+// ks_deque_iter - deque iterable type
+typedef struct {
+    KS_OBJ_BASE
+
+    // deque being iterated
+    ks_deque self;
+
+    // current (logical) position
+    ks_size_t pos;
+
+}* ks_deque_iter;
+
+KS_TYPE_DECLFWD(ks_T_deque_iter);
+
+// deque_iter.__free__(self) - free obj
+static KS_TFUNC(deque_iter, free) {
+    ks_deque_iter self;
+    KS_GETARGS("self:*", &self, ks_T_deque_iter)
+
+    KS_DECREF(self->self);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// deque_iter.__next__(self) - return next element
+static KS_TFUNC(deque_iter, next) {
+    ks_deque_iter self;
+    KS_GETARGS("self:*", &self, ks_T_deque_iter)
+
+    if (self->pos >= self->self->len) return ks_throw(ks_T_OutOfIterError, "");
+
+    ks_obj ret = DEQUE_AT(self->self, self->pos);
+    self->pos++;
+    return KS_NEWREF(ret);
+}
+
+// deque.__iter__(self) - return iterator
+static KS_TFUNC(deque, iter) {
+    ks_deque self;
+    KS_GETARGS("self:*", &self, ks_T_deque)
+
+    ks_deque_iter ret = KS_ALLOC_OBJ(ks_deque_iter);
+    KS_INIT_OBJ(ret, ks_T_deque_iter);
+
+    ret->self = self;
+    KS_INCREF(self);
+    ret->pos = 0;
+
+    return (ks_obj)ret;
+}
+
+
+/* export */
+
+KS_TYPE_DECLFWD(ks_T_deque);
+
+void ks_init_T_deque() {
+    ks_type_init_c(ks_T_deque, "deque", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(deque_new_, "deque.__new__(objs=none)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(deque_free_, "deque.__free__(self)")},
+        {"__str__",                (ks_obj)ks_cfunc_new_c_old(deque_str_, "deque.__str__(self)")},
+        {"__repr__",               (ks_obj)ks_cfunc_new_c_old(deque_str_, "deque.__repr__(self)")},
+
+        {"__len__",                (ks_obj)ks_cfunc_new_c_old(deque_len_, "deque.__len__(self)")},
+        {"__iter__",               (ks_obj)ks_cfunc_new_c_old(deque_iter_, "deque.__iter__(self)")},
+
+        {"__getitem__",            (ks_obj)ks_cfunc_new_c_old(deque_getitem_, "deque.__getitem__(self, idx)")},
+        {"__setitem__",            (ks_obj)ks_cfunc_new_c_old(deque_setitem_, "deque.__setitem__(self, idx, val)")},
+
+        {"push",                   (ks_obj)ks_cfunc_new_c_old(deque_push_, "deque.push(self, *objs)")},
+        {"pushleft",               (ks_obj)ks_cfunc_new_c_old(deque_pushleft_, "deque.pushleft(self, *objs)")},
+        {"pop",                    (ks_obj)ks_cfunc_new_c_old(deque_pop_, "deque.pop(self)")},
+        {"popleft",                (ks_obj)ks_cfunc_new_c_old(deque_popleft_, "deque.popleft(self)")},
+        {"extend",                 (ks_obj)ks_cfunc_new_c_old(deque_extend_, "deque.extend(self, objs)")},
+        {"extendleft",             (ks_obj)ks_cfunc_new_c_old(deque_extendleft_, "deque.extendleft(self, objs)")},
+        {"clear",                  (ks_obj)ks_cfunc_new_c_old(deque_clear_, "deque.clear(self)")},
+    ));
+
+    ks_type_init_c(ks_T_deque_iter, "deque_iter", ks_T_object, KS_KEYVALS(
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(deque_iter_free_, "deque_iter.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(deque_iter_next_, "deque_iter.__next__(self)")},
+    ));
+}
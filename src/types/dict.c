@@ -104,6 +104,8 @@ static int next_prime(int x) {
     return i;
 }
 
+static void dict_resize(ks_dict self, ks_size_t new_n_buckets);
+
 // Construct a new dictionary from key, val pairs (elems[0], elems[1] is the first, elems[2*i+0], elems[2*i+1] makes up the i'th pair)
 // NOTE: `len%2==0` is a requirement!
 // NOTE: Returns new reference, or NULL if an error was thrown
@@ -115,12 +117,20 @@ ks_dict ks_dict_new(ks_size_t len, ks_obj* elems) {
 
     // empty entries
     self->n_entries = 0;
+    self->max_n_entries = 0;
     self->entries = NULL;
 
     // empty buckets
     self->n_buckets = 0;
     self->buckets = NULL;
 
+    if (len > 0) {
+        // size it for all the pairs
+        self->max_n_entries = len / 2;
+        self->entries = ks_malloc(sizeof(*self->entries) * self->max_n_entries);
+        dict_resize(self, (ks_size_t)(len / 2 / KS_DICT_NEW_LOAD) + 1);
+    }
+
     ks_size_t i;
     for (i = 0; i < len / 2; ++i) {
         // get key/val pair
@@ -336,7 +346,10 @@ bool ks_dict_set_h(ks_dict self, ks_obj key, ks_hash_t hash, ks_obj val) {
         if (ei == KS_DICT_BUCKET_EMPTY) {
             // we have found an empty bucket before a corresponding entry, so we can safely replace it
             ei = self->n_entries++;
-            self->entries = ks_realloc(self->entries, sizeof(*self->entries) * self->n_entries);
+            if (self->n_entries > self->max_n_entries) {
+                self->max_n_entries = self->n_entries + self->n_entries / 2 + 4;
+                self->entries = ks_realloc(self->entries, sizeof(*self->entries) * self->max_n_entries);
+            }
 
             // set the bucket to the new location
             self->buckets[bi] = ei;
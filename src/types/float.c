@@ -17,20 +17,44 @@ ks_float ks_float_new(double val) {
     return self;
 }
 
+// float.__new__(obj=0.0) - create a float
+static KS_TFUNC(float, new) {
+    ks_obj obj = NULL;
+    KS_GETARGS("?obj", &obj)
+
+    if (!obj) {
+        return (ks_obj)ks_float_new(0.0);
+    } else if (obj->type == ks_T_float) {
+        return KS_NEWREF(obj);
+    } else if (obj->type == ks_T_str) {
+        // parse it, ignoring whitespace around the number
+        const char* src = ((ks_str)obj)->chr;
+        ks_ssize_t len = ((ks_str)obj)->len_b, i = 0;
+        while (i < len && isspace((unsigned char)src[i])) i++;
+        while (len > i && isspace((unsigned char)src[len - 1])) len--;
+
+        double val;
+        if (len == i || ks_num_scan_double(src + i, len - i, &val) != len - i) return ks_throw(ks_T_ArgError, "Invalid float: %R", obj);
+        return (ks_obj)ks_float_new(val);
+    } else if (obj->type == ks_T_int || obj->type == ks_T_bool) {
+        double val;
+        if (!ks_num_get_double(obj, &val)) return NULL;
+        return (ks_obj)ks_float_new(val);
+    } else if (obj->type->__float__ != NULL) {
+        return ks_obj_call(obj->type->__float__, n_args, args);
+    }
+
+    KS_THROW_TYPE_ERR(obj, ks_T_float);
+}
+
 // float.__str__(self) - to string
 static KS_TFUNC(float, str) {
     ks_float self;
     KS_GETARGS("self:*", &self, ks_T_float)
 
-
-    // print it out
-    char cstr[256];
-    snprintf(cstr, 255, "%.9lf", (double)self->val);
-
-    int len = strlen(cstr);
-    while (len > 1 && cstr[len - 1] == '0' && cstr[len - 2] != '.') {
-        len--;
-    }
+    // the shortest text that reads back as the same value
+    char cstr[KS_NUM_FMT_MAX];
+    int len = ks_num_fmt_double(cstr, self->val);
 
     return (ks_obj)ks_str_new_c(cstr, len);
 }
@@ -58,6 +82,7 @@ KS_TYPE_DECLFWD(ks_T_float);
 void ks_init_T_float() {
 
     ks_type_init_c(ks_T_float, "float", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(float_new_, "float.__new__(obj=0.0)")},
         {"__str__",                (ks_obj)ks_cfunc_new_c_old(float_str_, "float.__str__(self)")},
         {"__repr__",               (ks_obj)ks_cfunc_new_c_old(float_str_, "float.__repr__(self)")},
         {"__free__",               (ks_obj)ks_cfunc_new_c_old(float_free_, "float.__free__(self)")},
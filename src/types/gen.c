@@ -0,0 +1,108 @@
+/* gen.c - implementation of the 'gen' type, which is the result of calling a function that contains 'yield'
+ *
+ * A generator keeps the stack frame of the function (with its locals and program counter) between calls to
+ *   `__next__`, as well as the values on the stack and active exception handlers at the point it yielded, so
+ *   resuming it does not need to recreate any of them. See `ks__exec_gen()` in `exec.c`
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#include "ks-impl.h"
+
+
+// Create a new generator
+ks_gen ks_gen_new(ks_kfunc func, ks_dict locals) {
+    ks_gen self = KS_ALLOC_OBJ(ks_gen);
+    KS_INIT_OBJ(self, ks_T_gen);
+
+    self->frame = ks_stack_frame_new((ks_obj)func);
+    self->frame->locals = (ks_dict)KS_NEWREF(locals);
+    self->frame->pc = func->code->bc;
+
+    self->stk = ks_list_new(0, NULL);
+
+    self->n_exc = 0;
+    self->exc = NULL;
+
+    self->isRunning = false;
+    self->isDone = false;
+
+    return self;
+}
+
+ks_obj ks_gen_next(ks_gen self) {
+    if (self->isDone) return ks_throw(ks_T_OutOfIterError, "");
+    if (self->isRunning) return ks_throw(ks_T_Error, "'gen' object is already running");
+
+    ks_thread th = ks_thread_get();
+    if (th->frames->len >= KS_MAX_STACK_DEPTH) {
+        return ks_throw(ks_T_InternalError, "Maximum call stack depth (=%i) was exceeded! (Check for infinite recursion)", KS_MAX_STACK_DEPTH);
+    }
+
+    // resume the same frame, so it shows up in tracebacks
+    ks_list_push(th->frames, (ks_obj)self->frame);
+
+    self->isRunning = true;
+    ks_obj ret = ks__exec_gen(th, self);
+    self->isRunning = false;
+
+    ks_list_popu(th->frames);
+
+    if (self->isDone) {
+        // release everything the function was using, since it will never be resumed
+        ks_list_clear(self->stk);
+        if (self->frame->locals) {
+            KS_DECREF(self->frame->locals);
+            self->frame->locals = NULL;
+        }
+    }
+
+    return ret;
+}
+
+
+// gen.__free__(self) - free obj
+static KS_TFUNC(gen, free) {
+    ks_gen self;
+    KS_GETARGS("self:*", &self, ks_T_gen)
+
+    KS_DECREF(self->frame);
+    KS_DECREF(self->stk);
+    ks_free(self->exc);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// gen.__str__(self) - to string
+static KS_TFUNC(gen, str) {
+    ks_gen self;
+    KS_GETARGS("self:*", &self, ks_T_gen)
+
+    return (ks_obj)ks_fmt_c("<'gen' of %S>", ((ks_kfunc)self->frame->func)->name_hr);
+}
+
+// gen.__next__(self) - resume until the next 'yield'
+static KS_TFUNC(gen, next) {
+    ks_gen self;
+    KS_GETARGS("self:*", &self, ks_T_gen)
+
+    return ks_gen_next(self);
+}
+
+
+/* export */
+
+KS_TYPE_DECLFWD(ks_T_gen);
+
+void ks_init_T_gen() {
+    ks_type_init_c(ks_T_gen, "gen", ks_T_object, KS_KEYVALS(
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(gen_free_, "gen.__free__(self)")},
+        {"__str__",                (ks_obj)ks_cfunc_new_c_old(gen_str_, "gen.__str__(self)")},
+        {"__repr__",               (ks_obj)ks_cfunc_new_c_old(gen_str_, "gen.__repr__(self)")},
+
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(gen_next_, "gen.__next__(self)")},
+    ));
+}
@@ -0,0 +1,330 @@
+/* heap.c - implementation of the 'heap' type, a priority queue
+ *
+ * This is a binary min-heap stored in an array. The heap remembers whether all of its elements are small ints,
+ *   floats, or strs (see `KS_HEAP_KIND_*`), in which case they are compared directly in C, rather than checking
+ *   their types (or calling `<`) for every comparison
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#include "ks-impl.h"
+
+
+/* Tuning/Performance parameters */
+
+// smallest capacity allocated
+#define KS_HEAP_MIN_LEN 8
+
+
+// Create a new (empty) heap
+ks_heap ks_heap_new() {
+    ks_heap self = KS_ALLOC_OBJ(ks_heap);
+    KS_INIT_OBJ(self, ks_T_heap);
+
+    self->len = 0;
+    self->max_len = 0;
+    self->elems = NULL;
+    self->kind = KS_HEAP_KIND_NONE;
+
+    return self;
+}
+
+// return the kind of heap 'obj' could be stored in
+static int heap_kindof(ks_obj obj) {
+    /**/ if (obj->type == ks_T_int) return ((ks_int)obj)->isLong ? KS_HEAP_KIND_OBJ : KS_HEAP_KIND_INT64;
+    else if (obj->type == ks_T_float) return KS_HEAP_KIND_FLOAT;
+    else if (obj->type == ks_T_str) return KS_HEAP_KIND_STR;
+    else return KS_HEAP_KIND_OBJ;
+}
+
+// update the kind of 'self' to allow for 'obj'
+static void heap_addkind(ks_heap self, ks_obj obj) {
+    int kind = heap_kindof(obj);
+    if (self->kind == KS_HEAP_KIND_NONE) self->kind = kind;
+    else if (self->kind != kind) self->kind = KS_HEAP_KIND_OBJ;
+}
+
+// calculate 'A < B', for elements of 'self'
+// NOTE: Returns 1 if true, 0 if false, or -1 and throws an error
+static int heap_lt(ks_heap self, ks_obj A, ks_obj B) {
+    switch (self->kind) {
+        case KS_HEAP_KIND_INT64: return ((ks_int)A)->v64 < ((ks_int)B)->v64;
+        case KS_HEAP_KIND_FLOAT: return ((ks_float)A)->val < ((ks_float)B)->val;
+        case KS_HEAP_KIND_STR: return ks_str_cmp((ks_str)A, (ks_str)B) < 0;
+        default: return ks_obj_lt(A, B);
+    }
+}
+
+// move the element at 'pos' towards the root, until its parent is not larger
+// NOTE: Returns success, or false and throws an error
+static bool heap_siftup(ks_heap self, ks_size_t pos) {
+    ks_obj item = self->elems[pos];
+    bool res = true;
+
+    while (pos > 0) {
+        ks_size_t par = (pos - 1) / 2;
+        int r = heap_lt(self, item, self->elems[par]);
+        if (r < 0) res = false;
+        if (r != 1) break;
+
+        self->elems[pos] = self->elems[par];
+        pos = par;
+    }
+
+    self->elems[pos] = item;
+    return res;
+}
+
+// move the element at 'pos' towards the leaves, until neither child is smaller
+// NOTE: Returns success, or false and throws an error
+static bool heap_siftdown(ks_heap self, ks_size_t pos) {
+    ks_obj item = self->elems[pos];
+    bool res = true;
+
+    ks_size_t child;
+    while ((child = 2 * pos + 1) < self->len) {
+        // pick the smaller child
+        if (child + 1 < self->len) {
+            int r = heap_lt(self, self->elems[child + 1], self->elems[child]);
+            if (r < 0) {
+                res = false;
+                break;
+            }
+            if (r == 1) child++;
+        }
+
+        int r = heap_lt(self, self->elems[child], item);
+        if (r < 0) res = false;
+        if (r != 1) break;
+
+        self->elems[pos] = self->elems[child];
+        pos = child;
+    }
+
+    self->elems[pos] = item;
+    return res;
+}
+
+bool ks_heap_push(ks_heap self, ks_obj obj) {
+    if (self->len >= self->max_len) {
+        self->max_len = self->max_len == 0 ? KS_HEAP_MIN_LEN : 2 * self->max_len;
+        self->elems = ks_realloc(self->elems, sizeof(*self->elems) * self->max_len);
+    }
+
+    heap_addkind(self, obj);
+    self->elems[self->len++] = KS_NEWREF(obj);
+
+    return heap_siftup(self, self->len - 1);
+}
+
+ks_obj ks_heap_pop(ks_heap self) {
+    if (self->len < 1) return ks_throw(ks_T_SizeError, "'heap' object had no elements to pop!");
+
+    ks_obj ret = self->elems[0];
+    self->len--;
+
+    if (self->len > 0) {
+        // move the last element to the root, and restore the heap
+        self->elems[0] = self->elems[self->len];
+        if (!heap_siftdown(self, 0)) {
+            KS_DECREF(ret);
+            return NULL;
+        }
+    } else {
+        self->kind = KS_HEAP_KIND_NONE;
+    }
+
+    return ret;
+}
+
+// add all of 'objs' to 'self', and then restore the heap in O(n)
+// NOTE: Returns success, or false and throws an error
+static bool heap_extend(ks_heap self, ks_obj objs) {
+    ks_list tmp = ks_list_new_iter(objs);
+    if (!tmp) return false;
+
+    if (self->len + tmp->len > self->max_len) {
+        self->max_len = self->len + tmp->len;
+        self->elems = ks_realloc(self->elems, sizeof(*self->elems) * self->max_len);
+    }
+
+    ks_size_t i;
+    for (i = 0; i < tmp->len; ++i) {
+        heap_addkind(self, tmp->elems[i]);
+        self->elems[self->len++] = KS_NEWREF(tmp->elems[i]);
+    }
+    KS_DECREF(tmp);
+
+    // heapify, from the last parent to the root
+    for (i = self->len / 2; i > 0; --i) {
+        if (!heap_siftdown(self, i - 1)) return false;
+    }
+
+    return true;
+}
+
+
+// heap.__new__(objs=none) - create a new heap
+static KS_TFUNC(heap, new) {
+    ks_obj objs = KSO_NONE;
+    KS_GETARGS("?objs", &objs)
+
+    ks_heap self = ks_heap_new();
+
+    if (objs != KSO_NONE && !heap_extend(self, objs)) {
+        KS_DECREF(self);
+        return NULL;
+    }
+
+    return (ks_obj)self;
+}
+
+// heap.__free__(self) - free obj
+static KS_TFUNC(heap, free) {
+    ks_heap self;
+    KS_GETARGS("self:*", &self, ks_T_heap)
+
+    ks_size_t i;
+    for (i = 0; i < self->len; ++i) KS_DECREF(self->elems[i]);
+    ks_free(self->elems);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// heap.__str__(self) - to string (with the elements in heap order)
+static KS_TFUNC(heap, str) {
+    ks_heap self;
+    KS_GETARGS("self:*", &self, ks_T_heap)
+
+    ks_str_builder sb = ks_str_builder_new();
+
+    ks_str_builder_add(sb, "heap([", 6);
+
+    ks_size_t i;
+    for (i = 0; i < self->len; ++i) {
+        if (i > 0) ks_str_builder_add(sb, ", ", 2);
+        ks_str_builder_add_repr(sb, self->elems[i]);
+    }
+
+    ks_str_builder_add(sb, "])", 2);
+
+    ks_str ret = ks_str_builder_get(sb);
+    KS_DECREF(sb);
+    return (ks_obj)ret;
+}
+
+// heap.__len__(self) - get length
+static KS_TFUNC(heap, len) {
+    ks_heap self;
+    KS_GETARGS("self:*", &self, ks_T_heap)
+
+    return (ks_obj)ks_int_new(self->len);
+}
+
+// heap.push(self, *objs) - push objects on to the heap
+static KS_TFUNC(heap, push) {
+    ks_heap self;
+    int n_objs;
+    ks_obj* objs;
+    KS_GETARGS("self:* *objs", &self, ks_T_heap, &n_objs, &objs)
+
+    int i;
+    for (i = 0; i < n_objs; ++i) {
+        if (!ks_heap_push(self, objs[i])) return NULL;
+    }
+
+    return KSO_NONE;
+}
+
+// heap.pop(self) - pop the smallest object off of the heap
+static KS_TFUNC(heap, pop) {
+    ks_heap self;
+    KS_GETARGS("self:*", &self, ks_T_heap)
+
+    return ks_heap_pop(self);
+}
+
+// heap.peek(self) - return the smallest object, without removing it
+static KS_TFUNC(heap, peek) {
+    ks_heap self;
+    KS_GETARGS("self:*", &self, ks_T_heap)
+
+    if (self->len < 1) return ks_throw(ks_T_SizeError, "'heap' object had no elements to peek!");
+
+    return KS_NEWREF(self->elems[0]);
+}
+
+// heap.pushpop(self, obj) - push 'obj', and then pop the smallest object (which is faster than calling both)
+static KS_TFUNC(heap, pushpop) {
+    ks_heap self;
+    ks_obj obj;
+    KS_GETARGS("self:* obj", &self, ks_T_heap, &obj)
+
+    if (self->len < 1) return KS_NEWREF(obj);
+
+    heap_addkind(self, obj);
+
+    // if 'obj' would be the smallest, it is popped right away
+    int r = heap_lt(self, self->elems[0], obj);
+    if (r < 0) return NULL;
+    if (r == 0) return KS_NEWREF(obj);
+
+    ks_obj ret = self->elems[0];
+    self->elems[0] = KS_NEWREF(obj);
+    if (!heap_siftdown(self, 0)) {
+        KS_DECREF(ret);
+        return NULL;
+    }
+
+    return ret;
+}
+
+// heap.extend(self, objs) - push all of 'objs' on to the heap
+static KS_TFUNC(heap, extend) {
+    ks_heap self;
+    ks_obj objs;
+    KS_GETARGS("self:* objs", &self, ks_T_heap, &objs)
+
+    if (!heap_extend(self, objs)) return NULL;
+
+    return KSO_NONE;
+}
+
+// heap.clear(self) - remove all elements
+static KS_TFUNC(heap, clear) {
+    ks_heap self;
+    KS_GETARGS("self:*", &self, ks_T_heap)
+
+    ks_size_t i;
+    for (i = 0; i < self->len; ++i) KS_DECREF(self->elems[i]);
+    self->len = 0;
+    self->kind = KS_HEAP_KIND_NONE;
+
+    return KSO_NONE;
+}
+
+
+/* export */
+
+KS_TYPE_DECLFWD(ks_T_heap);
+
+void ks_init_T_heap() {
+    ks_type_init_c(ks_T_heap, "heap", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(heap_new_, "heap.__new__(objs=none)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(heap_free_, "heap.__free__(self)")},
+        {"__str__",                (ks_obj)ks_cfunc_new_c_old(heap_str_, "heap.__str__(self)")},
+        {"__repr__",               (ks_obj)ks_cfunc_new_c_old(heap_str_, "heap.__repr__(self)")},
+
+        {"__len__",                (ks_obj)ks_cfunc_new_c_old(heap_len_, "heap.__len__(self)")},
+
+        {"push",                   (ks_obj)ks_cfunc_new_c_old(heap_push_, "heap.push(self, *objs)")},
+        {"pop",                    (ks_obj)ks_cfunc_new_c_old(heap_pop_, "heap.pop(self)")},
+        {"peek",                   (ks_obj)ks_cfunc_new_c_old(heap_peek_, "heap.peek(self)")},
+        {"pushpop",                (ks_obj)ks_cfunc_new_c_old(heap_pushpop_, "heap.pushpop(self, obj)")},
+        {"extend",                 (ks_obj)ks_cfunc_new_c_old(heap_extend_, "heap.extend(self, objs)")},
+        {"clear",                  (ks_obj)ks_cfunc_new_c_old(heap_clear_, "heap.clear(self)")},
+    ));
+}
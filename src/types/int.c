@@ -36,12 +36,12 @@ ks_int ks_int_new(int64_t val) {
 
 
 // Create a kscript int from a string in a given base
-ks_int ks_int_new_s(char* str, int base) {
+ks_int ks_int_new_s(const char* str, int base) {
     ks_obj parsed = ks_num_parse(str, -1, base);
     if (!parsed) return NULL;
     if (parsed->type != ks_T_int) {
         KS_DECREF(parsed);
-        return (ks_int)ks_throw(ks_T_ArgError, "Invalid integer format: '%*s'", strlen(str));
+        return (ks_int)ks_throw(ks_T_ArgError, "Invalid integer format: '%s'", str);
     } else {
         return (ks_int)parsed;
     }
@@ -240,14 +240,14 @@ static KS_TFUNC(int, new) {
         // a specific base is requested, so it must be a string
         if (mode->type == ks_T_str) {
             if (ks_str_eq_c((ks_str)mode, "roman", 5)) {
-                return (ks_obj)ks_int_new_s(((ks_str)obj)->chr, KS_BASE_ROMAN);
+                return (ks_obj)ks_int_new_s(ks_str_cstr((ks_str)obj), KS_BASE_ROMAN);
             }
 
         } else if (ks_num_is_integral(mode)) {
             int64_t base;
             if (!ks_num_get_int64(mode, &base)) return NULL;
 
-            return (ks_obj)ks_int_new_s(((ks_str)obj)->chr, base);
+            return (ks_obj)ks_int_new_s(ks_str_cstr((ks_str)obj), base);
         }
         //if (base < 2 || base > MAX_BASE) return ks_throw(ks_T_ArgError, "Invalid base (%l), expected between 2 and %i", base, (int)MAX_BASE);
 
@@ -263,7 +263,7 @@ static KS_TFUNC(int, new) {
     } else if (obj->type == ks_T_complex) {
         return (ks_obj)ks_int_new(round(((ks_complex)obj)->val));
     } else if (obj->type == ks_T_str) {
-        return (ks_obj)ks_int_new_s(((ks_str)obj)->chr, 0);
+        return (ks_obj)ks_int_new_s(ks_str_cstr((ks_str)obj), 0);
     //} else if (ks_type_issub(obj->type, ks_type_Enum)) {
     //    return (ks_obj)ks_int_new(((ks_Enum)obj)->enum_idx);
     } else if (obj->type->__int__ != NULL) {
@@ -284,7 +284,7 @@ static KS_TFUNC(int, fmt) {
     if (!KS_STR_ISASCII(fstr)) return ks_throw(ks_T_ArgError, "Invalid format string: %R", fstr);
 
     // format string in C
-    const char* fstrc = fstr->chr;
+    const char* fstrc = ks_str_cstr(fstr);
 
 
     // sign component, whether '+', or ' ' (\0 for default)
@@ -352,9 +352,10 @@ static KS_TFUNC(int, fmt) {
 
     // now, actually format it
     // temporary variable
+    // NOTE: a copy is made even for long integers, since it is negated below
     mpz_t tz;
     if (self->isLong) {
-        *tz = *self->vz;
+        mpz_init_set(tz, self->vz);
     } else {
         mpz_init(tz);
         if (!ks_num_get_mpz((ks_obj)self, tz)) {
@@ -432,6 +433,7 @@ static KS_TFUNC(int, fmt) {
 
     ks_str res = ks_str_new_c(tmp, total_size);
     ks_free(tmp);
+    mpz_clear(tz);
 
     return (ks_obj)res;
 }
@@ -597,8 +599,8 @@ static KS_TFUNC(int, str) {
 
     } else if (base == 10 && !self->isLong) {
         // simple base 10
-        char tmp[256];
-        int ct = snprintf(tmp, sizeof(tmp) - 1, "%lli", (long long int)self->v64);
+        char tmp[KS_NUM_FMT_MAX];
+        int ct = ks_num_fmt_int64(tmp, self->v64);
 
         return (ks_obj)ks_str_new_c(tmp, ct);
 
@@ -8,6 +8,19 @@
 #include "ks-impl.h"
 
 
+/* Tuning/Performance parameters */
+
+// default size (in bytes) of the internal buffer of an 'ios'
+#define KS_IOS_BLOCK (64 * 1024)
+
+// smallest size of the internal buffer (it must always be able to hold a partial UTF-8 character)
+#define KS_IOS_MIN_BLOCK 16
+
+
+// the standard streams
+ks_ios ks_stdin = NULL, ks_stdout = NULL, ks_stderr = NULL;
+
+
 // Create a blank 'iostream', with no target
 // NOTE: Use `ks_ios_open()` to actually get a target
 // NOTE: Returns a new reference
@@ -25,6 +38,12 @@ ks_ios ks_ios_new() {
     // specifics
     self->_fp = NULL;
 
+    self->buf = NULL;
+    self->buf_max = KS_IOS_BLOCK;
+    self->buf_pos = self->buf_len = 0;
+    self->isWriting = false;
+    self->isLineBuf = false;
+
     return self;
 
 }
@@ -39,15 +58,20 @@ bool ks_ios_open(ks_ios self, ks_str fname, ks_str mode) {
 
     // TODO: may need to encode `fname` to utf16 for windows
 
-    self->_fp = fopen(fname->chr, mode->chr);
+    self->_fp = fopen(ks_str_cstr(fname), ks_str_cstr(mode));
     if (!self->_fp) {
         // error
         ks_throw(ks_T_IOError, "Failed to open '%S': %s", fname, strerror(errno));
         return false;
     }
 
+    // we do our own buffering, so stdio's would just be an extra copy
+    setvbuf(self->_fp, NULL, _IONBF, 0);
+
     self->isOpen = true;
     self->isExtern = false;
+    self->buf_pos = self->buf_len = 0;
+    self->isWriting = false;
 
 
     // swap out references
@@ -77,6 +101,8 @@ bool ks_ios_extern_FILE(ks_ios self, ks_str fname, ks_str mode, FILE* _fp) {
 
     self->isOpen = true;
     self->isExtern = true;
+    self->buf_pos = self->buf_len = 0;
+    self->isWriting = false;
 
     // swap out references
     KS_INCREF(fname);
@@ -90,23 +116,163 @@ bool ks_ios_extern_FILE(ks_ios self, ks_str fname, ks_str mode, FILE* _fp) {
     return true;
 }
 
+
+/* Buffering */
+
+// make sure the internal buffer has been allocated
+static void ios_buf_alloc(ks_ios self) {
+    if (!self->buf) self->buf = ks_malloc(self->buf_max);
+}
+
+// write out everything in the buffer, without throwing an error
+// NOTE: Returns success
+static bool ios_write_out(ks_ios self) {
+    ks_size_t len_b = self->buf_len;
+    self->buf_len = 0;
+
+    if (len_b > 0 && fwrite(self->buf, 1, len_b, self->_fp) != len_b) return false;
+
+    // extern files may have their own buffer, which C code writing to them also uses
+    if (self->isExtern && fflush(self->_fp) != 0) return false;
+
+    return true;
+}
+
+// stop writing, flushing everything that has been written into the buffer
+// NOTE: Returns success, or false and throws an error
+static bool ios_end_write(ks_ios self) {
+    if (!self->isWriting) return true;
+
+    self->isWriting = false;
+    if (!ios_write_out(self)) {
+        ks_throw(ks_T_IOError, "Failed to write to %R (reason: %s)", self->name, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+// Write out anything buffered in the standard streams (ignoring errors)
+void ks_ios_sync_std() {
+    if (ks_stdout && ks_stdout->isWriting) ios_write_out(ks_stdout);
+    if (ks_stderr && ks_stderr->isWriting) ios_write_out(ks_stderr);
+}
+
+// stop reading, moving the position of the file back to where the user thinks it is (i.e. before any buffered
+//   data that has not been consumed)
+static void ios_end_read(ks_ios self) {
+    if (self->isWriting) return;
+
+    if (self->buf_pos < self->buf_len) {
+        // NOTE: this fails for pipes and such, but the data could never have been re-read there anyway
+        fseek(self->_fp, -(long)(self->buf_len - self->buf_pos), SEEK_CUR);
+    }
+
+    self->buf_pos = self->buf_len = 0;
+}
+
+// start reading, so that the buffer holds data read from the file
+// NOTE: Returns success, or false and throws an error
+static bool ios_begin_read(ks_ios self) {
+    if (!self->isOpen) {
+        ks_throw(ks_T_IOError, "Attempted to read from file that wasn't open");
+        return false;
+    }
+
+    if (!ios_end_write(self)) return false;
+    ios_buf_alloc(self);
+
+    return true;
+}
+
+// read another block from the file into the buffer, keeping any unconsumed data (which is moved to the front)
+// NOTE: Returns the number of bytes that were added (0 means the end of the file), or -1 and throws an error
+static ks_ssize_t ios_fill(ks_ios self) {
+    ks_size_t left = self->buf_len - self->buf_pos;
+    if (left > 0 && self->buf_pos > 0) memmove(self->buf, self->buf + self->buf_pos, left);
+    self->buf_pos = 0;
+    self->buf_len = left;
+
+    ks_ssize_t n = fread(self->buf + left, 1, self->buf_max - left, self->_fp);
+    if (n <= 0 && ferror(self->_fp)) {
+        clearerr(self->_fp);
+        ks_throw(ks_T_IOError, "Failed to read from %R (reason: %s)", self->name, strerror(errno));
+        return -1;
+    }
+
+    self->buf_len += n;
+    return n;
+}
+
+// Write any buffered data to the underlying file
+// NOTE: Returns success, or false and throws an error
+bool ks_ios_flush(ks_ios self) {
+    if (!self->isOpen) {
+        ks_throw(ks_T_IOError, "Attempted to flush file that wasn't open");
+        return false;
+    }
+
+    if (!ios_end_write(self)) return false;
+
+    if (fflush(self->_fp) != 0) {
+        ks_throw(ks_T_IOError, "Failed to flush %R (reason: %s)", self->name, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+// Set the size of the internal buffer used by 'self' (any buffered data is flushed first)
+// NOTE: Returns success, or false and throws an error
+bool ks_ios_setbuf(ks_ios self, ks_ssize_t buf_max) {
+    if (buf_max <= 0) {
+        ks_throw(ks_T_ArgError, "Buffer size must be positive (got %l)", (int64_t)buf_max);
+        return false;
+    }
+    if (buf_max < KS_IOS_MIN_BLOCK) buf_max = KS_IOS_MIN_BLOCK;
+
+    if (self->isOpen) {
+        if (!ios_end_write(self)) return false;
+        ios_end_read(self);
+    }
+
+    ks_free(self->buf);
+    self->buf = NULL;
+    self->buf_max = buf_max;
+
+    return true;
+}
+
+
 // Close 'self' (or, if already closed, do nothing)
-// NOTE: will never throw an error; all errors are ignored
-void ks_ios_close(ks_ios self) {
+// NOTE: The stream is always closed, but returns false and throws an error if buffered data could not be written
+bool ks_ios_close(ks_ios self) {
 
     // short circuit
-    if (!self->isOpen) return;
+    if (!self->isOpen) return true;
+
+    // write out anything still buffered
+    bool rst = ios_end_write(self);
+    if (self->isExtern) ios_end_read(self);
 
     // actually close if not extern
     if (!self->isExtern) {
 
         ks_trace("ks", "Closing file %S (_fp: %p)", self, self->_fp);
-        fclose(self->_fp);
+        // NOTE: this is where the C library writes out its own buffer, so it can fail too
+        if (fclose(self->_fp) != 0 && rst) {
+            ks_throw(ks_T_IOError, "Failed to close %R (reason: %s)", self->name, strerror(errno));
+            rst = false;
+        }
     }
 
     self->isOpen = false;
     self->isExtern = false;
     self->_fp = NULL;
+
+    ks_free(self->buf);
+    self->buf = NULL;
+    self->buf_pos = self->buf_len = 0;
     
     ks_str empt = ks_str_new("");
     KS_INCREF(empt);
@@ -115,6 +281,7 @@ void ks_ios_close(ks_ios self) {
     KS_DECREF(self->mode);
     self->name = self->mode = empt;
 
+    return rst;
 }
 
 // Return the current position (in bytes) in 'self', or -1 and throw an error
@@ -125,8 +292,14 @@ ks_ssize_t ks_ios_tell(ks_ios self) {
     }
 
     ks_ssize_t ret = ftell(self->_fp);
-    if (ret < 0) ks_throw(ks_T_IOError, "Failed to get 'tell()': %s", strerror(errno));
-    return ret;
+    if (ret < 0) {
+        ks_throw(ks_T_IOError, "Failed to get 'tell()': %s", strerror(errno));
+        return -1;
+    }
+
+    // account for buffered data
+    if (self->isWriting) return ret + self->buf_len;
+    else return ret - (self->buf_len - self->buf_pos);
 }
 
 // Return the size (in bytes) of the entire stream, or -1 and throw an error
@@ -136,6 +309,9 @@ ks_ssize_t ks_ios_size(ks_ios self) {
         return -1;
     }
 
+    // the file needs to contain everything written so far
+    if (!ios_end_write(self)) return -1;
+
     ks_ssize_t pos = ftell(self->_fp);
     if (pos < 0) {
         ks_throw(ks_T_IOError, "Failed to get 'size()': %s", strerror(errno));
@@ -160,7 +336,7 @@ ks_ssize_t ks_ios_size(ks_ios self) {
 bool ks_ios_seek(ks_ios self, ks_ssize_t pos_b, int seekmode) {
     if (!self->isOpen) {
         ks_throw(ks_T_IOError, "Attempted to get seek in file that wasn't open");
-        return -1;
+        return false;
     }
 
     // convert to C seek mode
@@ -176,31 +352,51 @@ bool ks_ios_seek(ks_ios self, ks_ssize_t pos_b, int seekmode) {
         return false;
     }
 
-    // now, seek to the given position
-
+    // drop the buffer, since it won't be valid at the new position
+    if (!ios_end_write(self)) return false;
+    if (_seek == SEEK_CUR) pos_b -= self->buf_len - self->buf_pos;
+    self->buf_pos = self->buf_len = 0;
 
-    ks_ssize_t ret = fseek(self->_fp, pos_b, _seek);
-    if (ret < 0) {
+    // now, seek to the given position
+    if (fseek(self->_fp, pos_b, _seek) != 0) {
         ks_throw(ks_T_ArgError, "Failed to seek in file: %s", strerror(errno));
-
+        return false;
     }
 
-    return ret;
+    return true;
 }
 
 // Read a given number of bytes from the iostream and put them into `dest`
 // NOTE: Returns number of bytes actually read (accounting for truncation), or -1 and throw an error
 ks_ssize_t ks_ios_readb(ks_ios self, ks_ssize_t len_b, void* dest) {
-    if (!self->isOpen) {
-        ks_throw(ks_T_IOError, "Attempted to read from file that wasn't open");
-        return -1;
-    }
+    if (!ios_begin_read(self)) return -1;
+
+    ks_ssize_t byt = 0;
+    while (byt < len_b) {
+        if (self->buf_pos == self->buf_len) {
+            // large reads skip the buffer, and go straight into 'dest'
+            if (len_b - byt >= self->buf_max) {
+                ks_ssize_t n = fread((uint8_t*)dest + byt, 1, len_b - byt, self->_fp);
+                if (n < len_b - byt && ferror(self->_fp)) {
+                    clearerr(self->_fp);
+                    ks_throw(ks_T_IOError, "Failed to read from %R (reason: %s)", self->name, strerror(errno));
+                    return -1;
+                }
+                byt += n;
+                break;
+            }
+
+            ks_ssize_t n = ios_fill(self);
+            if (n < 0) return -1;
+            else if (n == 0) break;
+        }
+
+        ks_ssize_t take = self->buf_len - self->buf_pos;
+        if (take > len_b - byt) take = len_b - byt;
 
-    ks_ssize_t byt = fread(dest, 1, len_b, self->_fp);
-    if (byt < 0) {
-        // handle discrepency
-    } else if (byt != len_b) {
-        // handle discrepancy
+        memcpy((uint8_t*)dest + byt, self->buf + self->buf_pos, take);
+        self->buf_pos += take;
+        byt += take;
     }
 
     return byt;
@@ -213,68 +409,223 @@ ks_ssize_t ks_ios_readb(ks_ios self, ks_ssize_t len_b, void* dest) {
 // ks_ios_reads(self, 4, &dest);
 // ks_free(dest);
 ks_ssize_t ks_ios_reads(ks_ios self, ks_ssize_t len_c, void** dest, ks_ssize_t* len_c_actual) {
-    if (!self->isOpen) {
-        ks_throw(ks_T_IOError, "Attempted to read from file that wasn't open");
-        return *len_c_actual = -1;
-    }
+    *len_c_actual = 0;
+    if (!ios_begin_read(self)) return *len_c_actual = -1;
     
     // number of bytes read
-    ks_ssize_t len_b = *len_c_actual = 0;
+    ks_ssize_t len_b = 0;
+
+    while (*len_c_actual < len_c) {
+        if (self->buf_pos == self->buf_len) {
+            ks_ssize_t n = ios_fill(self);
+            if (n < 0) return *len_c_actual = -1;
+            else if (n == 0) break;
+        }
 
-    // holds single utf8 sequence
-    uint8_t tmp[4];
+        // take as many whole characters out of the buffer as possible (up to the requested amount)
+        uint8_t* st = self->buf + self->buf_pos, *en = self->buf + self->buf_len, *p = st;
+        ks_ssize_t want = len_c - *len_c_actual, got = 0;
+        while (p < en && got < want) {
+            int seq = *p < 0xC0 ? 1 : *p < 0xE0 ? 2 : *p < 0xF0 ? 3 : 4;
+            if (p + seq > en) break;
+            p += seq;
+            got++;
+        }
 
-    // whethe or not to keep going
-    bool keepGoing = true;
+        if (p == st) {
+            // only a partial character is left, so read the rest of it
+            ks_ssize_t n = ios_fill(self);
+            if (n < 0) return *len_c_actual = -1;
+            else if (n > 0) continue;
 
-    ks_size_t cur_dest_size = 0;
+            // truncated at the end of the file (this will fail validation later)
+            p = en;
+            got = 1;
+        }
 
-    while (*len_c_actual < len_c && keepGoing) {
-        // read an entire character from the stream
-        // TODO: allow other than utf8
+        *dest = ks_realloc(*dest, len_b + (p - st) + 1);
+        memcpy((uint8_t*)*dest + len_b, st, p - st);
+        len_b += p - st;
+        *len_c_actual += got;
+        self->buf_pos += p - st;
+    }
 
-        int i;
-        for (i = 0; i < 4; ++i) {
-            ks_ssize_t read = fread(tmp + i, 1, 1, self->_fp);
-            if (read != 1) {
-                // end of sequence
-                keepGoing = false;
-                break;
-            }
+    // NUL-terminate it
+    if (*dest) ((char*)*dest)[len_b] = '\0';
 
-            if (tmp[i] & 0xC0 == 0x80) {
-                // we are done
-                break;
+    return len_b;
+}
+
+// Read a single line from the iostream (up to and including the next '\n'), and set `*out` to it (a new reference)
+// NOTE: At the end of the stream, `*out` is set to NULL and true is returned (no error is thrown)
+// NOTE: Returns success, or false and throws an error
+bool ks_ios_readline(ks_ios self, bool keepends, ks_obj* out) {
+    *out = NULL;
+    if (!ios_begin_read(self)) return false;
+
+    if (self->buf_pos == self->buf_len) {
+        ks_ssize_t n = ios_fill(self);
+        if (n < 0) return false;
+        else if (n == 0) return true;
+    }
+
+    // the line, which is either inside the buffer, or collected in 'tmp' if it spans multiple blocks
+    const uint8_t* line = self->buf + self->buf_pos;
+    ks_ssize_t len_b = self->buf_len - self->buf_pos;
+    uint8_t* tmp = NULL;
+
+    uint8_t* nl = memchr(line, '\n', len_b);
+    if (nl) {
+        len_b = nl + 1 - line;
+        self->buf_pos += len_b;
+    } else {
+        ks_ssize_t tmp_len = 0;
+        while (true) {
+            // move the rest of the buffer into 'tmp'
+            ks_ssize_t take = self->buf_len - self->buf_pos;
+            nl = memchr(self->buf + self->buf_pos, '\n', take);
+            if (nl) take = nl + 1 - (self->buf + self->buf_pos);
+
+            tmp = ks_realloc(tmp, tmp_len + take);
+            memcpy(tmp + tmp_len, self->buf + self->buf_pos, take);
+            tmp_len += take;
+            self->buf_pos += take;
+
+            if (nl) break;
+
+            ks_ssize_t n = ios_fill(self);
+            if (n < 0) {
+                ks_free(tmp);
+                return false;
+            } else if (n == 0) break;
+        }
+
+        line = tmp;
+        len_b = tmp_len;
+    }
+
+    if (!keepends && len_b > 0 && line[len_b - 1] == '\n') {
+        len_b--;
+        if (len_b > 0 && line[len_b - 1] == '\r') len_b--;
+    }
+
+    if (strchr(ks_str_cstr(self->mode), 'b')) {
+        *out = (ks_obj)ks_bytes_new(line, len_b);
+    } else if (ks_text_utf8_validate((const char*)line, len_b) < 0) {
+        ks_throw(ks_T_ArgError, "Data read from %R was not valid UTF-8", self->name);
+    } else {
+        *out = (ks_obj)ks_str_utf8((const char*)line, len_b);
+    }
+
+    ks_free(tmp);
+    return *out != NULL;
+}
+
+// Write a given number of bytes to the iostream
+// NOTE: Returns success, or false and throws an error
+bool ks_ios_writeb(ks_ios self, ks_ssize_t len_b, const void* src) {
+    if (!self->isOpen) {
+        ks_throw(ks_T_IOError, "Attempted to write to file that wasn't open");
+        return false;
+    }
+    if (!strpbrk(ks_str_cstr(self->mode), "wax+")) {
+        ks_throw(ks_T_IOError, "Attempted to write to %R, which was not opened for writing (mode: %R)", self->name, self->mode);
+        return false;
+    }
+
+    if (!self->isWriting) {
+        ios_end_read(self);
+        self->isWriting = true;
+    }
+
+    ios_buf_alloc(self);
+
+    if (self->buf_len + len_b > self->buf_max) {
+        // make room
+        if (!ios_end_write(self)) return false;
+        self->isWriting = true;
+
+        if (len_b >= self->buf_max) {
+            // large writes go straight to the file
+            if (fwrite(src, 1, len_b, self->_fp) != len_b || (self->isExtern && fflush(self->_fp) != 0)) {
+                ks_throw(ks_T_IOError, "Failed to write to %R (reason: %s)", self->name, strerror(errno));
+                return false;
             }
+
+            return true;
         }
+    }
 
-        // exit early
-        if (!keepGoing) break;
+    // batch it up
+    memcpy(self->buf + self->buf_len, src, len_b);
+    self->buf_len += len_b;
 
-        // append to destination
-        *dest = ks_realloc(*dest, cur_dest_size + i + 1);
-        memcpy((void*)(((intptr_t)*dest) + cur_dest_size), tmp, i);
-        cur_dest_size += i;
+    if (self->isLineBuf && memchr(src, '\n', len_b)) {
+        if (!ios_end_write(self)) return false;
+        self->isWriting = true;
+    }
+
+    return true;
+}
 
-        // inc counters
-        *len_c_actual++;
-        len_b += i;
+// Write 'str(args[i])' for each argument, seperated by 'sep' and followed by 'end'
+// NOTE: Returns success, or false and throws an error
+bool ks_ios_print(ks_ios self, int n_args, ks_obj* args, const char* sep, const char* end, bool flush) {
+    ks_size_t sep_len = strlen(sep);
+
+    int i;
+    for (i = 0; i < n_args; ++i) {
+        if (i > 0 && !ks_ios_writeb(self, sep_len, sep)) return false;
+
+        ks_obj obj = args[i];
+        if (obj->type == ks_T_str) {
+            // write directly, without a copy
+            if (!ks_ios_writeb(self, ((ks_str)obj)->len_b, ((ks_str)obj)->chr)) return false;
+        } else if (obj->type == ks_T_int && !((ks_int)obj)->isLong) {
+            char tmp[KS_NUM_FMT_MAX];
+            int len = ks_num_fmt_int64(tmp, ((ks_int)obj)->v64);
+            if (!ks_ios_writeb(self, len, tmp)) return false;
+        } else if (obj->type == ks_T_float) {
+            char tmp[KS_NUM_FMT_MAX];
+            int len = ks_num_fmt_double(tmp, ((ks_float)obj)->val);
+            if (!ks_ios_writeb(self, len, tmp)) return false;
+        } else {
+            ks_str obj_str = ks_fmt_c("%S", obj);
+            if (!obj_str) return false;
+            bool rst = ks_ios_writeb(self, obj_str->len_b, obj_str->chr);
+            KS_DECREF(obj_str);
+            if (!rst) return false;
+        }
     }
 
-    // NUL-terminate it
-    if (*dest) ((char*)*dest)[cur_dest_size] = '\0';
+    if (!ks_ios_writeb(self, strlen(end), end)) return false;
 
-    return len_b;
+    return !flush || ks_ios_flush(self);
 }
 
-// ios.__new__(fname, mode="r")
+
+// ios.__new__(fname, mode='r', bufsize=none) - open a file, using an internal buffer of 'bufsize' bytes
 static KS_TFUNC(ios, new) {
     ks_str fname;
-    ks_str mode;
-    KS_GETARGS("fname:* mode:*", &fname, ks_T_str, &mode, ks_T_str)
+    ks_str mode = NULL;
+    ks_obj bufsize = KSO_NONE;
+    KS_GETARGS("fname:* ?mode:* ?bufsize", &fname, ks_T_str, &mode, ks_T_str, &bufsize)
+
+    int64_t buf_max = KS_IOS_BLOCK;
+    if (bufsize != KSO_NONE && !ks_num_get_int64(bufsize, &buf_max)) return NULL;
 
     ks_ios self = ks_ios_new();
-    if (!ks_ios_open(self, fname, mode)) {
+    if (!ks_ios_setbuf(self, buf_max)) {
+        KS_DECREF(self);
+        return NULL;
+    }
+
+    if (!mode) mode = ks_str_new("r");
+    else KS_INCREF(mode);
+
+    bool rst = ks_ios_open(self, fname, mode);
+    KS_DECREF(mode);
+    if (!rst) {
         KS_DECREF(self);
         return NULL;
     }
@@ -296,8 +647,8 @@ static KS_TFUNC(ios, free) {
     ks_ios self;
     KS_GETARGS("self:*", &self, ks_T_ios)
 
-    // close the stream
-    ks_ios_close(self);
+    // close the stream (there is nobody to report an error to)
+    if (!ks_ios_close(self)) ks_catch_ignore();
 
     KS_DECREF(self->mode);
     KS_DECREF(self->name);
@@ -314,7 +665,7 @@ static KS_TFUNC(ios, close) {
     ks_ios self;
     KS_GETARGS("self:*", &self, ks_T_ios)
 
-    ks_ios_close(self);
+    if (!ks_ios_close(self)) return NULL;
 
     return KSO_NONE;
 }
@@ -343,6 +694,9 @@ static KS_TFUNC(ios, reads) {
     if (len_b < 0) {
         ks_free(dest);
         return NULL;
+    } else if (ks_text_utf8_validate((const char*)dest, len_b) < 0) {
+        ks_free(dest);
+        return ks_throw(ks_T_ArgError, "Data read from %R was not valid UTF-8", self->name);
     } else {
         ks_str ret = ks_str_utf8((const char*)dest, len_b);
         ks_free(dest);
@@ -350,9 +704,217 @@ static KS_TFUNC(ios, reads) {
     }
 }
 
+// ios.read(self, num=none) - read 'num' bytes (if opened in binary mode) or characters (otherwise), defaulting to
+//   the rest of the file
+static KS_TFUNC(ios, read) {
+    ks_ios self;
+    ks_obj num = KSO_NONE;
+    KS_GETARGS("self:* ?num", &self, ks_T_ios, &num)
+
+    if (!strchr(ks_str_cstr(self->mode), 'b')) {
+        return ios_reads_(n_args, args);
+    }
+
+    int64_t len_b = KS_SSIZE_MAX;
+    if (num != KSO_NONE && !ks_num_get_int64(num, &len_b)) return NULL;
+    if (len_b < 0) return ks_throw(ks_T_ArgError, "Number of bytes must be non-negative (got %l)", len_b);
+
+    // read a block at a time, so 'num' can be much larger than the file
+    uint8_t* dest = NULL;
+    ks_ssize_t dest_len = 0;
+    while (dest_len < len_b) {
+        ks_ssize_t want = len_b - dest_len;
+        if (want > 4 * self->buf_max) want = 4 * self->buf_max;
+
+        dest = ks_realloc(dest, dest_len + want);
+        ks_ssize_t n = ks_ios_readb(self, want, dest + dest_len);
+        if (n < 0) {
+            ks_free(dest);
+            return NULL;
+        }
+
+        dest_len += n;
+        if (n < want) break;
+    }
+
+    ks_bytes ret = ks_bytes_new(dest, dest_len);
+    ks_free(dest);
+    return (ks_obj)ret;
+}
+
+// ios.readline(self, keepends=true) - read the next line, or an empty string at the end of the file
+static KS_TFUNC(ios, readline) {
+    ks_ios self;
+    ks_obj keepends = KSO_TRUE;
+    KS_GETARGS("self:* ?keepends", &self, ks_T_ios, &keepends)
+
+    int truthy = ks_obj_truthy(keepends);
+    if (truthy < 0) return NULL;
+
+    ks_obj ret;
+    if (!ks_ios_readline(self, truthy, &ret)) return NULL;
+
+    if (!ret) ret = strchr(ks_str_cstr(self->mode), 'b') ? (ks_obj)ks_bytes_new(NULL, 0) : (ks_obj)ks_str_new("");
+    return ret;
+}
+
+// ios.readlines(self, keepends=true) - read the rest of the lines in the file, as a list
+static KS_TFUNC(ios, readlines) {
+    ks_ios self;
+    ks_obj keepends = KSO_TRUE;
+    KS_GETARGS("self:* ?keepends", &self, ks_T_ios, &keepends)
+
+    int truthy = ks_obj_truthy(keepends);
+    if (truthy < 0) return NULL;
+
+    ks_list res = ks_list_new(0, NULL);
+    while (true) {
+        ks_obj line;
+        if (!ks_ios_readline(self, truthy, &line)) {
+            KS_DECREF(res);
+            return NULL;
+        }
+        if (!line) break;
+
+        ks_list_push(res, line);
+        KS_DECREF(line);
+    }
+
+    return (ks_obj)res;
+}
+
+// ios.__next__(self) - read the next line (keeping the line ending), so that 'for line in f' reads 'f' line by line
+// NOTE: `for` loops and `ks_citer` call `ks_ios_readline()` directly, which ends without throwing an 'OutOfIterError'
+static KS_TFUNC(ios, next) {
+    ks_ios self;
+    KS_GETARGS("self:*", &self, ks_T_ios)
+
+    ks_obj ret;
+    if (!ks_ios_readline(self, true, &ret)) return NULL;
+    if (!ret) return ks_throw(ks_T_OutOfIterError, "");
+
+    return ret;
+}
 
 
+/* iterator type */
 
+// ks_ios_lines - iterator over the lines of an 'ios'
+typedef struct {
+    KS_OBJ_BASE
+
+    // the stream being read
+    ks_ios self;
+
+    // whether to keep the line endings
+    bool keepends;
+
+}* ks_ios_lines;
+
+// declare type
+KS_TYPE_DECLFWD(ks_T_ios_lines);
+
+// ios_lines.__free__(self) - free obj
+static KS_TFUNC(ios_lines, free) {
+    ks_ios_lines self;
+    KS_GETARGS("self:*", &self, ks_T_ios_lines)
+
+    KS_DECREF(self->self);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// ios_lines.__next__(self) - return the next line
+static KS_TFUNC(ios_lines, next) {
+    ks_ios_lines self;
+    KS_GETARGS("self:*", &self, ks_T_ios_lines)
+
+    ks_obj ret;
+    if (!ks_ios_readline(self->self, self->keepends, &ret)) return NULL;
+    if (!ret) return ks_throw(ks_T_OutOfIterError, "");
+
+    return ret;
+}
+
+// ios.lines(self, keepends=true) - return an iterator over the rest of the lines in the file
+static KS_TFUNC(ios, lines) {
+    ks_ios self;
+    ks_obj keepends = KSO_TRUE;
+    KS_GETARGS("self:* ?keepends", &self, ks_T_ios, &keepends)
+
+    int truthy = ks_obj_truthy(keepends);
+    if (truthy < 0) return NULL;
+
+    ks_ios_lines ret = KS_ALLOC_OBJ(ks_ios_lines);
+    KS_INIT_OBJ(ret, ks_T_ios_lines);
+
+    ret->self = (ks_ios)KS_NEWREF(self);
+    ret->keepends = truthy;
+
+    return (ks_obj)ret;
+}
+
+// ios.print(self, *args) - write the arguments (converted to strings) seperated by spaces, and then a newline
+static KS_TFUNC(ios, print) {
+    ks_ios self;
+    int n_extra;
+    ks_obj* extra;
+    KS_GETARGS("self:* *args", &self, ks_T_ios, &n_extra, &extra)
+
+    if (!ks_ios_print(self, n_extra, extra, " ", "\n", false)) return NULL;
+
+    return KSO_NONE;
+}
+
+// ios.flush(self) - write any buffered data to the file
+static KS_TFUNC(ios, flush) {
+    ks_ios self;
+    KS_GETARGS("self:*", &self, ks_T_ios)
+
+    if (!ks_ios_flush(self)) return NULL;
+
+    return KSO_NONE;
+}
+
+// ios.readinto(self, buf) - read directly into a writable buffer (such as a bytearray), returning the number of bytes read
+static KS_TFUNC(ios, readinto) {
+    ks_ios self;
+    ks_obj obj;
+    KS_GETARGS("self:* buf", &self, ks_T_ios, &obj)
+
+    ks_buffer buf;
+    if (!ks_buffer_get(obj, &buf, KS_BUFFER_WRITABLE | KS_BUFFER_CONTIG)) return NULL;
+
+    ks_ssize_t len_b = ks_ios_readb(self, buf.len_b, buf.data);
+    ks_buffer_release(&buf);
+    if (len_b < 0) return NULL;
+
+    return (ks_obj)ks_int_new(len_b);
+}
+
+// ios.write(self, data) - write any object supporting the buffer protocol (str (as UTF-8), bytes, bytearray, ...) to the stream
+static KS_TFUNC(ios, write) {
+    ks_ios self;
+    ks_obj data;
+    KS_GETARGS("self:* data", &self, ks_T_ios, &data)
+
+    if (!ks_buffer_has(data)) {
+        KS_THROW_TYPE_ERR(data, ks_T_bytes);
+    }
+
+    // write directly from the object's memory, without copying
+    ks_buffer buf;
+    if (!ks_buffer_get(data, &buf, KS_BUFFER_CONTIG)) return NULL;
+    bool rst = ks_ios_writeb(self, buf.len_b, buf.data);
+    ks_buffer_release(&buf);
+
+    if (!rst) return NULL;
+
+    return KSO_NONE;
+}
 
 
 
@@ -360,18 +922,63 @@ static KS_TFUNC(ios, reads) {
 
 KS_TYPE_DECLFWD(ks_T_ios);
 
+// create an extern 'ios' for one of the standard streams
+static ks_ios ios_wrap(FILE* fp, const char* name, const char* mode) {
+    ks_ios self = ks_ios_new();
+    ks_str name_str = ks_str_new(name), mode_str = ks_str_new(mode);
+    ks_ios_extern_FILE(self, name_str, mode_str, fp);
+    KS_DECREF(name_str);
+    KS_DECREF(mode_str);
+    return self;
+}
+
+// flush the standard streams when the process exits
+static void ios_atexit() {
+    ks_ios_sync_std();
+}
+
 void ks_init_T_ios() {
     
     ks_type_init_c(ks_T_ios, "ios", ks_T_object, KS_KEYVALS(
-        {"__new__",                (ks_obj)ks_cfunc_new_c_old(ios_new_, "ios.__new__(fname, mode='r'")},
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(ios_new_, "ios.__new__(fname, mode='r', bufsize=none)")},
         {"__free__",               (ks_obj)ks_cfunc_new_c_old(ios_free_, "ios.__free__(self)")},
         {"__str__",                (ks_obj)ks_cfunc_new_c_old(ios_str_, "ios.__str__(self)")},
         {"__repr__",               (ks_obj)ks_cfunc_new_c_old(ios_str_, "ios.__repr__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(ios_next_, "ios.__next__(self)")},
 
+        {"read",                   (ks_obj)ks_cfunc_new_c_old(ios_read_, "ios.read(self, num=none)")},
         {"reads",                  (ks_obj)ks_cfunc_new_c_old(ios_reads_, "ios.reads(self, numc=none)")},
+        {"readline",               (ks_obj)ks_cfunc_new_c_old(ios_readline_, "ios.readline(self, keepends=true)")},
+        {"readlines",              (ks_obj)ks_cfunc_new_c_old(ios_readlines_, "ios.readlines(self, keepends=true)")},
+        {"lines",                  (ks_obj)ks_cfunc_new_c_old(ios_lines_, "ios.lines(self, keepends=true)")},
+        {"readinto",               (ks_obj)ks_cfunc_new_c_old(ios_readinto_, "ios.readinto(self, buf)")},
+        {"write",                  (ks_obj)ks_cfunc_new_c_old(ios_write_, "ios.write(self, data)")},
+        {"print",                  (ks_obj)ks_cfunc_new_c_old(ios_print_, "ios.print(self, *args)")},
+        {"flush",                  (ks_obj)ks_cfunc_new_c_old(ios_flush_, "ios.flush(self)")},
         {"close",                  (ks_obj)ks_cfunc_new_c_old(ios_close_, "ios.close(self)")},
         
     ));
 
     ks_T_ios->flags |= KS_TYPE_FLAGS_EQSS;
+
+    // wrap the standard streams
+    ks_stdin = ios_wrap(stdin, "<stdin>", "r");
+    ks_stdout = ios_wrap(stdout, "<stdout>", "w");
+    ks_stderr = ios_wrap(stderr, "<stderr>", "w");
+
+    // like C, only wait for a newline on terminals (and never wait for long on stderr)
+    ks_stdout->isLineBuf = isatty(fileno(stdout));
+    ks_stderr->isLineBuf = true;
+    atexit(ios_atexit);
+
+    ks_type_set_c(ks_T_ios, KS_KEYVALS(
+        {"stdin",                  KS_NEWREF(ks_stdin)},
+        {"stdout",                 KS_NEWREF(ks_stdout)},
+        {"stderr",                 KS_NEWREF(ks_stderr)},
+    ));
+
+    ks_type_init_c(ks_T_ios_lines, "ios_lines", ks_T_object, KS_KEYVALS(
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(ios_lines_free_, "ios_lines.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(ios_lines_next_, "ios_lines.__next__(self)")},
+    ));
 }
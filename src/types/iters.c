@@ -0,0 +1,662 @@
+/* iters.c - implementation of the lazy iterator types: 'map', 'filter', 'zip', 'enumerate', 'chain', 'islice',
+ *   'takewhile', 'dropwhile', and 'repeat'
+ *
+ * Each of these holds iterators for its inputs, and produces a single element per call to `__next__`, so pipelines
+ *   built from them use constant memory, no matter how large the input is (and may even be infinite)
+ *
+ * They all signal the end by throwing an 'OutOfIterError' (which is what `for` loops and `ks_citer` check for), and
+ *   if an input iterator throws one, it is passed straight through
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#include "ks-impl.h"
+
+
+// get the next object from the iterator 'it'
+// NOTE: Returns a new reference, or NULL and throws an error (which may be an 'OutOfIterError')
+static ks_obj iters_next(ks_obj it) {
+    return ks_F_next->func(1, &it);
+}
+
+// return whether the current exception is an 'OutOfIterError', and if so, catch it
+static bool iters_catch_end() {
+    ks_thread th = ks_thread_get();
+    if (th->exc && th->exc->type == ks_T_OutOfIterError) {
+        ks_catch_ignore();
+        return true;
+    }
+    return false;
+}
+
+// create a tuple of iterators for each of 'objs'
+// NOTE: Returns a new reference, or NULL and throws an error
+static ks_tuple iters_make(int n_objs, ks_obj* objs) {
+    ks_obj* its = ks_malloc(sizeof(*its) * n_objs);
+
+    int i;
+    for (i = 0; i < n_objs; ++i) {
+        if (!(its[i] = ks_F_iter->func(1, &objs[i]))) {
+            while (--i >= 0) KS_DECREF(its[i]);
+            ks_free(its);
+            return NULL;
+        }
+    }
+
+    ks_tuple res = ks_tuple_new_n(n_objs, its);
+    ks_free(its);
+    return res;
+}
+
+// implementation of '__free__' for the iterator type '_type', which holds references to the given fields
+// NOTE: fields may be NULL, in which case they are skipped
+#define ITERS_FREE(_type, ...) { \
+    ks_##_type self; \
+    KS_GETARGS("self:*", &self, ks_T_##_type) \
+    ks_obj _refs[] = { __VA_ARGS__ }; \
+    int _i; \
+    for (_i = 0; _i < sizeof(_refs) / sizeof(*_refs); ++_i) if (_refs[_i]) KS_DECREF(_refs[_i]); \
+    KS_UNINIT_OBJ(self); \
+    KS_FREE_OBJ(self); \
+    return KSO_NONE; \
+}
+
+
+/* map */
+
+// ks_map - lazily applies a function to the elements of one or more iterables
+typedef struct {
+    KS_OBJ_BASE
+
+    // the function to call
+    ks_obj func;
+
+    // the iterators being read from
+    ks_tuple its;
+
+}* ks_map;
+
+// map.__new__(func, *objs) - create a new map of 'func' over the elements of 'objs' (which are zipped together
+//   if there are multiple)
+static KS_TFUNC(map, new) {
+    ks_obj func;
+    int n_objs;
+    ks_obj* objs;
+    KS_GETARGS("func *objs", &func, &n_objs, &objs)
+
+    if (n_objs < 1) return ks_throw(ks_T_ArgError, "'map' requires at least 1 iterable");
+
+    ks_tuple its = iters_make(n_objs, objs);
+    if (!its) return NULL;
+
+    ks_map self = KS_ALLOC_OBJ(ks_map);
+    KS_INIT_OBJ(self, ks_T_map);
+
+    self->func = KS_NEWREF(func);
+    self->its = its;
+
+    return (ks_obj)self;
+}
+
+// map.__free__(self) - free obj
+static KS_TFUNC(map, free) ITERS_FREE(map, self->func, (ks_obj)self->its)
+
+// map.__next__(self) - return the function applied to the next element(s)
+static KS_TFUNC(map, next) {
+    ks_map self;
+    KS_GETARGS("self:*", &self, ks_T_map)
+
+    int n = self->its->len;
+
+    if (n == 1) {
+        ks_obj ob = iters_next(self->its->elems[0]);
+        if (!ob) return NULL;
+
+        ks_obj ret = ks_obj_call(self->func, 1, &ob);
+        KS_DECREF(ob);
+        return ret;
+    }
+
+    ks_obj* obs = ks_malloc(sizeof(*obs) * n);
+
+    int i;
+    for (i = 0; i < n; ++i) {
+        if (!(obs[i] = iters_next(self->its->elems[i]))) break;
+    }
+
+    ks_obj ret = i == n ? ks_obj_call(self->func, n, obs) : NULL;
+
+    while (--i >= 0) KS_DECREF(obs[i]);
+    ks_free(obs);
+
+    return ret;
+}
+
+
+/* filter */
+
+// ks_filter - lazily yields the elements of an iterable for which a function is truthy
+typedef struct {
+    KS_OBJ_BASE
+
+    // the function to call (or 'none', to use the truthiness of the elements themselves)
+    ks_obj func;
+
+    // the iterator being read from
+    ks_obj it;
+
+}* ks_filter;
+
+// filter.__new__(func, objs) - create a new filter of 'objs' by 'func'
+static KS_TFUNC(filter, new) {
+    ks_obj func, objs;
+    KS_GETARGS("func objs", &func, &objs)
+
+    ks_obj it = ks_F_iter->func(1, &objs);
+    if (!it) return NULL;
+
+    ks_filter self = KS_ALLOC_OBJ(ks_filter);
+    KS_INIT_OBJ(self, ks_T_filter);
+
+    self->func = KS_NEWREF(func);
+    self->it = it;
+
+    return (ks_obj)self;
+}
+
+// filter.__free__(self) - free obj
+static KS_TFUNC(filter, free) ITERS_FREE(filter, self->func, self->it)
+
+// filter.__next__(self) - return the next element which passes the filter
+static KS_TFUNC(filter, next) {
+    ks_filter self;
+    KS_GETARGS("self:*", &self, ks_T_filter)
+
+    while (true) {
+        ks_obj ob = iters_next(self->it);
+        if (!ob) return NULL;
+
+        int truthy;
+        if (self->func == KSO_NONE) {
+            truthy = ks_obj_truthy(ob);
+        } else {
+            ks_obj res = ks_obj_call(self->func, 1, &ob);
+            if (!res) {
+                KS_DECREF(ob);
+                return NULL;
+            }
+            truthy = ks_obj_truthy(res);
+            KS_DECREF(res);
+        }
+
+        if (truthy < 0) {
+            KS_DECREF(ob);
+            return NULL;
+        } else if (truthy) {
+            return ob;
+        }
+
+        KS_DECREF(ob);
+    }
+}
+
+
+/* zip */
+
+// ks_zip - lazily yields tuples of the elements of multiple iterables, until the shortest one runs out
+typedef struct {
+    KS_OBJ_BASE
+
+    // the iterators being read from
+    ks_tuple its;
+
+}* ks_zip;
+
+// zip.__new__(*objs) - create a new zip of 'objs'
+static KS_TFUNC(zip, new) {
+    int n_objs;
+    ks_obj* objs;
+    KS_GETARGS("*objs", &n_objs, &objs)
+
+    ks_tuple its = iters_make(n_objs, objs);
+    if (!its) return NULL;
+
+    ks_zip self = KS_ALLOC_OBJ(ks_zip);
+    KS_INIT_OBJ(self, ks_T_zip);
+
+    self->its = its;
+
+    return (ks_obj)self;
+}
+
+// zip.__free__(self) - free obj
+static KS_TFUNC(zip, free) ITERS_FREE(zip, (ks_obj)self->its)
+
+// zip.__next__(self) - return a tuple of the next elements
+static KS_TFUNC(zip, next) {
+    ks_zip self;
+    KS_GETARGS("self:*", &self, ks_T_zip)
+
+    int n = self->its->len;
+    if (n == 0) return ks_throw(ks_T_OutOfIterError, "");
+
+    ks_obj* obs = ks_malloc(sizeof(*obs) * n);
+
+    int i;
+    for (i = 0; i < n; ++i) {
+        if (!(obs[i] = iters_next(self->its->elems[i]))) {
+            while (--i >= 0) KS_DECREF(obs[i]);
+            ks_free(obs);
+            return NULL;
+        }
+    }
+
+    ks_tuple ret = ks_tuple_new_n(n, obs);
+    ks_free(obs);
+    return (ks_obj)ret;
+}
+
+
+/* enumerate */
+
+// ks_enumerate - lazily yields tuples of '(idx, elem)' for an iterable
+typedef struct {
+    KS_OBJ_BASE
+
+    // the iterator being read from
+    ks_obj it;
+
+    // the next index to yield
+    int64_t idx;
+
+}* ks_enumerate;
+
+// enumerate.__new__(objs, start=0) - create a new enumerate of 'objs', with indices starting at 'start'
+static KS_TFUNC(enumerate, new) {
+    ks_obj objs;
+    int64_t start = 0;
+    KS_GETARGS("objs ?start:i64", &objs, &start)
+
+    ks_obj it = ks_F_iter->func(1, &objs);
+    if (!it) return NULL;
+
+    ks_enumerate self = KS_ALLOC_OBJ(ks_enumerate);
+    KS_INIT_OBJ(self, ks_T_enumerate);
+
+    self->it = it;
+    self->idx = start;
+
+    return (ks_obj)self;
+}
+
+// enumerate.__free__(self) - free obj
+static KS_TFUNC(enumerate, free) ITERS_FREE(enumerate, self->it)
+
+// enumerate.__next__(self) - return '(idx, elem)' for the next element
+static KS_TFUNC(enumerate, next) {
+    ks_enumerate self;
+    KS_GETARGS("self:*", &self, ks_T_enumerate)
+
+    ks_obj ob = iters_next(self->it);
+    if (!ob) return NULL;
+
+    return (ks_obj)ks_tuple_new_n(2, (ks_obj[]){ (ks_obj)ks_int_new(self->idx++), ob });
+}
+
+
+/* chain */
+
+// ks_chain - lazily yields the elements of each iterable, one after another
+typedef struct {
+    KS_OBJ_BASE
+
+    // the iterables to go through
+    ks_tuple objs;
+
+    // index of the next iterable in 'objs'
+    int pos;
+
+    // the iterator currently being read from (or NULL if there is none yet)
+    ks_obj it;
+
+}* ks_chain;
+
+// chain.__new__(*objs) - create a new chain of 'objs'
+static KS_TFUNC(chain, new) {
+    int n_objs;
+    ks_obj* objs;
+    KS_GETARGS("*objs", &n_objs, &objs)
+
+    ks_chain self = KS_ALLOC_OBJ(ks_chain);
+    KS_INIT_OBJ(self, ks_T_chain);
+
+    // iterators are only created once they are reached
+    self->objs = ks_tuple_new(n_objs, objs);
+    self->pos = 0;
+    self->it = NULL;
+
+    return (ks_obj)self;
+}
+
+// chain.__free__(self) - free obj
+static KS_TFUNC(chain, free) ITERS_FREE(chain, (ks_obj)self->objs, self->it)
+
+// chain.__next__(self) - return the next element
+static KS_TFUNC(chain, next) {
+    ks_chain self;
+    KS_GETARGS("self:*", &self, ks_T_chain)
+
+    while (true) {
+        if (!self->it) {
+            if (self->pos >= self->objs->len) return ks_throw(ks_T_OutOfIterError, "");
+
+            self->it = ks_F_iter->func(1, &self->objs->elems[self->pos++]);
+            if (!self->it) return NULL;
+        }
+
+        ks_obj ob = iters_next(self->it);
+        if (ob) return ob;
+        if (!iters_catch_end()) return NULL;
+
+        // move on to the next iterable
+        KS_DECREF(self->it);
+        self->it = NULL;
+    }
+}
+
+
+/* islice */
+
+// ks_islice - lazily yields a slice of an iterable (without indexing it)
+typedef struct {
+    KS_OBJ_BASE
+
+    // the iterator being read from (or NULL, once the slice has been exhausted)
+    ks_obj it;
+
+    // index of the next element in 'it', and the index of the next element to yield
+    int64_t pos, next;
+
+    // end of the slice (or -1 for no end), and the step between elements
+    int64_t stop, step;
+
+}* ks_islice;
+
+// islice.__new__(objs, start, stop=none, step=1) - create a new slice of 'objs'
+// NOTE: 'islice(objs, stop)' is the same as 'islice(objs, 0, stop)'
+static KS_TFUNC(islice, new) {
+    ks_obj objs, start, stop = NULL, step = NULL;
+    KS_GETARGS("objs start ?stop ?step", &objs, &start, &stop, &step)
+
+    if (!stop) {
+        stop = start;
+        start = KSO_NONE;
+    }
+
+    int64_t start_v = 0, stop_v = -1, step_v = 1;
+    if ((start != KSO_NONE && !ks_num_get_int64(start, &start_v)) || (stop != KSO_NONE && !ks_num_get_int64(stop, &stop_v)) || (step && step != KSO_NONE && !ks_num_get_int64(step, &step_v))) {
+        return NULL;
+    }
+
+    if (start_v < 0 || (stop != KSO_NONE && stop_v < 0)) return ks_throw(ks_T_ArgError, "'islice' requires 'start' and 'stop' to be non-negative");
+    if (step_v < 1) return ks_throw(ks_T_ArgError, "'islice' requires 'step' to be positive");
+
+    ks_obj it = ks_F_iter->func(1, &objs);
+    if (!it) return NULL;
+
+    ks_islice self = KS_ALLOC_OBJ(ks_islice);
+    KS_INIT_OBJ(self, ks_T_islice);
+
+    self->it = it;
+    self->pos = 0;
+    self->next = start_v;
+    self->stop = stop_v;
+    self->step = step_v;
+
+    return (ks_obj)self;
+}
+
+// islice.__free__(self) - free obj
+static KS_TFUNC(islice, free) ITERS_FREE(islice, self->it)
+
+// islice.__next__(self) - return the next element in the slice
+static KS_TFUNC(islice, next) {
+    ks_islice self;
+    KS_GETARGS("self:*", &self, ks_T_islice)
+
+    if (!self->it || (self->stop >= 0 && self->next >= self->stop)) {
+        // release the input as soon as possible, since no more elements are needed
+        if (self->it) KS_DECREF(self->it);
+        self->it = NULL;
+        return ks_throw(ks_T_OutOfIterError, "");
+    }
+
+    // skip elements before the next one
+    while (self->pos < self->next) {
+        ks_obj ob = iters_next(self->it);
+        if (!ob) return NULL;
+        KS_DECREF(ob);
+        self->pos++;
+    }
+
+    ks_obj ob = iters_next(self->it);
+    if (!ob) return NULL;
+
+    self->pos++;
+    self->next += self->step;
+
+    return ob;
+}
+
+
+/* takewhile/dropwhile */
+
+// ks_takewhile - lazily yields elements of an iterable while a function is truthy for them
+// ks_dropwhile - lazily skips elements of an iterable while a function is truthy for them, then yields the rest
+typedef struct {
+    KS_OBJ_BASE
+
+    // the function to call
+    ks_obj func;
+
+    // the iterator being read from
+    ks_obj it;
+
+    // whether the function has been falsey yet
+    bool done;
+
+}* ks_takewhile, *ks_dropwhile;
+
+// call 'func(ob)', and return its truthiness (or -1 and throw an error)
+static int iters_test(ks_obj func, ks_obj ob) {
+    ks_obj res = ks_obj_call(func, 1, &ob);
+    if (!res) return -1;
+
+    int truthy = ks_obj_truthy(res);
+    KS_DECREF(res);
+    return truthy;
+}
+
+// create a new takewhile/dropwhile
+static ks_obj iters_while_new(ks_type tp, int n_args, ks_obj* args) {
+    ks_obj func, objs;
+    KS_GETARGS("func objs", &func, &objs)
+
+    ks_obj it = ks_F_iter->func(1, &objs);
+    if (!it) return NULL;
+
+    ks_takewhile self = KS_ALLOC_OBJ(ks_takewhile);
+    KS_INIT_OBJ(self, tp);
+
+    self->func = KS_NEWREF(func);
+    self->it = it;
+    self->done = false;
+
+    return (ks_obj)self;
+}
+
+// takewhile.__new__(func, objs) - create a new iterator of 'objs' that stops once 'func' is falsey
+static KS_TFUNC(takewhile, new) {
+    return iters_while_new(ks_T_takewhile, n_args, args);
+}
+
+// takewhile.__free__(self) - free obj
+static KS_TFUNC(takewhile, free) ITERS_FREE(takewhile, self->func, self->it)
+
+// takewhile.__next__(self) - return the next element, if 'func' is truthy for it
+static KS_TFUNC(takewhile, next) {
+    ks_takewhile self;
+    KS_GETARGS("self:*", &self, ks_T_takewhile)
+
+    if (self->done) return ks_throw(ks_T_OutOfIterError, "");
+
+    ks_obj ob = iters_next(self->it);
+    if (!ob) return NULL;
+
+    int truthy = iters_test(self->func, ob);
+    if (truthy == 1) return ob;
+
+    KS_DECREF(ob);
+    if (truthy < 0) return NULL;
+
+    self->done = true;
+    return ks_throw(ks_T_OutOfIterError, "");
+}
+
+// dropwhile.__new__(func, objs) - create a new iterator of 'objs' that starts once 'func' is falsey
+static KS_TFUNC(dropwhile, new) {
+    return iters_while_new(ks_T_dropwhile, n_args, args);
+}
+
+// dropwhile.__free__(self) - free obj
+static KS_TFUNC(dropwhile, free) ITERS_FREE(dropwhile, self->func, self->it)
+
+// dropwhile.__next__(self) - return the next element, once 'func' has been falsey
+static KS_TFUNC(dropwhile, next) {
+    ks_dropwhile self;
+    KS_GETARGS("self:*", &self, ks_T_dropwhile)
+
+    while (true) {
+        ks_obj ob = iters_next(self->it);
+        if (!ob || self->done) return ob;
+
+        int truthy = iters_test(self->func, ob);
+        if (truthy == 0) {
+            self->done = true;
+            return ob;
+        }
+
+        KS_DECREF(ob);
+        if (truthy < 0) return NULL;
+    }
+}
+
+
+/* repeat */
+
+// ks_repeat - lazily yields the same object, either a number of times or forever
+typedef struct {
+    KS_OBJ_BASE
+
+    // the object to yield
+    ks_obj obj;
+
+    // the number of times left (or -1 for forever)
+    int64_t times;
+
+}* ks_repeat;
+
+// repeat.__new__(obj, times=none) - create a new iterator yielding 'obj' for 'times' times (or forever, if none)
+static KS_TFUNC(repeat, new) {
+    ks_obj obj, times = KSO_NONE;
+    KS_GETARGS("obj ?times", &obj, &times)
+
+    int64_t times_v = -1;
+    if (times != KSO_NONE) {
+        if (!ks_num_get_int64(times, &times_v)) return NULL;
+        if (times_v < 0) times_v = 0;
+    }
+
+    ks_repeat self = KS_ALLOC_OBJ(ks_repeat);
+    KS_INIT_OBJ(self, ks_T_repeat);
+
+    self->obj = KS_NEWREF(obj);
+    self->times = times_v;
+
+    return (ks_obj)self;
+}
+
+// repeat.__free__(self) - free obj
+static KS_TFUNC(repeat, free) ITERS_FREE(repeat, self->obj)
+
+// repeat.__next__(self) - return the object again
+static KS_TFUNC(repeat, next) {
+    ks_repeat self;
+    KS_GETARGS("self:*", &self, ks_T_repeat)
+
+    if (self->times == 0) return ks_throw(ks_T_OutOfIterError, "");
+    if (self->times > 0) self->times--;
+
+    return KS_NEWREF(self->obj);
+}
+
+
+/* export */
+
+KS_TYPE_DECLFWD(ks_T_map);
+KS_TYPE_DECLFWD(ks_T_filter);
+KS_TYPE_DECLFWD(ks_T_zip);
+KS_TYPE_DECLFWD(ks_T_enumerate);
+KS_TYPE_DECLFWD(ks_T_chain);
+KS_TYPE_DECLFWD(ks_T_islice);
+KS_TYPE_DECLFWD(ks_T_takewhile);
+KS_TYPE_DECLFWD(ks_T_dropwhile);
+KS_TYPE_DECLFWD(ks_T_repeat);
+
+void ks_init_T_iters() {
+    ks_type_init_c(ks_T_map, "map", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(map_new_, "map.__new__(func, *objs)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(map_free_, "map.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(map_next_, "map.__next__(self)")},
+    ));
+    ks_type_init_c(ks_T_filter, "filter", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(filter_new_, "filter.__new__(func, objs)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(filter_free_, "filter.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(filter_next_, "filter.__next__(self)")},
+    ));
+    ks_type_init_c(ks_T_zip, "zip", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(zip_new_, "zip.__new__(*objs)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(zip_free_, "zip.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(zip_next_, "zip.__next__(self)")},
+    ));
+    ks_type_init_c(ks_T_enumerate, "enumerate", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(enumerate_new_, "enumerate.__new__(objs, start=0)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(enumerate_free_, "enumerate.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(enumerate_next_, "enumerate.__next__(self)")},
+    ));
+    ks_type_init_c(ks_T_chain, "chain", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(chain_new_, "chain.__new__(*objs)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(chain_free_, "chain.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(chain_next_, "chain.__next__(self)")},
+    ));
+    ks_type_init_c(ks_T_islice, "islice", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(islice_new_, "islice.__new__(objs, start, stop=none, step=1)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(islice_free_, "islice.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(islice_next_, "islice.__next__(self)")},
+    ));
+    ks_type_init_c(ks_T_takewhile, "takewhile", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(takewhile_new_, "takewhile.__new__(func, objs)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(takewhile_free_, "takewhile.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(takewhile_next_, "takewhile.__next__(self)")},
+    ));
+    ks_type_init_c(ks_T_dropwhile, "dropwhile", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(dropwhile_new_, "dropwhile.__new__(func, objs)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(dropwhile_free_, "dropwhile.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(dropwhile_next_, "dropwhile.__next__(self)")},
+    ));
+    ks_type_init_c(ks_T_repeat, "repeat", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(repeat_new_, "repeat.__new__(obj, times=none)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(repeat_free_, "repeat.__free__(self)")},
+        {"__next__",               (ks_obj)ks_cfunc_new_c_old(repeat_next_, "repeat.__next__(self)")},
+    ));
+}
@@ -1,4 +1,12 @@
 /* list.c - implementation of the 'list' type
+ *
+ * Lists of numbers which are created or grown by scripts (and have at least `KS_LIST_UNBOX_MIN` elements, all small
+ *   ints or all floats) are stored unboxed (see `KS_LIST_KIND_*`), as a plain array of C values. Elements are only
+ *   made into objects when they are read, and storing anything else boxes the whole list again
+ *
+ * Only the methods of the type itself (`list()`, `push`, `+`, `*`, and slicing) unbox a list; the C functions
+ *   (`ks_list_push()` and friends) keep unboxed lists unboxed when they can, but never unbox a list. So C code can
+ *   keep using 'elems' of lists that it creates and doesn't give to scripts (for example, the stack of a thread)
  *
  * @author: Cade Brown <brown.cade@gmail.com>
  */
@@ -6,6 +14,12 @@
 #include "ks-impl.h"
 
 
+/* Tuning/Performance parameters */
+
+// minimum length for a list to be stored unboxed (smaller lists would spend more time creating objects when
+//   they are read than they save)
+#define KS_LIST_UNBOX_MIN 32
+
 
 // Construct a new list from an array of elements
 // NOTE: Returns new reference, or NULL if an error was thrown
@@ -16,7 +30,10 @@ ks_list ks_list_new(ks_size_t len, ks_obj* elems) {
 
 
     self->len = len;
+    self->max_len = len;
     self->elems = ks_malloc(sizeof(*self->elems) * self->len);
+    self->kind = KS_LIST_KIND_OBJ;
+    self->raw.v64 = NULL;
 
     ks_size_t i;
     for (i = 0; i < len; ++i) {
@@ -27,6 +44,105 @@ ks_list ks_list_new(ks_size_t len, ks_obj* elems) {
     return self;
 }
 
+// create an empty list, which stores its elements as 'kind'
+static ks_list list_new_kind(int kind) {
+    ks_list self = ks_list_new(0, NULL);
+    if (kind != KS_LIST_KIND_OBJ) {
+        ks_free(self->elems);
+        self->elems = NULL;
+        self->kind = kind;
+    }
+    return self;
+}
+
+// return the kind of list that 'obj' could be stored in unboxed (or KS_LIST_KIND_OBJ if none)
+static int list_kindof(ks_obj obj) {
+    if (obj->type == ks_T_int && !((ks_int)obj)->isLong) return KS_LIST_KIND_INT64;
+    else if (obj->type == ks_T_float) return KS_LIST_KIND_FLOAT;
+    else return KS_LIST_KIND_OBJ;
+}
+
+// return the kind of list that all of 'elems[:n]' could be stored in unboxed (or KS_LIST_KIND_OBJ if none)
+static int list_kindof_all(ks_size_t n, ks_obj* elems) {
+    if (n == 0) return KS_LIST_KIND_OBJ;
+
+    int kind = list_kindof(elems[0]);
+    ks_size_t i;
+    for (i = 1; i < n && kind != KS_LIST_KIND_OBJ; ++i) {
+        if (list_kindof(elems[i]) != kind) kind = KS_LIST_KIND_OBJ;
+    }
+
+    return kind;
+}
+
+// return the kind of list that 'n' elements taken from 'objs' (which is iterated over) should be stored in
+static int list_kindof_seq(ks_obj objs, ks_size_t n) {
+    if (n < KS_LIST_UNBOX_MIN) {
+        return KS_LIST_KIND_OBJ;
+    } else if (objs->type == ks_T_list) {
+        ks_list l = (ks_list)objs;
+        return l->kind != KS_LIST_KIND_OBJ ? l->kind : list_kindof_all(l->len, l->elems);
+    } else if (objs->type == ks_T_tuple) {
+        return list_kindof_all(((ks_tuple)objs)->len, ((ks_tuple)objs)->elems);
+    } else if (objs->type == ks_T_range) {
+        return KS_LIST_KIND_INT64;
+    } else {
+        return KS_LIST_KIND_OBJ;
+    }
+}
+
+// create an object for element 'idx' of an unboxed list
+static ks_obj list_boxi(ks_list self, ks_size_t idx) {
+    if (self->kind == KS_LIST_KIND_INT64) return (ks_obj)ks_int_new(self->raw.v64[idx]);
+    else return (ks_obj)ks_float_new(self->raw.vf[idx]);
+}
+
+// Return a reference to 'self[idx]'
+ks_obj ks_list_get(ks_list self, ks_size_t idx) {
+    return self->kind == KS_LIST_KIND_OBJ ? KS_NEWREF(self->elems[idx]) : list_boxi(self, idx);
+}
+
+// Make sure the elements of 'self' are stored as objects, and return them
+ks_obj* ks_list_box(ks_list self) {
+    if (self->kind != KS_LIST_KIND_OBJ) {
+        ks_obj* elems = ks_malloc(sizeof(*elems) * self->max_len);
+
+        ks_size_t i;
+        for (i = 0; i < self->len; ++i) elems[i] = list_boxi(self, i);
+
+        ks_free(self->raw.v64);
+        self->raw.v64 = NULL;
+        self->elems = elems;
+        self->kind = KS_LIST_KIND_OBJ;
+    }
+
+    return self->elems;
+}
+
+// store the elements of 'self' unboxed, if it is long enough and they are all numbers of the same kind
+// NOTE: This is only done for lists that scripts create or grow; see the top of this file
+static void list_unbox(ks_list self) {
+    if (self->kind != KS_LIST_KIND_OBJ || self->len < KS_LIST_UNBOX_MIN) return;
+
+    int kind = list_kindof_all(self->len, self->elems);
+    if (kind == KS_LIST_KIND_OBJ) return;
+
+    int64_t* raw = ks_malloc(sizeof(*raw) * self->max_len);
+
+    ks_size_t i;
+    for (i = 0; i < self->len; ++i) {
+        ks_obj ob = self->elems[i];
+        if (kind == KS_LIST_KIND_INT64) raw[i] = ((ks_int)ob)->v64;
+        else ((double*)raw)[i] = ((ks_float)ob)->val;
+        KS_DECREF(ob);
+    }
+
+    ks_free(self->elems);
+    self->elems = NULL;
+    self->raw.v64 = raw;
+    self->kind = kind;
+}
+
 // Construct a list from an iterator
 // NOTE: Returns new reference, or NULL if an error was thrown
 ks_list ks_list_new_iter(ks_obj iter_obj) {
@@ -45,7 +161,7 @@ void ks_list_clear(ks_list self) {
     ks_size_t i;
 
     // release references
-    for (i = 0; i < self->len; ++i) KS_DECREF(self->elems[i]);
+    if (self->kind == KS_LIST_KIND_OBJ) for (i = 0; i < self->len; ++i) KS_DECREF(self->elems[i]);
 
     // now, set the length
     self->len = 0;
@@ -57,15 +173,58 @@ void ks_list_clear(ks_list self) {
 }
 
 
+// ensure 'self' has room for at least 'n' elements
+static void list_reserve(ks_list self, ks_size_t n) {
+    if (n <= self->max_len) return;
+
+    // grow geometrically, so that repeated pushes are amortized O(1)
+    ks_size_t new_max_len = self->max_len + self->max_len / 2 + 4;
+    if (new_max_len < n) new_max_len = n;
+
+    if (self->kind == KS_LIST_KIND_OBJ) self->elems = ks_realloc(self->elems, sizeof(*self->elems) * new_max_len);
+    else self->raw.v64 = ks_realloc(self->raw.v64, sizeof(*self->raw.v64) * new_max_len);
+    self->max_len = new_max_len;
+}
+
 // Empty out `objs` (which must be iterable!), and add everything to `self`
 // NOTE: Returns success, or false and throws an error
 bool ks_list_pushall(ks_list self, ks_obj objs) {
     if (objs->type == ks_T_list) {
-        ks_list_pushn(self, ((ks_list)objs)->len, ((ks_list)objs)->elems);
+        ks_list other = (ks_list)objs;
+        if (other->kind == KS_LIST_KIND_OBJ) {
+            ks_list_pushn(self, other->len, other->elems);
+        } else if (other->kind == self->kind) {
+            // NOTE: 'other' may be 'self', so only read its data after reserving
+            ks_size_t n = other->len;
+            list_reserve(self, self->len + n);
+            memcpy(self->raw.v64 + self->len, other->raw.v64, sizeof(*self->raw.v64) * n);
+            self->len += n;
+        } else {
+            ks_size_t i, n = other->len;
+            for (i = 0; i < n; ++i) {
+                ks_obj ob = list_boxi(other, i);
+                ks_list_push(self, ob);
+                KS_DECREF(ob);
+            }
+        }
         return true;
     } else if (objs->type == ks_T_tuple) {
         ks_list_pushn(self, ((ks_tuple)objs)->len, ((ks_tuple)objs)->elems);
         return true;
+    } else if (objs->type == ks_T_range) {
+        // create the integers directly, rather than going through the iterator
+        int64_t start, step;
+        ks_size_t n, i;
+        if (ks_range_get_c((ks_range)objs, &start, &step, &n)) {
+            if (self->kind == KS_LIST_KIND_FLOAT) ks_list_box(self);
+            list_reserve(self, self->len + n);
+            for (i = 0; i < n; ++i) {
+                int64_t v64 = start + (int64_t)i * step;
+                if (self->kind == KS_LIST_KIND_INT64) self->raw.v64[self->len++] = v64;
+                else self->elems[self->len++] = (ks_obj)ks_int_new(v64);
+            }
+            return true;
+        }
     }
 
 
@@ -85,13 +244,20 @@ bool ks_list_pushall(ks_list self, ks_obj objs) {
 
 // Pushes 'obj' on to the end of the list
 void ks_list_push(ks_list self, ks_obj obj) {
-    int idx = self->len++;
+    if (self->kind != KS_LIST_KIND_OBJ && list_kindof(obj) != self->kind) ks_list_box(self);
 
-    self->elems = ks_realloc(self->elems, sizeof(*self->elems) * self->len);
+    list_reserve(self, self->len + 1);
+    int idx = self->len++;
 
-    // set the new element to the given object, and hold a reference to it
-    self->elems[idx] = obj;
-    KS_INCREF(obj);
+    if (self->kind == KS_LIST_KIND_INT64) {
+        self->raw.v64[idx] = ((ks_int)obj)->v64;
+    } else if (self->kind == KS_LIST_KIND_FLOAT) {
+        self->raw.vf[idx] = ((ks_float)obj)->val;
+    } else {
+        // set the new element to the given object, and hold a reference to it
+        self->elems[idx] = obj;
+        KS_INCREF(obj);
+    }
 
 }
 
@@ -104,14 +270,25 @@ void ks_list_pushn(ks_list self, int n, ks_obj* objs) {
         ks_list_push(self, objs[i]);
     } */
 
+    ks_size_t i;
+    if (self->kind != KS_LIST_KIND_OBJ) {
+        // each one may need to box the list
+        // NOTE: 'objs' can't be from this list, since it has no objects
+        for (i = 0; i < n; ++i) ks_list_push(self, objs[i]);
+        return;
+    }
+
     // push up to a new start
     ks_size_t new_start = self->len;
-    self->len += n;
+
+    // 'objs' may be from this list, which could be moved when reallocating
+    ks_ssize_t self_off = (objs >= self->elems && objs < self->elems + self->len) ? objs - self->elems : -1;
 
     // ensure enough space is given
-    self->elems = ks_realloc(self->elems, sizeof(*self->elems) * self->len);
+    list_reserve(self, self->len + n);
+    self->len += n;
+    if (self_off >= 0) objs = self->elems + self_off;
 
-    ks_size_t i;
     for (i = 0; i < n; ++i) {
         KS_INCREF(objs[i]);
         self->elems[new_start + i] = objs[i];
@@ -138,6 +315,7 @@ void ks_list_pushn(ks_list self, int n, ks_obj* objs) {
 // NOTE: Throws 'SizeError' if the list was empty
 ks_obj ks_list_pop(ks_list self) {
     if (self->len < 1) return ks_throw(ks_T_SizeError, "'list' object had no elements to pop!");
+    if (self->kind != KS_LIST_KIND_OBJ) return list_boxi(self, --self->len);
     return self->elems[--self->len];
 }
 
@@ -156,7 +334,12 @@ bool ks_list_popn(ks_list self, int n, ks_obj* dest) {
     self->len -= n;
 
     // now, set 'dest' to them
-    memcpy(dest, &self->elems[self->len], sizeof(*dest) * n);
+    if (self->kind != KS_LIST_KIND_OBJ) {
+        int i;
+        for (i = 0; i < n; ++i) dest[i] = list_boxi(self, self->len + i);
+    } else {
+        memcpy(dest, &self->elems[self->len], sizeof(*dest) * n);
+    }
 
     return true;
 }
@@ -168,8 +351,8 @@ bool ks_list_popu(ks_list self) {
         ks_throw(ks_T_SizeError, "'list' object had no elements to pop!");
         return false;
     }
-    ks_obj top = self->elems[--self->len];
-    KS_DECREF(top);
+    self->len--;
+    if (self->kind == KS_LIST_KIND_OBJ) KS_DECREF(self->elems[self->len]);
 
     return true;
 }
@@ -186,45 +369,400 @@ bool ks_list_popun(ks_list self, int n) {
     self->len -= n;
     ks_size_t i;
 
-    for (i = self->len; i < self->len + n; ++i) {
-        KS_DECREF(self->elems[i]);
+    if (self->kind == KS_LIST_KIND_OBJ) {
+        for (i = self->len; i < self->len + n; ++i) {
+            KS_DECREF(self->elems[i]);
+        }
+    }
+
+    return true;
+}
+
+/* Sorting
+ *
+ * Lists are sorted with a stable, adaptive merge sort (in the style of timsort): existing ascending (or strictly
+ *   descending) runs are detected and reused, short runs are extended with binary insertion sort, and runs are
+ *   merged while keeping the run stack balanced, so already sorted (or reversed) data takes O(n) comparisons
+ *
+ * Before sorting, the keys are scanned; if they are all the same type (int, float, or str), a direct C comparison
+ *   is used for every pair, instead of checking the types each time in `ks_obj_lt()`
+ *
+ */
+
+// an element being sorted, with its (possibly computed) key
+struct sort_item {
+
+    // the key, as either a C value (for the fast paths), or the key object
+    union {
+        int64_t v64;
+        double vf;
+        ks_obj obj;
+    } k;
+
+    // the value being sorted (which holds a reference)
+    ks_obj val;
+
+};
+
+// sorting state
+struct sort_ctx {
+
+    // return whether a < b
+    bool (*lt)(struct sort_ctx* ctx, struct sort_item* a, struct sort_item* b);
+
+    // whether an error has been thrown (in which case the order no longer matters)
+    bool threwErr;
+
+    // temporary storage for merging
+    struct sort_item* tmp;
+    ks_size_t tmp_len;
+
+};
+
+// minimum run length (shorter runs are extended by insertion sort)
+#define SORT_MINRUN 32
+
+// maximum number of pending runs (which is plenty, since run lengths grow at least as fast as the fibonacci sequence)
+#define SORT_MAXRUNS 128
+
+static bool sort_lt_int64(struct sort_ctx* ctx, struct sort_item* a, struct sort_item* b) {
+    return a->k.v64 < b->k.v64;
+}
+
+static bool sort_lt_int(struct sort_ctx* ctx, struct sort_item* a, struct sort_item* b) {
+    return ks_int_cmp((ks_int)a->k.obj, (ks_int)b->k.obj) < 0;
+}
+
+static bool sort_lt_float(struct sort_ctx* ctx, struct sort_item* a, struct sort_item* b) {
+    return a->k.vf < b->k.vf;
+}
+
+static bool sort_lt_str(struct sort_ctx* ctx, struct sort_item* a, struct sort_item* b) {
+    return ks_str_cmp((ks_str)a->k.obj, (ks_str)b->k.obj) < 0;
+}
+
+// generic comparison (see `ks_obj_lt()`)
+static bool sort_lt_obj(struct sort_ctx* ctx, struct sort_item* a, struct sort_item* b) {
+    if (ctx->threwErr) return false;
+
+    int res = ks_obj_lt(a->k.obj, b->k.obj);
+    if (res < 0) {
+        ctx->threwErr = true;
+        return false;
+    }
+
+    return res == 1;
+}
+
+// reverse items[0:n]
+static void sort_reverse(struct sort_item* items, ks_size_t n) {
+    ks_size_t i;
+    for (i = 0; i < n / 2; ++i) {
+        struct sort_item t = items[i];
+        items[i] = items[n - i - 1];
+        items[n - i - 1] = t;
+    }
+}
+
+// sort items[0:n] with binary insertion sort, given that items[0:start] is already sorted
+static void sort_binins(struct sort_ctx* ctx, struct sort_item* items, ks_size_t start, ks_size_t n) {
+    ks_size_t i;
+    for (i = start; i < n; ++i) {
+        struct sort_item pivot = items[i];
+
+        // find the first position greater than the pivot (so equal items stay in order)
+        ks_size_t lo = 0, hi = i;
+        while (lo < hi) {
+            ks_size_t mid = lo + (hi - lo) / 2;
+            if (ctx->lt(ctx, &pivot, &items[mid])) hi = mid;
+            else lo = mid + 1;
+        }
+
+        memmove(&items[lo + 1], &items[lo], sizeof(*items) * (i - lo));
+        items[lo] = pivot;
+    }
+}
+
+// ensure the temporary storage can hold 'n' items
+static void sort_reserve(struct sort_ctx* ctx, ks_size_t n) {
+    if (ctx->tmp_len < n) {
+        ctx->tmp_len = n;
+        ctx->tmp = ks_realloc(ctx->tmp, sizeof(*ctx->tmp) * n);
+    }
+}
+
+// merge the adjacent sorted runs items[0:na] and items[na:na+nb]
+static void sort_merge(struct sort_ctx* ctx, struct sort_item* items, ks_size_t na, ks_size_t nb) {
+    struct sort_item* A = items, *B = items + na;
+
+    // already in order
+    if (!ctx->lt(ctx, &B[0], &A[na - 1])) return;
+
+    if (na <= nb) {
+        // copy the left run out, and merge forwards
+        sort_reserve(ctx, na);
+        memcpy(ctx->tmp, A, sizeof(*A) * na);
+
+        ks_size_t i = 0, j = 0, k = 0;
+        while (i < na && j < nb) {
+            // take from the left unless the right is strictly less, to remain stable
+            if (ctx->lt(ctx, &B[j], &ctx->tmp[i])) items[k++] = B[j++];
+            else items[k++] = ctx->tmp[i++];
+        }
+
+        memcpy(&items[k], &ctx->tmp[i], sizeof(*A) * (na - i));
+    } else {
+        // copy the right run out, and merge backwards
+        sort_reserve(ctx, nb);
+        memcpy(ctx->tmp, B, sizeof(*B) * nb);
+
+        ks_size_t i = na, j = nb, k = na + nb;
+        while (i > 0 && j > 0) {
+            if (ctx->lt(ctx, &ctx->tmp[j - 1], &A[i - 1])) items[--k] = A[--i];
+            else items[--k] = ctx->tmp[--j];
+        }
+
+        memcpy(&items[k - j], ctx->tmp, sizeof(*B) * j);
+    }
+}
+
+// stably sort items[0:n]
+static void sort_items(struct sort_ctx* ctx, struct sort_item* items, ks_size_t n) {
+    if (n < 2) return;
+
+    // stack of pending runs
+    ks_size_t run_base[SORT_MAXRUNS], run_len[SORT_MAXRUNS];
+    int n_runs = 0;
+
+    ks_size_t pos = 0;
+    while (pos < n) {
+
+        // find the next run
+        ks_size_t len = 1;
+        if (pos + 1 < n) {
+            if (ctx->lt(ctx, &items[pos + 1], &items[pos])) {
+                // strictly descending (so reversing it is stable)
+                len = 2;
+                while (pos + len < n && ctx->lt(ctx, &items[pos + len], &items[pos + len - 1])) len++;
+                sort_reverse(&items[pos], len);
+            } else {
+                len = 2;
+                while (pos + len < n && !ctx->lt(ctx, &items[pos + len], &items[pos + len - 1])) len++;
+            }
+        }
+
+        // extend short runs
+        if (len < SORT_MINRUN) {
+            ks_size_t ext = n - pos < SORT_MINRUN ? n - pos : SORT_MINRUN;
+            sort_binins(ctx, &items[pos], len, ext);
+            len = ext;
+        }
+
+        run_base[n_runs] = pos;
+        run_len[n_runs] = len;
+        n_runs++;
+        pos += len;
+
+        // merge runs until the stack is balanced (each run is longer than the sum of the next two)
+        while (n_runs > 1) {
+            int i = n_runs - 2;
+            if ((i > 0 && run_len[i - 1] <= run_len[i] + run_len[i + 1]) || (i > 1 && run_len[i - 2] <= run_len[i - 1] + run_len[i])) {
+                if (run_len[i - 1] < run_len[i + 1]) i--;
+            } else if (run_len[i] > run_len[i + 1]) {
+                break;
+            }
+
+            sort_merge(ctx, &items[run_base[i]], run_len[i], run_len[i + 1]);
+            run_len[i] += run_len[i + 1];
+            memmove(&run_base[i + 1], &run_base[i + 2], sizeof(*run_base) * (n_runs - i - 2));
+            memmove(&run_len[i + 1], &run_len[i + 2], sizeof(*run_len) * (n_runs - i - 2));
+            n_runs--;
+        }
+    }
+
+    // merge whatever is left
+    while (n_runs > 1) {
+        int i = n_runs - 2;
+        if (i > 0 && run_len[i - 1] < run_len[i + 1]) i--;
+
+        sort_merge(ctx, &items[run_base[i]], run_len[i], run_len[i + 1]);
+        run_len[i] += run_len[i + 1];
+        memmove(&run_base[i + 1], &run_base[i + 2], sizeof(*run_base) * (n_runs - i - 2));
+        memmove(&run_len[i + 1], &run_len[i + 2], sizeof(*run_len) * (n_runs - i - 2));
+        n_runs--;
+    }
+}
+
+// Sort a list in place (stably), comparing `key(elem)` (or the elements, if 'key' is NULL or none), and
+//   reversing the order if 'reverse' is true
+// NOTE: Returns success, or false and throws an error (in which case the list is left in some order)
+bool ks_list_sort(ks_list self, ks_obj key, bool reverse) {
+    if (key == KSO_NONE) key = NULL;
+
+    ks_size_t n = self->len, i;
+    if (n < 2 && !key) return true;
+
+    if (self->kind != KS_LIST_KIND_OBJ && !key) {
+        // unboxed, so sort the C values directly (in the same way as the fast paths below)
+        struct sort_item* items = ks_malloc(sizeof(*items) * n);
+        struct sort_ctx ctx = (struct sort_ctx){ .lt = sort_lt_int64, .threwErr = false, .tmp = NULL, .tmp_len = 0 };
+        if (self->kind == KS_LIST_KIND_INT64) {
+            for (i = 0; i < n; ++i) items[i].k.v64 = self->raw.v64[i];
+        } else {
+            ctx.lt = sort_lt_float;
+            for (i = 0; i < n; ++i) items[i].k.vf = self->raw.vf[i];
+        }
+
+        if (reverse) sort_reverse(items, n);
+        sort_items(&ctx, items, n);
+        if (reverse) sort_reverse(items, n);
+
+        if (self->kind == KS_LIST_KIND_INT64) {
+            for (i = 0; i < n; ++i) self->raw.v64[i] = items[i].k.v64;
+        } else {
+            for (i = 0; i < n; ++i) self->raw.vf[i] = items[i].k.vf;
+        }
+
+        ks_free(items);
+        ks_free(ctx.tmp);
+        return true;
+    }
+
+    // key functions are given (and may keep) the elements themselves
+    ks_list_box(self);
+
+    // take the elements out of the list while sorting, so that key functions which modify it can be detected
+    ks_obj* elems = self->elems;
+    ks_size_t max_len = self->max_len;
+    self->elems = NULL;
+    self->len = self->max_len = 0;
+
+    struct sort_item* items = ks_malloc(sizeof(*items) * (n > 0 ? n : 1));
+    bool threwErr = false;
+
+    // decorate each element with its key (so each key function is only called once per element)
+    for (i = 0; i < n; ++i) {
+        items[i].val = elems[i];
+        if (key) {
+            if (!threwErr) {
+                items[i].k.obj = ks_obj_call(key, 1, &elems[i]);
+                if (!items[i].k.obj) threwErr = true;
+            } else {
+                items[i].k.obj = NULL;
+            }
+        } else {
+            items[i].k.obj = elems[i];
+        }
+    }
+
+    struct sort_ctx ctx = (struct sort_ctx){ .lt = sort_lt_obj, .threwErr = threwErr, .tmp = NULL, .tmp_len = 0 };
+
+    if (!threwErr) {
+
+        // pre-scan the key types, to choose a comparison
+        ks_type kt = n > 0 ? items[0].k.obj->type : NULL;
+        bool allSmall = true;
+        for (i = 0; i < n && kt; ++i) {
+            ks_obj k = items[i].k.obj;
+            if (k->type != kt) kt = NULL;
+            else if (kt == ks_T_int && ((ks_int)k)->isLong) allSmall = false;
+        }
+
+        if (kt == ks_T_int && allSmall) {
+            ctx.lt = sort_lt_int64;
+        } else if (kt == ks_T_int) {
+            ctx.lt = sort_lt_int;
+        } else if (kt == ks_T_float) {
+            ctx.lt = sort_lt_float;
+        } else if (kt == ks_T_str) {
+            ctx.lt = sort_lt_str;
+        }
+
+        // unbox the C values (the key objects are still held through the list of keys, if any)
+        ks_obj* keys = NULL;
+        if (ctx.lt == sort_lt_int64 || ctx.lt == sort_lt_float) {
+            if (key) {
+                keys = ks_malloc(sizeof(*keys) * n);
+                for (i = 0; i < n; ++i) keys[i] = items[i].k.obj;
+            }
+            for (i = 0; i < n; ++i) {
+                if (ctx.lt == sort_lt_int64) items[i].k.v64 = ((ks_int)items[i].k.obj)->v64;
+                else items[i].k.vf = ((ks_float)items[i].k.obj)->val;
+            }
+        }
+
+        // reversing before and after sorting keeps equal elements in their original order
+        if (reverse) sort_reverse(items, n);
+        sort_items(&ctx, items, n);
+        if (reverse) sort_reverse(items, n);
+
+        if (keys) {
+            for (i = 0; i < n; ++i) KS_DECREF(keys[i]);
+            ks_free(keys);
+        } else if (key) {
+            for (i = 0; i < n; ++i) KS_DECREF(items[i].k.obj);
+        }
+
+    } else if (key) {
+        for (i = 0; i < n; ++i) if (items[i].k.obj) KS_DECREF(items[i].k.obj);
+    }
+
+    // undecorate
+    for (i = 0; i < n; ++i) elems[i] = items[i].val;
+
+    ks_free(items);
+    ks_free(ctx.tmp);
+
+    // put the elements back
+    bool modified = self->len != 0;
+    ks_list_clear(self);
+    ks_free(self->elems);
+    ks_free(self->raw.v64);
+    self->raw.v64 = NULL;
+    self->kind = KS_LIST_KIND_OBJ;
+    self->elems = elems;
+    self->len = n;
+    self->max_len = max_len;
+
+    if (ctx.threwErr) return false;
+    if (modified) {
+        ks_throw(ks_T_Error, "'list' object was modified during sorting");
+        return false;
     }
 
     return true;
 }
 
+
 // list.__new__(objs) - create new list
 static KS_TFUNC(list, new) {
     ks_obj objs;
     KS_GETARGS("objs", &objs)
 
     // handle short cases
-    if (objs->type == ks_T_tuple) {
+    if (objs->type == ks_T_tuple && ((ks_tuple)objs)->len < KS_LIST_UNBOX_MIN) {
         return (ks_obj)ks_list_new(((ks_tuple)objs)->len, ((ks_tuple)objs)->elems);
-    } else if (objs->type == ks_T_list) {
+    } else if (objs->type == ks_T_list && ((ks_list)objs)->kind == KS_LIST_KIND_OBJ && ((ks_list)objs)->len < KS_LIST_UNBOX_MIN) {
         return (ks_obj)ks_list_new(((ks_list)objs)->len, ((ks_list)objs)->elems);
     }
 
-    // create new list and populate it
-    ks_list ret = ks_list_new(0, NULL);
-
-    struct ks_citer cit = ks_citer_make(objs);
-    ks_obj ob;
-    while (ob = ks_citer_next(&cit)) {
-        ks_list_push(ret, ob);
-        KS_DECREF(ob);
+    // create new list and populate it (unboxed, if the elements are known to be numbers)
+    ks_size_t n = 0;
+    if (objs->type == ks_T_list) n = ((ks_list)objs)->len;
+    else if (objs->type == ks_T_tuple) n = ((ks_tuple)objs)->len;
+    else if (objs->type == ks_T_range) {
+        int64_t start, step;
+        if (!ks_range_get_c((ks_range)objs, &start, &step, &n)) n = 0;
     }
 
-    ks_citer_done(&cit);
-
-    // check error status
-    if (cit.threwErr) {
+    ks_list ret = list_new_kind(list_kindof_seq(objs, n));
+    if (!ks_list_pushall(ret, objs)) {
         KS_DECREF(ret);
         return NULL;
-    } else {
-        return (ks_obj)ret;
     }
 
+    list_unbox(ret);
+    return (ks_obj)ret;
 }
 
 
@@ -233,15 +771,12 @@ static KS_TFUNC(list, free) {
     ks_list self;
     KS_GETARGS("self:*", &self, ks_T_list)
 
-    ks_size_t i;
-
     // free references held to entries
-    for (i = 0; i < self->len; ++i) {
-        KS_DECREF(self->elems[i]);
-    }
+    ks_list_clear(self);
 
     // free allocated space
     ks_free(self->elems);
+    ks_free(self->raw.v64);
 
     KS_UNINIT_OBJ(self);
     KS_FREE_OBJ(self);
@@ -268,10 +803,12 @@ static KS_TFUNC(list, str) {
 
     ks_str_builder_add(sb, "[", 1);
 
-    // free references held to entries
+    // add each element (which may be a temporary object, if 'self' is unboxed)
     for (i = 0; i < self->len; ++i) {
         if (i > 0) ks_str_builder_add(sb, ", ", 2);
-        ks_str_builder_add_repr(sb, self->elems[i]);
+        ks_obj ob = ks_list_get(self, i);
+        ks_str_builder_add_repr(sb, ob);
+        KS_DECREF(ob);
     }
 
     ks_str_builder_add(sb, "]", 1);
@@ -289,6 +826,10 @@ static KS_TFUNC(list, push) {
     KS_GETARGS("self:* obj", &self, ks_T_list, &obj)
 
     ks_list_push(self, obj);
+
+    // lists of numbers built up by scripts become unboxed once they are long enough
+    if (self->len == KS_LIST_UNBOX_MIN) list_unbox(self);
+
     return KSO_NONE;
 }
 
@@ -303,6 +844,20 @@ static KS_TFUNC(list, pop) {
     return ks_list_pop(self);
 }
 
+// list.sort(self, key=none, reverse=false) - sort the list in place (stably), by 'key(elem)' if 'key' is given
+static KS_TFUNC(list, sort) {
+    ks_list self;
+    ks_obj key = KSO_NONE, reverse = KSO_FALSE;
+    KS_GETARGS("self:* ?key ?reverse", &self, ks_T_list, &key, &reverse)
+
+    int rev = ks_obj_truthy(reverse);
+    if (rev < 0) return NULL;
+
+    if (!ks_list_sort(self, key, rev == 1)) return NULL;
+
+    return KSO_NONE;
+}
+
 // list.__getitem__(self, idx) - get the item in a list
 static KS_TFUNC(list, getitem) {
     ks_list self;
@@ -319,7 +874,7 @@ static KS_TFUNC(list, getitem) {
         if (v64 < 0 || v64 >= self->len) KS_THROW_INDEX_ERR(self, idx);
 
         // return the item specified
-        return KS_NEWREF(self->elems[v64]);
+        return ks_list_get(self, v64);
     } else {
         ks_catch_ignore();
     }
@@ -332,11 +887,17 @@ static KS_TFUNC(list, getitem) {
         if (!ks_slice_getci((ks_slice)idx, self->len, &first, &last, &delta)) return NULL;
 
         int64_t i;
-        ks_list res = ks_list_new(0, NULL);
+        ks_list res = list_new_kind(self->kind);
 
-        // add appropriate elements
+        // add appropriate elements (an unboxed list gives an unboxed slice)
         for (i = first; i != last; i += delta) {
-            ks_list_push(res, self->elems[i]);
+            if (self->kind == KS_LIST_KIND_OBJ) {
+                ks_list_push(res, self->elems[i]);
+            } else {
+                list_reserve(res, res->len + 1);
+                // (the bits are copied the same way for either kind)
+                res->raw.v64[res->len++] = self->raw.v64[i];
+            }
         }
 
         return (ks_obj)res;
@@ -346,6 +907,21 @@ static KS_TFUNC(list, getitem) {
     }
 }
 
+// set 'self[idx] = val', boxing 'self' if 'val' can't be stored unboxed in it
+static void list_set(ks_list self, ks_size_t idx, ks_obj val) {
+    if (self->kind != KS_LIST_KIND_OBJ && list_kindof(val) != self->kind) ks_list_box(self);
+
+    if (self->kind == KS_LIST_KIND_INT64) {
+        self->raw.v64[idx] = ((ks_int)val)->v64;
+    } else if (self->kind == KS_LIST_KIND_FLOAT) {
+        self->raw.vf[idx] = ((ks_float)val)->val;
+    } else {
+        KS_INCREF(val);
+        KS_DECREF(self->elems[idx]);
+        self->elems[idx] = val;
+    }
+}
+
 // list.__setitem__(self, idx, val) - set items in list
 static KS_TFUNC(list, setitem) {
     ks_list self;
@@ -363,9 +939,7 @@ static KS_TFUNC(list, setitem) {
 
 
         // swap it out
-        KS_INCREF(val);
-        KS_DECREF(self->elems[v64]);
-        self->elems[v64] = val;
+        list_set(self, v64, val);
 
         // return new reference
         KS_INCREF(val);
@@ -396,9 +970,7 @@ static KS_TFUNC(list, setitem) {
                 // strided assign
 
                 // swap out at this index
-                KS_INCREF(ob);
-                KS_DECREF(self->elems[i]);
-                self->elems[i] = ob;
+                list_set(self, i, ob);
                 ct++;
 
                 // prepare for next loop
@@ -422,9 +994,7 @@ static KS_TFUNC(list, setitem) {
             // copied assign
             // add appropriate elements
             for (i = first; i != last; i += delta) {
-                KS_INCREF(val);
-                KS_DECREF(self->elems[i]);
-                self->elems[i] = val;
+                list_set(self, i, val);
             }
 
             return KSO_NONE;
@@ -435,30 +1005,45 @@ static KS_TFUNC(list, setitem) {
     }
 }
 
+// compare two lists element-wise
+// NOTE: Returns 1 if they are equal, 0 if not, or -1 and throws an error
+static int list_eq(ks_list L, ks_list R) {
+    if (L->len != R->len) return 0;
+
+    ks_size_t i;
+    if (L->kind == KS_LIST_KIND_INT64 && R->kind == KS_LIST_KIND_INT64) {
+        for (i = 0; i < L->len; ++i) if (L->raw.v64[i] != R->raw.v64[i]) return 0;
+        return 1;
+    } else if (L->kind == KS_LIST_KIND_FLOAT && R->kind == KS_LIST_KIND_FLOAT) {
+        for (i = 0; i < L->len; ++i) if (L->raw.vf[i] != R->raw.vf[i]) return 0;
+        return 1;
+    }
+
+    // NOTE: `==` may modify the lists, so check the lengths each time
+    for (i = 0; i < L->len && i < R->len; ++i) {
+        ks_obj a = ks_list_get(L, i), b = ks_list_get(R, i);
+        ks_obj lreq = ks_F_eq->func(2, (ks_obj[]){ a, b });
+        KS_DECREF(a);
+        KS_DECREF(b);
+        if (!lreq) return -1;
+        int truthy = ks_obj_truthy(lreq);
+        KS_DECREF(lreq);
+        if (truthy <= 0) return truthy;
+    }
+
+    // all were equal
+    return L->len == R->len;
+}
+
 // list.__eq__(L, R) - check if all elements are equal
 static KS_TFUNC(list, eq) {
     ks_obj L, R;
     KS_GETARGS("L R", &L, &R);
 
     if (L->type == ks_T_list && R->type == ks_T_list) {
-        
-        ks_list lL = (ks_list)L, lR = (ks_list)R;
-        if (lL->len != lR->len) return KSO_FALSE;
-
-        int i;
-        for (i = 0; i < lL->len; ++i) {
-            ks_obj lreq = ks_F_eq->func(2, (ks_obj[]){ lL->elems[i], lR->elems[i] });
-            if (!lreq) return NULL;
-            int truthy = ks_obj_truthy(lreq);
-            KS_DECREF(lreq);
-            if (truthy < 0) return NULL;
-            if (!truthy) return KSO_FALSE;
-
-        }
-
-        // all were equal
-        return KSO_TRUE;
-
+        int res = list_eq((ks_list)L, (ks_list)R);
+        if (res < 0) return NULL;
+        return KSO_BOOL(res == 1);
     }
 
     KS_THROW_BOP_ERR("==", L, R);
@@ -471,24 +1056,9 @@ static KS_TFUNC(list, ne) {
     KS_GETARGS("L R", &L, &R);
 
     if (L->type == ks_T_list && R->type == ks_T_list) {
-        
-        ks_list lL = (ks_list)L, lR = (ks_list)R;
-        if (lL->len != lR->len) return KSO_TRUE;
-
-        int i;
-        for (i = 0; i < lL->len; ++i) {
-            ks_obj lreq = ks_F_eq->func(2, (ks_obj[]){ lL->elems[i], lR->elems[i] });
-            if (!lreq) return NULL;
-            int truthy = ks_obj_truthy(lreq);
-            KS_DECREF(lreq);
-            if (truthy < 0) return NULL;
-            if (!truthy) return KSO_TRUE;
-
-        }
-
-        // all were equal
-        return KSO_FALSE;
-
+        int res = list_eq((ks_list)L, (ks_list)R);
+        if (res < 0) return NULL;
+        return KSO_BOOL(res == 0);
     }
 
     KS_THROW_BOP_ERR("==", L, R);
@@ -501,8 +1071,8 @@ static KS_TFUNC(list, add) {
 
     if (ks_obj_is_iterable(L) && ks_obj_is_iterable(R)) {
 
-        // result list
-        ks_list res = ks_list_new(0, NULL);
+        // result list (which starts out unboxed if 'L' is, and stays that way if 'R' has the same kind of numbers)
+        ks_list res = list_new_kind(L->type == ks_T_list ? ((ks_list)L)->kind : KS_LIST_KIND_OBJ);
 
         // try adding them
         if (!ks_list_pushall(res, L)) {
@@ -514,6 +1084,7 @@ static KS_TFUNC(list, add) {
             return NULL;
         }
 
+        list_unbox(res);
         return (ks_obj)res;
 
     }
@@ -521,6 +1092,28 @@ static KS_TFUNC(list, add) {
     KS_THROW_BOP_ERR("+", L, R);
 }
 
+// return 'objs' repeated 'times' times, as a list
+static ks_list list_repeat(ks_obj objs, int64_t times) {
+    ks_size_t n = 0;
+    if (objs->type == ks_T_list) n = ((ks_list)objs)->len;
+    else if (objs->type == ks_T_tuple) n = ((ks_tuple)objs)->len;
+
+    // result list (so `[0.0] * n` is unboxed from the start)
+    ks_list res = list_new_kind(list_kindof_seq(objs, times > 0 ? n * times : 0));
+
+    // now, add copies
+    int64_t i;
+    for (i = 0; i < times; ++i) {
+        // try adding them
+        if (!ks_list_pushall(res, objs)) {
+            KS_DECREF(res);
+            return NULL;
+        }
+    }
+
+    return res;
+}
+
 // list.__mul__(L, R)
 static KS_TFUNC(list, mul) {
     ks_obj L, R;
@@ -535,21 +1128,7 @@ static KS_TFUNC(list, mul) {
             return NULL;
         }
 
-        // result list
-        ks_list res = ks_list_new(0, NULL);
-
-
-        // now, add copies
-        ks_size_t i;
-        for (i = 0; i < times; ++i) {
-            // try adding them
-            if (!ks_list_pushall(res, L)) {
-                KS_DECREF(res);
-                return NULL;
-            }
-        }
-
-        return (ks_obj)res;
+        return (ks_obj)list_repeat(L, times);
 
     } else if (ks_num_is_integral(L) && ks_num_is_numeric(R)) {
         
@@ -559,21 +1138,7 @@ static KS_TFUNC(list, mul) {
             return NULL;
         }
 
-        // result list
-        ks_list res = ks_list_new(0, NULL);
-
-
-        // now, add copies
-        ks_size_t i;
-        for (i = 0; i < times; ++i) {
-            // try adding them
-            if (!ks_list_pushall(res, R)) {
-                KS_DECREF(res);
-                return NULL;
-            }
-        }
-
-        return (ks_obj)res;
+        return (ks_obj)list_repeat(R, times);
     }
 
     KS_THROW_BOP_ERR("*", L, R);
@@ -623,8 +1188,7 @@ static KS_TFUNC(list_iter, next) {
 
 
     // get next element
-    ks_obj ret = self->self->elems[self->pos++];
-    return KS_NEWREF(ret);
+    return ks_list_get(self->self, self->pos++);
 }
 
 // list.__iter__(self) - return iterator
@@ -672,6 +1236,7 @@ void ks_init_T_list() {
 
         {"push",                   (ks_obj)ks_cfunc_new_c_old(list_push_, "list.push(self, obj)")},
         {"pop",                    (ks_obj)ks_cfunc_new_c_old(list_pop_, "list.pop(self)")},
+        {"sort",                   (ks_obj)ks_cfunc_new_c_old(list_sort_, "list.sort(self, key=none, reverse=false)")},
 
     ));
     ks_type_init_c(ks_T_list_iter, "list_iter", ks_T_object, KS_KEYVALS(
@@ -108,7 +108,7 @@ static KS_TFUNC(logger, new) {
     ks_str name;
     KS_GETARGS("name:*", &name, ks_T_str)
 
-    return (ks_obj)ks_logger_get(name->chr, true);
+    return (ks_obj)ks_logger_get(ks_str_cstr(name), true);
 }
 
 
@@ -182,7 +182,7 @@ static KS_TFUNC(logger, error) {
     int line = -1;
     ks_thread_getloc(ks_thread_get(), &fname, &line);
 
-    my_log(KS_LOG_ERROR, fname ? fname->chr : NULL, line, self, "%A", n_extra, extra);
+    my_log(KS_LOG_ERROR, fname ? ks_str_cstr(fname) : NULL, line, self, "%A", n_extra, extra);
 
     return KSO_NONE;
 }
@@ -198,7 +198,7 @@ static KS_TFUNC(logger, warn) {
     int line = -1;
     ks_thread_getloc(ks_thread_get(), &fname, &line);
 
-    my_log(KS_LOG_WARN, fname ? fname->chr : NULL, line, self, "%A", n_extra, extra);
+    my_log(KS_LOG_WARN, fname ? ks_str_cstr(fname) : NULL, line, self, "%A", n_extra, extra);
 
     return KSO_NONE;
 }
@@ -214,7 +214,7 @@ static KS_TFUNC(logger, info) {
     int line = -1;
     ks_thread_getloc(ks_thread_get(), &fname, &line);
 
-    my_log(KS_LOG_INFO, fname ? fname->chr : NULL, line, self, "%A", n_extra, extra);
+    my_log(KS_LOG_INFO, fname ? ks_str_cstr(fname) : NULL, line, self, "%A", n_extra, extra);
 
     return KSO_NONE;
 }
@@ -230,7 +230,7 @@ static KS_TFUNC(logger, debug) {
     int line = -1;
     ks_thread_getloc(ks_thread_get(), &fname, &line);
 
-    my_log(KS_LOG_DEBUG, fname ? fname->chr : NULL, line, self, "%A", n_extra, extra);
+    my_log(KS_LOG_DEBUG, fname ? ks_str_cstr(fname) : NULL, line, self, "%A", n_extra, extra);
 
     return KSO_NONE;
 }
@@ -246,7 +246,7 @@ static KS_TFUNC(logger, trace) {
     int line = -1;
     ks_thread_getloc(ks_thread_get(), &fname, &line);
 
-    my_log(KS_LOG_TRACE, fname ? fname->chr : NULL, line, self, "%A", n_extra, extra);
+    my_log(KS_LOG_TRACE, fname ? ks_str_cstr(fname) : NULL, line, self, "%A", n_extra, extra);
 
     return KSO_NONE;
 }
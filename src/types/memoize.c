@@ -0,0 +1,290 @@
+/* memoize.c - implementation of the 'memoize' type, which caches the results of a function
+ *
+ * Results are stored in a hash table keyed by the arguments (hashed with `ks_obj_hash()`, and compared with
+ *   `ks_obj_eq()`), and each entry is also in a doubly linked list ordered by how recently it was used. So, a
+ *   hit is a hash lookup plus moving the entry to the front, and once there are more than 'max_len' results, the
+ *   entry at the back is the one that is evicted
+ *
+ * The wrapped function is only called (through `ks_obj_call()`) on a miss
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+#include "ks-impl.h"
+
+
+/* Tuning/Performance parameters */
+
+// smallest number of buckets allocated
+#define KS_MEMOIZE_MIN_BUCKETS 16
+
+
+typedef struct ks_memoize_entry ks_memoize_entry;
+
+// Construct a new memoized function
+ks_memoize ks_memoize_new(ks_obj func, ks_ssize_t max_len) {
+    ks_memoize self = KS_ALLOC_OBJ(ks_memoize);
+    KS_INIT_OBJ(self, ks_T_memoize);
+
+    self->func = KS_NEWREF(func);
+    self->max_len = max_len;
+
+    self->len = 0;
+    self->n_buckets = KS_MEMOIZE_MIN_BUCKETS;
+    self->buckets = ks_malloc(sizeof(*self->buckets) * self->n_buckets);
+    memset(self->buckets, 0, sizeof(*self->buckets) * self->n_buckets);
+
+    self->first = self->last = NULL;
+
+    self->hits = self->misses = 0;
+
+    return self;
+}
+
+// remove 'ent' from the recently-used list
+static void memoize_unlink(ks_memoize self, ks_memoize_entry* ent) {
+    if (ent->prev) ent->prev->next = ent->next;
+    else self->first = ent->next;
+
+    if (ent->next) ent->next->prev = ent->prev;
+    else self->last = ent->prev;
+}
+
+// add 'ent' to the front of the recently-used list
+static void memoize_link(ks_memoize self, ks_memoize_entry* ent) {
+    ent->prev = NULL;
+    ent->next = self->first;
+
+    if (self->first) self->first->prev = ent;
+    else self->last = ent;
+
+    self->first = ent;
+}
+
+// find the entry for 'key', or return NULL if there is none
+static ks_memoize_entry* memoize_find(ks_memoize self, ks_obj key, ks_hash_t hash) {
+    ks_memoize_entry* ent = self->buckets[hash & (self->n_buckets - 1)];
+    while (ent) {
+        if (ent->hash == hash && (ent->key == key || ks_obj_eq(ent->key, key))) return ent;
+        ent = ent->next_b;
+    }
+    return NULL;
+}
+
+// remove (and free) the least recently used entry
+static void memoize_evict(ks_memoize self) {
+    ks_memoize_entry* ent = self->last;
+
+    // remove from its bucket
+    ks_memoize_entry** pp = &self->buckets[ent->hash & (self->n_buckets - 1)];
+    while (*pp != ent) pp = &(*pp)->next_b;
+    *pp = ent->next_b;
+
+    memoize_unlink(self, ent);
+    self->len--;
+
+    KS_DECREF(ent->key);
+    KS_DECREF(ent->val);
+    ks_free(ent);
+}
+
+// double the number of buckets, and redistribute the entries
+static void memoize_grow(ks_memoize self) {
+    ks_size_t n_buckets = 2 * self->n_buckets;
+    ks_memoize_entry** buckets = ks_malloc(sizeof(*buckets) * n_buckets);
+    memset(buckets, 0, sizeof(*buckets) * n_buckets);
+
+    ks_memoize_entry* ent;
+    for (ent = self->first; ent != NULL; ent = ent->next) {
+        ks_size_t b = ent->hash & (n_buckets - 1);
+        ent->next_b = buckets[b];
+        buckets[b] = ent;
+    }
+
+    ks_free(self->buckets);
+    self->buckets = buckets;
+    self->n_buckets = n_buckets;
+}
+
+ks_obj ks_memoize_call(ks_memoize self, int n_args, ks_obj* args) {
+    if (self->max_len == 0) {
+        self->misses++;
+        return ks_obj_call(self->func, n_args, args);
+    }
+
+    // a single argument is used as the key directly, to avoid creating a tuple (unless it is a tuple itself, which
+    //   would be the same key as calling with its elements)
+    ks_obj key = n_args == 1 && args[0]->type != ks_T_tuple ? KS_NEWREF(args[0]) : (ks_obj)ks_tuple_new(n_args, args);
+
+    ks_hash_t hash;
+    if (!ks_obj_hash(key, &hash)) {
+        KS_DECREF(key);
+        return NULL;
+    }
+
+    ks_memoize_entry* ent = memoize_find(self, key, hash);
+    if (ent) {
+        self->hits++;
+        KS_DECREF(key);
+        if (ent != self->first) {
+            memoize_unlink(self, ent);
+            memoize_link(self, ent);
+        }
+        return KS_NEWREF(ent->val);
+    }
+
+    self->misses++;
+    ks_obj val = ks_obj_call(self->func, n_args, args);
+    if (!val) {
+        KS_DECREF(key);
+        return NULL;
+    }
+
+    // the call may have been recursive (and stored the same key), so check again
+    ent = memoize_find(self, key, hash);
+    if (ent) {
+        KS_DECREF(key);
+        KS_DECREF(ent->val);
+        ent->val = KS_NEWREF(val);
+        if (ent != self->first) {
+            memoize_unlink(self, ent);
+            memoize_link(self, ent);
+        }
+        return val;
+    }
+
+    if (self->len >= self->n_buckets) memoize_grow(self);
+
+    ent = ks_malloc(sizeof(*ent));
+    ent->key = key;
+    ent->hash = hash;
+    ent->val = KS_NEWREF(val);
+
+    ks_size_t b = hash & (self->n_buckets - 1);
+    ent->next_b = self->buckets[b];
+    self->buckets[b] = ent;
+
+    memoize_link(self, ent);
+    self->len++;
+
+    while (self->max_len > 0 && self->len > self->max_len) memoize_evict(self);
+
+    return val;
+}
+
+void ks_memoize_clear(ks_memoize self) {
+    while (self->len > 0) memoize_evict(self);
+}
+
+
+// memoize.__new__(func, maxsize=none) - create a new memoized function, which keeps at most 'maxsize' results
+static KS_TFUNC(memoize, new) {
+    ks_obj func, maxsize = KSO_NONE;
+    KS_GETARGS("func ?maxsize", &func, &maxsize)
+
+    int64_t max_len = -1;
+    if (maxsize != KSO_NONE) {
+        if (!ks_num_get_int64(maxsize, &max_len)) return NULL;
+        if (max_len < 0) return ks_throw(ks_T_ArgError, "'maxsize' must be non-negative (or none, for no limit)");
+    }
+
+    return (ks_obj)ks_memoize_new(func, max_len);
+}
+
+// memoize.__free__(self) - free obj
+static KS_TFUNC(memoize, free) {
+    ks_memoize self;
+    KS_GETARGS("self:*", &self, ks_T_memoize)
+
+    ks_memoize_clear(self);
+    ks_free(self->buckets);
+    KS_DECREF(self->func);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// memoize.__str__(self) - to string
+static KS_TFUNC(memoize, str) {
+    ks_memoize self;
+    KS_GETARGS("self:*", &self, ks_T_memoize)
+
+    return (ks_obj)ks_fmt_c("memoize(%R, hits=%l, misses=%l)", self->func, self->hits, self->misses);
+}
+
+// memoize.__call__(self, *args) - call the function, or return the cached result
+static KS_TFUNC(memoize, call) {
+    ks_memoize self;
+    int n_extra;
+    ks_obj* extra;
+    KS_GETARGS("self:* *args", &self, ks_T_memoize, &n_extra, &extra)
+
+    return ks_memoize_call(self, n_extra, extra);
+}
+
+// memoize.__getattr__(self, attr) - get an attribute
+static KS_TFUNC(memoize, getattr) {
+    ks_memoize self;
+    ks_str attr;
+    KS_GETARGS("self:* attr:*", &self, ks_T_memoize, &attr, ks_T_str)
+
+    if (ks_str_eq_c(attr, "hits", 4)) {
+        return (ks_obj)ks_int_new(self->hits);
+    } else if (ks_str_eq_c(attr, "misses", 6)) {
+        return (ks_obj)ks_int_new(self->misses);
+    } else if (ks_str_eq_c(attr, "func", 4)) {
+        return KS_NEWREF(self->func);
+    }
+
+    // otherwise, look up methods (i.e. 'clear')
+    ks_obj ret = ks_type_get(ks_T_memoize, attr);
+    if (!ret) KS_THROW_ATTR_ERR(self, attr);
+
+    if (ks_obj_is_callable(ret)) {
+        ks_obj mem = (ks_obj)ks_pfunc_new(ret, (ks_obj)self);
+        KS_DECREF(ret);
+        return mem;
+    }
+
+    return ret;
+}
+
+// memoize.__len__(self) - number of cached results
+static KS_TFUNC(memoize, len) {
+    ks_memoize self;
+    KS_GETARGS("self:*", &self, ks_T_memoize)
+
+    return (ks_obj)ks_int_new(self->len);
+}
+
+// memoize.clear(self) - remove all cached results (and reset 'hits' and 'misses')
+static KS_TFUNC(memoize, clear) {
+    ks_memoize self;
+    KS_GETARGS("self:*", &self, ks_T_memoize)
+
+    ks_memoize_clear(self);
+    self->hits = self->misses = 0;
+
+    return KSO_NONE;
+}
+
+
+/* export */
+
+KS_TYPE_DECLFWD(ks_T_memoize);
+
+void ks_init_T_memoize() {
+    ks_type_init_c(ks_T_memoize, "memoize", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(memoize_new_, "memoize.__new__(func, maxsize=none)")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(memoize_free_, "memoize.__free__(self)")},
+        {"__str__",                (ks_obj)ks_cfunc_new_c_old(memoize_str_, "memoize.__str__(self)")},
+        {"__repr__",               (ks_obj)ks_cfunc_new_c_old(memoize_str_, "memoize.__repr__(self)")},
+        {"__call__",               (ks_obj)ks_cfunc_new_c_old(memoize_call_, "memoize.__call__(self, *args)")},
+        {"__getattr__",            (ks_obj)ks_cfunc_new_c_old(memoize_getattr_, "memoize.__getattr__(self, attr)")},
+        {"__len__",                (ks_obj)ks_cfunc_new_c_old(memoize_len_, "memoize.__len__(self)")},
+
+        {"clear",                  (ks_obj)ks_cfunc_new_c_old(memoize_clear_, "memoize.clear(self)")},
+    ));
+}
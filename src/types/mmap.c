@@ -0,0 +1,289 @@
+/* mmap.c - implementation of the 'mmap' type, which maps a file into memory
+ *
+ * The contents are not copied into the heap; the OS pages them in as they are used. They are exposed through the
+ *   buffer protocol, so anything that reads a buffer (`nx.array`, `ios.write()`, `bytearray.extend()`, ...) can use
+ *   the file directly. Consumers that need a writable buffer (like `nx.view`, since nx arrays are always writable)
+ *   require mode 'r+' or 'c' (copy-on-write, for a private view of the file), and throw an error for mode 'r'
+ *
+ * Since consumers hold a reference through `ks_buffer_get()`, and the mapping is only removed in `__free__`, they
+ *   never see the memory go away
+ *
+ * @author: Cade Brown <brown.cade@gmail.com>
+ */
+
+// for 'posix_madvise()', which is newer than the POSIX version requested in 'ks-config.h'
+#define _DEFAULT_SOURCE
+
+#include "ks-impl.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+// Map a file into memory
+ks_mmap ks_mmap_new(ks_str fname, ks_str mode) {
+    bool readonly = false, isCopy = false;
+    if (ks_str_eq_c(mode, "r", 1) || ks_str_eq_c(mode, "rb", 2)) {
+        readonly = true;
+    } else if (ks_str_eq_c(mode, "r+", 2) || ks_str_eq_c(mode, "rb+", 3) || ks_str_eq_c(mode, "r+b", 3)) {
+        readonly = false;
+    } else if (ks_str_eq_c(mode, "c", 1)) {
+        isCopy = true;
+    } else {
+        return ks_throw(ks_T_ArgError, "Invalid mode %R for 'mmap' (expected 'r', 'r+' or 'c')", mode);
+    }
+
+    // copy-on-write mappings never write to the file, so it only needs to be readable
+    int fd = open(ks_str_cstr(fname), (readonly || isCopy) ? O_RDONLY : O_RDWR);
+    if (fd < 0) return ks_throw(ks_T_IOError, "Failed to open '%S': %s", fname, strerror(errno));
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return ks_throw(ks_T_IOError, "Failed to get the size of '%S': %s", fname, strerror(errno));
+    }
+
+    // empty files can't be mapped, but they don't need to be
+    void* data = NULL;
+    if (st.st_size > 0) {
+        data = mmap(NULL, st.st_size, readonly ? PROT_READ : (PROT_READ | PROT_WRITE), (readonly || isCopy) ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return ks_throw(ks_T_IOError, "Failed to map '%S': %s", fname, strerror(errno));
+        }
+    }
+
+    // the mapping keeps the file open
+    close(fd);
+
+    ks_mmap self = KS_ALLOC_OBJ(ks_mmap);
+    KS_INIT_OBJ(self, ks_T_mmap);
+
+    self->name = (ks_str)KS_NEWREF(fname);
+    self->mode = (ks_str)KS_NEWREF(mode);
+    self->data = data;
+    self->len_b = st.st_size;
+    self->readonly = readonly;
+    self->isCopy = isCopy;
+
+    return self;
+}
+
+// convert 'idx' into a position in 'self'
+static bool mmap_getidx(ks_mmap self, ks_obj idx, ks_size_t* out) {
+    int64_t v64;
+    if (!ks_num_get_int64(idx, &v64)) return false;
+    if (v64 < 0) v64 += self->len_b;
+    if (v64 < 0 || v64 >= self->len_b) {
+        ks_throw(ks_T_KeyError, "'%T' object given invalid index: '%S'", self, idx);
+        return false;
+    }
+
+    *out = v64;
+    return true;
+}
+
+
+// mmap.__new__(fname, mode='r') - map a file into memory (see `ks_mmap_new()` for the modes)
+static KS_TFUNC(mmap, new) {
+    ks_str fname, mode = NULL;
+    KS_GETARGS("fname:* ?mode:*", &fname, ks_T_str, &mode, ks_T_str)
+
+    if (!mode) mode = ks_str_new("r");
+    else KS_INCREF(mode);
+
+    ks_mmap ret = ks_mmap_new(fname, mode);
+    KS_DECREF(mode);
+    return (ks_obj)ret;
+}
+
+// mmap.__free__(self) - free obj
+static KS_TFUNC(mmap, free) {
+    ks_mmap self;
+    KS_GETARGS("self:*", &self, ks_T_mmap)
+
+    if (self->data) munmap(self->data, self->len_b);
+
+    KS_DECREF(self->name);
+    KS_DECREF(self->mode);
+
+    KS_UNINIT_OBJ(self);
+    KS_FREE_OBJ(self);
+
+    return KSO_NONE;
+}
+
+// mmap.__str__(self) - to string
+static KS_TFUNC(mmap, str) {
+    ks_mmap self;
+    KS_GETARGS("self:*", &self, ks_T_mmap)
+
+    return (ks_obj)ks_fmt_c("<mmap name=%R, mode=%R, len=%l>", self->name, self->mode, (int64_t)self->len_b);
+}
+
+// mmap.__len__(self) - number of bytes
+static KS_TFUNC(mmap, len) {
+    ks_mmap self;
+    KS_GETARGS("self:*", &self, ks_T_mmap)
+
+    return (ks_obj)ks_int_new(self->len_b);
+}
+
+// mmap.__getitem__(self, idx) - get a byte value, or a slice as 'bytes'
+static KS_TFUNC(mmap, getitem) {
+    ks_mmap self;
+    ks_obj idx;
+    KS_GETARGS("self:* idx", &self, ks_T_mmap, &idx)
+
+    if (idx->type == ks_T_slice) {
+        int64_t first, last, delta;
+        if (!ks_slice_getci((ks_slice)idx, self->len_b, &first, &last, &delta)) return NULL;
+
+        // contiguous slices are copied straight out of the mapping
+        if (delta == 1) return (ks_obj)ks_bytes_new(self->data + first, last - first);
+
+        ks_ssize_t n = (last - first) / delta;
+        uint8_t* tmp = ks_malloc(n > 0 ? n : 1);
+
+        int64_t i, ct = 0;
+        for (i = first; i != last; i += delta, ct++) {
+            tmp[ct] = self->data[i];
+        }
+
+        ks_bytes ret = ks_bytes_new(tmp, n);
+        ks_free(tmp);
+        return (ks_obj)ret;
+    }
+
+    ks_size_t i;
+    if (!mmap_getidx(self, idx, &i)) return NULL;
+
+    return (ks_obj)ks_int_new(self->data[i]);
+}
+
+// mmap.__setitem__(self, idx, val) - set a byte value (only for writable mappings)
+static KS_TFUNC(mmap, setitem) {
+    ks_mmap self;
+    ks_obj idx, val;
+    KS_GETARGS("self:* idx val", &self, ks_T_mmap, &idx, &val)
+
+    if (self->readonly) return ks_throw(ks_T_TypeError, "Cannot modify read-only 'mmap' of %R", self->name);
+
+    ks_size_t i;
+    if (!mmap_getidx(self, idx, &i)) return NULL;
+
+    int64_t v64;
+    if (!ks_num_get_int64(val, &v64)) return NULL;
+    if (v64 < 0 || v64 > 255) return ks_throw(ks_T_ArgError, "Byte value must be in range(256) (got %l)", v64);
+
+    self->data[i] = v64;
+
+    return KSO_NONE;
+}
+
+// mmap.__hash__(self) - hash of the contents (only for read-only mappings, which can't change)
+static KS_TFUNC(mmap, hash) {
+    ks_mmap self;
+    KS_GETARGS("self:*", &self, ks_T_mmap)
+
+    if (!self->readonly) return ks_throw(ks_T_TypeError, "Writable 'mmap' objects are not hashable");
+
+    return (ks_obj)ks_int_new(ks_hash_bytes(self->data, self->len_b));
+}
+
+// mmap.decode(self, start=0, stop=none) - decode the bytes [start, stop) as UTF-8, into a 'str'
+static KS_TFUNC(mmap, decode) {
+    ks_mmap self;
+    int64_t start = 0;
+    ks_obj stop = KSO_NONE;
+    KS_GETARGS("self:* ?start:i64 ?stop", &self, ks_T_mmap, &start, &stop)
+
+    int64_t end = self->len_b;
+    if (stop != KSO_NONE && !ks_num_get_int64(stop, &end)) return NULL;
+
+    if (start < 0) start += self->len_b;
+    if (end < 0) end += self->len_b;
+    if (start < 0 || start > self->len_b || end < start || end > self->len_b) {
+        return ks_throw(ks_T_ArgError, "Invalid range [%l, %l) for 'mmap' of %l bytes", start, end, (int64_t)self->len_b);
+    }
+
+    const char* src = (const char*)self->data + start;
+    if (ks_text_utf8_validate(src, end - start) < 0) {
+        return ks_throw(ks_T_ArgError, "Data in %R was not valid UTF-8", self->name);
+    }
+
+    return (ks_obj)ks_str_utf8(src, end - start);
+}
+
+// mmap.advise(self, how) - tell the OS how the memory will be used: 'normal', 'sequential', 'random',
+//   'willneed' or 'dontneed'
+static KS_TFUNC(mmap, advise) {
+    ks_mmap self;
+    ks_str how;
+    KS_GETARGS("self:* how:*", &self, ks_T_mmap, &how, ks_T_str)
+
+    int adv;
+    if (ks_str_eq_c(how, "normal", 6)) {
+        adv = POSIX_MADV_NORMAL;
+    } else if (ks_str_eq_c(how, "sequential", 10)) {
+        adv = POSIX_MADV_SEQUENTIAL;
+    } else if (ks_str_eq_c(how, "random", 6)) {
+        adv = POSIX_MADV_RANDOM;
+    } else if (ks_str_eq_c(how, "willneed", 8)) {
+        adv = POSIX_MADV_WILLNEED;
+    } else if (ks_str_eq_c(how, "dontneed", 8)) {
+        adv = POSIX_MADV_DONTNEED;
+    } else {
+        return ks_throw(ks_T_ArgError, "Unknown advice %R (expected 'normal', 'sequential', 'random', 'willneed' or 'dontneed')", how);
+    }
+
+    // NOTE: advice is only a hint, so there is nothing to do if it is rejected
+    if (self->data) posix_madvise(self->data, self->len_b, adv);
+
+    return KSO_NONE;
+}
+
+// mmap.flush(self) - write changes back to the file (which does nothing for copy-on-write mappings)
+static KS_TFUNC(mmap, flush) {
+    ks_mmap self;
+    KS_GETARGS("self:*", &self, ks_T_mmap)
+
+    if (!self->readonly && !self->isCopy && self->data && msync(self->data, self->len_b, MS_SYNC) != 0) {
+        return ks_throw(ks_T_IOError, "Failed to flush %R: %s", self->name, strerror(errno));
+    }
+
+    return KSO_NONE;
+}
+
+
+// buffer protocol: the mapped memory
+static bool mmap_getbuf(ks_obj self, ks_buffer* buf, int flags) {
+    ks_mmap m = (ks_mmap)self;
+    ks_buffer_init_bytes(buf, self, m->data, m->len_b, m->readonly);
+    return true;
+}
+
+
+/* export */
+
+KS_TYPE_DECLFWD(ks_T_mmap);
+
+void ks_init_T_mmap() {
+    ks_type_init_c(ks_T_mmap, "mmap", ks_T_object, KS_KEYVALS(
+        {"__new__",                (ks_obj)ks_cfunc_new_c_old(mmap_new_, "mmap.__new__(fname, mode='r')")},
+        {"__free__",               (ks_obj)ks_cfunc_new_c_old(mmap_free_, "mmap.__free__(self)")},
+        {"__str__",                (ks_obj)ks_cfunc_new_c_old(mmap_str_, "mmap.__str__(self)")},
+        {"__repr__",               (ks_obj)ks_cfunc_new_c_old(mmap_str_, "mmap.__repr__(self)")},
+        {"__len__",                (ks_obj)ks_cfunc_new_c_old(mmap_len_, "mmap.__len__(self)")},
+        {"__getitem__",            (ks_obj)ks_cfunc_new_c_old(mmap_getitem_, "mmap.__getitem__(self, idx)")},
+        {"__setitem__",            (ks_obj)ks_cfunc_new_c_old(mmap_setitem_, "mmap.__setitem__(self, idx, val)")},
+        {"__hash__",               (ks_obj)ks_cfunc_new_c_old(mmap_hash_, "mmap.__hash__(self)")},
+
+        {"decode",                 (ks_obj)ks_cfunc_new_c_old(mmap_decode_, "mmap.decode(self, start=0, stop=none)")},
+        {"advise",                 (ks_obj)ks_cfunc_new_c_old(mmap_advise_, "mmap.advise(self, how)")},
+        {"flush",                  (ks_obj)ks_cfunc_new_c_old(mmap_flush_, "mmap.flush(self)")},
+    ));
+
+    ks_T_mmap->getbuf = mmap_getbuf;
+}
@@ -18,7 +18,8 @@ ks_parser ks_parser_new(ks_str src_code, ks_str src_name, ks_str file_name) {
     ks_parser self = KS_ALLOC_OBJ(ks_parser);
     KS_INIT_OBJ(self, ks_T_parser);
 
-    // set specific variables
+    // set specific variables (the tokenizer relies on the source being NUL-terminated)
+    ks_str_cstr(src_code);
     self->src = src_code;
     KS_INCREF(src_code);
     self->src_name = src_name;
@@ -294,10 +295,14 @@ static bool tokenize(ks_parser self) {
                     }
                 }
 
-                // allow for an exponential
+                // allow for an exponential (which may have a sign)
                 if (c == 'p') {
                     ADV();
                     c = PEEK();
+                    if (c == '+' || c == '-') {
+                        ADV();
+                        c = PEEK();
+                    }
                 }
 
                 // read whole number part (may be empty)
@@ -442,10 +447,14 @@ static bool tokenize(ks_parser self) {
                     }
                 }
 
-                // allow eEXP
+                // allow eEXP (which may have a sign, i.e. '1e-5')
                 if (c == 'e') {
                     ADV();
                     c = PEEK();
+                    if (c == '+' || c == '-') {
+                        ADV();
+                        c = PEEK();
+                    }
                 }
 
                 // read  exponent
@@ -853,7 +862,7 @@ static bool tok_iskw(ks_parser self, ks_tok tok) {
         TOK_EQ(tok, "for") || 
         TOK_EQ(tok, "try") || TOK_EQ(tok, "catch") || TOK_EQ(tok, "throw") ||
         TOK_EQ(tok, "true") || TOK_EQ(tok, "false") ||
-        TOK_EQ(tok, "ret")
+        TOK_EQ(tok, "ret") || TOK_EQ(tok, "yield")
     ;
 }
 
@@ -2065,6 +2074,23 @@ ks_ast ks_parser_stmt(ks_parser self, enum ks_parse_flags flags) {
         return ret;
 
 
+    } else if (TOK_EQ(ctok, "yield")) {
+        // yield <expr>
+        ADV_1();
+
+        SKIP_IRR_E();
+
+        // parse out the expression being yielded
+        ks_ast expr = ks_parser_expr(self, KS_PARSE_INBRK);
+        if (!expr) goto kpps_err;
+
+        ks_ast ret = ks_ast_new_yield(expr);
+        KS_DECREF(expr);
+
+        ret->tok = ks_tok_combo(self, start_tok, expr->tok);
+
+        return ret;
+
     } else if (TOK_EQ(ctok, "throw")) {
         // throw <expr>
         ADV_1();
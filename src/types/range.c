@@ -19,6 +19,20 @@ ks_range ks_range_new(ks_int start, ks_int stop, ks_int step) {
     return self;
 }
 
+bool ks_range_get_c(ks_range self, int64_t* start, int64_t* step, ks_size_t* len) {
+    if (self->start->isLong || self->stop->isLong || self->step->isLong || self->step->v64 == 0) return false;
+
+    int64_t a = self->start->v64, b = self->stop->v64, s = self->step->v64;
+    *start = a;
+    *step = s;
+
+    // (the differences are done unsigned, since they may not fit in an int64_t)
+    /**/ if (s > 0) *len = a < b ? ((uint64_t)b - (uint64_t)a - 1) / (uint64_t)s + 1 : 0;
+    else *len = a > b ? ((uint64_t)a - (uint64_t)b - 1) / (0 - (uint64_t)s) + 1 : 0;
+
+    return true;
+}
+
 
 // range.__new__(*args) - create new range
 static KS_TFUNC(range, new) {
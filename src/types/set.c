@@ -27,6 +27,9 @@
 // When a dictionary is being resized/rehashed, this is the target load factor
 #define KS_SET_NEW_LOAD 0.15
 
+// minimum capacity (in entries) to allocate for a non-empty set
+#define KS_SET_MIN_ENTRIES 8
+
 // probe offset for index 'i'
 #define KS_SET_PROBE(i) (i)
 // quadratic probing
@@ -73,6 +76,7 @@ ks_set ks_set_new(ks_size_t len, ks_obj* elems) {
 
     // empty entries
     self->n_entries = 0;
+    self->max_n_entries = 0;
     self->entries = NULL;
 
     // empty buckets
@@ -99,12 +103,13 @@ double ks_set_load(ks_set self) {
 
 
 // resize a set to have at least `new_n_buckets` buckets
+// NOTE: this also removes any deleted entries
 static void set_resize(ks_set self, ks_size_t new_n_buckets) {
     // check if we are alreayd large enough
     if (self->n_buckets >= new_n_buckets && self->n_buckets > 0) return;
 
     // ensure its a prime
-    new_n_buckets = next_prime(new_n_buckets - 1);
+    new_n_buckets = next_prime(new_n_buckets < 3 ? 2 : new_n_buckets - 1);
 
     // loop vars
     ks_size_t i, j;
@@ -114,63 +119,81 @@ static void set_resize(ks_set self, ks_size_t new_n_buckets) {
     self->buckets = ks_realloc(self->buckets, sizeof(*self->buckets) * self->n_buckets);
     for (i = 0; i < self->n_buckets; ++i) self->buckets[i] = KS_SET_BUCKET_EMPTY;
 
+    // compact the entries, removing the ones that have been deleted
+    for (i = j = 0; i < self->n_entries; ++i) {
+        if (self->entries[i].key != NULL) self->entries[j++] = self->entries[i];
+    }
+    self->n_entries = j;
+
     // now, go through and rehash the entries
-    // NOTE: any entries that are not found will be removed
     for (i = 0; i < self->n_entries; ++i) {
-        // i'th entry
-        struct ks_set_entry* ent = &self->entries[i];
-
-        if (ent->key == NULL) {
-            // this item has been deleted; so shift all the entries down 1 and continue
-            for (j = i; j < self->n_entries - 1; ++j) {
-                self->entries[j] = self->entries[j + 1];
-            }
-
-            // retry the current i (since it has been shifted over)
-            i--;
-
-            // there is now 1 less entry
-            self->n_entries--;
-
-            continue;
-        }
-
         // bucket index (bi)
-        ks_size_t bi = ent->hash % self->n_buckets;
+        ks_size_t bi = self->entries[i].hash % self->n_buckets;
 
         // keep track of original and how many tries
         ks_size_t bi0 = bi, tries = 0;
 
-        bool found = false;
+        // find the first empty bucket, which there must be since the load factor is < 1
+        while (self->buckets[bi] != KS_SET_BUCKET_EMPTY) {
+            tries++;
+            bi = (bi0 + KS_SET_PROBE(tries)) % self->n_buckets;
+            assert (bi != bi0 && "could not resize set!");
+        }
 
-        do {
-            // get the entry index (ei), which is an index into self->entries
-            int ei = self->buckets[bi];
+        self->buckets[bi] = i;
+    }
+}
 
-            if (ei == KS_SET_BUCKET_EMPTY) {
-                // the bucket is empty, so set it to 'i' (current entry) and continue;
-                self->buckets[bi] = i;
-                found = true;
-                break;
-            }
+// ensure that a set has room for 'n' entries (including the current ones), without any other allocations
+//   or rehashing
+static void set_reserve(ks_set self, ks_size_t n) {
+    if (n > self->max_n_entries) {
+        // grow geometrically, so repeated additions are amortized O(1)
+        ks_size_t new_max = self->max_n_entries * 2;
+        if (new_max < n) new_max = n;
+        if (new_max < KS_SET_MIN_ENTRIES) new_max = KS_SET_MIN_ENTRIES;
+
+        self->max_n_entries = new_max;
+        self->entries = ks_realloc(self->entries, sizeof(*self->entries) * self->max_n_entries);
+    }
 
+    if (self->n_buckets == 0 || n > self->n_buckets * KS_SET_MAX_LOAD) set_resize(self, (ks_size_t)(n / KS_SET_NEW_LOAD) + 1);
+}
 
-            tries++;
+// insert 'key' (with precomputed hash 'hash') into a set, which is known to not contain anything equal to 'key' (for
+//   example, if 'key' came from another set, and is being checked against this one)
+// NOTE: Room must have been reserved with `set_reserve()`; this never compares keys or throws errors
+static void set_insert_new(ks_set self, ks_obj key, ks_hash_t hash) {
+    ks_size_t bi = hash % self->n_buckets;
+    ks_size_t bi0 = bi, tries = 0;
 
-            // probing function
-            bi = (bi0 + KS_SET_PROBE(tries)) % self->n_buckets;
+    // find the first bucket that is not in use
+    while (self->buckets[bi] >= 0) {
+        tries++;
+        bi = (bi0 + KS_SET_PROBE(tries)) % self->n_buckets;
+    }
+
+    ks_size_t ei = self->n_entries++;
+    self->buckets[bi] = ei;
 
-        } while (bi != bi0);
+    KS_INCREF(key);
+    self->entries[ei] = (struct ks_set_entry){ .hash = hash, .key = key };
+}
 
-        assert (found && "could not resize set!");
+// return the number of items in the set
+static ks_size_t set_len(ks_set self) {
+    ks_size_t i, ct = 0;
+    for (i = 0; i < self->n_entries; ++i) {
+        if (self->entries[i].key != NULL) ct++;
     }
+    return ct;
 }
 
 // Add 'key' to a set
 // NOTE: Returns success, or `false` and throws an error
 bool ks_set_add_h(ks_set self, ks_obj key, ks_hash_t hash) {
 
-    if (ks_set_load(self) > KS_SET_MAX_LOAD || self->n_buckets == 0) set_resize(self, (int)(self->n_entries / KS_SET_NEW_LOAD));
+    set_reserve(self, self->n_entries + 1);
 
     // bucket index (bi)
     ks_size_t bi = hash % self->n_buckets;
@@ -186,7 +209,6 @@ bool ks_set_add_h(ks_set self, ks_obj key, ks_hash_t hash) {
 
             // we have found an empty bucket before a corresponding entry, so we can safely replace it
             ei = self->n_entries++;
-            self->entries = ks_realloc(self->entries, sizeof(*self->entries) * self->n_entries);
 
             // set the bucket to the new location
             self->buckets[bi] = ei;
@@ -268,6 +290,8 @@ bool ks_set_has_h(ks_set self, ks_obj key, ks_hash_t hash) {
 
 // delete item from set
 bool ks_set_del_h(ks_set self, ks_obj key, ks_hash_t hash) {
+    if (self->n_buckets < 1) return true;
+
     // bucket index (bi)
     ks_size_t bi = hash % self->n_buckets;
 
@@ -283,6 +307,9 @@ bool ks_set_del_h(ks_set self, ks_obj key, ks_hash_t hash) {
             // already removed
             return true;
 
+        } else if (ei == KS_SET_BUCKET_DELETED) {
+            // do nothing; skip it
+
         } else if (self->entries[ei].hash == hash) {
             // possible match; the hashes match
             if (self->entries[ei].key == key || ks_obj_eq(self->entries[ei].key, key)) {
@@ -339,6 +366,172 @@ bool ks_set_has(ks_set self, ks_obj key) {
 
 
 
+/* Set Algebra */
+
+// NOTE: These all reuse the hashes stored in the entries, so no item is ever rehashed, and the results are
+//   presized so that no table is resized while they are being built
+
+
+// return a new set containing all the items in 'self'
+static ks_set set_copy(ks_set self) {
+    ks_set ret = ks_set_new(0, NULL);
+    set_reserve(ret, set_len(self));
+
+    ks_size_t i;
+    for (i = 0; i < self->n_entries; ++i) {
+        if (self->entries[i].key != NULL) set_insert_new(ret, self->entries[i].key, self->entries[i].hash);
+    }
+
+    return ret;
+}
+
+// add all the items in 'from' to 'self' (in place)
+static void set_update(ks_set self, ks_set from) {
+    set_reserve(self, self->n_entries + set_len(from));
+
+    ks_size_t i;
+    for (i = 0; i < from->n_entries; ++i) {
+        if (from->entries[i].key != NULL) ks_set_add_h(self, from->entries[i].key, from->entries[i].hash);
+    }
+}
+
+// return a new set of the items that are in both 'A' and 'B'
+static ks_set set_intersection(ks_set A, ks_set B) {
+    ks_size_t lA = set_len(A), lB = set_len(B);
+
+    // iterate over the smaller set, and look up in the larger one
+    if (lB < lA) {
+        ks_set tmp = A;
+        A = B;
+        B = tmp;
+        lA = lB;
+    }
+
+    ks_set ret = ks_set_new(0, NULL);
+    set_reserve(ret, lA);
+
+    ks_size_t i;
+    for (i = 0; i < A->n_entries; ++i) {
+        struct ks_set_entry* ent = &A->entries[i];
+        if (ent->key != NULL && ks_set_has_h(B, ent->key, ent->hash)) set_insert_new(ret, ent->key, ent->hash);
+    }
+
+    return ret;
+}
+
+// return a new set of the items that are in 'A' but not in 'B'
+static ks_set set_difference(ks_set A, ks_set B) {
+    ks_set ret = ks_set_new(0, NULL);
+    set_reserve(ret, set_len(A));
+
+    ks_size_t i;
+    for (i = 0; i < A->n_entries; ++i) {
+        struct ks_set_entry* ent = &A->entries[i];
+        if (ent->key != NULL && !ks_set_has_h(B, ent->key, ent->hash)) set_insert_new(ret, ent->key, ent->hash);
+    }
+
+    return ret;
+}
+
+// return a new set of the items that are in exactly one of 'A' and 'B'
+static ks_set set_symmetric_difference(ks_set A, ks_set B) {
+    ks_set ret = ks_set_new(0, NULL);
+    set_reserve(ret, set_len(A) + set_len(B));
+
+    ks_size_t i;
+    for (i = 0; i < A->n_entries; ++i) {
+        struct ks_set_entry* ent = &A->entries[i];
+        if (ent->key != NULL && !ks_set_has_h(B, ent->key, ent->hash)) set_insert_new(ret, ent->key, ent->hash);
+    }
+    for (i = 0; i < B->n_entries; ++i) {
+        struct ks_set_entry* ent = &B->entries[i];
+        if (ent->key != NULL && !ks_set_has_h(A, ent->key, ent->hash)) set_insert_new(ret, ent->key, ent->hash);
+    }
+
+    return ret;
+}
+
+// return whether every item in 'A' is also in 'B'
+static bool set_issubset(ks_set A, ks_set B) {
+    if (set_len(A) > set_len(B)) return false;
+
+    ks_size_t i;
+    for (i = 0; i < A->n_entries; ++i) {
+        struct ks_set_entry* ent = &A->entries[i];
+        if (ent->key != NULL && !ks_set_has_h(B, ent->key, ent->hash)) return false;
+    }
+
+    return true;
+}
+
+// return whether 'A' and 'B' have no items in common
+static bool set_isdisjoint(ks_set A, ks_set B) {
+    // iterate over the smaller set, and look up in the larger one
+    if (set_len(B) < set_len(A)) {
+        ks_set tmp = A;
+        A = B;
+        B = tmp;
+    }
+
+    ks_size_t i;
+    for (i = 0; i < A->n_entries; ++i) {
+        struct ks_set_entry* ent = &A->entries[i];
+        if (ent->key != NULL && ks_set_has_h(B, ent->key, ent->hash)) return false;
+    }
+
+    return true;
+}
+
+// replace the contents of 'self' with the contents of 'from', and consume the reference to 'from'
+static void set_assign(ks_set self, ks_set from) {
+    // swap the tables, so that 'from' holds the old contents and releases them when it is freed
+    struct ks_set_entry* entries = self->entries;
+    ks_size_t n_entries = self->n_entries, max_n_entries = self->max_n_entries;
+    ks_ssize_t* buckets = self->buckets;
+    ks_size_t n_buckets = self->n_buckets;
+
+    self->entries = from->entries;
+    self->n_entries = from->n_entries;
+    self->max_n_entries = from->max_n_entries;
+    self->buckets = from->buckets;
+    self->n_buckets = from->n_buckets;
+
+    from->entries = entries;
+    from->n_entries = n_entries;
+    from->max_n_entries = max_n_entries;
+    from->buckets = buckets;
+    from->n_buckets = n_buckets;
+
+    KS_DECREF(from);
+}
+
+// convert 'obj' to a set; sets are returned as-is, and other iterables are added to a new set
+// NOTE: Returns new reference, or NULL if an error was thrown
+static ks_set set_arg(ks_obj obj) {
+    if (obj->type == ks_T_set) return (ks_set)KS_NEWREF(obj);
+    if (!ks_obj_is_iterable(obj)) KS_THROW_TYPE_ERR(obj, ks_T_set);
+
+    ks_set ret = ks_set_new(0, NULL);
+
+    // iterate and add to set
+    struct ks_citer cit = ks_citer_make(obj);
+    ks_obj ob;
+    while ((ob = ks_citer_next(&cit)) != NULL) {
+        if (!ks_set_add(ret, ob)) cit.threwErr = true;
+        KS_DECREF(ob);
+    }
+
+    ks_citer_done(&cit);
+    if (cit.threwErr) {
+        KS_DECREF(ret);
+        return NULL;
+    }
+
+    return ret;
+}
+
+
+
 /* Object Methods */
 
 // set.__new__(objs=None) - create new set object
@@ -352,25 +545,10 @@ static KS_TFUNC(set, new) {
     } else {
         if (!ks_obj_is_iterable(objs)) return ks_throw(ks_T_ArgError, "'objs' must be iterable or 'none'");
 
-        // create new set
-        ks_set ret = ks_set_new(0, NULL);
-        // iterate and add to set
-        struct ks_citer cit = ks_citer_make(objs);
-        ks_obj ob;
-        while ((ob = ks_citer_next(&cit)) != NULL) {
-            if (!ks_set_add(ret, ob)) cit.threwErr = true;            
-            KS_DECREF(ob);
-        }
-
-        ks_citer_done(&cit);
-        if (cit.threwErr) {
-            KS_DECREF(ret);
-            return NULL;
-        }
-
-        return (ks_obj)ret;
+        // always create a new set, even if 'objs' is a set
+        if (objs->type == ks_T_set) return (ks_obj)set_copy((ks_set)objs);
+        return (ks_obj)set_arg(objs);
     }
-
 }
 
 // set.__free__(self) -> free obj
@@ -433,14 +611,337 @@ static KS_TFUNC(set, str) {
 static KS_TFUNC(set, len) {
     ks_set self;
     KS_GETARGS("self:*", &self, ks_T_set)
- 
-    // count non-null entries
-    ks_ssize_t i, ct = 0;
-    for (i = 0; i < self->n_entries; ++i) {
-        if (self->entries[i].key != NULL) ct++;
+
+    return (ks_obj)ks_int_new(set_len(self));
+}
+
+// set.add(self, obj) - add an item to the set
+static KS_TFUNC(set, add) {
+    ks_set self;
+    ks_obj obj;
+    KS_GETARGS("self:* obj", &self, ks_T_set, &obj)
+
+    if (!ks_set_add(self, obj)) return NULL;
+    return KSO_NONE;
+}
+
+// set.has(self, obj) - return whether an item is in the set
+static KS_TFUNC(set, has) {
+    ks_set self;
+    ks_obj obj;
+    KS_GETARGS("self:* obj", &self, ks_T_set, &obj)
+
+    return KSO_BOOL(ks_set_has(self, obj));
+}
+
+// set.del(self, obj) - remove an item from the set, if it is in it
+static KS_TFUNC(set, del) {
+    ks_set self;
+    ks_obj obj;
+    KS_GETARGS("self:* obj", &self, ks_T_set, &obj)
+
+    if (!ks_set_del(self, obj)) return NULL;
+    return KSO_NONE;
+}
+
+
+// set.union(self, *others) - return a new set of the items in 'self' or any of 'others'
+static KS_TFUNC(set, union) {
+    ks_set self;
+    int n_others;
+    ks_obj* others;
+    KS_GETARGS("self:* *others", &self, ks_T_set, &n_others, &others)
+
+    ks_set ret = set_copy(self);
+
+    int i;
+    for (i = 0; i < n_others; ++i) {
+        ks_set other = set_arg(others[i]);
+        if (!other) {
+            KS_DECREF(ret);
+            return NULL;
+        }
+
+        set_update(ret, other);
+        KS_DECREF(other);
+    }
+
+    return (ks_obj)ret;
+}
+
+// set.intersection(self, *others) - return a new set of the items in 'self' and all of 'others'
+static KS_TFUNC(set, intersection) {
+    ks_set self;
+    int n_others;
+    ks_obj* others;
+    KS_GETARGS("self:* *others", &self, ks_T_set, &n_others, &others)
+
+    if (n_others == 0) return (ks_obj)set_copy(self);
+
+    ks_set ret = (ks_set)KS_NEWREF(self);
+
+    int i;
+    for (i = 0; i < n_others; ++i) {
+        ks_set other = set_arg(others[i]);
+        if (!other) {
+            KS_DECREF(ret);
+            return NULL;
+        }
+
+        ks_set next = set_intersection(ret, other);
+        KS_DECREF(other);
+        KS_DECREF(ret);
+        ret = next;
+    }
+
+    return (ks_obj)ret;
+}
+
+// set.difference(self, *others) - return a new set of the items in 'self' that are not in any of 'others'
+static KS_TFUNC(set, difference) {
+    ks_set self;
+    int n_others;
+    ks_obj* others;
+    KS_GETARGS("self:* *others", &self, ks_T_set, &n_others, &others)
+
+    if (n_others == 0) return (ks_obj)set_copy(self);
+
+    ks_set ret = (ks_set)KS_NEWREF(self);
+
+    int i;
+    for (i = 0; i < n_others; ++i) {
+        ks_set other = set_arg(others[i]);
+        if (!other) {
+            KS_DECREF(ret);
+            return NULL;
+        }
+
+        ks_set next = set_difference(ret, other);
+        KS_DECREF(other);
+        KS_DECREF(ret);
+        ret = next;
     }
 
-    return (ks_obj)ks_int_new(ct);
+    return (ks_obj)ret;
+}
+
+// set.symmetric_difference(self, other) - return a new set of the items in exactly one of 'self' and 'other'
+static KS_TFUNC(set, symmetric_difference) {
+    ks_set self;
+    ks_obj other;
+    KS_GETARGS("self:* other", &self, ks_T_set, &other)
+
+    ks_set B = set_arg(other);
+    if (!B) return NULL;
+
+    ks_set ret = set_symmetric_difference(self, B);
+    KS_DECREF(B);
+
+    return (ks_obj)ret;
+}
+
+// set.issubset(self, other) - return whether every item in 'self' is in 'other'
+static KS_TFUNC(set, issubset) {
+    ks_set self;
+    ks_obj other;
+    KS_GETARGS("self:* other", &self, ks_T_set, &other)
+
+    ks_set B = set_arg(other);
+    if (!B) return NULL;
+
+    bool res = set_issubset(self, B);
+    KS_DECREF(B);
+
+    return KSO_BOOL(res);
+}
+
+// set.issuperset(self, other) - return whether every item in 'other' is in 'self'
+static KS_TFUNC(set, issuperset) {
+    ks_set self;
+    ks_obj other;
+    KS_GETARGS("self:* other", &self, ks_T_set, &other)
+
+    ks_set B = set_arg(other);
+    if (!B) return NULL;
+
+    bool res = set_issubset(B, self);
+    KS_DECREF(B);
+
+    return KSO_BOOL(res);
+}
+
+// set.isdisjoint(self, other) - return whether 'self' and 'other' have no items in common
+static KS_TFUNC(set, isdisjoint) {
+    ks_set self;
+    ks_obj other;
+    KS_GETARGS("self:* other", &self, ks_T_set, &other)
+
+    ks_set B = set_arg(other);
+    if (!B) return NULL;
+
+    bool res = set_isdisjoint(self, B);
+    KS_DECREF(B);
+
+    return KSO_BOOL(res);
+}
+
+
+// set.update(self, *others) - add the items in all of 'others' to 'self'
+static KS_TFUNC(set, update) {
+    ks_set self;
+    int n_others;
+    ks_obj* others;
+    KS_GETARGS("self:* *others", &self, ks_T_set, &n_others, &others)
+
+    int i;
+    for (i = 0; i < n_others; ++i) {
+        ks_set other = set_arg(others[i]);
+        if (!other) return NULL;
+
+        set_update(self, other);
+        KS_DECREF(other);
+    }
+
+    return KSO_NONE;
+}
+
+// set.intersection_update(self, *others) - remove the items in 'self' that are not in all of 'others'
+static KS_TFUNC(set, intersection_update) {
+    ks_set self;
+    int n_others;
+    ks_obj* others;
+    KS_GETARGS("self:* *others", &self, ks_T_set, &n_others, &others)
+
+    int i;
+    for (i = 0; i < n_others; ++i) {
+        ks_set other = set_arg(others[i]);
+        if (!other) return NULL;
+
+        set_assign(self, set_intersection(self, other));
+        KS_DECREF(other);
+    }
+
+    return KSO_NONE;
+}
+
+// set.difference_update(self, *others) - remove the items in 'self' that are in any of 'others'
+static KS_TFUNC(set, difference_update) {
+    ks_set self;
+    int n_others;
+    ks_obj* others;
+    KS_GETARGS("self:* *others", &self, ks_T_set, &n_others, &others)
+
+    int i;
+    for (i = 0; i < n_others; ++i) {
+        ks_set other = set_arg(others[i]);
+        if (!other) return NULL;
+
+        if (set_len(other) < set_len(self) && other != self) {
+            // remove the items of the smaller set one at a time
+            ks_size_t j;
+            for (j = 0; j < other->n_entries; ++j) {
+                if (other->entries[j].key != NULL) ks_set_del_h(self, other->entries[j].key, other->entries[j].hash);
+            }
+        } else {
+            // rebuild from the smaller set, which avoids leaving deleted entries behind
+            set_assign(self, set_difference(self, other));
+        }
+
+        KS_DECREF(other);
+    }
+
+    return KSO_NONE;
+}
+
+// set.symmetric_difference_update(self, other) - keep only the items in exactly one of 'self' and 'other'
+static KS_TFUNC(set, symmetric_difference_update) {
+    ks_set self;
+    ks_obj other;
+    KS_GETARGS("self:* other", &self, ks_T_set, &other)
+
+    ks_set B = set_arg(other);
+    if (!B) return NULL;
+
+    set_assign(self, set_symmetric_difference(self, B));
+    KS_DECREF(B);
+
+    return KSO_NONE;
+}
+
+
+// set.__binor__(L, R) - union of two sets
+static KS_TFUNC(set, binor) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    if (L->type == ks_T_set && R->type == ks_T_set) {
+        ks_set ret = set_copy((ks_set)L);
+        set_update(ret, (ks_set)R);
+        return (ks_obj)ret;
+    }
+
+    KS_THROW_BOP_ERR("|", L, R);
+}
+
+// set.__binand__(L, R) - intersection of two sets
+static KS_TFUNC(set, binand) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    if (L->type == ks_T_set && R->type == ks_T_set) {
+        return (ks_obj)set_intersection((ks_set)L, (ks_set)R);
+    }
+
+    KS_THROW_BOP_ERR("&", L, R);
+}
+
+// set.__sub__(L, R) - difference of two sets
+static KS_TFUNC(set, sub) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    if (L->type == ks_T_set && R->type == ks_T_set) {
+        return (ks_obj)set_difference((ks_set)L, (ks_set)R);
+    }
+
+    KS_THROW_BOP_ERR("-", L, R);
+}
+
+// set.__binxor__(L, R) - symmetric difference of two sets
+static KS_TFUNC(set, binxor) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    if (L->type == ks_T_set && R->type == ks_T_set) {
+        return (ks_obj)set_symmetric_difference((ks_set)L, (ks_set)R);
+    }
+
+    KS_THROW_BOP_ERR("^", L, R);
+}
+
+// set.__eq__(L, R) - whether two sets have the same items
+static KS_TFUNC(set, eq) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    if (L->type == ks_T_set && R->type == ks_T_set) {
+        return KSO_BOOL(set_len((ks_set)L) == set_len((ks_set)R) && set_issubset((ks_set)L, (ks_set)R));
+    }
+
+    // a set is never equal to something that isn't a set
+    return KSO_FALSE;
+}
+
+// set.__ne__(L, R) - whether two sets have different items
+static KS_TFUNC(set, ne) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R)
+
+    if (L->type == ks_T_set && R->type == ks_T_set) {
+        return KSO_BOOL(set_len((ks_set)L) != set_len((ks_set)R) || !set_issubset((ks_set)L, (ks_set)R));
+    }
+
+    return KSO_TRUE;
 }
 
 /* Iterator Type */
@@ -523,6 +1024,31 @@ void ks_init_T_set() {
 
         {"__iter__",               (ks_obj)ks_cfunc_new_c_old(set_iter_, "set.__iter__(self)")},
 
+        {"__binor__",              (ks_obj)ks_cfunc_new_c_old(set_binor_, "set.__binor__(L, R)")},
+        {"__binand__",             (ks_obj)ks_cfunc_new_c_old(set_binand_, "set.__binand__(L, R)")},
+        {"__sub__",                (ks_obj)ks_cfunc_new_c_old(set_sub_, "set.__sub__(L, R)")},
+        {"__binxor__",             (ks_obj)ks_cfunc_new_c_old(set_binxor_, "set.__binxor__(L, R)")},
+
+        {"__eq__",                 (ks_obj)ks_cfunc_new_c_old(set_eq_, "set.__eq__(L, R)")},
+        {"__ne__",                 (ks_obj)ks_cfunc_new_c_old(set_ne_, "set.__ne__(L, R)")},
+
+        {"add",                    (ks_obj)ks_cfunc_new_c_old(set_add_, "set.add(self, obj)")},
+        {"has",                    (ks_obj)ks_cfunc_new_c_old(set_has_, "set.has(self, obj)")},
+        {"del",                    (ks_obj)ks_cfunc_new_c_old(set_del_, "set.del(self, obj)")},
+
+        {"union",                  (ks_obj)ks_cfunc_new_c_old(set_union_, "set.union(self, *others)")},
+        {"intersection",           (ks_obj)ks_cfunc_new_c_old(set_intersection_, "set.intersection(self, *others)")},
+        {"difference",             (ks_obj)ks_cfunc_new_c_old(set_difference_, "set.difference(self, *others)")},
+        {"symmetric_difference",   (ks_obj)ks_cfunc_new_c_old(set_symmetric_difference_, "set.symmetric_difference(self, other)")},
+        {"issubset",               (ks_obj)ks_cfunc_new_c_old(set_issubset_, "set.issubset(self, other)")},
+        {"issuperset",             (ks_obj)ks_cfunc_new_c_old(set_issuperset_, "set.issuperset(self, other)")},
+        {"isdisjoint",             (ks_obj)ks_cfunc_new_c_old(set_isdisjoint_, "set.isdisjoint(self, other)")},
+
+        {"update",                 (ks_obj)ks_cfunc_new_c_old(set_update_, "set.update(self, *others)")},
+        {"intersection_update",    (ks_obj)ks_cfunc_new_c_old(set_intersection_update_, "set.intersection_update(self, *others)")},
+        {"difference_update",      (ks_obj)ks_cfunc_new_c_old(set_difference_update_, "set.difference_update(self, *others)")},
+        {"symmetric_difference_update", (ks_obj)ks_cfunc_new_c_old(set_symmetric_difference_update_, "set.symmetric_difference_update(self, other)")},
+
     ));
     ks_type_init_c(ks_T_set_iter, "set_iter", ks_T_object, KS_KEYVALS(
         {"__free__",               (ks_obj)ks_cfunc_new_c_old(set_iter_free_, "set_iter.__free__(self)")},
@@ -36,51 +36,38 @@ bool ks_slice_getci(ks_slice self, int64_t len, int64_t* first, int64_t* last, i
         if (!ks_num_get_int64(self->step, &step)) return false;
     }
 
+    if (step == 0) {
+        ks_throw(ks_T_ArgError, "Slices cannot have step==0");
+        return false;
+    }
+
+    // negative indices are wrapped once, and then indices are clamped to the valid range for the direction
     if (self->start == KSO_NONE) {
         start = step > 0 ? 0 : len - 1;
     } else {
         if (!ks_num_get_int64(self->start, &start)) return false;
-        start = ((start % len) + len) % len;
+        if (start < 0) start += len;
+        /**/ if (start < 0) start = step > 0 ? 0 : -1;
+        else if (start >= len) start = step > 0 ? len : len - 1;
     }
 
     if (self->stop == KSO_NONE) {
         stop = step > 0 ? len : -1;
     } else {
         if (!ks_num_get_int64(self->stop, &stop)) return false;
-        stop = ((stop % len) + len) % len;
+        if (stop < 0) stop += len;
+        /**/ if (stop < 0) stop = step > 0 ? 0 : -1;
+        else if (stop >= len) stop = step > 0 ? len : len - 1;
     }
 
-    if (step == 0) {
-        ks_throw(ks_T_ArgError, "Slices cannot have step==0");
-        return false;
-    }
+    // number of indices in the slice
+    int64_t ct = 0;
+    /**/ if (step > 0 && start < stop) ct = (stop - start - 1) / step + 1;
+    else if (step < 0 && stop < start) ct = (start - stop - 1) / (-step) + 1;
 
     *first = start;
-    *last = stop;
-    
-    if (step >= len || step <= -len) {
-        // only 1 iteration
-        *delta = 1;
-        *last = *first + *delta; 
-        return true;
-    } else if ((step > 0 && *last < *first) || (step < 0 && *last > *first)) {
-        // no objects
-        *delta = 1;
-        *last = *first;
-    } else {
-        // otherwise, just set to step
-        *delta = step;
-    }
-
-
-
-    // difference
-    int64_t diff = *last - *first;
-
-    if (diff % *delta != 0) {
-        // get the index after the last one
-        *last = *first + *delta * (diff / *delta + 1);
-    }
+    *delta = step;
+    *last = start + ct * step;
 
     return true;
 }
@@ -22,26 +22,159 @@
 static struct ks_str_s KS_STR_CHARS[KS_STR_CHAR_MAX];
 
 
+/* Tuning/Performance parameters */
+
+// minimum length (in bytes) of a substring which is created as a view of the original string, instead of a copy
+#define KS_STR_VIEW_MIN 128
+
+// minimum length (in bytes) of a needle to use a skip table (Boyer-Moore-Horspool) when searching for it
+#define KS_STR_SKIP_MIN 8
+
+
+/* Vectorized Helpers */
+
+// These process a block of 'KS_TEXT_VEC' bytes at a time, and return bitmasks (bit 'i' corresponding to byte 'i' of the block),
+//   using AVX2 or SSE2 if available, and 64-bit words (SWAR) otherwise
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+#define KS_TEXT_VEC 32
+
+// mask of bytes which have their high bit set (i.e. are not ASCII)
+static inline uint32_t text_vec_high(const uint8_t* src) {
+    return (uint32_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)src));
+}
+
+// mask of bytes which start a character (i.e. are not continuation bytes, which are 0x80 through 0xBF, or -128 through -65 as signed)
+static inline uint32_t text_vec_lead(const uint8_t* src) {
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_loadu_si256((const __m256i*)src), _mm256_set1_epi8(-65)));
+}
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+#define KS_TEXT_VEC 16
+
+// mask of bytes which have their high bit set (i.e. are not ASCII)
+static inline uint32_t text_vec_high(const uint8_t* src) {
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)src));
+}
+
+// mask of bytes which start a character (i.e. are not continuation bytes, which are 0x80 through 0xBF, or -128 through -65 as signed)
+static inline uint32_t text_vec_lead(const uint8_t* src) {
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_loadu_si128((const __m128i*)src), _mm_set1_epi8(-65)));
+}
+
+#else
+
+#define KS_TEXT_VEC 8
+
+// gather the high bits of each byte in 'x' into an 8 bit mask
+static inline uint32_t text_swar_mask(uint64_t x) {
+    uint64_t r = 0;
+    int i;
+    for (i = 0; i < 8; ++i) r |= ((x >> (8 * i + 7)) & 1) << i;
+    return (uint32_t)r;
+}
+
+// mask of bytes which have their high bit set (i.e. are not ASCII)
+static inline uint32_t text_vec_high(const uint8_t* src) {
+    uint64_t x;
+    memcpy(&x, src, sizeof(x));
+    // most blocks are entirely ASCII, so avoid building the mask for them
+    x &= 0x8080808080808080ULL;
+    return x ? text_swar_mask(x) : 0;
+}
+
+// mask of bytes which start a character (i.e. are not continuation bytes, which are 0b10XXXXXX)
+static inline uint32_t text_vec_lead(const uint8_t* src) {
+    uint64_t x;
+    memcpy(&x, src, sizeof(x));
+    return ~text_swar_mask(x & ~(x << 1)) & 0xFF;
+}
+
+#endif
+
+
 /* Raw Unicode Functions */
 
 
 // Calculate the length (in unicode characters, defined via the number of sequences decoded) of a string
 //   of (valid) UTF8. A negative return value indicates a unicode error was thrown
 // NOTE: If `len_b<0`, then `src` is assumed to be NUL-terminated
-ks_ssize_t ks_text_utf8_len_c(const char* src, ks_size_t len_b) {
+ks_ssize_t ks_text_utf8_len_c(const char* src, ks_ssize_t len_b) {
     if (len_b == 0) return 0;
     else if (len_b < 0) len_b = strlen(src); // default to NUL-terminated
 
-    // iterator
-    const char* x = src;
+    const uint8_t* x = (const uint8_t*)src;
 
     // length in characters
-    ks_ssize_t len_c = 0;
+    ks_ssize_t len_c = 0, i = 0;
+
+    for (; i + KS_TEXT_VEC <= len_b; i += KS_TEXT_VEC) {
+        // only count the start of sequences, not continuation bytes
+        len_c += text_vec_high(x + i) ? __builtin_popcount(text_vec_lead(x + i)) : KS_TEXT_VEC;
+    }
 
-    while (*x) {
-        // count actual ending blocks
-        if (((*x) & 0xC0) != 0x80) len_c++;
-        x++;
+    for (; i < len_b; ++i) {
+        if ((x[i] & 0xC0) != 0x80) len_c++;
+    }
+
+    return len_c;
+}
+
+// Validate 'len_b' bytes of UTF8 text, rejecting bad continuations, overlong encodings, surrogates, and values past U+10FFFF
+// NOTE: Returns the length in characters, or a negative number if it was invalid (no error is thrown)
+ks_ssize_t ks_text_utf8_validate(const char* src, ks_ssize_t len_b) {
+    const uint8_t* x = (const uint8_t*)src;
+
+    // current position (in bytes) and length in characters
+    ks_ssize_t i = 0, len_c = 0;
+
+    while (i < len_b) {
+        // skip over entire blocks of ASCII
+        if (i + KS_TEXT_VEC <= len_b && !text_vec_high(x + i)) {
+            i += KS_TEXT_VEC;
+            len_c += KS_TEXT_VEC;
+            continue;
+        }
+
+        uint8_t c = x[i];
+
+        // number of continuation bytes, and the range that the first of them must be in
+        int n;
+        uint8_t lo = 0x80, hi = 0xBF;
+
+        /**/ if (c < 0x80) n = 0;
+        else if (c < 0xC2) return KS_UNICH_WASERR;
+        else if (c < 0xE0) n = 1;
+        else if (c < 0xF0) {
+            n = 2;
+            // overlong, and surrogates
+            if (c == 0xE0) lo = 0xA0;
+            else if (c == 0xED) hi = 0x9F;
+        } else if (c < 0xF5) {
+            n = 3;
+            // overlong, and past U+10FFFF
+            if (c == 0xF0) lo = 0x90;
+            else if (c == 0xF4) hi = 0x8F;
+        } else return KS_UNICH_WASERR;
+
+        // truncated sequence
+        if (i + n >= len_b) return KS_UNICH_WASERR;
+
+        if (n > 0) {
+            if (x[i + 1] < lo || x[i + 1] > hi) return KS_UNICH_WASERR;
+
+            int j;
+            for (j = 2; j <= n; ++j) {
+                if ((x[i + j] & 0xC0) != 0x80) return KS_UNICH_WASERR;
+            }
+        }
+
+        i += n + 1;
+        len_c++;
     }
 
     return len_c;
@@ -76,6 +209,26 @@ ks_ssize_t ks_text_utf8_to_utf32(const char* src, ks_unich* dest, ks_ssize_t len
     ks_ssize_t cur_c = 0;
 
     while (cur_c < len_c) {
+        #if defined(__SSE2__)
+        // fast path: widen blocks of ASCII directly
+        // NOTE: there are at least 'len_c - cur_c' bytes left, since every character takes at least 1
+        if (len_c - cur_c >= 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)srci);
+            if (!_mm_movemask_epi8(v)) {
+                __m128i z = _mm_setzero_si128();
+                __m128i lo = _mm_unpacklo_epi8(v, z), hi = _mm_unpackhi_epi8(v, z);
+                _mm_storeu_si128((__m128i*)(desti +  0), _mm_unpacklo_epi16(lo, z));
+                _mm_storeu_si128((__m128i*)(desti +  4), _mm_unpackhi_epi16(lo, z));
+                _mm_storeu_si128((__m128i*)(desti +  8), _mm_unpacklo_epi16(hi, z));
+                _mm_storeu_si128((__m128i*)(desti + 12), _mm_unpackhi_epi16(hi, z));
+                srci += 16;
+                desti += 16;
+                cur_c += 16;
+                continue;
+            }
+        }
+        #endif
+
         // decode single character
         c[0] = srci[0];
 
@@ -140,6 +293,9 @@ ks_ssize_t ks_text_utf8_to_utf32(const char* src, ks_unich* dest, ks_ssize_t len
 
             // 4 bytes read
             srci += 4;
+        } else {
+            // invalid starting byte
+            return KS_UNICH_WASERR;
         }
 
         // advance to next destination
@@ -452,6 +608,110 @@ ks_str ks_str_chr(ks_unich chr) {
 
 /* Creation Routines */
 
+#if KS_STR_OFF_EVERY
+
+// fill in `self->offs[i]` for all 'i' past 'from_i' (`self->offs[from_i]` must already be correct), which
+//   must have enough room for `self->len_c / KS_STR_OFF_EVERY + 1` entries
+static void str_calc_offs(ks_str self, ks_size_t from_i) {
+    // current byte and character index
+    ks_size_t p = self->offs[from_i], c = from_i * KS_STR_OFF_EVERY;
+
+    for (; p < self->len_b; ++p) {
+        // only count the start of sequences, not continuation bytes
+        if ((self->chr[p] & 0xC0) != 0x80) {
+            if (c % KS_STR_OFF_EVERY == 0) self->offs[c / KS_STR_OFF_EVERY] = p;
+            c++;
+        }
+    }
+
+    // the last entry may refer to the end of the string
+    if (c % KS_STR_OFF_EVERY == 0) self->offs[c / KS_STR_OFF_EVERY] = p;
+}
+
+// allocate an offsets table for a string of 'len_b' bytes, whose first 'len_c' characters are known to be ASCII
+static ks_size_t* str_offs_begin(ks_size_t len_b, ks_size_t len_c) {
+    // upper bound, since there are at most 'len_b' characters
+    ks_size_t* offs = ks_malloc((len_b / KS_STR_OFF_EVERY + 1) * sizeof(*offs));
+
+    ks_size_t i;
+    for (i = 0; i * KS_STR_OFF_EVERY < len_c; ++i) offs[i] = i * KS_STR_OFF_EVERY;
+
+    return offs;
+}
+
+#endif /* KS_STR_OFF_EVERY */
+
+// calculate the derived fields (hash, length in characters, and offsets) of a string which has had 'len_b' and 'chr' filled in
+static void str_calc(ks_str self) {
+    // calculate hash
+    self->v_hash = ks_hash_bytes(self->chr, self->len_b);
+
+    #if KS_STR_OFF_EVERY
+
+    // calculate characters via reading the UTF-8, and the byte offsets of every-so-often characters, in a single pass
+    // The offsets are only required for non-ASCII data, so they are allocated when the first non-ASCII byte is found
+    const uint8_t* x = (const uint8_t*)self->chr;
+    ks_size_t len_b = self->len_b, i = 0, c = 0, t, j;
+    ks_size_t* offs = NULL;
+
+    for (; i + KS_TEXT_VEC <= len_b; i += KS_TEXT_VEC) {
+        uint32_t high = text_vec_high(x + i);
+        if (!high && !offs) {
+            // ASCII so far, so every byte is a character
+            c += KS_TEXT_VEC;
+            continue;
+        }
+
+        if (!offs) offs = str_offs_begin(len_b, c);
+
+        // mask of the bytes that begin characters
+        uint32_t lead = high ? text_vec_lead(x + i) : (uint32_t)(((uint64_t)1 << KS_TEXT_VEC) - 1);
+        ks_size_t n = __builtin_popcount(lead);
+
+        // record the offsets of any characters in this block whose index is a multiple of 'KS_STR_OFF_EVERY'
+        for (t = (c + KS_STR_OFF_EVERY - 1) / KS_STR_OFF_EVERY * KS_STR_OFF_EVERY; t < c + n; t += KS_STR_OFF_EVERY) {
+            // find the position of the '(t - c)'th set bit
+            uint32_t m = lead;
+            for (j = c; j < t; ++j) m &= m - 1;
+            offs[t / KS_STR_OFF_EVERY] = i + __builtin_ctz(m);
+        }
+
+        c += n;
+    }
+
+    // handle the remaining bytes
+    for (; i < len_b; ++i) {
+        if ((x[i] & 0x80) && !offs) offs = str_offs_begin(len_b, c);
+
+        // only count the start of sequences, not continuation bytes
+        if ((x[i] & 0xC0) != 0x80) {
+            if (offs && c % KS_STR_OFF_EVERY == 0) offs[c / KS_STR_OFF_EVERY] = i;
+            c++;
+        }
+    }
+
+    self->len_c = c;
+
+    if (offs) {
+        // the last entry may refer to the end of the string
+        if (c % KS_STR_OFF_EVERY == 0) offs[c / KS_STR_OFF_EVERY] = len_b;
+
+        // trim to the actual size, since it was allocated assuming every byte could be a character
+        self->offs = ks_realloc(offs, (c / KS_STR_OFF_EVERY + 1) * sizeof(*offs));
+    } else {
+        // ASCII data, since the bytes are equal to the characters
+        // no offsets required
+        self->offs = NULL;
+    }
+
+    #else
+
+    // now, calculate characters via reading the UTF-8
+    self->len_c = ks_text_utf8_len_c(self->chr, self->len_b);
+
+    #endif /* KS_STR_OFF_EVERY */
+}
+
 // construct new string from UTF-8 data, given length in bytes
 ks_str ks_str_utf8(const char* cstr, ks_ssize_t len_b) {
     // calculate length if it was negative
@@ -460,67 +720,110 @@ ks_str ks_str_utf8(const char* cstr, ks_ssize_t len_b) {
         else len_b = strlen(cstr);
     }
 
-    // check for the NUL-string (i.e. empty, length==0)
-    /**/ if (len_b == 0 || cstr == NULL || !*cstr) return (ks_str)KS_NEWREF(&KS_STR_CHARS[0]);
-    else if (len_b == 1) return (ks_str)KS_NEWREF(&KS_STR_CHARS[*cstr]);
+    // check for the NUL-string (i.e. empty, length==0), or single ASCII characters (but not '\0', since that
+    //   singleton is the empty string)
+    /**/ if (len_b == 0 || cstr == NULL) return (ks_str)KS_NEWREF(&KS_STR_CHARS[0]);
+    else if (len_b == 1 && *cstr != '\0' && (unsigned char)*cstr < 0x80) return (ks_str)KS_NEWREF(&KS_STR_CHARS[(unsigned char)*cstr]);
     else {
         // allocate the string and return a new one
         ks_str self = ks_malloc(sizeof(*self) + len_b);
         KS_INIT_OBJ(self, ks_T_str);
+        self->src = NULL;
+        self->chr = self->_chr;
         self->len_b = len_b;
 
         // copy and NUL-terminate it
         memcpy(self->chr, cstr, self->len_b);
         self->chr[self->len_b] = '\0';
 
-        // calculate hash
-        self->v_hash = ks_hash_bytes(self->chr, self->len_b);
+        str_calc(self);
 
-        // now, calculate characters via reading the UTF-8
-        self->len_c = ks_text_utf8_len_c(self->chr, self->len_b);
+        return self;
+    }
+}
 
+// Take ownership of 'buf', which was allocated with `ks_malloc(sizeof(*buf) + len_b)` (or larger), and has
+//   'len_b' bytes of UTF-8 in 'buf->_chr'. The memory is turned into a string object without copying
+// NOTE: Returns new reference; 'buf' should not be used afterwards (it may be freed)
+ks_str ks_str_adopt(ks_str buf, ks_size_t len_b) {
+    if (len_b == 0 || (len_b == 1 && buf->_chr[0] != '\0' && (unsigned char)buf->_chr[0] < 0x80)) {
+        // use the global singletons, and throw away the buffer
+        ks_str ret = len_b == 0 ? &KS_STR_CHARS[0] : &KS_STR_CHARS[(unsigned char)buf->_chr[0]];
+        ks_free(buf);
+        return (ks_str)KS_NEWREF(ret);
+    }
 
-        // calculate byte offsets of every-so-often characters, if enabled
-        #if KS_STR_OFF_EVERY
-        if (self->len_b != self->len_c) {
-            // non-ascii data
-            
-            // calculate offsets
-            int n_offs = self->len_c / KS_STR_OFF_EVERY + 1;
-            self->offs = ks_malloc(n_offs * sizeof(*self->offs));
-
-            // create an iterator
-            struct ks_str_citer cit = ks_str_citer_make(self);
-
-            int i;
-            for (i = 0; i < n_offs; ++i) {
-                // set current offset
-                self->offs[i] = cit.cbyi;
-
-                // skip out early
-                if (i >= n_offs - 1) break;
-
-                int j;
-                // advance a number of characters
-                for (j = 0; j < KS_STR_OFF_EVERY; ++j) {
-                    if (ks_str_citer_next(&cit) < 0) {
-                        // internal error
-                        ks_warn("ks", "While calculating offsets for UTF8 string '%s', ks_str_citer_next() gave an error!", self->chr);
-                    }
-                }
-            }
+    KS_INIT_OBJ(buf, ks_T_str);
+    buf->src = NULL;
+    buf->chr = buf->_chr;
+    buf->len_b = len_b;
+    buf->chr[len_b] = '\0';
+
+    str_calc(buf);
+
+    return buf;
+}
+
+// Append 'R' to 'L', reusing the memory of 'L'. The capacity is rounded up to a power of two, so that repeated
+//   appends only occasionally have to move the data
+// NOTE: Only valid if the caller holds the only reference to 'L'; the reference
+//   is consumed, and a reference to the result (which may have moved) is returned. On failure, 'L' is left untouched
+ks_str ks_str_iadd(ks_str L, ks_str R) {
+    if (R->len_b == 0) return L;
+
+    ks_size_t len_b = L->len_b + R->len_b;
+
+    if ((L >= &KS_STR_CHARS[0] && L <= &KS_STR_CHARS[KS_STR_CHAR_MAX]) || L->chr != L->_chr) {
+        // global singletons and views cannot be reallocated, so make a new string
+        ks_str ret = ks_malloc(sizeof(*ret) + len_b);
+        if (!ret) return ks_throw(ks_T_OutOfMemError, "Failed to allocate %z bytes for 'str'", len_b);
+        memcpy(ret->_chr, L->chr, L->len_b);
+        memcpy(ret->_chr + L->len_b, R->chr, R->len_b);
+        KS_DECREF(L);
+        return ks_str_adopt(ret, len_b);
+    }
+
+    ks_size_t cap = 16;
+    while (cap < len_b) cap *= 2;
+
+    // NOTE: realloc() returns the same pointer without copying when the capacity has not changed
+    ks_str self = ks_realloc(L, sizeof(*self) + cap);
+    if (!self) return ks_throw(ks_T_OutOfMemError, "Failed to allocate %z bytes for 'str'", len_b);
+    self->chr = self->_chr;
 
+    memcpy(self->chr + self->len_b, R->chr, R->len_b);
+    self->chr[len_b] = '\0';
 
+    // extend the DJB hash from where it left off (unless it may have been adjusted, in which case recompute it)
+    if (self->v_hash == 1) {
+        self->v_hash = ks_hash_bytes(self->chr, len_b);
+    } else {
+        ks_size_t i;
+        for (i = 0; i < R->len_b; ++i) self->v_hash = 33 * self->v_hash + (uint8_t)R->chr[i];
+        if (self->v_hash == 0) self->v_hash = 1;
+    }
+
+    ks_size_t old_len_c = self->len_c;
+    self->len_b = len_b;
+    self->len_c += R->len_c;
+
+    #if KS_STR_OFF_EVERY
+    if (self->len_b != self->len_c) {
+        // resume the offsets from the last one that was already known
+        ks_size_t from_i = old_len_c / KS_STR_OFF_EVERY;
+        if (!self->offs) {
+            // the left side was ASCII, so its offsets are trivial
+            self->offs = ks_malloc((self->len_c / KS_STR_OFF_EVERY + 1) * sizeof(*self->offs));
+            ks_size_t i;
+            for (i = 0; i <= from_i; ++i) self->offs[i] = i * KS_STR_OFF_EVERY;
         } else {
-            // ASCII data, since the bytes are equal to the characters
-            // no offsets required
-            self->offs = NULL;
-        
+            self->offs = ks_realloc(self->offs, (self->len_c / KS_STR_OFF_EVERY + 1) * sizeof(*self->offs));
         }
-        #endif /* KS_STR_OFF_EVERY */
-
-        return self;
+        str_calc_offs(self, from_i);
     }
+    #endif /* KS_STR_OFF_EVERY */
+
+    return self;
 }
 
 // Construct a new 'str' object, from a C-style string.
@@ -532,8 +835,11 @@ ks_str ks_str_new_c(const char* cstr, ssize_t len) {
 // compare strings, comparing memory
 int ks_str_cmp(ks_str A, ks_str B) {
     /**/ if (A == B) return 0;
-    //else if (A->len_c != B->len_c) return A->len_c - B->len_c;
-    else return memcmp(A->chr, B->chr, A->len_b > B->len_b ? B->len_b : A->len_b);
+
+    // comparing UTF-8 bytes gives the same order as comparing codepoints, and a prefix comes first
+    int res = memcmp(A->chr, B->chr, A->len_b > B->len_b ? B->len_b : A->len_b);
+    if (res != 0) return res;
+    return A->len_b < B->len_b ? -1 : A->len_b > B->len_b ? 1 : 0;
 }
 
 // get whether two strings equal each other
@@ -556,9 +862,13 @@ ks_str ks_str_escape(ks_str A) {
     char utf8[5];
     struct ks_str_citer cit = ks_str_citer_make(A);
     ks_unich ch;
-    while (!cit.done && (ch = ks_str_citer_next(&cit))) {
+    while (!cit.done) {
+        ch = ks_str_citer_next(&cit);
+        if (cit.err) break;
+
         // escape the given character
         /**/ if (ch == '\\') ks_str_builder_add(sb, "\\\\", 2);
+        else if (ch == '\0') ks_str_builder_add(sb, "\\u0000", 6);
         else if (ch == '\n') ks_str_builder_add(sb, "\\n", 2);
         else if (ch == '\t') ks_str_builder_add(sb, "\\t", 2);
         else if (ch == '\a') ks_str_builder_add(sb, "\\a", 2);
@@ -703,31 +1013,80 @@ ks_str ks_str_unescape(ks_str A) {
 }
 
 
+// return the string which owns the bytes that 'self->chr' points to
+// NOTE: A view that has been materialized (see `ks_str_cstr()`) owns its own copy, but still refers to 'src'
+static ks_str str_owner(ks_str self) {
+    ks_str src = self->src;
+    return (src && self->chr >= src->chr && self->chr <= src->chr + src->len_b) ? src : self;
+}
+
+// Return the bytes of 'self' as a NUL-terminated C-style string
+const char* ks_str_cstr(ks_str self) {
+    if (self->chr[self->len_b] == '\0') return self->chr;
+
+    // an interior view, so copy out its bytes (once; from then on, 'chr' is the copy)
+    // NOTE: 'src' is kept until 'self' is freed, so pointers into it (and buffers exported from 'self') stay valid
+    char* cpy = ks_malloc(self->len_b + 1);
+    memcpy(cpy, self->chr, self->len_b);
+    cpy[self->len_b] = '\0';
+    self->chr = cpy;
+
+    return cpy;
+}
+
+// create a substring of 'self' from a range of bytes (which must be on character boundaries)
+ks_str ks_str_substr_b(ks_str self, ks_ssize_t start_b, ks_ssize_t len_b) {
+    if (start_b == 0 && len_b == self->len_b) {
+        // the entire string
+        return (ks_str)KS_NEWREF(self);
+    } else if (len_b >= KS_STR_VIEW_MIN) {
+        // large substrings are views into the original bytes, so they don't need to be copied. They are only
+        //   NUL-terminated if they are suffixes, so C code that needs that must use `ks_str_cstr()`
+        ks_str ret = KS_ALLOC_OBJ(ks_str);
+        KS_INIT_OBJ(ret, ks_T_str);
+
+        // always refer to the string that actually owns the bytes
+        ret->src = str_owner(self);
+        KS_INCREF(ret->src);
+
+        ret->chr = self->chr + start_b;
+        ret->len_b = len_b;
+        str_calc(ret);
+
+        return ret;
+    } else {
+        return ks_str_utf8(self->chr + start_b, len_b);
+    }
+}
+
 // Get substring
 ks_str ks_str_substr(ks_str self, ks_ssize_t start, ks_ssize_t len_c) {
+    if (len_c < 0 || start + len_c > self->len_c) len_c = self->len_c - start;
+
+    // start index and length (in bytes)
+    ks_ssize_t start_i, len_b;
 
     // check for ascii strings
     if (KS_STR_ISASCII(self)) {
         // len_c==len_b
-        return ks_str_utf8(self->chr + start, len_c);
-    }
-
-    struct ks_str_citer cit = ks_str_citer_make(self);
+        start_i = start;
+        len_b = len_c;
+    } else {
+        struct ks_str_citer cit = ks_str_citer_make(self);
 
-    // zoom to the start
-    if (!ks_str_citer_seek(&cit, start)) return (ks_str)ks_throw(ks_T_InternalError, "Could not seek with unicode!");
+        // zoom to the start
+        if (!ks_str_citer_seek(&cit, start)) return (ks_str)ks_throw(ks_T_InternalError, "Could not seek with unicode!");
 
-    // start index
-    ks_ssize_t start_i = cit.cbyi;
+        start_i = cit.cbyi;
 
-    // go to end
-    if (!ks_str_citer_seek(&cit, start + len_c)) return (ks_str)ks_throw(ks_T_InternalError, "Could not seek with unicode!");
+        // go to end
+        if (!ks_str_citer_seek(&cit, start + len_c)) return (ks_str)ks_throw(ks_T_InternalError, "Could not seek with unicode!");
 
-    // calculate the length (in bytes) that it coveres
-    ks_ssize_t len_b = cit.cbyi - start_i;
+        // calculate the length (in bytes) that it coveres
+        len_b = cit.cbyi - start_i;
+    }
 
-    // TODO: maybe more efficient method for substrings
-    return ks_str_utf8(self->chr + start_i, len_b);
+    return ks_str_substr_b(self, start_i, len_b);
 }
 
 // str.__new__(obj, *args)
@@ -757,7 +1116,17 @@ static KS_TFUNC(str, free) {
         return KSO_NONE;
     }
 
-    // nothing else is needed because the string is allocated with enough bytes for all the characters    
+    // the characters are allocated along with the string (or belong to 'src'), but the offsets are seperate
+    #if KS_STR_OFF_EVERY
+    ks_free(self->offs);
+    #endif /* KS_STR_OFF_EVERY */
+
+    if (self->src) {
+        // free the copy made by `ks_str_cstr()`, if there is one
+        if (str_owner(self) == self) ks_free(self->chr);
+        KS_DECREF(self->src);
+    }
+
     KS_UNINIT_OBJ(self);
     KS_FREE_OBJ(self);
 
@@ -810,9 +1179,43 @@ static KS_TFUNC(str, getitem) {
         int64_t idx64;
         if (!ks_num_get_int64(idx, &idx64)) return NULL;
 
+        // ensure negative indices are wrapped once
+        if (idx64 < 0) idx64 += self->len_c;
+
+        // do bounds check
+        if (idx64 < 0 || idx64 >= self->len_c) KS_THROW_INDEX_ERR(self, idx);
+
         return (ks_obj)ks_str_substr(self, idx64, 1);
+    } else if (idx->type == ks_T_slice) {
+        if (self->len_c == 0) return KS_NEWREF(self);
+
+        int64_t first, last, delta;
+        // convert to C for loop parameters
+        if (!ks_slice_getci((ks_slice)idx, self->len_c, &first, &last, &delta)) return NULL;
+
+        // contiguous slices are substrings (which may be views)
+        if (delta == 1) return (ks_obj)ks_str_substr(self, first, last - first);
+
+        ks_str_builder sb = ks_str_builder_new();
+        struct ks_str_citer cit = ks_str_citer_make(self);
+
+        int64_t i;
+        for (i = first; i != last; i += delta) {
+            char utf8[5];
+            if (!ks_str_citer_seek(&cit, i)) {
+                KS_DECREF(sb);
+                return ks_throw(ks_T_InternalError, "Could not seek with unicode!");
+            }
+            ks_unich ch = ks_str_citer_next(&cit);
+            int sz = ks_text_utf32_to_utf8(&ch, utf8, 1);
+            ks_str_builder_add(sb, utf8, sz);
+        }
+
+        ks_str ret = ks_str_builder_get(sb);
+        KS_DECREF(sb);
+        return (ks_obj)ret;
     } else {
-        return ks_throw(ks_T_TodoError, "Non-integer indexes not supported!");
+        return ks_throw(ks_T_TypeError, "Expected 'idx' to be an integer, or a slice, but got '%T'", idx);
     }
 }
 
@@ -821,12 +1224,62 @@ static KS_TFUNC(str, getitem) {
 /* misc. string utilities */
 
 
+// str.format(self, *args) - replace the fields of a format string, which are '{[index][!r|!s][:spec]}' (and '{{' and
+//   '}}' for literal braces), with the arguments. The spec is given to the argument's '__fmt__', or otherwise may be
+//   '[-][0][width]' to pad the text
+static KS_TFUNC(str, format) {
+    ks_str self;
+    int n_extra;
+    ks_obj* extra;
+    KS_GETARGS("self:* *args", &self, ks_T_str, &n_extra, &extra)
+
+    ks_str_builder sb = ks_str_builder_new();
+    if (!ks_str_builder_add_format(sb, self, n_extra, extra)) {
+        KS_DECREF(sb);
+        return NULL;
+    }
+
+    ks_str ret = ks_str_builder_get(sb);
+    KS_DECREF(sb);
+    return (ks_obj)ret;
+}
+
 // str.join(self, objs) - join an iterable by a seperator
 static KS_TFUNC(str, join) {
     ks_str self;
     ks_obj objs;
     KS_GETARGS("self:* objs:iter", &self, ks_T_str, &objs);
 
+    if ((objs->type == ks_T_list && ((ks_list)objs)->kind == KS_LIST_KIND_OBJ) || objs->type == ks_T_tuple) {
+        // fast path: if everything is already a string, we can calculate the exact size first, and then
+        //   copy directly into the result
+        ks_size_t n = objs->type == ks_T_list ? ((ks_list)objs)->len : ((ks_tuple)objs)->len;
+        ks_obj* elems = objs->type == ks_T_list ? ((ks_list)objs)->elems : ((ks_tuple)objs)->elems;
+
+        ks_size_t i, len_b = 0;
+        for (i = 0; i < n && elems[i]->type == ks_T_str; ++i) {
+            len_b += ((ks_str)elems[i])->len_b;
+        }
+
+        if (i == n) {
+            if (n > 0) len_b += (n - 1) * self->len_b;
+
+            ks_str ret = ks_malloc(sizeof(*ret) + len_b);
+            char* p = ret->_chr;
+            for (i = 0; i < n; ++i) {
+                ks_str it = (ks_str)elems[i];
+                if (i > 0) {
+                    memcpy(p, self->chr, self->len_b);
+                    p += self->len_b;
+                }
+                memcpy(p, it->chr, it->len_b);
+                p += it->len_b;
+            }
+
+            return (ks_obj)ks_str_adopt(ret, len_b);
+        }
+    }
+
     // create string builder
     ks_str_builder sb = ks_str_builder_new();
 
@@ -871,6 +1324,14 @@ static KS_TFUNC(str, add) {
     ks_obj L, R;
     KS_GETARGS("L R", &L, &R)
 
+    if (L->type == ks_T_str && R->type == ks_T_str) {
+        // concatenate directly into the result
+        ks_str Ls = (ks_str)L, Rs = (ks_str)R;
+        ks_str ret = ks_malloc(sizeof(*ret) + Ls->len_b + Rs->len_b);
+        memcpy(ret->_chr, Ls->chr, Ls->len_b);
+        memcpy(ret->_chr + Ls->len_b, Rs->chr, Rs->len_b);
+        return (ks_obj)ks_str_adopt(ret, Ls->len_b + Rs->len_b);
+    }
 
     return (ks_obj)ks_fmt_c("%S%S", L, R);
 
@@ -983,6 +1444,125 @@ static KS_TFUNC(str, substr) {
 }
 
 
+/* Searching */
+
+// describes a search for a substring (the needle), which is prepared once and then may be used many times
+typedef struct {
+
+    // the bytes being searched for
+    const char* ndl;
+    ks_ssize_t nlen;
+
+    // whether or not to use the skip table (for longer needles)
+    bool useSkip;
+
+    // Boyer-Moore-Horspool skip table, the distance to shift the window based on its last byte
+    ks_ssize_t skip[256];
+
+} str_search_t;
+
+// initialize a search for the given needle
+static void str_search_init(str_search_t* srch, const char* ndl, ks_ssize_t nlen) {
+    srch->ndl = ndl;
+    srch->nlen = nlen;
+    srch->useSkip = nlen >= KS_STR_SKIP_MIN;
+
+    if (srch->useSkip) {
+        ks_ssize_t i;
+        for (i = 0; i < 256; ++i) srch->skip[i] = nlen;
+        for (i = 0; i < nlen - 1; ++i) srch->skip[(uint8_t)ndl[i]] = nlen - 1 - i;
+    }
+}
+
+// find the first occurence of the needle in 'hay', returning the byte index, or -1 if it was not found
+// NOTE: Since both are UTF-8, any match is always on a character boundary
+static ks_ssize_t str_search_find(str_search_t* srch, const char* hay, ks_ssize_t hlen) {
+    const char* ndl = srch->ndl;
+    ks_ssize_t nlen = srch->nlen;
+
+    /**/ if (nlen == 0) return 0;
+    else if (nlen > hlen) return -1;
+    else if (nlen == 1) {
+        const char* p = memchr(hay, ndl[0], hlen);
+        return p ? p - hay : -1;
+    } else if (!srch->useSkip) {
+        // filter possible starting positions by the first byte (which memchr() does very quickly), then check the rest
+        const char* p = hay, *end = hay + hlen - nlen + 1;
+        while (p < end && (p = memchr(p, ndl[0], end - p)) != NULL) {
+            if (memcmp(p + 1, ndl + 1, nlen - 1) == 0) return p - hay;
+            p++;
+        }
+        return -1;
+    } else {
+        // Boyer-Moore-Horspool, comparing the last byte of the window first
+        uint8_t last = ndl[nlen - 1];
+        ks_ssize_t i = 0;
+        while (i <= hlen - nlen) {
+            uint8_t c = hay[i + nlen - 1];
+            if (c == last && memcmp(hay + i, ndl, nlen - 1) == 0) return i;
+            i += srch->skip[c];
+        }
+        return -1;
+    }
+}
+
+// find the last occurence of 'ndl' in 'hay', returning the byte index, or -1 if it was not found
+static ks_ssize_t str_search_rfind(const char* hay, ks_ssize_t hlen, const char* ndl, ks_ssize_t nlen) {
+    if (nlen > hlen) return -1;
+
+    ks_ssize_t i;
+    for (i = hlen - nlen; i >= 0; --i) {
+        if (hay[i] == ndl[0] && memcmp(hay + i, ndl, nlen) == 0) return i;
+    }
+
+    return -1;
+}
+
+// convert a character index into a byte index into 'self'
+static ks_ssize_t str_byteidx(ks_str self, ks_ssize_t ci) {
+    if (ci <= 0 || KS_STR_ISASCII(self)) return ci;
+    else if (ci >= self->len_c) return self->len_b;
+
+    struct ks_str_citer cit = ks_str_citer_make(self);
+    ks_str_citer_seek(&cit, ci);
+    return cit.cbyi;
+}
+
+// convert a byte index into 'self' into a character index
+static ks_ssize_t str_charidx(ks_str self, ks_ssize_t bi) {
+    return KS_STR_ISASCII(self) ? bi : ks_text_utf8_len_c(self->chr, bi);
+}
+
+// adjust python-style 'start' and 'end' character indices (which may be negative), and convert them to byte indices
+// NOTE: Returns false if the range is empty (i.e. nothing can be found in it, not even the empty string)
+static bool str_adjrange(ks_str self, int64_t start, int64_t end, ks_ssize_t* start_b, ks_ssize_t* end_b) {
+    if (start < 0) start += self->len_c;
+    if (end < 0) end += self->len_c;
+    if (start < 0) start = 0;
+    if (end > self->len_c) end = self->len_c;
+    if (end < start) return false;
+
+    *start_b = str_byteidx(self, start);
+    *end_b = str_byteidx(self, end);
+    return true;
+}
+
+// read an 'end' argument, which may be 'none' (for the end of the string)
+// NOTE: Returns success
+static bool str_getend(ks_obj obj, int64_t* end) {
+    if (obj == KSO_NONE) {
+        *end = KS_SSIZE_MAX;
+        return true;
+    }
+    return ks_num_get_int64(obj, end);
+}
+
+// return whether 'c' is an (ASCII) whitespace byte
+static bool str_isspace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+
 /* 'check' functions that return true or false */
 
 
@@ -1007,6 +1587,396 @@ static KS_TFUNC(str, endswith) {
 }
 
 
+/* searching, splitting, and stripping */
+
+
+// create a list with room for exactly 'n' elements, which are filled in by setting `elems[len++]` (to a new reference)
+static ks_list str_list_presize(ks_size_t n) {
+    ks_list ret = ks_list_new(0, NULL);
+    ks_free(ret->elems);
+    ret->elems = ks_malloc(sizeof(*ret->elems) * n);
+    ret->max_len = n;
+    return ret;
+}
+
+// str.find(self, sub, start=0, end=none) - return the index of the first occurence of 'sub', or -1 if it was not found
+static KS_TFUNC(str, find) {
+    ks_str self, sub;
+    int64_t start = 0, end;
+    ks_obj end_o = KSO_NONE;
+    KS_GETARGS("self:* sub:* ?start:i64 ?end", &self, ks_T_str, &sub, ks_T_str, &start, &end_o)
+    if (!str_getend(end_o, &end)) return NULL;
+
+    ks_ssize_t start_b, end_b;
+    if (!str_adjrange(self, start, end, &start_b, &end_b)) return (ks_obj)ks_int_new(-1);
+
+    str_search_t srch;
+    str_search_init(&srch, sub->chr, sub->len_b);
+
+    ks_ssize_t r = str_search_find(&srch, self->chr + start_b, end_b - start_b);
+    return (ks_obj)ks_int_new(r < 0 ? -1 : str_charidx(self, start_b + r));
+}
+
+// str.rfind(self, sub, start=0, end=none) - return the index of the last occurence of 'sub', or -1 if it was not found
+static KS_TFUNC(str, rfind) {
+    ks_str self, sub;
+    int64_t start = 0, end;
+    ks_obj end_o = KSO_NONE;
+    KS_GETARGS("self:* sub:* ?start:i64 ?end", &self, ks_T_str, &sub, ks_T_str, &start, &end_o)
+    if (!str_getend(end_o, &end)) return NULL;
+
+    ks_ssize_t start_b, end_b;
+    if (!str_adjrange(self, start, end, &start_b, &end_b)) return (ks_obj)ks_int_new(-1);
+
+    ks_ssize_t r = sub->len_b == 0 ? end_b - start_b : str_search_rfind(self->chr + start_b, end_b - start_b, sub->chr, sub->len_b);
+    return (ks_obj)ks_int_new(r < 0 ? -1 : str_charidx(self, start_b + r));
+}
+
+// str.count(self, sub, start=0, end=none) - return the number of non-overlapping occurences of 'sub'
+static KS_TFUNC(str, count) {
+    ks_str self, sub;
+    int64_t start = 0, end;
+    ks_obj end_o = KSO_NONE;
+    KS_GETARGS("self:* sub:* ?start:i64 ?end", &self, ks_T_str, &sub, ks_T_str, &start, &end_o)
+    if (!str_getend(end_o, &end)) return NULL;
+
+    ks_ssize_t start_b, end_b;
+    if (!str_adjrange(self, start, end, &start_b, &end_b)) return (ks_obj)ks_int_new(0);
+
+    // the empty string is found between every character
+    if (sub->len_b == 0) return (ks_obj)ks_int_new(str_charidx(self, end_b) - str_charidx(self, start_b) + 1);
+
+    str_search_t srch;
+    str_search_init(&srch, sub->chr, sub->len_b);
+
+    ks_ssize_t ct = 0, p = start_b, r;
+    while ((r = str_search_find(&srch, self->chr + p, end_b - p)) >= 0) {
+        ct++;
+        p += r + sub->len_b;
+    }
+
+    return (ks_obj)ks_int_new(ct);
+}
+
+// str.replace(self, old, new, count=-1) - replace occurences of 'old' with 'new' (at most 'count' of them, if 'count>=0')
+static KS_TFUNC(str, replace) {
+    ks_str self, old, rep;
+    int64_t count = -1;
+    KS_GETARGS("self:* old:* new:* ?count:i64", &self, ks_T_str, &old, ks_T_str, &rep, ks_T_str, &count)
+
+    if (count < 0) count = KS_SSIZE_MAX;
+
+    if (old->len_b == 0) {
+        // insert 'new' before every character, and at the end
+        ks_str_builder sb = ks_str_builder_new();
+        struct ks_str_citer cit = ks_str_citer_make(self);
+
+        ks_ssize_t ct = 0, last = 0;
+        while (ct < count) {
+            ks_str_builder_add(sb, rep->chr, rep->len_b);
+            ct++;
+            if (cit.done) break;
+
+            ks_str_citer_next(&cit);
+            ks_str_builder_add(sb, self->chr + last, cit.cbyi - last);
+            last = cit.cbyi;
+        }
+        ks_str_builder_add(sb, self->chr + last, self->len_b - last);
+
+        ks_str ret = ks_str_builder_get(sb);
+        KS_DECREF(sb);
+        return (ks_obj)ret;
+    }
+
+    str_search_t srch;
+    str_search_init(&srch, old->chr, old->len_b);
+
+    // first, count the replacements so the result can be allocated exactly
+    ks_ssize_t n = 0, p = 0, r;
+    while (n < count && (r = str_search_find(&srch, self->chr + p, self->len_b - p)) >= 0) {
+        n++;
+        p += r + old->len_b;
+    }
+
+    if (n == 0) return KS_NEWREF(self);
+
+    ks_ssize_t len_b = self->len_b + n * (rep->len_b - old->len_b);
+    ks_str ret = ks_malloc(sizeof(*ret) + len_b);
+    char* out = ret->_chr;
+
+    ks_ssize_t i;
+    for (i = 0, p = 0; i < n; ++i) {
+        r = str_search_find(&srch, self->chr + p, self->len_b - p);
+        memcpy(out, self->chr + p, r);
+        out += r;
+        memcpy(out, rep->chr, rep->len_b);
+        out += rep->len_b;
+        p += r + old->len_b;
+    }
+    memcpy(out, self->chr + p, self->len_b - p);
+
+    return (ks_obj)ks_str_adopt(ret, len_b);
+}
+
+
+// split 'self' on runs of whitespace, from the left or right, with at most 'maxsplit' splits (if 'maxsplit>=0')
+static ks_obj str_split_ws(ks_str self, int64_t maxsplit, bool fromRight) {
+    const char* s = self->chr;
+    ks_ssize_t len = self->len_b, p, q, n = 0;
+
+    // count the number of pieces first
+    for (p = 0; p < len; ) {
+        while (p < len && str_isspace(s[p])) p++;
+        if (p >= len) break;
+        n++;
+        while (p < len && !str_isspace(s[p])) p++;
+    }
+    if (maxsplit >= 0 && n > maxsplit + 1) n = maxsplit + 1;
+
+    ks_list ret = str_list_presize(n);
+    if (n == 0) return (ks_obj)ret;
+
+    if (!fromRight) {
+        p = 0;
+        while (ret->len < n - 1) {
+            while (str_isspace(s[p])) p++;
+            q = p;
+            while (!str_isspace(s[q])) q++;
+            ret->elems[ret->len++] = (ks_obj)ks_str_substr_b(self, p, q - p);
+            p = q;
+        }
+
+        // the rest of the string
+        while (str_isspace(s[p])) p++;
+        q = len;
+        if (maxsplit < 0 || n <= maxsplit) while (str_isspace(s[q - 1])) q--;
+        ret->elems[ret->len++] = (ks_obj)ks_str_substr_b(self, p, q - p);
+    } else {
+        // fill in backwards
+        q = len;
+        ks_ssize_t i;
+        for (i = n - 1; i > 0; --i) {
+            while (str_isspace(s[q - 1])) q--;
+            p = q;
+            while (!str_isspace(s[p - 1])) p--;
+            ret->elems[i] = (ks_obj)ks_str_substr_b(self, p, q - p);
+            q = p;
+        }
+
+        // the rest of the string
+        while (str_isspace(s[q - 1])) q--;
+        p = 0;
+        if (maxsplit < 0 || n <= maxsplit) while (str_isspace(s[p])) p++;
+        ret->elems[0] = (ks_obj)ks_str_substr_b(self, p, q - p);
+        ret->len = n;
+    }
+
+    return (ks_obj)ret;
+}
+
+// str.split(self, sep=none, maxsplit=-1) - split on 'sep' (or on runs of whitespace, if 'sep' is none), making at
+//   most 'maxsplit' splits if 'maxsplit>=0'
+static KS_TFUNC(str, split) {
+    ks_str self;
+    ks_obj sep = KSO_NONE;
+    int64_t maxsplit = -1;
+    KS_GETARGS("self:* ?sep ?maxsplit:i64", &self, ks_T_str, &sep, &maxsplit)
+
+    if (sep == KSO_NONE) return str_split_ws(self, maxsplit, false);
+    else if (sep->type != ks_T_str) KS_THROW_TYPE_ERR(sep, ks_T_str);
+
+    ks_str ssep = (ks_str)sep;
+    if (ssep->len_b == 0) return ks_throw(ks_T_ArgError, "Empty separator");
+    if (maxsplit < 0) maxsplit = KS_SSIZE_MAX;
+
+    str_search_t srch;
+    str_search_init(&srch, ssep->chr, ssep->len_b);
+
+    // count the pieces first, so the list can be allocated exactly
+    ks_ssize_t n = 1, p = 0, r;
+    while (n <= maxsplit && (r = str_search_find(&srch, self->chr + p, self->len_b - p)) >= 0) {
+        n++;
+        p += r + ssep->len_b;
+    }
+
+    ks_list ret = str_list_presize(n);
+
+    p = 0;
+    while (ret->len < n - 1) {
+        r = str_search_find(&srch, self->chr + p, self->len_b - p);
+        ret->elems[ret->len++] = (ks_obj)ks_str_substr_b(self, p, r);
+        p += r + ssep->len_b;
+    }
+    ret->elems[ret->len++] = (ks_obj)ks_str_substr_b(self, p, self->len_b - p);
+
+    return (ks_obj)ret;
+}
+
+// str.rsplit(self, sep=none, maxsplit=-1) - split on 'sep' (or on runs of whitespace, if 'sep' is none), making at
+//   most 'maxsplit' splits (starting from the right) if 'maxsplit>=0'
+static KS_TFUNC(str, rsplit) {
+    ks_str self;
+    ks_obj sep = KSO_NONE;
+    int64_t maxsplit = -1;
+    KS_GETARGS("self:* ?sep ?maxsplit:i64", &self, ks_T_str, &sep, &maxsplit)
+
+    if (sep == KSO_NONE) return str_split_ws(self, maxsplit, true);
+    else if (sep->type != ks_T_str) KS_THROW_TYPE_ERR(sep, ks_T_str);
+
+    ks_str ssep = (ks_str)sep;
+    if (ssep->len_b == 0) return ks_throw(ks_T_ArgError, "Empty separator");
+    if (maxsplit < 0) maxsplit = KS_SSIZE_MAX;
+
+    // count the pieces first, so the list can be allocated exactly
+    ks_ssize_t n = 1, q = self->len_b, r;
+    while (n <= maxsplit && (r = str_search_rfind(self->chr, q, ssep->chr, ssep->len_b)) >= 0) {
+        n++;
+        q = r;
+    }
+
+    ks_list ret = str_list_presize(n);
+
+    // fill in backwards
+    ks_ssize_t i;
+    q = self->len_b;
+    for (i = n - 1; i > 0; --i) {
+        r = str_search_rfind(self->chr, q, ssep->chr, ssep->len_b);
+        ret->elems[i] = (ks_obj)ks_str_substr_b(self, r + ssep->len_b, q - r - ssep->len_b);
+        q = r;
+    }
+    ret->elems[0] = (ks_obj)ks_str_substr_b(self, 0, q);
+    ret->len = n;
+
+    return (ks_obj)ret;
+}
+
+// find the end of the line starting at 'p' (i.e. the index of the line break, or 'len'), and set '*eol' to
+//   the length of the line break ('\n', '\r', or '\r\n')
+static ks_ssize_t str_lineend(const char* s, ks_ssize_t len, ks_ssize_t p, bool hasCR, int* eol) {
+    ks_ssize_t q;
+    if (!hasCR) {
+        // only '\n' can end lines
+        const char* nl = memchr(s + p, '\n', len - p);
+        q = nl ? nl - s : len;
+    } else {
+        q = p;
+        while (q < len && s[q] != '\n' && s[q] != '\r') q++;
+    }
+
+    /**/ if (q >= len) *eol = 0;
+    else if (s[q] == '\r' && q + 1 < len && s[q + 1] == '\n') *eol = 2;
+    else *eol = 1;
+
+    return q;
+}
+
+// str.splitlines(self, keepends=false) - split into lines, optionally keeping the line breaks
+static KS_TFUNC(str, splitlines) {
+    ks_str self;
+    ks_obj keepends = KSO_FALSE;
+    KS_GETARGS("self:* ?keepends", &self, ks_T_str, &keepends)
+
+    int keep = ks_obj_truthy(keepends);
+    if (keep < 0) return NULL;
+
+    const char* s = self->chr;
+    ks_ssize_t len = self->len_b, p, q, n = 0;
+    bool hasCR = memchr(s, '\r', len) != NULL;
+    int eol;
+
+    // count the lines first
+    for (p = 0; p < len; p = q + eol) {
+        q = str_lineend(s, len, p, hasCR, &eol);
+        n++;
+    }
+
+    ks_list ret = str_list_presize(n);
+
+    for (p = 0; p < len; p = q + eol) {
+        q = str_lineend(s, len, p, hasCR, &eol);
+        ret->elems[ret->len++] = (ks_obj)ks_str_substr_b(self, p, q - p + (keep ? eol : 0));
+    }
+
+    return (ks_obj)ret;
+}
+
+// return whether 'c' is one of the 'n' characters in 'cps'
+static bool str_strip_has(ks_unich* cps, ks_ssize_t n, ks_unich c) {
+    ks_ssize_t i;
+    for (i = 0; i < n; ++i) if (cps[i] == c) return true;
+    return false;
+}
+
+// strip characters from either side of 'self', returning the result. If 'chars' is none, whitespace is stripped
+static ks_obj str_strip_impl(ks_str self, ks_obj chars, bool left, bool right) {
+    ks_ssize_t p = 0, q = self->len_b;
+    const char* s = self->chr;
+
+    if (chars == KSO_NONE) {
+        if (left) while (p < q && str_isspace(s[p])) p++;
+        if (right) while (q > p && str_isspace(s[q - 1])) q--;
+    } else if (chars->type != ks_T_str) {
+        KS_THROW_TYPE_ERR(chars, ks_T_str);
+    } else if (KS_STR_ISASCII((ks_str)chars)) {
+        // build a table of which bytes to strip (which only match ASCII characters in 'self')
+        bool tbl[256] = { false };
+        ks_ssize_t i;
+        for (i = 0; i < ((ks_str)chars)->len_b; ++i) tbl[(uint8_t)((ks_str)chars)->chr[i]] = true;
+
+        if (left) while (p < q && tbl[(uint8_t)s[p]]) p++;
+        if (right) while (q > p && tbl[(uint8_t)s[q - 1]]) q--;
+    } else {
+        // decode the characters to strip
+        ks_str cs = (ks_str)chars;
+        ks_unich* cps = ks_malloc(sizeof(*cps) * cs->len_c);
+        ks_text_utf8_to_utf32(cs->chr, cps, cs->len_c);
+
+        ks_ssize_t sz;
+        ks_unich c;
+
+        if (left) while (p < q && (sz = ks_text_utf8_to_utf32(s + p, &c, 1)) > 0 && str_strip_has(cps, cs->len_c, c)) p += sz;
+        if (right) while (q > p) {
+            // find the start of the last character
+            ks_ssize_t st = q - 1;
+            while (st > p && (s[st] & 0xC0) == 0x80) st--;
+            if (ks_text_utf8_to_utf32(s + st, &c, 1) < 0 || !str_strip_has(cps, cs->len_c, c)) break;
+            q = st;
+        }
+
+        ks_free(cps);
+    }
+
+    return (ks_obj)ks_str_substr_b(self, p, q - p);
+}
+
+// str.strip(self, chars=none) - remove characters in 'chars' (default: whitespace) from both ends
+static KS_TFUNC(str, strip) {
+    ks_str self;
+    ks_obj chars = KSO_NONE;
+    KS_GETARGS("self:* ?chars", &self, ks_T_str, &chars)
+
+    return str_strip_impl(self, chars, true, true);
+}
+
+// str.lstrip(self, chars=none) - remove characters in 'chars' (default: whitespace) from the start
+static KS_TFUNC(str, lstrip) {
+    ks_str self;
+    ks_obj chars = KSO_NONE;
+    KS_GETARGS("self:* ?chars", &self, ks_T_str, &chars)
+
+    return str_strip_impl(self, chars, true, false);
+}
+
+// str.rstrip(self, chars=none) - remove characters in 'chars' (default: whitespace) from the end
+static KS_TFUNC(str, rstrip) {
+    ks_str self;
+    ks_obj chars = KSO_NONE;
+    KS_GETARGS("self:* ?chars", &self, ks_T_str, &chars)
+
+    return str_strip_impl(self, chars, false, true);
+}
+
+
 
 
 
@@ -1104,6 +2074,14 @@ static KS_TFUNC(str, iter) {
 
 
 
+// buffer protocol: the UTF-8 bytes of the string
+static bool str_getbuf(ks_obj self, ks_buffer* buf, int flags) {
+    ks_str s = (ks_str)self;
+    ks_buffer_init_bytes(buf, self, s->chr, s->len_b, true);
+    return true;
+}
+
+
 /* export */
 
 KS_TYPE_DECLFWD(ks_T_str);
@@ -1117,6 +2095,8 @@ void ks_init_T_str() {
         ks_str tc = &KS_STR_CHARS[i];
         KS_INIT_OBJ(tc, ks_T_str);
         tc->len_c = tc->len_b = i == 0 ? 0 : 1;
+        tc->src = NULL;
+        tc->chr = tc->_chr;
 
         tc->chr[0] = (char)i;
         tc->chr[1] = '\0';
@@ -1150,11 +2130,25 @@ void ks_init_T_str() {
         {"endswith",             (ks_obj)ks_cfunc_new_c_old(str_endswith_, "str.endswith(self, val)")},
 
         {"substr",                 (ks_obj)ks_cfunc_new_c_old(str_substr_, "str.substr(self, start, len=none)")},
+
+        {"find",                   (ks_obj)ks_cfunc_new_c_old(str_find_, "str.find(self, sub, start=0, end=none)")},
+        {"rfind",                  (ks_obj)ks_cfunc_new_c_old(str_rfind_, "str.rfind(self, sub, start=0, end=none)")},
+        {"count",                  (ks_obj)ks_cfunc_new_c_old(str_count_, "str.count(self, sub, start=0, end=none)")},
+        {"replace",                (ks_obj)ks_cfunc_new_c_old(str_replace_, "str.replace(self, old, new, count=-1)")},
+        {"split",                  (ks_obj)ks_cfunc_new_c_old(str_split_, "str.split(self, sep=none, maxsplit=-1)")},
+        {"rsplit",                 (ks_obj)ks_cfunc_new_c_old(str_rsplit_, "str.rsplit(self, sep=none, maxsplit=-1)")},
+        {"splitlines",             (ks_obj)ks_cfunc_new_c_old(str_splitlines_, "str.splitlines(self, keepends=false)")},
+        {"strip",                  (ks_obj)ks_cfunc_new_c_old(str_strip_, "str.strip(self, chars=none)")},
+        {"lstrip",                 (ks_obj)ks_cfunc_new_c_old(str_lstrip_, "str.lstrip(self, chars=none)")},
+        {"rstrip",                 (ks_obj)ks_cfunc_new_c_old(str_rstrip_, "str.rstrip(self, chars=none)")},
+        {"format",                 (ks_obj)ks_cfunc_new_c_old(str_format_, "str.format(self, *args)")},
         {"join",                   (ks_obj)ks_cfunc_new_c_old(str_join_, "str.join(self, objs)")},
 
 
     ));
 
+    ks_T_str->getbuf = str_getbuf;
+
     ks_type_init_c(ks_T_str_iter, "str_iter", ks_T_object, KS_KEYVALS(
         {"__free__",               (ks_obj)ks_cfunc_new_c_old(str_iter_free_, "str_iter.__free__(self)")},
         {"__next__",               (ks_obj)ks_cfunc_new_c_old(str_iter_next_, "str_iter.__next__(self)")},
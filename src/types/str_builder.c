@@ -34,6 +34,20 @@ typedef struct {
 
 #define KSFMT_DFT ((ksfmt_t) { .isLeft = false, .hasPlus = false, .hasSpace = false, .hasZero = false, .width = -1, .base = 10 })
 
+
+/* Tuning/Performance parameters */
+
+// minimum capacity (in bytes) of a string builder's buffer, once anything has been added
+#define KS_STR_BUILDER_MIN 32
+
+// maximum number of pieces of a C format string that are compiled at once (longer format strings are done in
+//   several batches)
+#define KS_FMT_MAX_OPS 16
+
+// number of compiled `str.format()` strings that are cached
+#define KS_FMT_CACHE 64
+
+
 // construct a new string builder
 ks_str_builder ks_str_builder_new() {
     ks_str_builder self = KS_ALLOC_OBJ(ks_str_builder);
@@ -41,23 +55,41 @@ ks_str_builder ks_str_builder_new() {
 
 
     self->len = 0;
-    self->data = NULL;
+    self->max_len = 0;
+    self->buf = NULL;
 
     return self;
 
 }
 
+// Make sure there is room for 'extra' more bytes, growing the buffer geometrically (so that adding 'N' bytes is
+//   amortized O(N))
+// NOTE: Returns success
+static bool sb_reserve(ks_str_builder self, ks_size_t extra) {
+    if (self->len + extra <= self->max_len) return true;
+
+    ks_size_t new_max_len = 2 * self->max_len;
+    if (new_max_len < KS_STR_BUILDER_MIN) new_max_len = KS_STR_BUILDER_MIN;
+    if (new_max_len < self->len + extra) new_max_len = self->len + extra;
+
+    // NOTE: `sizeof(*self->buf)` has room for the NUL-terminator
+    ks_str new_buf = ks_realloc(self->buf, sizeof(*self->buf) + new_max_len);
+    if (!new_buf) return false;
+
+    self->buf = new_buf;
+    self->max_len = new_max_len;
+
+    return true;
+}
+
 // Add raw bytes to the string builder
 // NOTE: Returns success
 bool ks_str_builder_add(ks_str_builder self, void* data, ks_size_t len) {
+    if (!sb_reserve(self, len)) return false;
 
-    int idx = self->len;
+    memcpy(self->buf->_chr + self->len, data, len);
     self->len += len;
 
-    self->data = ks_realloc(self->data, self->len);
-
-    memcpy((void*)((intptr_t)self->data + idx), data, len);
-
     return true;
 }
 
@@ -72,52 +104,53 @@ static bool ks_is_field(char c) {
 // digits used for base formatting
 static const char bfmt_digs[] = "0123456789abcdef";
 
-// internal buffer reversing on a buffer, reverses '0' through 'n-1' (inclusive)
-static void bfmt_rev(char* buf, int n) {
-    int i;
-    for (i = 0; 2 * i < n; ++i) {
-        char tmp = buf[i];
-        buf[i] = buf[n - i - 1];
-        buf[n - i - 1] = tmp;
-    }
-}
-
-
+// Add 'val' formatted with 'ksfmt', where the width includes the sign, and zero padding goes after the sign (which
+//   is the same output as `int.__fmt__()`)
 static bool add_i64(ks_str_builder sb, ksfmt_t ksfmt, int64_t val) {
-    char buf[256];
+    char buf[64];
 
-    // buffer pointer
-    int bp = 0;
-
-    bool is_neg = val < 0;
-    if (is_neg) val = -val;
+    if (ksfmt.base == 10 && ksfmt.width < 0 && !ksfmt.hasPlus && !ksfmt.hasSpace) {
+        // the common case, 2 digits at a time
+        return ks_str_builder_add(sb, buf, ks_num_fmt_int64(buf, val));
+    }
 
     // ensure the base is representable
     assert (ksfmt.base <= sizeof(bfmt_digs) - 1);
 
+    char sign = val < 0 ? '-' : ksfmt.hasPlus ? '+' : ksfmt.hasSpace ? ' ' : '\0';
+
+    // the magnitude, which is correct for the most negative value as well
+    uint64_t mag = val < 0 ? -(uint64_t)val : (uint64_t)val;
+
     // add digits, which will be in reverse order
+    int nd = 0;
     do {
-        buf[bp++] = bfmt_digs[val % ksfmt.base];
-        val /= ksfmt.base;
-    } while (bp < sizeof(buf) - 1 && val > 0);
+        buf[nd++] = bfmt_digs[mag % ksfmt.base];
+        mag /= ksfmt.base;
+    } while (mag > 0);
 
-    if (ksfmt.width > 0) while (bp < 255 - 1 && bp < ksfmt.width) {
-        buf[bp++] = ksfmt.hasZero ? '0' : ' ';
-    }
+    int len = nd + (sign != '\0');
+    int pad = ksfmt.width > len ? ksfmt.width - len : 0;
 
+    if (!sb_reserve(sb, len + pad)) return false;
+    char* p = sb->buf->_chr + sb->len;
 
-    // add negative sign to the end, which will be reversed
-    if (is_neg) buf[bp++] = '-';
-    else {
-        if (ksfmt.hasPlus) buf[bp++] = '+';
-        else if (ksfmt.hasSpace) buf[bp++] = ' ';
+    if (!ksfmt.isLeft && !ksfmt.hasZero) {
+        memset(p, ' ', pad);
+        p += pad;
+    }
+    if (sign != '\0') *p++ = sign;
+    if (!ksfmt.isLeft && ksfmt.hasZero) {
+        memset(p, '0', pad);
+        p += pad;
+    }
+    while (nd > 0) *p++ = buf[--nd];
+    if (ksfmt.isLeft) {
+        memset(p, ' ', pad);
+        p += pad;
     }
-    // reverse the buffer, since digits come out in opposite order
-    bfmt_rev(buf, bp);
-
-    ks_str_builder_add(sb, buf, bp);
 
-    // the next character would be here
+    sb->len = p - sb->buf->_chr;
     return true;
 }
 
@@ -137,6 +170,11 @@ bool ks_str_builder_add_str(ks_str_builder self, ks_obj obj) {
         // handle short integer
         return add_i64(self, KSFMT_DFT, ((ks_int)obj)->v64);
 
+    } else if (obj->type == ks_T_float) {
+        // handle float, without creating a string
+        char buf[KS_NUM_FMT_MAX];
+        return ks_str_builder_add(self, buf, ks_num_fmt_double(buf, ((ks_float)obj)->val));
+
     } else if (obj->type->__str__ != NULL) {
         ks_str obj_str = (ks_str)ks_obj_call(obj->type->__str__, 1, &obj);
         if (!obj_str) return false;
@@ -170,6 +208,11 @@ bool ks_str_builder_add_repr(ks_str_builder self, ks_obj obj) {
         KS_DECREF(esc);
 
         return true;
+    } else if (obj->type == ks_T_int && !((ks_int)obj)->isLong) {
+        return add_i64(self, KSFMT_DFT, ((ks_int)obj)->v64);
+    } else if (obj->type == ks_T_float) {
+        char buf[KS_NUM_FMT_MAX];
+        return ks_str_builder_add(self, buf, ks_num_fmt_double(buf, ((ks_float)obj)->val));
     }
 
     if (obj->type->__repr__ != NULL) {
@@ -183,208 +226,338 @@ bool ks_str_builder_add_repr(ks_str_builder self, ks_obj obj) {
     }
 }
 
-// add format
-// based roughly on: https://en.wikipedia.org/wiki/Printf_format_string
-bool ks_str_builder_add_vfmt(ks_str_builder self, const char* fmt, va_list ap) {
 
-    // original format
-    const char* ofmt = fmt;
+/* C format strings */
 
-    // maximum field size
-    #define MAX_FIELD 256
+// a compiled piece of a C format string, which is some literal text, followed by a specifier (unless 'c' is '\0')
+typedef struct {
 
-    // field temporary
-    char field[MAX_FIELD];
+    // the literal text before the specifier
+    const char* lit;
+    ks_size_t n_lit;
 
-    // return status
-    bool rst = false;
+    // the specifier character, i.e. 'i' for '%i'
+    char c;
 
-    // keep looping while we have more formatting strings to go
-    while (*fmt) {
+    // whether the width is given as an argument ('*'), and whether it was '%+z' (which takes an array)
+    bool star, multi;
 
-        // starting place
-        const char* sp = fmt;
+    // the flags and width
+    ksfmt_t f;
 
-        // advance the formatter to the next '%' (or the end)
-        while (*fmt && fmt[0] != '%') fmt++;
+    // for '%s', the number of bytes to add (which is measured while sizing the output)
+    ks_size_t n;
 
-        // add those bytes to the builder
-        ks_str_builder_add(self, (void*)sp, fmt - sp);
+} vfmt_op;
 
-        // break out if we hit the end
-        if (!*fmt) break;
+// Compile up to 'max_ops' pieces of 'fmt' into 'ops', setting '*end' to where it stopped
+// NOTE: Returns the number of pieces
+static int vfmt_compile(const char* fmt, vfmt_op* ops, int max_ops, const char** end) {
+    int n = 0;
+
+    while (*fmt && n < max_ops) {
+        vfmt_op* op = &ops[n++];
+        op->c = '\0';
+        op->f = KSFMT_DFT;
+        op->star = op->multi = false;
 
-        // skip '%'
-        fmt++;
+        // the literal text runs until the next '%' (or the end)
+        const char* p = strchr(fmt, '%');
+        op->lit = fmt;
+        if (!p) {
+            op->n_lit = strlen(fmt);
+            fmt += op->n_lit;
+            break;
+        }
+        op->n_lit = p - fmt;
+        fmt = p + 1;
 
-        // if we have '%%', just do a single one and keep on going
+        // '%%' is just a single '%', so keep it as part of the literal text
         if (*fmt == '%') {
-            ks_str_builder_add(self, "%", 1);
+            op->n_lit++;
             fmt++;
             continue;
         }
 
+        // otherwise, it is '%<field><c>', so parse the field
+        for (;; fmt++) {
+            /**/ if (*fmt == '-') op->f.isLeft = true;
+            else if (*fmt == '+') op->f.hasPlus = true;
+            else if (*fmt == ' ') op->f.hasSpace = true;
+            else if (*fmt == '0') op->f.hasZero = true;
+            else break;
+        }
 
-        // current pos into 'field'
-        int i = 0;
+        if (*fmt == '*') {
+            op->star = true;
+            fmt++;
+        } else if (isdigit(*fmt)) {
+            op->f.width = 0;
+            while (isdigit(*fmt)) op->f.width = 10 * op->f.width + (*fmt++ - '0');
+        }
 
-        // otherwise, it is '%<field><c>', so we need to parse the field
-        while (ks_is_field(*fmt) && i < MAX_FIELD - 1) {
-            field[i++] = *fmt++;
+        // skip anything else in the field, although a '*' anywhere means the width is an argument (i.e. '%.*s')
+        while (ks_is_field(*fmt)) {
+            if (*fmt == '*') op->star = true;
+            fmt++;
         }
-        field[i] = '\0';
 
-        // now, get the single character formatter
-        char c = *fmt++;
+        if (!*fmt) break;
+        op->c = *fmt++;
 
+        if (op->c == 'z' && op->f.hasPlus) {
+            // '%+z' is a list of sizes
+            op->multi = true;
+            op->f.hasPlus = false;
+        }
+    }
 
-        ksfmt_t ksfmt = KSFMT_DFT;
-        ksfmt.hasZero = strchr(field, '0') != NULL;
-        ksfmt.hasPlus = strchr(field, '+') != NULL;
-        ksfmt.hasSpace = strchr(field, ' ') != NULL;
-        ksfmt.isLeft = strchr(field, '-') != NULL;
+    *end = fmt;
+    return n;
+}
 
-        // read width
-        if (strchr(field, '*') != NULL) {
-            ksfmt.width = va_arg(ap, int);
-        } else {
-            ksfmt.width = -1;
+// Estimate the number of bytes 'obj' adds for '%S' or '%R'
+static ks_size_t vfmt_size_obj(ks_obj obj) {
+    if (obj->type == ks_T_str) return ((ks_str)obj)->len_b;
+    else if (obj->type == ks_T_float) return KS_NUM_FMT_MAX;
+    else return 20;
+}
+
+// Estimate the number of bytes that 'n' compiled pieces will add, taking their arguments from 'ap'
+static ks_size_t vfmt_size(vfmt_op* ops, int n, va_list ap) {
+    ks_size_t sz = 0;
+
+    int i, j;
+    for (i = 0; i < n; ++i) {
+        vfmt_op* op = &ops[i];
+        sz += op->n_lit;
+
+        int width = op->star ? va_arg(ap, int) : op->f.width;
+        if (width > 0 && op->c != 's') sz += width;
+
+        switch (op->c) {
+            case '\0':
+                break;
+            case 'i':
+                va_arg(ap, int);
+                sz += 20;
+                break;
+            case 'l':
+                va_arg(ap, int64_t);
+                sz += 20;
+                break;
+            case 'z':
+                if (op->multi) {
+                    int num = va_arg(ap, int);
+                    va_arg(ap, ks_ssize_t*);
+                    sz += 21 * num;
+                } else {
+                    va_arg(ap, ks_size_t);
+                    sz += 20;
+                }
+                break;
+            case 'f':
+                va_arg(ap, double);
+                sz += KS_NUM_FMT_MAX;
+                break;
+            case 'p':
+                va_arg(ap, void*);
+                sz += 18;
+                break;
+            case 'c':
+                va_arg(ap, int);
+                sz += 1;
+                break;
+            case 's': {
+                const char* val = va_arg(ap, const char*);
+                op->n = width < 0 ? strlen(val) : width;
+                sz += op->n;
+                break;
+            }
+            case 'O':
+            case 'T': {
+                ks_obj val = va_arg(ap, ks_obj);
+                sz += val->type->__name__->len_b + (op->c == 'O' ? 32 : 0);
+                break;
+            }
+            case 'S':
+            case 'R': {
+                ks_obj val = va_arg(ap, ks_obj);
+                sz += vfmt_size_obj(val) + (op->c == 'R' ? 2 : 0);
+                break;
+            }
+            case 'A': {
+                int ct = va_arg(ap, int);
+                ks_obj* val = va_arg(ap, ks_obj*);
+                for (j = 0; j < ct; ++j) sz += 1 + vfmt_size_obj(val[j]);
+                break;
+            }
+            default:
+                // unknown specifier, which is reported when the output is added (and nothing past it can be sized)
+                return sz;
         }
+    }
 
+    return sz;
+}
 
-        if (c == 'i') {
-            // %i -> base 10 integer, from C 'int'
-            int val = va_arg(ap, int);
+// add format
+// based roughly on: https://en.wikipedia.org/wiki/Printf_format_string
+// The format string is compiled (in batches of 'KS_FMT_MAX_OPS' pieces) into a list of literal text and specifiers,
+//   the arguments are walked once to size the output (so the buffer is usually allocated just once), and then the
+//   pieces are added in order
+bool ks_str_builder_add_vfmt(ks_str_builder self, const char* fmt, va_list ap) {
 
-            add_i64(self, ksfmt, val);
+    // original format
+    const char* ofmt = fmt;
 
-        } else if (c == 'l') {
-            // %i -> base 10 integer, from C 'int64_t'
-            int64_t val = va_arg(ap, int64_t);
+    // compiled pieces
+    vfmt_op ops[KS_FMT_MAX_OPS];
 
-            add_i64(self, ksfmt, val);
+    // keep looping while we have more formatting strings to go
+    while (*fmt) {
 
-        } else if (c == 'z') {
-            // %z -> base 10 integer, from a 'ks_size_t'
+        int n = vfmt_compile(fmt, ops, KS_FMT_MAX_OPS, &fmt);
 
-            bool doMult = strchr(field, '+') != NULL;
+        va_list ap_size;
+        va_copy(ap_size, ap);
+        ks_size_t sz = vfmt_size(ops, n, ap_size);
+        va_end(ap_size);
 
-            if (doMult) {
+        if (!sb_reserve(self, sz)) return false;
 
-                int num = va_arg(ap, int);
-                ks_ssize_t* vals = va_arg(ap, ks_ssize_t*);
-                ksfmt.hasPlus = false;
+        int i, j;
+        for (i = 0; i < n; ++i) {
+            vfmt_op* op = &ops[i];
 
-                int i;
-                for (i = 0; i < num; ++i) {
-                    if (i != 0) {
-                        ks_str_builder_add(self, ",", 1);
-                    }
+            // add the literal text
+            if (op->n_lit > 0 && !ks_str_builder_add(self, (void*)op->lit, op->n_lit)) return false;
 
-                    add_i64(self, ksfmt, vals[i]);
-                }
+            // read width
+            ksfmt_t ksfmt = op->f;
+            if (op->star) ksfmt.width = va_arg(ap, int);
 
-            } else {
+            char c = op->c;
 
-                ks_size_t val = va_arg(ap, ks_size_t);
+            if (c == '\0') {
+                // just literal text
 
-                add_i64(self, ksfmt, val);
+            } else if (c == 'i') {
+                // %i -> base 10 integer, from C 'int'
+                int val = va_arg(ap, int);
 
-            }
+                if (!add_i64(self, ksfmt, val)) return false;
 
+            } else if (c == 'l') {
+                // %l -> base 10 integer, from C 'int64_t'
+                int64_t val = va_arg(ap, int64_t);
 
+                if (!add_i64(self, ksfmt, val)) return false;
 
-        } else if (c == 'p') {
-            // %i -> base 10 integer, from C 'int'
-            void* val = va_arg(ap, void*);
+            } else if (c == 'z') {
+                // %z -> base 10 integer, from a 'ks_size_t'
 
-            ksfmt.base = 16;
+                if (op->multi) {
+                    // %+z -> comma seperated list of integers, from an 'int' count and 'ks_ssize_t*' array
 
-            ks_str_builder_add(self, "0x", 2);
-            add_i64(self, ksfmt, (int64_t)val);
+                    int num = va_arg(ap, int);
+                    ks_ssize_t* vals = va_arg(ap, ks_ssize_t*);
 
-        } else if (c == 'c') {
-            // %c -> char
-            char val = (char)va_arg(ap, int);
+                    for (j = 0; j < num; ++j) {
+                        if (j != 0) {
+                            ks_str_builder_add(self, ",", 1);
+                        }
 
-            if (ksfmt.width < 0) ksfmt.width = 1;
+                        if (!add_i64(self, ksfmt, vals[j])) return false;
+                    }
 
-            int i;
-            for (i = 0; i < ksfmt.width; ++i) ks_str_builder_add(self, &val, 1);
+                } else {
 
-        } else if (c == 's') {
-            // %i -> base 10 integer, from C 'int'
-            char* val = va_arg(ap, char*);
+                    ks_size_t val = va_arg(ap, ks_size_t);
 
+                    if (!add_i64(self, ksfmt, val)) return false;
 
-            if (ksfmt.width < 0) ksfmt.width = strlen(val);
+                }
 
-            ks_str_builder_add(self, val, ksfmt.width);
+            } else if (c == 'f') {
+                // %f -> float, from C 'double', using the shortest text that reads back as the same value
+                double val = va_arg(ap, double);
 
-        } else if (c == 'O') {
-            // %O -> add a simplified object format
-            ks_obj val = va_arg(ap, ks_obj);
+                char buf[KS_NUM_FMT_MAX];
+                ks_str_builder_add(self, buf, ks_num_fmt_double(buf, val));
 
-            // attempt to add it
-            if (!ks_str_builder_add_fmt(self, "<'%s' obj @ %p>", val->type->__name__->chr, val)) {
-                goto vfmt_end;
-            }
+            } else if (c == 'p') {
+                // %p -> pointer, in base 16
+                void* val = va_arg(ap, void*);
 
+                ksfmt.base = 16;
 
-        } else if (c == 'T') {
-            // %T -> add just the type name of an object
-            ks_obj val = va_arg(ap, ks_obj);
+                ks_str_builder_add(self, "0x", 2);
+                if (!add_i64(self, ksfmt, (int64_t)val)) return false;
 
-            ks_str_builder_add(self, val->type->__name__->chr, val->type->__name__->len_b);
+            } else if (c == 'c') {
+                // %c -> char
+                char val = (char)va_arg(ap, int);
 
+                if (ksfmt.width < 0) ksfmt.width = 1;
 
-        } else if (c == 'S') {
-            // %S -> add str(obj) to the result
-            ks_obj val = va_arg(ap, ks_obj);
+                for (j = 0; j < ksfmt.width; ++j) ks_str_builder_add(self, &val, 1);
 
-            // attempt to add it
-            if (!ks_str_builder_add_str(self, val)) {
-                goto vfmt_end;
-            }
+            } else if (c == 's') {
+                // %s -> C-style string, which was measured while sizing the output
+                char* val = va_arg(ap, char*);
 
-        } else if (c == 'R') {
-            // %R -> add repr(obj) to the result
-            ks_obj val = va_arg(ap, ks_obj);
+                ks_str_builder_add(self, val, op->n);
 
-            // attempt to add it
-            if (!ks_str_builder_add_repr(self, val)) {
-                goto vfmt_end;
-            }
+            } else if (c == 'O') {
+                // %O -> add a simplified object format
+                ks_obj val = va_arg(ap, ks_obj);
 
-        } else if (c == 'A') {
-            // %A -> add " ".join(objs) to the result
+                // attempt to add it
+                if (!ks_str_builder_add_fmt(self, "<'%s' obj @ %p>", ks_str_cstr(val->type->__name__), val)) return false;
+
+            } else if (c == 'T') {
+                // %T -> add just the type name of an object
+                ks_obj val = va_arg(ap, ks_obj);
 
-            int ct = va_arg(ap, int);
-            ks_obj* val = va_arg(ap, ks_obj*);
+                ks_str_builder_add(self, val->type->__name__->chr, val->type->__name__->len_b);
 
-            int i;
-            for (i = 0; i < ct; ++i) {
-                if (i > 0) ks_str_builder_add(self, " ", 1);
+            } else if (c == 'S') {
+                // %S -> add str(obj) to the result
+                ks_obj val = va_arg(ap, ks_obj);
 
                 // attempt to add it
-                if (!ks_str_builder_add_str(self, val[i])) {
-                    goto vfmt_end;
-                }
+                if (!ks_str_builder_add_str(self, val)) return false;
 
-            }
+            } else if (c == 'R') {
+                // %R -> add repr(obj) to the result
+                ks_obj val = va_arg(ap, ks_obj);
 
-        } else {
+                // attempt to add it
+                if (!ks_str_builder_add_repr(self, val)) return false;
 
-            ks_error("ks", "Unknown format specifier: '%c' in format string '%s'", c, ofmt);
-            goto vfmt_end;
-        }
-    }
+            } else if (c == 'A') {
+                // %A -> add " ".join(objs) to the result
 
-    rst = true;
-    vfmt_end: ;
+                int ct = va_arg(ap, int);
+                ks_obj* val = va_arg(ap, ks_obj*);
 
-    return rst;
+                for (j = 0; j < ct; ++j) {
+                    if (j > 0) ks_str_builder_add(self, " ", 1);
+
+                    // attempt to add it
+                    if (!ks_str_builder_add_str(self, val[j])) return false;
+                }
+
+            } else {
+
+                ks_error("ks", "Unknown format specifier: '%c' in format string '%s'", c, ofmt);
+                return false;
+            }
+        }
+    }
 
+    return true;
 }
 
 // add format
@@ -397,9 +570,369 @@ bool ks_str_builder_add_fmt(ks_str_builder self, const char* fmt, ...) {
 }
 
 
-// return current string
+/* str.format() */
+
+// a compiled piece of a `str.format()` string, which is some literal text, followed by a replacement field (unless
+//   'arg' is negative)
+typedef struct {
+
+    // the literal text before the field, as a byte offset and length into the format string
+    ks_size_t lit_i, lit_n;
+
+    // the index of the argument the field formats, or -1 if there is no field
+    int arg;
+
+    // the conversion, 'r' for '!r', 's' for '!s', or '\0' if none was given
+    char conv;
+
+    // the text after ':', or NULL if there was none
+    ks_str spec;
+
+    // if 'int_spec', then 'spec' is '[flags][width][.prec][type]', and has been parsed into 'f' (the same way
+    //   `int.__fmt__()` does). If 'pad_spec' is also set, it is only the '-' and '0' flags and a width, which can
+    //   pad any text
+    bool int_spec, pad_spec;
+    ksfmt_t f;
+
+} sfmt_field;
+
+// a compiled `str.format()` string
+typedef struct {
+
+    // the format string (a reference is held, so it can be compared by identity)
+    ks_str src;
+
+    // the number of calls that are currently using this program, which is not freed while they are
+    int busy;
+
+    // the total length (in bytes) of the literal text
+    ks_size_t n_lit;
+
+    // the pieces of the format string
+    int n_fields;
+    sfmt_field* fields;
+
+} sfmt_prog;
+
+// the cache of compiled format strings, indexed by their hash
+static sfmt_prog* sfmt_cache[KS_FMT_CACHE];
+
+// Free a compiled format string
+static void sfmt_free(sfmt_prog* prog) {
+    int i;
+    for (i = 0; i < prog->n_fields; ++i) {
+        if (prog->fields[i].spec) KS_DECREF(prog->fields[i].spec);
+    }
+    ks_free(prog->fields);
+    KS_DECREF(prog->src);
+    ks_free(prog);
+}
+
+// Parse the digits at '*p' (advancing past them) into 'out'
+// NOTE: Returns false if the number is too large for an 'int'
+static bool sfmt_digits(const char** p, int* out) {
+    int64_t v = 0;
+    while (isdigit(**p)) {
+        v = 10 * v + (*(*p)++ - '0');
+        if (v > INT32_MAX) return false;
+    }
+    *out = (int)v;
+    return true;
+}
+
+// Parse 'field->spec' (of the format string 'fmt') the same way that `int.__fmt__()` does
+// NOTE: Returns false if an error was thrown
+static bool sfmt_parse_spec(ks_str fmt, sfmt_field* field) {
+    const char* p = field->spec->chr;
+    ksfmt_t f = KSFMT_DFT;
+
+    // flags that were given, and whether there was a precision or type
+    bool seen[4] = { false, false, false, false };
+    bool other = false;
+
+    for (;; p++) {
+        int k = *p == '-' ? 0 : *p == '+' ? 1 : *p == ' ' ? 2 : *p == '0' ? 3 : -1;
+        if (k < 0) break;
+
+        // repeated flags are an error, which `int.__fmt__()` reports
+        if (seen[k] || (k == 1 && seen[2]) || (k == 2 && seen[1])) return true;
+        seen[k] = true;
+    }
+    f.isLeft = seen[0];
+    f.hasPlus = seen[1];
+    f.hasSpace = seen[2];
+    f.hasZero = seen[3];
+
+    if (isdigit(*p) && !sfmt_digits(&p, &f.width)) {
+        ks_throw(ks_T_ArgError, "Invalid format string: %R, width is too large", fmt);
+        return false;
+    }
+    if (*p == '.') {
+        other = true;
+        p++;
+        while (isdigit(*p)) p++;
+    }
+    if (*p == 'i' || *p == 'd') {
+        other = true;
+        p++;
+    } else if (*p == 'x') {
+        other = true;
+        f.base = 16;
+        p++;
+    }
+
+    field->int_spec = *p == '\0';
+    field->pad_spec = field->int_spec && !other && !f.hasPlus && !f.hasSpace;
+    field->f = f;
+    return true;
+}
+
+// Compile a format string for `str.format()`
+// NOTE: Returns the program, or NULL if an error was thrown
+static sfmt_prog* sfmt_compile(ks_str fmt) {
+    sfmt_prog* prog = ks_malloc(sizeof(*prog));
+    prog->src = (ks_str)KS_NEWREF(fmt);
+    prog->busy = 0;
+    prog->n_lit = 0;
+    prog->n_fields = 0;
+    prog->fields = NULL;
+
+    // how fields have been numbered (1 for automatically, 2 for manually), and the next automatic index
+    int numbering = 0, auto_idx = 0, max_fields = 0;
+
+    const char* s = fmt->chr;
+    ks_size_t len = fmt->len_b, i = 0;
+
+    while (true) {
+
+        // the literal text runs until the next '{' or '}' (or the end)
+        ks_size_t j = i;
+        while (j < len && s[j] != '{' && s[j] != '}') j++;
+
+        if (prog->n_fields >= max_fields) {
+            max_fields = max_fields == 0 ? 4 : 2 * max_fields;
+            prog->fields = ks_realloc(prog->fields, sizeof(*prog->fields) * max_fields);
+        }
+        sfmt_field* field = &prog->fields[prog->n_fields++];
+        field->lit_i = i;
+        field->lit_n = j - i;
+        field->arg = -1;
+        field->conv = '\0';
+        field->spec = NULL;
+        field->int_spec = field->pad_spec = false;
+        prog->n_lit += field->lit_n;
+
+        if (j >= len) break;
+
+        if (j + 1 < len && s[j + 1] == s[j]) {
+            // '{{' or '}}', so the first of them is part of the literal text
+            field->lit_n++;
+            prog->n_lit++;
+            i = j + 2;
+            continue;
+        }
+
+        if (s[j] == '}') {
+            ks_throw(ks_T_ArgError, "Invalid format string: %R, single '}' encountered", fmt);
+            sfmt_free(prog);
+            return NULL;
+        }
+
+        // parse '{[index][!conv][:spec]}' (the string is NUL-terminated, so looking one past the end is fine)
+        ks_size_t k = j + 1;
+        int kind = 1;
+        if (isdigit(s[k])) {
+            kind = 2;
+            const char* p = s + k;
+            if (!sfmt_digits(&p, &field->arg)) {
+                ks_throw(ks_T_ArgError, "Invalid format string: %R, field index is too large", fmt);
+                sfmt_free(prog);
+                return NULL;
+            }
+            k = p - s;
+        } else {
+            field->arg = auto_idx++;
+        }
+
+        if (numbering != 0 && numbering != kind) {
+            ks_throw(ks_T_ArgError, "Invalid format string: %R, cannot switch between automatic and manual field numbering", fmt);
+            sfmt_free(prog);
+            return NULL;
+        }
+        numbering = kind;
+
+        if (s[k] == '!') {
+            k++;
+            if (s[k] != 'r' && s[k] != 's') {
+                ks_throw(ks_T_ArgError, "Invalid format string: %R, unknown conversion (expected '!r' or '!s')", fmt);
+                sfmt_free(prog);
+                return NULL;
+            }
+            field->conv = s[k++];
+        }
+
+        if (s[k] == ':') {
+            ks_size_t st = ++k;
+            while (k < len && s[k] != '}') k++;
+            if (k > st) {
+                field->spec = ks_str_new_c(s + st, k - st);
+                if (!sfmt_parse_spec(fmt, field)) {
+                    sfmt_free(prog);
+                    return NULL;
+                }
+            }
+        }
+
+        if (k >= len || s[k] != '}') {
+            ks_throw(ks_T_ArgError, "Invalid format string: %R, expected '}' to end a field", fmt);
+            sfmt_free(prog);
+            return NULL;
+        }
+
+        i = k + 1;
+    }
+
+    return prog;
+}
+
+// Pad the text added since the byte offset 'st' to the width in 'f' (on the left, unless the '-' flag was given)
+static bool sfmt_pad(ks_str_builder self, ks_size_t st, ksfmt_t f) {
+    ks_ssize_t len_c = self->len > st ? ks_text_utf8_len_c(self->buf->_chr + st, self->len - st) : 0;
+    if (len_c >= f.width) return true;
+
+    ks_size_t pad = f.width - len_c;
+    if (!sb_reserve(self, pad)) return false;
+
+    char* p = self->buf->_chr;
+    if (f.isLeft) {
+        memset(p + self->len, ' ', pad);
+    } else {
+        memmove(p + st + pad, p + st, self->len - st);
+        memset(p + st, f.hasZero ? '0' : ' ', pad);
+    }
+    self->len += pad;
+
+    return true;
+}
+
+// Add the output of a compiled format string
+static bool sfmt_exec(ks_str_builder self, sfmt_prog* prog, int n_args, ks_obj* args) {
+
+    // size the output first, from the literal text and the lengths of string arguments
+    ks_size_t sz = prog->n_lit;
+    int i;
+    for (i = 0; i < prog->n_fields; ++i) {
+        sfmt_field* field = &prog->fields[i];
+        if (field->arg < 0) continue;
+        if (field->arg >= n_args) {
+            ks_throw(ks_T_ArgError, "Format string %R needs argument #%i, but only %i were given", prog->src, field->arg, n_args);
+            return false;
+        }
+
+        ks_obj obj = args[field->arg];
+        sz += obj->type == ks_T_str ? ((ks_str)obj)->len_b : 8;
+        if (field->spec && field->f.width > 0) sz += field->f.width;
+    }
+
+    if (!sb_reserve(self, sz)) return false;
+
+    for (i = 0; i < prog->n_fields; ++i) {
+        sfmt_field* field = &prog->fields[i];
+
+        // add the literal text
+        if (field->lit_n > 0) {
+            if (!ks_str_builder_add(self, prog->src->chr + field->lit_i, field->lit_n)) return false;
+        }
+
+        if (field->arg < 0) continue;
+        ks_obj obj = args[field->arg];
+
+        if (!field->spec) {
+            // just str() or repr()
+            if (!(field->conv == 'r' ? ks_str_builder_add_repr(self, obj) : ks_str_builder_add_str(self, obj))) return false;
+
+        } else if (!field->conv && field->int_spec && obj->type == ks_T_int && !((ks_int)obj)->isLong) {
+            // short integers are formatted directly, with the same output as `int.__fmt__()`
+            if (!add_i64(self, field->f, ((ks_int)obj)->v64)) return false;
+
+        } else if (!field->conv && obj->type->__fmt__ != NULL) {
+            // the type formats itself
+            ks_obj fargs[2] = { obj, (ks_obj)field->spec };
+            ks_obj res = ks_obj_call(obj->type->__fmt__, 2, fargs);
+            if (!res) return false;
+
+            bool rst = ks_str_builder_add_str(self, res);
+            KS_DECREF(res);
+            if (!rst) return false;
+
+        } else if (field->pad_spec) {
+            // add the text, and then pad it
+            ks_size_t st = self->len;
+            if (!(field->conv == 'r' ? ks_str_builder_add_repr(self, obj) : ks_str_builder_add_str(self, obj))) return false;
+            if (!sfmt_pad(self, st, field->f)) return false;
+
+        } else {
+            ks_throw(ks_T_ArgError, "Invalid format string: %R, for '%T' object", field->spec, obj);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Add `fmt.format(*args)` to the string builder
+// The format string is compiled once, and kept in a cache keyed by its hash (which is checked by identity first, so
+//   a format string that is a constant in the code never has to be compared byte by byte)
+bool ks_str_builder_add_format(ks_str_builder self, ks_str fmt, int n_args, ks_obj* args) {
+
+    sfmt_prog** slot = &sfmt_cache[fmt->v_hash % KS_FMT_CACHE];
+    sfmt_prog* prog = *slot;
+
+    // whether 'prog' is kept in the cache
+    bool cached = true;
+
+    if (!prog || (prog->src != fmt && (prog->src->v_hash != fmt->v_hash || prog->src->len_b != fmt->len_b || memcmp(prog->src->chr, fmt->chr, fmt->len_b) != 0))) {
+        prog = sfmt_compile(fmt);
+        if (!prog) return false;
+
+        if (*slot && (*slot)->busy > 0) {
+            // the entry is being used further up the stack (i.e. by a '__str__' that formats), so leave it alone
+            cached = false;
+        } else {
+            if (*slot) sfmt_free(*slot);
+            *slot = prog;
+        }
+    }
+
+    prog->busy++;
+    bool rst = sfmt_exec(self, prog, n_args, args);
+    prog->busy--;
+
+    if (!cached) sfmt_free(prog);
+
+    return rst;
+}
+
+
+// return current string, handing over the buffer
 ks_str ks_str_builder_get(ks_str_builder self) {
-    return ks_str_new_c(self->data, self->len);
+    if (!self->buf) return ks_str_new_c(NULL, 0);
+
+    ks_str buf = self->buf;
+
+    // trim excess capacity, which usually does not move the memory
+    if (self->max_len > self->len + self->len / 4) {
+        ks_str new_buf = ks_realloc(buf, sizeof(*buf) + self->len);
+        if (new_buf) buf = new_buf;
+    }
+
+    self->buf = NULL;
+    self->max_len = 0;
+
+    ks_str ret = ks_str_adopt(buf, self->len);
+    self->len = 0;
+
+    return ret;
 }
 
 // str_builder.__free__(self) -> free obj
@@ -407,7 +940,7 @@ static KS_TFUNC(str_builder, free) {
     ks_str_builder self;
     KS_GETARGS("self:*", &self, ks_T_str_builder)
 
-    ks_free(self->data);
+    ks_free(self->buf);
 
     KS_UNINIT_OBJ(self);
     KS_FREE_OBJ(self);
@@ -14,6 +14,7 @@ ks_tuple ks_tuple_new(int len, ks_obj* elems) {
 
     // initialize type-specific things
     self->len = len;
+    self->v_hash = 0;
 
     int i;
     // and populate the array
@@ -34,6 +35,7 @@ ks_tuple ks_tuple_new_n(int len, ks_obj* elems) {
 
     // initialize type-specific things
     self->len = len;
+    self->v_hash = 0;
 
     int i;
     if (elems != NULL) {
@@ -52,6 +54,48 @@ ks_tuple ks_tuple_new_n(int len, ks_obj* elems) {
     return self;
 }
 
+// Calculate (and cache) the hash of a tuple
+bool ks_tuple_hash(ks_tuple self, ks_hash_t* out) {
+    if (self->v_hash != 0) {
+        *out = self->v_hash;
+        return true;
+    }
+
+    ks_hash_t hash = 0;
+
+    ks_size_t i;
+    for (i = 0; i < self->len; ++i) {
+        ks_hash_t chash;
+        if (!ks_obj_hash(self->elems[i], &chash)) return false;
+
+        hash = (hash ^ chash) * KS_HASH_MUL + KS_HASH_ADD;
+    }
+
+    // 0 is reserved for 'not computed'
+    if (hash == 0) hash = 1;
+
+    *out = self->v_hash = hash;
+    return true;
+}
+
+// Return whether two tuples are equal
+bool ks_tuple_eq(ks_tuple L, ks_tuple R) {
+    if (L == R) return true;
+    if (L->len != R->len) return false;
+
+    // if both hashes have been computed, they can rule out equality quickly
+    if (L->v_hash != 0 && R->v_hash != 0 && L->v_hash != R->v_hash) return false;
+
+    ks_size_t i;
+    for (i = 0; i < L->len; ++i) {
+        ks_obj a = L->elems[i], b = R->elems[i];
+        if (a != b && !ks_obj_eq(a, b)) return false;
+    }
+
+    return true;
+}
+
+
 // Build a tuple from C-style variables
 // For example, `ks_build_tuple("%i %f", 2, 3.0)` returns (2, 3.0)
 // NOTE: Returns a new reference, or NULL if there was an error thrown
@@ -169,7 +213,7 @@ static KS_TFUNC(tuple, new) {
     // handle short cases
     if (objs->type == ks_T_tuple) {
         return KS_NEWREF(objs);
-    } else if (objs->type == ks_T_list) {
+    } else if (objs->type == ks_T_list && ((ks_list)objs)->kind == KS_LIST_KIND_OBJ) {
         return (ks_obj)ks_tuple_new(((ks_list)objs)->len, ((ks_list)objs)->elems);
     }
 
@@ -230,21 +274,75 @@ static KS_TFUNC(tuple, hash) {
     ks_tuple self;
     KS_GETARGS("self:*", &self, ks_T_tuple)
 
-    ks_hash_t hash = 0;
+    ks_hash_t hash;
+    if (!ks_tuple_hash(self, &hash)) return NULL;
 
-    int i;
-    for (i = 0; i < self->len; ++i) {
-        ks_hash_t chash;
-        if (!ks_obj_hash(self->elems[i], &chash)) {
-            return NULL;
+    return (ks_obj)ks_int_new(hash);
+}
+
+// tuple.__eq__(L, R) - check if all elements are equal
+static KS_TFUNC(tuple, eq) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R);
+
+    if (L->type == ks_T_tuple && R->type == ks_T_tuple) {
+        ks_tuple tL = (ks_tuple)L, tR = (ks_tuple)R;
+        if (ks_tuple_eq(tL, tR)) return KSO_TRUE;
+        if (tL->len != tR->len) return KSO_FALSE;
+
+        // fall back to the '==' operator for elements 'ks_obj_eq()' doesn't know about
+        ks_size_t i;
+        for (i = 0; i < tL->len; ++i) {
+            ks_obj lreq = ks_F_eq->func(2, (ks_obj[]){ tL->elems[i], tR->elems[i] });
+            if (!lreq) return NULL;
+            int truthy = ks_obj_truthy(lreq);
+            KS_DECREF(lreq);
+            if (truthy < 0) return NULL;
+            if (!truthy) return KSO_FALSE;
         }
 
-        hash = (hash ^ chash) * KS_HASH_MUL + KS_HASH_ADD;
+        // all were equal
+        return KSO_TRUE;
     }
 
-    return (ks_obj)ks_int_new(hash);
+    KS_THROW_BOP_ERR("==", L, R);
 }
 
+// tuple.__ne__(L, R) - check if any elements differ
+static KS_TFUNC(tuple, ne) {
+    ks_obj L, R;
+    KS_GETARGS("L R", &L, &R);
+
+    if (L->type == ks_T_tuple && R->type == ks_T_tuple) {
+        ks_obj res = tuple_eq_(2, (ks_obj[]){ L, R });
+        if (!res) return NULL;
+        bool isEq = res == KSO_TRUE;
+        KS_DECREF(res);
+        return KSO_BOOL(!isEq);
+    }
+
+    KS_THROW_BOP_ERR("!=", L, R);
+}
+
+// template for the ordering operators, which compare lexicographically (see `ks_obj_lt()`)
+// '_swap' is whether to compare 'R < L' instead, and '_neg' is whether to negate the result
+#define T_TUPLE_ORD(_name, _str, _swap, _neg)                                     \
+static KS_TFUNC(tuple, _name) {                                                   \
+    ks_obj L, R;                                                                  \
+    KS_GETARGS("L R", &L, &R);                                                    \
+    if (L->type == ks_T_tuple && R->type == ks_T_tuple) {                         \
+        int res = _swap ? ks_obj_lt(R, L) : ks_obj_lt(L, R);                      \
+        if (res < 0) return NULL;                                                 \
+        return KSO_BOOL(_neg ? !res : res);                                       \
+    }                                                                             \
+    KS_THROW_BOP_ERR(_str, L, R);                                                 \
+}
+
+T_TUPLE_ORD(lt, "<", false, false)
+T_TUPLE_ORD(gt, ">", true, false)
+T_TUPLE_ORD(le, "<=", true, true)
+T_TUPLE_ORD(ge, ">=", false, true)
+
 
 // tuple.__str__(self) - to string
 static KS_TFUNC(tuple, str) {
@@ -489,6 +587,13 @@ void ks_init_T_tuple() {
         {"__len__",                (ks_obj)ks_cfunc_new_c_old(tuple_len_, "tuple.__len__(self)")},
         {"__hash__",               (ks_obj)ks_cfunc_new_c_old(tuple_hash_, "tuple.__hash__(self)")},
 
+        {"__eq__",                 (ks_obj)ks_cfunc_new_c_old(tuple_eq_, "tuple.__eq__(L, R)")},
+        {"__ne__",                 (ks_obj)ks_cfunc_new_c_old(tuple_ne_, "tuple.__ne__(L, R)")},
+        {"__lt__",                 (ks_obj)ks_cfunc_new_c_old(tuple_lt_, "tuple.__lt__(L, R)")},
+        {"__gt__",                 (ks_obj)ks_cfunc_new_c_old(tuple_gt_, "tuple.__gt__(L, R)")},
+        {"__le__",                 (ks_obj)ks_cfunc_new_c_old(tuple_le_, "tuple.__le__(L, R)")},
+        {"__ge__",                 (ks_obj)ks_cfunc_new_c_old(tuple_ge_, "tuple.__ge__(L, R)")},
+
         {"__str__",                (ks_obj)ks_cfunc_new_c_old(tuple_str_, "tuple.__str__(self)")},
         {"__repr__",               (ks_obj)ks_cfunc_new_c_old(tuple_str_, "tuple.__repr__(self)")},
 
@@ -59,6 +59,9 @@ static void my_setall(ks_type self, ks_type parent) {
     SPEC_CASE(__binand__)
     SPEC_CASE(__binxor__)
 
+    SPEC_CASE(getbuf)
+    SPEC_CASE(relbuf)
+
     #undef SPEC_CASE
 
 }
@@ -70,6 +70,11 @@ bool ks_obj_hash(ks_obj obj, ks_hash_t* out) {
     } else if (obj->type == ks_T_int) {
         *out = ks_int_hash((ks_int)obj);
         return true;
+    } else if (obj->type == ks_T_tuple) {
+        return ks_tuple_hash((ks_tuple)obj, out);
+    } else if (obj->type == ks_T_bytes) {
+        *out = ((ks_bytes)obj)->v_hash;
+        return true;
     } else if (obj->type->__hash__ != NULL) {
         ks_int val = (ks_int)ks_obj_call(obj->type->__hash__, 1, &obj);
         if (!val) return NULL;
@@ -100,6 +105,13 @@ bool ks_obj_eq(ks_obj A, ks_obj B) {
         // speed up some special cases here
         /**/ if (A->type == ks_T_str) {
             return ks_str_eq((ks_str)A, (ks_str)B);
+        } else if (A->type == ks_T_int) {
+            return ks_int_cmp((ks_int)A, (ks_int)B) == 0;
+        } else if (A->type == ks_T_tuple) {
+            return ks_tuple_eq((ks_tuple)A, (ks_tuple)B);
+        } else if (A->type == ks_T_bytes) {
+            ks_bytes Ab = (ks_bytes)A, Bb = (ks_bytes)B;
+            return Ab->len_b == Bb->len_b && Ab->v_hash == Bb->v_hash && memcmp(Ab->byt, Bb->byt, Ab->len_b) == 0;
         }
     }
     return false;
@@ -108,6 +120,45 @@ bool ks_obj_eq(ks_obj A, ks_obj B) {
 
 
 
+int ks_obj_lt(ks_obj A, ks_obj B) {
+    if (A->type == B->type) {
+        // speed up some special cases here
+        /**/ if (A->type == ks_T_int) {
+            return ks_int_cmp((ks_int)A, (ks_int)B) < 0;
+        } else if (A->type == ks_T_float) {
+            return ((ks_float)A)->val < ((ks_float)B)->val;
+        } else if (A->type == ks_T_str) {
+            return ks_str_cmp((ks_str)A, (ks_str)B) < 0;
+        } else if (A->type == ks_T_tuple) {
+            // lexicographical order: the first element that differs decides it
+            ks_tuple At = (ks_tuple)A, Bt = (ks_tuple)B;
+            ks_size_t i;
+            for (i = 0; i < At->len && i < Bt->len; ++i) {
+                if (ks_obj_eq(At->elems[i], Bt->elems[i])) continue;
+                int r = ks_obj_lt(At->elems[i], Bt->elems[i]);
+                if (r != 0) return r;
+                r = ks_obj_lt(Bt->elems[i], At->elems[i]);
+                if (r != 0) return r < 0 ? -1 : 0;
+            }
+            return At->len < Bt->len;
+        }
+    } else if ((A->type == ks_T_int || A->type == ks_T_float) && (B->type == ks_T_int || B->type == ks_T_float)) {
+        int cmp;
+        if (!ks_num_cmp(A, B, &cmp)) return -1;
+        return cmp < 0;
+    }
+
+    // otherwise, use the operator
+    ks_obj res = ks_obj_call((ks_obj)ks_F_lt, 2, (ks_obj[]){ A, B });
+    if (!res) return -1;
+
+    int truthy = res == KSO_TRUE ? 1 : res == KSO_FALSE ? 0 : ks_obj_truthy(res);
+    KS_DECREF(res);
+    return truthy;
+}
+
+
+
 /* call(func, *args) -> obj
  *
  * Try and call 'func(*args)' and return the result
@@ -210,8 +261,13 @@ ks_obj ks_obj_call2(ks_obj func, int n_args, ks_obj* args, ks_dict locals) {
 
 
         if (!haderr) {
-            // actually perform call
-            ret = ks__exec(thread, kfc->code);
+            if (kfc->code->isGen) {
+                // the function contains 'yield', so return a generator that will execute it when requested
+                ret = (ks_obj)ks_gen_new(kfc, c_frame->locals);
+            } else {
+                // actually perform call
+                ret = ks__exec(thread, kfc->code);
+            }
         }
     } else if (func->type == ks_T_pfunc) {
         // call `func(self, *args)`
@@ -310,6 +366,10 @@ ks_obj ks_obj_call2(ks_obj func, int n_args, ks_obj* args, ks_dict locals) {
             ks_throw(ks_T_Error, "'%T' object was not callable! (expected there to be `%S.__new__()`, but there was none!)", func, func);
         }
 
+    } else if (func->type == ks_T_memoize) {
+        // look up the result directly, rather than calling 'memoize.__call__'
+        ret = ks_memoize_call((ks_memoize)func, n_args, args);
+
     } else if (func->type->__call__ != NULL) {
 
 
@@ -495,8 +555,15 @@ ks_str ks_readfile(const char* fname, const char* mode) {
     fclose(fp);
 
 
+    if (ks_text_utf8_validate(buf, read_sz) < 0) {
+        ks_free(buf);
+        return (ks_str)ks_throw(ks_T_ArgError, "File '%s' was not valid UTF-8", fname);
+    }
+
     // create new string
-    return ks_str_new_c(buf, sz);
+    ks_str ret = ks_str_new_c(buf, read_sz);
+    ks_free(buf);
+    return ret;
 
 }
 